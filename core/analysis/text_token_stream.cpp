@@ -63,6 +63,85 @@
 
 #include "text_token_stream.hpp"
 
+NS_LOCAL
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a bounded 2-way set associative cache of processed words, maps a
+///        word as found in the input (UTF-8 for words found without ICU,
+///        UTF-16 code units otherwise) to its term value or to the fact that
+///        the word is ignored
+////////////////////////////////////////////////////////////////////////////////
+class term_cache {
+ public:
+  static const size_t SETS = 512; // power of 2
+  static const size_t MAX_KEY_SIZE = 64; // longer words are rarely repeated
+
+  struct entry {
+    irs::bstring key;
+    irs::bstring value;
+    size_t hash{};
+    bool utf16{};
+    bool ignored{};
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @return cached entry for the specified word or nullptr
+  ////////////////////////////////////////////////////////////////////////////////
+  const entry* find(
+      const irs::bytes_ref& key, size_t hash, bool utf16
+  ) NOEXCEPT {
+    if (entries_.empty()) {
+      return nullptr;
+    }
+
+    const auto set = hash & (SETS - 1);
+
+    for (size_t way = 0; way < 2; ++way) {
+      auto& entry = entries_[2*set + way];
+
+      if (entry.hash == hash && entry.utf16 == utf16 && irs::bytes_ref(entry.key) == key) {
+        recent_[set] = irs::byte_type(way);
+
+        return &entry;
+      }
+    }
+
+    return nullptr;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @return entry for the specified word replacing the least recently used
+  ///         one, the caller is expected to fill 'value' and 'ignored'
+  ////////////////////////////////////////////////////////////////////////////////
+  entry& insert(const irs::bytes_ref& key, size_t hash, bool utf16) {
+    if (entries_.empty()) {
+      entries_.resize(2*SETS);
+      recent_.resize(SETS);
+    }
+
+    const auto set = hash & (SETS - 1);
+    const auto way = 1 - recent_[set];
+    auto& entry = entries_[2*set + way];
+
+    recent_[set] = irs::byte_type(way);
+    entry.key.assign(key.c_str(), key.size());
+    entry.hash = hash;
+    entry.utf16 = utf16;
+
+    return entry;
+  }
+
+ private:
+  std::vector<entry> entries_; // allocated on first use
+  std::vector<irs::byte_type> recent_; // most recently used way of each set
+}; // term_cache
+
+NS_END
+
 NS_ROOT
 NS_BEGIN(analysis)
 
@@ -71,14 +150,25 @@ NS_BEGIN(analysis)
 // -----------------------------------------------------------------------------
 
 struct text_token_stream::state_t {
+  bool ascii; // ASCII words may bypass ICU for the current locale
   std::shared_ptr<icu::BreakIterator> break_iterator;
-  icu::UnicodeString data;
+  term_cache cache;
+  cache_stats cache_statistics;
+  icu::UnicodeString data; // chunk of 'text' tokenized via ICU
+  size_t data_end; // end of 'data' chunk in 'text'
+  bool data_valid; // 'data' chunk is being tokenized
   icu::Locale locale;
   std::shared_ptr<const icu::Normalizer2> normalizer;
   std::shared_ptr<sb_stemmer> stemmer;
+  string_ref text; // UTF-8 input
+  std::string text_buf; // UTF-8 input converted from a non UTF-8 locale
+  size_t text_pos; // word boundary in 'text' tokenization is resumed at
+  size_t text_pos_utf16; // 'text_pos' in UTF-16 code units as used by offsets
   std::string tmp_buf; // used by processTerm(...)
   std::shared_ptr<icu::Transliterator> transliterator;
-  state_t(): locale("C") {
+  state_t()
+    : ascii(false), data_end(0), data_valid(false),
+      locale("C"), text_pos(0), text_pos_utf16(0) {
     // NOTE: use of the default constructor for Locale() or
     //       use of Locale::createFromName(nullptr)
     //       causes a memory leak with Boost 1.58, as detected by valgrind
@@ -332,6 +422,260 @@ irs::analysis::analyzer::ptr construct(
   return construct(cache_key, locale, std::move(ignored_words));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief UAX #29 word break classes of ASCII characters, characters that are
+///        treated differently by locale tailorings (e.g. ':' for 'fi' and 'sv')
+///        and non-ASCII bytes are left to ICU
+////////////////////////////////////////////////////////////////////////////////
+enum ascii_class_t : irs::byte_type {
+  ASCII_OTHER,
+  ASCII_LETTER,
+  ASCII_DIGIT,
+  ASCII_EXTEND_NUM_LET, // '_'
+  ASCII_MID_NUM_LET, // '.', '\''
+  ASCII_MID_NUM, // ',', ';'
+  ASCII_WHITESPACE,
+  ASCII_UNSUPPORTED
+};
+
+struct ascii_classes {
+  ascii_classes() {
+    for (size_t i = 0; i < 0x80; ++i) {
+      value[i] = ASCII_OTHER;
+    }
+
+    for (size_t i = 0x80; i < IRESEARCH_COUNTOF(value); ++i) {
+      value[i] = ASCII_UNSUPPORTED;
+    }
+
+    for (auto c = 'a'; c <= 'z'; ++c) {
+      value[irs::byte_type(c)] = value[irs::byte_type(c - 'a' + 'A')] = ASCII_LETTER;
+    }
+
+    for (auto c = '0'; c <= '9'; ++c) {
+      value[irs::byte_type(c)] = ASCII_DIGIT;
+    }
+
+    for (auto c : irs::string_ref(" \t\n\v\f\r")) {
+      value[irs::byte_type(c)] = ASCII_WHITESPACE;
+    }
+
+    value[irs::byte_type('_')] = ASCII_EXTEND_NUM_LET;
+    value[irs::byte_type('.')] = ASCII_MID_NUM_LET;
+    value[irs::byte_type('\'')] = ASCII_MID_NUM_LET;
+    value[irs::byte_type(',')] = ASCII_MID_NUM;
+    value[irs::byte_type(';')] = ASCII_MID_NUM;
+    value[irs::byte_type(':')] = ASCII_UNSUPPORTED; // MidLetter for some locales
+  }
+
+  irs::byte_type operator[](char c) const NOEXCEPT {
+    return value[irs::byte_type(c)];
+  }
+
+  irs::byte_type value[256];
+};
+
+const ascii_classes ASCII_CLASSES;
+
+inline bool is_ascii_word(irs::byte_type cls) NOEXCEPT {
+  return ASCII_LETTER == cls || ASCII_DIGIT == cls || ASCII_EXTEND_NUM_LET == cls;
+}
+
+enum class ascii_word_t {
+  FOUND, // a word is found
+  END, // no more words in input
+  UNSUPPORTED // ICU is required to find the next word
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the next word in 'text' starting from 'pos' according to the
+///        UAX #29 word boundary rules restricted to ASCII (WB5-WB13b), a word
+///        is reported only if every character deciding its boundaries is ASCII
+///        so that the boundaries are the same as would be found by ICU
+////////////////////////////////////////////////////////////////////////////////
+ascii_word_t next_ascii_word(
+    const irs::string_ref& text,
+    size_t pos,
+    size_t& start,
+    size_t& end
+) NOEXCEPT {
+  const auto size = text.size();
+
+  for (auto i = pos;;) {
+    irs::byte_type prev;
+
+    // skip non-word characters
+    for (;; ++i) {
+      if (i == size) {
+        return ascii_word_t::END;
+      }
+
+      prev = ASCII_CLASSES[text[i]];
+
+      if (ASCII_UNSUPPORTED == prev) {
+        return ascii_word_t::UNSUPPORTED;
+      }
+
+      if (is_ascii_word(prev)) {
+        break;
+      }
+    }
+
+    // find the end of the word
+    for (start = i++; i < size;) {
+      const auto cls = ASCII_CLASSES[text[i]];
+
+      if (is_ascii_word(cls)) {
+        prev = cls;
+        ++i;
+        continue;
+      }
+
+      if (ASCII_UNSUPPORTED == cls) {
+        return ascii_word_t::UNSUPPORTED;
+      }
+
+      // letters and digits are joined over 'MidNumLet' (WB6, WB7),
+      // digits are also joined over 'MidNum' (WB11, WB12)
+      if ((ASCII_MID_NUM_LET == cls && ASCII_LETTER == prev)
+          || ((ASCII_MID_NUM_LET == cls || ASCII_MID_NUM == cls) && ASCII_DIGIT == prev)) {
+        if (i + 1 < size) {
+          const auto next = ASCII_CLASSES[text[i + 1]];
+
+          if (ASCII_UNSUPPORTED == next) {
+            return ascii_word_t::UNSUPPORTED;
+          }
+
+          if (next == prev) {
+            i += 2;
+            continue;
+          }
+        }
+      }
+
+      break;
+    }
+
+    end = i;
+
+    // ICU does not consider a standalone '_' to be a word
+    if (end - start > 1 || ASCII_EXTEND_NUM_LET != prev) {
+      return ascii_word_t::FOUND;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @return end of the chunk of 'text' starting at 'pos' to be tokenized via ICU,
+///         i.e. the first position after 'pos' where ASCII whitespace is
+///         followed by a character not requiring ICU
+////////////////////////////////////////////////////////////////////////////////
+size_t unsupported_chunk_end(const irs::string_ref& text, size_t pos) NOEXCEPT {
+  const auto size = text.size();
+
+  for (auto i = pos; i < size; ++i) {
+    if (ASCII_WHITESPACE != ASCII_CLASSES[text[i]]) {
+      continue;
+    }
+
+    while (i < size && ASCII_WHITESPACE == ASCII_CLASSES[text[i]]) {
+      ++i;
+    }
+
+    if (i == size || ASCII_UNSUPPORTED != ASCII_CLASSES[text[i]]) {
+      return i;
+    }
+  }
+
+  return size;
+}
+
+bool process_term(
+  irs::analysis::text_token_stream::bytes_term& term,
+  const std::unordered_set<std::string>& ignored_words,
+  irs::analysis::text_token_stream::state_t& state
+);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process a word via 'process' unless its outcome is already cached,
+///        the locale and ignored words of an analyzer never change so cached
+///        outcomes remain valid across reset(...)
+/// @param key the word as found in the input
+/// @param utf16 'key' denotes UTF-16 code units
+////////////////////////////////////////////////////////////////////////////////
+template<typename Func>
+bool process_cached_term(
+    irs::analysis::text_token_stream::bytes_term& term,
+    irs::analysis::text_token_stream::state_t& state,
+    const irs::bytes_ref& key,
+    bool utf16,
+    Func process
+) {
+  auto& stats = state.cache_statistics;
+
+  if (key.size() > term_cache::MAX_KEY_SIZE) {
+    ++stats.misses;
+
+    return process();
+  }
+
+  const auto hash = irs::hash_utils::hash(key);
+  auto* cached = state.cache.find(key, hash, utf16);
+
+  if (cached) {
+    ++stats.hits;
+
+    if (cached->ignored) {
+      return false;
+    }
+
+    term.value(irs::bytes_ref(cached->value));
+
+    return true;
+  }
+
+  ++stats.misses;
+
+  const auto found = process();
+  auto& entry = state.cache.insert(key, hash, utf16);
+
+  entry.ignored = !found;
+
+  if (found) {
+    const auto& value = static_cast<const irs::term_attribute&>(term).value();
+
+    entry.value.assign(value.c_str(), value.size());
+    term.value(irs::bytes_ref(entry.value));
+  } else {
+    entry.value.clear();
+  }
+
+  return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process an ASCII word, normalization and accent removal do not
+///        affect ASCII so only case-conversion is required
+////////////////////////////////////////////////////////////////////////////////
+bool process_term(
+  irs::analysis::text_token_stream::bytes_term& term,
+  const std::unordered_set<std::string>& ignored_words,
+  irs::analysis::text_token_stream::state_t& state,
+  const irs::string_ref& data
+) {
+  std::string& word_utf8 = state.tmp_buf;
+
+  word_utf8.resize(data.size());
+
+  for (size_t i = 0, size = data.size(); i < size; ++i) {
+    const auto c = data[i];
+
+    word_utf8[i] = 'A' <= c && c <= 'Z' ? char(c - 'A' + 'a') : c;
+  }
+
+  return process_term(term, ignored_words, state);
+}
+
 bool process_term(
   irs::analysis::text_token_stream::bytes_term& term,
   const std::unordered_set<std::string>& ignored_words,
@@ -365,6 +709,19 @@ bool process_term(
   word_utf8.clear();
   word.toUTF8String(word_utf8);
 
+  return process_term(term, ignored_words, state);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process a normalized UTF-8 word stored in 'state.tmp_buf'
+////////////////////////////////////////////////////////////////////////////////
+bool process_term(
+  irs::analysis::text_token_stream::bytes_term& term,
+  const std::unordered_set<std::string>& ignored_words,
+  irs::analysis::text_token_stream::state_t& state
+) {
+  const std::string& word_utf8 = state.tmp_buf;
+
   // ...........................................................................
   // skip ignored tokens
   // ...........................................................................
@@ -498,6 +855,9 @@ text_token_stream::text_token_stream(
   locale_.encoding = locale_utils::encoding(locale);
   locale_.language = locale_utils::language(locale);
   locale_.utf8 = locale_utils::utf8(locale);
+
+  // case-conversion of ASCII is locale-specific for Turkic languages ('I')
+  state_->ascii = locale_.language != "tr" && locale_.language != "az";
 }
 
 // -----------------------------------------------------------------------------
@@ -513,6 +873,10 @@ text_token_stream::text_token_stream(
   return construct(locale.name(), locale);
 }
 
+text_token_stream::cache_stats text_token_stream::cache_statistics() const NOEXCEPT {
+  return state_->cache_statistics;
+}
+
 bool text_token_stream::reset(const string_ref& data) {
   if (state_->locale.isBogus()) {
     state_->locale =
@@ -577,40 +941,50 @@ bool text_token_stream::reset(const string_ref& data) {
   }
 
   // ...........................................................................
-  // convert encoding to UTF8 for use with ICU
+  // convert encoding to UTF8
   // ...........................................................................
   if (locale_.utf8) {
-    if (data.size() > INT32_MAX) {
-      return false; // ICU UnicodeString signatures can handle at most INT32_MAX
-    }
-
-    state_->data = icu::UnicodeString::fromUTF8(
-      icu::StringPiece(data.c_str(), (int32_t)(data.size()))
-    );
+    state_->text = data;
   }
   else {
-    std::string data_utf8 = boost::locale::conv::to_utf<char>(
+    state_->text_buf = boost::locale::conv::to_utf<char>(
       data.c_str(), data.c_str() + data.size(), locale_.encoding
     );
+    state_->text = state_->text_buf;
+  }
 
-    if (data_utf8.size() > INT32_MAX) {
-      return false; // ICU UnicodeString signatures can handle at most INT32_MAX
-    }
+  if (state_->text.size() > INT32_MAX) {
+    return false; // ICU UnicodeString signatures can handle at most INT32_MAX
+  }
 
-    state_->data = icu::UnicodeString::fromUTF8(
-      icu::StringPiece(data_utf8.c_str(), (int32_t)(data_utf8.size()))
-    );
+  state_->text_pos = 0;
+  state_->text_pos_utf16 = 0;
+  state_->data_valid = false;
+
+  if (!state_->ascii) {
+    set_chunk(state_->text.size()); // tokenise the whole input via ICU
   }
 
+  return true;
+}
+
+void text_token_stream::set_chunk(size_t end) {
+  assert(state_->text_pos <= end && end <= state_->text.size());
+
+  state_->data = icu::UnicodeString::fromUTF8(icu::StringPiece(
+    state_->text.c_str() + state_->text_pos,
+    (int32_t)(end - state_->text_pos)
+  ));
+  state_->data_end = end;
+  state_->data_valid = true;
+
   // ...........................................................................
   // tokenise the unicode data
   // ...........................................................................
   state_->break_iterator->setText(state_->data);
-
-  return true;
 }
 
-bool text_token_stream::next() {
+bool text_token_stream::next_chunk_word() {
   // ...........................................................................
   // find boundaries of the next word
   // ...........................................................................
@@ -622,19 +996,76 @@ bool text_token_stream::next() {
     // ...........................................................................
     // skip whitespace and unsuccessful terms
     // ...........................................................................
-    if (UWordBreak::UBRK_WORD_NONE == state_->break_iterator->getRuleStatus()
-        || !process_term(term_, ignored_words_, *state_, state_->data.tempSubString(start, end - start))) {
+    if (UWordBreak::UBRK_WORD_NONE == state_->break_iterator->getRuleStatus()) {
       continue;
     }
 
-    offs_.start = start;
-    offs_.end = end;
+    const auto word = state_->data.tempSubString(start, end - start);
+    const bytes_ref key(
+      reinterpret_cast<const byte_type*>(word.getBuffer()),
+      size_t(word.length())*sizeof(UChar)
+    );
+
+    if (!process_cached_term(term_, *state_, key, true, [this, &word]()->bool {
+          return process_term(term_, ignored_words_, *state_, word);
+        })) {
+      continue;
+    }
+
+    offs_.start = uint32_t(state_->text_pos_utf16 + start);
+    offs_.end = uint32_t(state_->text_pos_utf16 + end);
     return true;
   }
 
   return false;
 }
 
+bool text_token_stream::next() {
+  auto& state = *state_;
+
+  for (;;) {
+    if (state.data_valid) {
+      if (next_chunk_word()) {
+        return true;
+      }
+
+      // continue after the chunk
+      state.data_valid = false;
+      state.text_pos = state.data_end;
+      state.text_pos_utf16 += size_t(state.data.length());
+    }
+
+    size_t start, end;
+
+    switch (next_ascii_word(state.text, state.text_pos, start, end)) {
+      case ascii_word_t::FOUND: {
+        const string_ref word(state.text.c_str() + start, end - start);
+        const auto found = process_cached_term(
+          term_, state, ref_cast<byte_type>(word), false,
+          [this, &state, &word]()->bool {
+            return process_term(term_, ignored_words_, state, word);
+        });
+
+        // all characters up to 'end' are single UTF-16 code units
+        offs_.start = uint32_t(state.text_pos_utf16 + start - state.text_pos);
+        offs_.end = uint32_t(state.text_pos_utf16 + end - state.text_pos);
+        state.text_pos_utf16 += end - state.text_pos;
+        state.text_pos = end;
+
+        if (found) {
+          return true;
+        }
+      } break;
+      case ascii_word_t::END:
+        state.text_pos = state.text.size();
+        return false;
+      case ascii_word_t::UNSUPPORTED:
+        set_chunk(unsupported_chunk_end(state.text, state.text_pos));
+        break;
+    }
+  }
+}
+
 NS_END // analysis
 NS_END // ROOT
 
@@ -56,6 +56,15 @@ class text_token_stream : public analyzer, util::noncopyable {
     irs::bstring buf_; // buffer for value if value cannot be referenced directly
   };
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief statistics of the cache of processed (normalized, stemmed and
+  ///        checked against ignored words) words of an analyzer instance
+  //////////////////////////////////////////////////////////////////////////////
+  struct cache_stats {
+    size_t hits{}; // number of words served from the cache
+    size_t misses{}; // number of words processed from scratch
+  };
+
   static char const* STOPWORD_PATH_ENV_VARIABLE;
 
   DECLARE_ANALYZER_TYPE();
@@ -70,11 +79,15 @@ class text_token_stream : public analyzer, util::noncopyable {
   virtual const irs::attribute_view& attributes() const NOEXCEPT override {
     return attrs_;
   }
+  cache_stats cache_statistics() const NOEXCEPT;
   static void init(); // for trigering registration in a static build
   virtual bool next() override;
   virtual bool reset(const string_ref& data) override;
 
  private:
+  bool next_chunk_word(); // next word of a chunk tokenized via ICU
+  void set_chunk(size_t end); // tokenize input up to 'end' via ICU
+
   irs::attribute_view attrs_;
   std::shared_ptr<state_t> state_;
   struct {
@@ -84,6 +84,17 @@ document::document() NOEXCEPT:
 REGISTER_ATTRIBUTE(iresearch::frequency);
 DEFINE_ATTRIBUTE_TYPE(frequency)
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   frequency_bound
+// -----------------------------------------------------------------------------
+
+REGISTER_ATTRIBUTE(iresearch::frequency_bound);
+DEFINE_ATTRIBUTE_TYPE(frequency_bound)
+
+frequency_bound::frequency_bound() NOEXCEPT
+  : func_([](doc_id_t) { return type_limits<type_t::doc_id_t>::eof(); }) {
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                granularity_prefix
 // -----------------------------------------------------------------------------
@@ -121,7 +132,7 @@ bool norm::reset(const sub_reader& reader, field_id column, const document& doc)
     return false;
   }
 
-  column_ = column_reader->values();
+  column_ = column_reader->values_cursor();
   doc_ = &doc;
   return true;
 }
@@ -137,6 +148,23 @@ float_t norm::read() const {
   return read_zvfloat(in);
 }
 
+void norm::read(const doc_id_t* docs, size_t size, float_t* values) const {
+  bytes_ref value;
+  bytes_ref_input in;
+
+  // sorted ids hit the same column block, so only the first lookup of
+  // each block actually loads data
+  for (auto* end = docs + size; docs != end; ++docs, ++values) {
+    if (!column_(*docs, value)) {
+      *values = DEFAULT();
+      continue;
+    }
+
+    in.reset(value);
+    *values = read_zvfloat(in);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                          position
 // -----------------------------------------------------------------------------
@@ -125,6 +125,48 @@ struct IRESEARCH_API frequency : basic_attribute<uint32_t> {
   frequency() = default;
 }; // frequency
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class frequency_bound
+/// @brief upper bounds of the 'frequency' attribute values of a postings
+///        list, both for the whole list and for the block of postings
+///        containing a given document
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API frequency_bound : attribute {
+  typedef std::function<doc_id_t(doc_id_t)> shallow_seek_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  frequency_bound() NOEXCEPT;
+
+  void clear() {
+    value = block = 0;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief sets the rule used for locating blocks of postings
+  //////////////////////////////////////////////////////////////////////////////
+  void rule(shallow_seek_f&& func) {
+    func_ = std::move(func);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves the block cursor to the block containing 'target' without
+  ///        moving the owning iterator
+  /// @returns the last document of the block, eof() if unknown
+  //////////////////////////////////////////////////////////////////////////////
+  doc_id_t shallow_seek(doc_id_t target) {
+    return func_(target);
+  }
+
+  uint32_t value{}; // max frequency across the whole postings list
+  uint32_t block{}; // max frequency in a block located by 'shallow_seek'
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  shallow_seek_f func_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // frequency_bound
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class granularity_prefix
 /// @brief indexed tokens are prefixed with one byte indicating granularity
@@ -154,6 +196,13 @@ struct IRESEARCH_API norm : stored_attribute {
 
   bool reset(const sub_reader& segment, field_id column, const document& doc);
   float_t read() const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief reads norms of 'size' documents into the specified buffer,
+  ///        document ids are expected to be sorted in ascending order
+  //////////////////////////////////////////////////////////////////////////////
+  void read(const doc_id_t* docs, size_t size, float_t* values) const;
+
   bool empty() const;
 
   void clear() {
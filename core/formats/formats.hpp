@@ -33,6 +33,7 @@
 
 #include "utils/block_pool.hpp"
 #include "utils/io_utils.hpp"
+#include "utils/roaring_bitmap.hpp"
 #include "utils/string.hpp"
 #include "utils/type_id.hpp"
 #include "utils/attributes_provider.hpp"
@@ -47,7 +48,7 @@ struct reader_state;
 struct index_output;
 struct data_input;
 struct index_input;
-typedef std::unordered_set<doc_id_t> document_mask;
+typedef roaring_bitmap document_mask;
 struct postings_writer;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -229,6 +230,17 @@ struct IRESEARCH_API field_reader {
   virtual size_t size() const = 0;
 }; // field_reader
 
+////////////////////////////////////////////////////////////////////////////////
+/// @enum column_codec
+/// @brief compression of the data blocks of a column
+////////////////////////////////////////////////////////////////////////////////
+enum class column_codec : uint8_t {
+  NONE = 0, // data is stored as is, e.g. for tiny frequently accessed values
+  LZ4, // fast compression
+  LZ4HC, // higher compression ratio at the cost of slower writes, e.g. for rarely accessed values
+  LZ4_DICT, // compression against a dictionary shared by all blocks of a column, e.g. for many small similar values
+}; // column_codec
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @struct columnstore_writer
 ////////////////////////////////////////////////////////////////////////////////
@@ -247,7 +259,16 @@ struct IRESEARCH_API columnstore_writer {
   virtual ~columnstore_writer();
 
   virtual void prepare(directory& dir, const segment_meta& meta) = 0;
-  virtual column_t push_column() = 0;
+
+  // adds a column compressing its data blocks with the specified codec
+  // NOTE: may be called concurrently, distinct columns may be written by
+  //       different threads concurrently, each column by a single thread at
+  //       a time, 'prepare', 'commit' and 'rollback' require exclusive access
+  virtual column_t push_column(column_codec codec) = 0;
+
+  // adds a column compressing its data blocks with LZ4
+  column_t push_column() { return push_column(column_codec::LZ4); }
+
   virtual void rollback() NOEXCEPT = 0;
   virtual bool commit() = 0; // @return was anything actually flushed
 }; // columnstore_writer
@@ -301,9 +322,20 @@ struct IRESEARCH_API columnstore_reader {
   struct column_reader {
     virtual ~column_reader() = default;
 
-    // returns corresponding column reader
+    // returns corresponding column reader, the reader may be invoked
+    // concurrently, values returned by the reader remain valid for the
+    // lifetime of the column reader
     virtual columnstore_reader::values_reader_f values() const = 0;
 
+    // returns corresponding column reader which holds only the data it has
+    // accessed last, e.g. for sequential reads with bounded memory usage,
+    // a value returned by the reader remains valid until the next invocation
+    // of the same reader instance, a reader instance must not be invoked
+    // concurrently, use a copy per thread
+    virtual columnstore_reader::values_reader_f values_cursor() const {
+      return values();
+    }
+
     // returns the corresponding column iterator
     // if the column implementation supports document payloads then the latter
     // may be accessed via the 'payload_iterator' attribute
@@ -311,7 +343,29 @@ struct IRESEARCH_API columnstore_reader {
 
     virtual bool visit(const columnstore_reader::values_visitor_f& reader) const = 0;
 
+    // visits values of the column which may belong to the specified range
+    // [min, max] of byte-wise ordered values, bytes_ref::NIL denotes an
+    // unbounded side of the range, blocks which are known to contain no
+    // values in range may be skipped, values out of range may still be visited
+    virtual bool visit_range(
+        const bytes_ref& /*min*/,
+        const bytes_ref& /*max*/,
+        const columnstore_reader::values_visitor_f& visitor) const {
+      return visit(visitor);
+    }
+
+    // schedules asynchronous loading of up to 'count' consecutive blocks
+    // starting from the one which may contain the specified key into a block
+    // cache ahead of the actual reads, e.g. before retrieving stored values
+    // for a page of search results, the request may be partially skipped if
+    // too many loads are pending, column iterators call it on their own while
+    // reading sequentially, it's safe to call the method from multiple threads
+    virtual void prefetch(doc_id_t /*key*/, size_t /*count*/) const { }
+
     virtual size_t size() const = 0;
+
+    // returns the codec used for compression of the column data blocks
+    virtual column_codec codec() const { return column_codec::LZ4; }
   };
 
   static const values_reader_f& empty_reader();
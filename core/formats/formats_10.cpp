@@ -23,11 +23,17 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
 #include <deque>
 #include <list>
+#include <map>
+#include <mutex>
 #include <numeric>
+#include <unordered_map>
 
 #include "shared.hpp"
 
@@ -47,13 +53,16 @@
 
 #include "store/memory_directory.hpp"
 #include "store/store_utils.hpp"
+#include "store/store_utils_adaptive.hpp"
 
+#include "utils/async_utils.hpp"
 #include "utils/bit_packing.hpp"
 #include "utils/bit_utils.hpp"
 #include "utils/bitset.hpp"
 #include "utils/compression.hpp"
 #include "utils/directory_utils.hpp"
 #include "utils/log.hpp"
+#include "utils/math_utils.hpp"
 #include "utils/memory.hpp"
 #include "utils/memory_pool.hpp"
 #include "utils/noncopyable.hpp"
@@ -61,6 +70,11 @@
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "utils/std.hpp"
+#include "utils/thread_utils.hpp"
+
+#ifdef IRESEARCH_SSE2
+  #include <emmintrin.h>
+#endif
 
 #if defined(_MSC_VER)
   #pragma warning(disable : 4351)
@@ -244,7 +258,7 @@ inline void prepare_output(
   format_utils::write_header(*out, format, version);
 }
 
-inline void prepare_input(
+inline int32_t prepare_input(
     std::string& str,
     index_input::ptr& in,
     IOAdvice advice,
@@ -264,7 +278,7 @@ inline void prepare_input(
     ));
   }
 
-  format_utils::check_header(*in, format, min_ver, max_ver);
+  return format_utils::check_header(*in, format, min_ver, max_ver);
 }
 
 // ----------------------------------------------------------------------------
@@ -282,7 +296,8 @@ class postings_writer final: public irs::postings_writer {
  public:
   static const string_ref TERMS_FORMAT_NAME;
   static const int32_t TERMS_FORMAT_MIN = 0;
-  static const int32_t TERMS_FORMAT_MAX = TERMS_FORMAT_MIN;
+  static const int32_t TERMS_FORMAT_BLOCK_MAX = 1; // term meta contains max frequency
+  static const int32_t TERMS_FORMAT_MAX = TERMS_FORMAT_BLOCK_MAX;
 
   static const string_ref DOC_FORMAT_NAME;
   static const string_ref DOC_EXT;
@@ -292,12 +307,19 @@ class postings_writer final: public irs::postings_writer {
   static const string_ref PAY_EXT;
 
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_BLOCK_MAX = 1; // skip data contains max frequencies
+  static const int32_t FORMAT_ADAPTIVE = 2; // encoding is chosen per block
+  static const int32_t FORMAT_MAX = FORMAT_ADAPTIVE;
 
   static const uint32_t MAX_SKIP_LEVELS = 10;
   static const uint32_t BLOCK_SIZE = format_traits::BLOCK_SIZE;
   static const uint32_t SKIP_N = 8;
 
+  static_assert(
+    BLOCK_SIZE == encode::adaptive::BLOCK_SIZE,
+    "block sizes of postings codecs must be the same"
+  );
+
   explicit postings_writer(bool volatile_attributes);
 
   // ------------------------------------------
@@ -339,20 +361,26 @@ class postings_writer final: public irs::postings_writer {
     void flush(uint32_t* buf, bool freq);
     bool full() const { return BLOCK_SIZE == size; }
     void next(doc_id_t id) { last = id, ++size; }
-    void freq(uint32_t frq) { freqs[size] = frq; }
+    void freq(uint32_t frq) {
+      freqs[size] = frq;
+      block_freq = std::max(block_freq, frq);
+    }
 
     void reset() {
       stream::reset();
       last = type_limits<type_t::doc_id_t>::invalid();
       block_last = 0;
+      block_freq = 0;
       size = 0;
     }
 
     doc_id_t deltas[BLOCK_SIZE]{}; // document deltas
     doc_id_t skip_doc[MAX_SKIP_LEVELS]{};
+    uint32_t skip_freq[MAX_SKIP_LEVELS]{}; // max frequency since the last skip
     std::unique_ptr<uint32_t[]> freqs; // document frequencies
     doc_id_t last{ type_limits<type_t::doc_id_t>::invalid() }; // last buffered document id
     doc_id_t block_last{}; // last document id in a block
+    uint32_t block_freq{}; // max frequency in a block
     uint32_t size{}; // number of buffered elements
   }; // doc_stream
 
@@ -441,15 +469,15 @@ const string_ref postings_writer::PAY_EXT = "pay";
 MSVC2015_ONLY(__pragma(warning(pop)))
 
 void postings_writer::doc_stream::flush(uint32_t* buf, bool freq) {
-  format_traits::write_block(*out, deltas, BLOCK_SIZE, buf);
+  encode::adaptive::write_block(*out, deltas, buf, true);
 
   if (freq) {
-    format_traits::write_block(*out, freqs.get(), BLOCK_SIZE, buf);
+    encode::adaptive::write_block(*out, freqs.get(), buf, false);
   }
 }
 
 void postings_writer::pos_stream::flush(uint32_t* comp_buf) {
-  format_traits::write_block(*out, this->buf, BLOCK_SIZE, comp_buf);
+  encode::adaptive::write_block(*out, this->buf, comp_buf, false);
   size = 0;
 }
 
@@ -477,14 +505,14 @@ void postings_writer::pay_stream::flush_payload(uint32_t* buf) {
   if (pay_buf_.empty()) {
     return;
   }
-  format_traits::write_block(*out, pay_sizes, BLOCK_SIZE, buf);
+  encode::adaptive::write_block(*out, pay_sizes, buf, false);
   out->write_bytes(pay_buf_.c_str(), pay_buf_.size());
   pay_buf_.clear();
 }
 
 void postings_writer::pay_stream::flush_offsets(uint32_t* buf) {
-  format_traits::write_block(*out, offs_start_buf, BLOCK_SIZE, buf);
-  format_traits::write_block(*out, offs_len_buf, BLOCK_SIZE, buf);
+  encode::adaptive::write_block(*out, offs_start_buf, buf, false);
+  encode::adaptive::write_block(*out, offs_len_buf, buf, false);
 }
 
 postings_writer::postings_writer(bool volatile_attributes)
@@ -617,6 +645,7 @@ irs::postings_writer::state postings_writer::write(irs::doc_iterator& docs) {
     ++meta->docs_count;
     if (tfreq) {
       (*tfreq) += freq->value;
+      meta->max_freq = std::max(meta->max_freq, freq->value);
     }
 
     end_doc();
@@ -661,6 +690,8 @@ void postings_writer::begin_term() {
 
   doc.last = type_limits<type_t::doc_id_t>::min(); // for proper delta of 1st id
   doc.block_last = type_limits<type_t::doc_id_t>::invalid();
+  doc.block_freq = 0;
+  std::fill_n(doc.skip_freq, MAX_SKIP_LEVELS, 0);
   skip_.reset();
 }
 
@@ -721,6 +752,13 @@ void postings_writer::end_doc() {
   if (doc.full()) {
     doc.block_last = doc.last;
     doc.end = doc.out->file_pointer();
+
+    // account block max frequency at every skip level
+    for (auto& freq : doc.skip_freq) {
+      freq = std::max(freq, doc.block_freq);
+    }
+    doc.block_freq = 0;
+
     if (features_.position()) {
       assert(pos_ && pos_->out);
       pos_->end = pos_->out->file_pointer();
@@ -870,6 +908,12 @@ void postings_writer::write_skip(size_t level, index_output& out) {
   doc.skip_doc[level] = doc.block_last;
   doc.skip_ptr[level] = doc_ptr;
 
+  if (features_.freq()) {
+    // max frequency among the blocks covered by the skip
+    out.write_vint(doc.skip_freq[level]);
+    doc.skip_freq[level] = 0;
+  }
+
   if (features_.position()) {
     assert(pos_);
 
@@ -908,6 +952,12 @@ void postings_writer::encode(
   if (meta.freq != integer_traits<uint32_t>::const_max) {
     assert(meta.freq >= meta.docs_count);
     out.write_vint(meta.freq - meta.docs_count);
+
+    if (meta.docs_count > 1) {
+      // for a single document max frequency is the term frequency
+      assert(meta.max_freq <= meta.freq);
+      out.write_vint(meta.max_freq);
+    }
   }
 
   out.write_vlong(meta.doc_start - last_state.doc_start);
@@ -950,12 +1000,58 @@ struct skip_state {
   size_t pend_pos{}; // positions to skip before new document block
   doc_id_t doc{ type_limits<type_t::doc_id_t>::invalid() }; // last document in a previous block
   uint32_t pay_pos{}; // payload size to skip before in new document block
+  uint32_t freq{}; // max frequency in a previous block(s)
 }; // skip_state
 
 struct skip_context : skip_state {
   size_t level{}; // skip level
 }; // skip_context
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                      block_codec
+// ----------------------------------------------------------------------------
+
+///////////////////////////////////////////////////////////////////////////////
+/// @struct block_codec
+/// @brief decodes full blocks of postings written by a particular version
+///        of the postings format
+///////////////////////////////////////////////////////////////////////////////
+struct block_codec {
+  static const block_codec& get(int32_t version) NOEXCEPT;
+
+  void (*read_block)(
+    index_input& in,
+    uint32_t* RESTRICT encoded,
+    uint32_t* RESTRICT decoded
+  );
+
+  void (*skip_block)(index_input& in);
+}; // block_codec
+
+const block_codec BITPACK_CODEC {
+  [](index_input& in, uint32_t* RESTRICT encoded, uint32_t* RESTRICT decoded) {
+    format_traits::read_block(in, postings_writer::BLOCK_SIZE, encoded, decoded);
+  },
+  [](index_input& in) {
+    format_traits::skip_block(in, postings_writer::BLOCK_SIZE);
+  }
+};
+
+const block_codec ADAPTIVE_CODEC {
+  [](index_input& in, uint32_t* RESTRICT encoded, uint32_t* RESTRICT decoded) {
+    encode::adaptive::read_block(in, encoded, decoded);
+  },
+  [](index_input& in) {
+    encode::adaptive::skip_block(in);
+  }
+};
+
+/*static*/ const block_codec& block_codec::get(int32_t version) NOEXCEPT {
+  return version >= postings_writer::FORMAT_ADAPTIVE
+    ? ADAPTIVE_CODEC
+    : BITPACK_CODEC;
+}
+
 struct doc_state {
   const index_input* pos_in;
   const index_input* pay_in;
@@ -965,29 +1061,162 @@ struct doc_state {
   uint64_t tail_start;
   size_t tail_length;
   ::features features;
+  const block_codec* codec;
 }; // doc_state
 
 // ----------------------------------------------------------------------------
 // --SECTION--                                                 helper functions
 // ----------------------------------------------------------------------------
 
-FORCE_INLINE void skip_positions(index_input& in) {
-  format_traits::skip_block(in, postings_writer::BLOCK_SIZE);
+FORCE_INLINE void skip_positions(const block_codec& codec, index_input& in) {
+  codec.skip_block(in);
 }
 
-FORCE_INLINE void skip_payload(index_input& in) {
+FORCE_INLINE void skip_payload(const block_codec& codec, index_input& in) {
   const size_t size = in.read_vint();
   if (size) {
-    format_traits::skip_block(in, postings_writer::BLOCK_SIZE);
+    codec.skip_block(in);
     in.seek(in.file_pointer() + size);
   }
 }
 
-FORCE_INLINE void skip_offsets(index_input& in) {
-  format_traits::skip_block(in, postings_writer::BLOCK_SIZE);
-  format_traits::skip_block(in, postings_writer::BLOCK_SIZE);
+FORCE_INLINE void skip_offsets(const block_codec& codec, index_input& in) {
+  codec.skip_block(in);
+  codec.skip_block(in);
+}
+
+// returns number of values less than 'target' in the specified range
+inline size_t count_less(
+    const doc_id_t* begin,
+    const doc_id_t* end,
+    doc_id_t target) NOEXCEPT {
+  size_t count = 0;
+
+#ifdef IRESEARCH_SSE2
+  // unsigned comparison via signed one of values with flipped sign bits
+  const __m128i sign = _mm_set1_epi32(int32_t(0x80000000));
+  const __m128i key = _mm_xor_si128(_mm_set1_epi32(int32_t(target)), sign);
+
+  for (; end - begin >= 4; begin += 4) {
+    const __m128i values = _mm_xor_si128(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)), sign
+    );
+
+    count += math::pop32(uint32_t(_mm_movemask_ps(
+      _mm_castsi128_ps(_mm_cmplt_epi32(values, key))
+    )));
+  }
+#endif
+
+  for (; begin != end; ++begin) {
+    count += size_t(*begin < target);
+  }
+
+  return count;
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                       skip_index
+// ----------------------------------------------------------------------------
+
+///////////////////////////////////////////////////////////////////////////////
+/// @class skip_index
+/// @brief flat in-memory copy of the 0 level of a skip-list, i.e. the last
+///        document and the postings pointers of every block of a postings list
+///////////////////////////////////////////////////////////////////////////////
+class skip_index : util::noncopyable {
+ public:
+  typedef std::shared_ptr<const skip_index> ptr;
+
+  // only postings lists with at least that number of blocks are
+  // skipped via a flat index rather than via a multi-level skip-list
+  static const size_t MIN_BLOCKS = 64;
+
+  void reserve(size_t size) {
+    docs_.reserve(size);
+    states_.reserve(size);
+  }
+
+  void push_back(const skip_state& state) {
+    assert(docs_.empty() || docs_.back() < state.doc);
+    docs_.push_back(state.doc);
+    states_.push_back(state);
+  }
+
+  size_t size() const NOEXCEPT { return docs_.size(); }
+
+  const skip_state& operator[](size_t i) const NOEXCEPT {
+    assert(i < states_.size());
+    return states_[i];
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the first skip not before 'from' with a document not less
+  ///          than 'target', 'size()' if there is no such skip
+  //////////////////////////////////////////////////////////////////////////////
+  size_t lower_bound(size_t from, doc_id_t target) const NOEXCEPT {
+    static const size_t LINEAR_SCAN = 32; // size of a range to scan linearly
+
+    const auto* docs = docs_.data();
+    const size_t size = docs_.size();
+
+    // galloping search for the range containing 'target', since
+    // consecutive seeks usually land nearby
+    size_t lo = from, hi = from;
+    for (size_t step = 1; hi < size && docs[hi] < target; step *= 2) {
+      lo = hi + 1;
+      hi += step;
+    }
+    hi = std::min(hi, size);
+
+    while (hi - lo > LINEAR_SCAN) {
+      const size_t mid = lo + (hi - lo) / 2;
+
+      if (docs[mid] < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+
+    return lo + count_less(docs + lo, docs + hi, target);
+  }
+
+ private:
+  std::vector<doc_id_t> docs_; // documents of skips, searched on seek
+  std::vector<skip_state> states_; // postings pointers of skips
+}; // skip_index
+
+///////////////////////////////////////////////////////////////////////////////
+/// @class skip_index_cache
+/// @brief flat skip indexes of long postings lists of a postings reader,
+///        loaded lazily and shared across all iterators of the reader,
+///        postings lists are identified by their offsets in a document stream
+///////////////////////////////////////////////////////////////////////////////
+class skip_index_cache : util::noncopyable {
+ public:
+  typedef std::shared_ptr<skip_index_cache> ptr;
+
+  skip_index::ptr find(uint64_t doc_start) const {
+    SCOPED_LOCK(mutex_);
+
+    const auto it = map_.find(doc_start);
+    return it == map_.end() ? nullptr : it->second;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns either the specified index or the one loaded by another thread
+  //////////////////////////////////////////////////////////////////////////////
+  skip_index::ptr insert(uint64_t doc_start, skip_index::ptr&& index) {
+    SCOPED_LOCK(mutex_);
+    return map_.emplace(doc_start, std::move(index)).first->second;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, skip_index::ptr> map_;
+}; // skip_index_cache
+
 ///////////////////////////////////////////////////////////////////////////////
 /// @class doc_iterator
 ///////////////////////////////////////////////////////////////////////////////
@@ -1007,9 +1236,13 @@ class doc_iterator : public irs::doc_iterator {
       const irs::attribute_view& attrs,
       const index_input* doc_in,
       const index_input* pos_in,
-      const index_input* pay_in) {
+      const index_input* pay_in,
+      int32_t version,
+      const skip_index_cache::ptr& skip_cache) {
     features_ = field; // set field features
     enabled_ = enabled; // set enabled features
+    version_ = version; // set postings format version
+    codec_ = &block_codec::get(version);
 
     // add mandatory attributes
     attrs_.emplace(doc_);
@@ -1036,7 +1269,21 @@ class doc_iterator : public irs::doc_iterator {
       assert(!doc_in_->eof());
     }
 
+    // long postings lists are skipped via a shared flat skip index
+    if (term_state_.docs_count >= skip_index::MIN_BLOCKS*postings_writer::BLOCK_SIZE) {
+      skip_cache_ = skip_cache;
+    }
+
     prepare_attributes(enabled, attrs, pos_in, pay_in);
+
+    // frequency upper bounds
+    if (enabled.freq() && version_ >= postings_writer::FORMAT_BLOCK_MAX) {
+      freq_bound_.value = term_state_.max_freq;
+      freq_bound_.rule([this](doc_id_t target) {
+        return shallow_seek(target);
+      });
+      attrs_.emplace(freq_bound_);
+    }
   }
 
   virtual doc_id_t seek(doc_id_t target) override {
@@ -1091,7 +1338,63 @@ class doc_iterator : public irs::doc_iterator {
   #pragma GCC diagnostic pop
 #endif
 
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    return read_batch(docs, freqs, size, [](const uint32_t*, size_t) { });
+  }
+
  protected:
+  // copies decoded documents block by block, 'visitor' is called with
+  // frequencies of each copied range
+  template<typename Visitor>
+  size_t read_batch(
+      doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size,
+      const Visitor& visitor) {
+    size_t count = 0;
+
+    while (count < size) {
+      if (begin_ == end_) {
+        cur_pos_ += relative_pos();
+
+        if (cur_pos_ == term_state_.docs_count) {
+          doc_.value = type_limits<type_t::doc_id_t>::eof();
+          begin_ = end_ = docs_; // seal the iterator
+          return count;
+        }
+
+        if (count) {
+          doc_.value = docs[count - 1]; // base for delta decoding
+        }
+
+        refill();
+      }
+
+      const auto n = std::min(size - count, size_t(end_ - begin_));
+
+      std::memcpy(docs + count, begin_, n*sizeof(doc_id_t));
+
+      if (freqs) {
+        std::memcpy(freqs + count, doc_freq_, n*sizeof(uint32_t));
+      }
+
+      visitor(doc_freq_, n);
+      begin_ += n;
+      doc_freq_ += n;
+      count += n;
+    }
+
+    if (count) {
+      doc_.value = docs[count - 1];
+      freq_.value = doc_freq_[-1];
+    }
+
+    return count;
+  }
+
   virtual void prepare_attributes(
       const features& enabled,
       const irs::attribute_view& attrs,
@@ -1112,6 +1415,10 @@ class doc_iterator : public irs::doc_iterator {
   }
 
   void seek_to_block(doc_id_t target);
+  void seek_skip(doc_id_t target);
+  void seek_skip_index(doc_id_t target);
+  skip_index::ptr load_skip_index();
+  doc_id_t shallow_seek(doc_id_t target);
 
   // returns current position in the document block 'docs_'
   size_t relative_pos() NOEXCEPT {
@@ -1123,6 +1430,10 @@ class doc_iterator : public irs::doc_iterator {
     state.doc = in.read_vint();
     state.doc_ptr += in.read_vlong();
 
+    if (features_.freq() && version_ >= postings_writer::FORMAT_BLOCK_MAX) {
+      state.freq = in.read_vint();
+    }
+
     if (features_.position()) {
       state.pend_pos = in.read_vint();
       state.pos_ptr += in.read_vlong();
@@ -1162,28 +1473,15 @@ class doc_iterator : public irs::doc_iterator {
 
     if (left >= postings_writer::BLOCK_SIZE) {
       // read doc deltas
-      format_traits::read_block(
-        *doc_in_,
-        postings_writer::BLOCK_SIZE,
-        enc_buf_,
-        docs_
-      );
+      codec_->read_block(*doc_in_, enc_buf_, docs_);
 
       if (features_.freq()) {
         // read frequency it is required by
         // the iterator or just skip it otherwise
         if (enabled_.freq()) {
-          format_traits::read_block(
-            *doc_in_,
-            postings_writer::BLOCK_SIZE,
-            enc_buf_,
-            doc_freqs_
-          );
+          codec_->read_block(*doc_in_, enc_buf_, doc_freqs_);
         } else {
-          format_traits::skip_block(
-            *doc_in_,
-            postings_writer::BLOCK_SIZE
-          );
+          codec_->skip_block(*doc_in_);
         }
       }
       end_ = docs_ + postings_writer::BLOCK_SIZE;
@@ -1213,7 +1511,11 @@ class doc_iterator : public irs::doc_iterator {
 
   std::vector<skip_state> skip_levels_;
   skip_reader skip_;
-  skip_context* skip_ctx_; // pointer to used skip context, will be used by skip reader
+  skip_context skip_ctx_; // where the block found by the last skip starts
+  size_t skipped_{}; // number of documents skipped by the last skip
+  skip_index_cache::ptr skip_cache_; // set for long postings lists only
+  skip_index::ptr skip_index_; // flat skip index, loaded on the first skip
+  size_t skip_block_{}; // skip found in 'skip_index_' by the last skip
   irs::attribute_view attrs_;
   uint32_t enc_buf_[postings_writer::BLOCK_SIZE]; // buffer for encoding
   doc_id_t docs_[postings_writer::BLOCK_SIZE]; // doc values
@@ -1225,77 +1527,174 @@ class doc_iterator : public irs::doc_iterator {
   uint32_t term_freq_{}; // total term frequency
   document doc_;
   frequency freq_;
+  frequency_bound freq_bound_;
   index_input::ptr doc_in_;
   version10::term_meta term_state_;
   features features_; // field features
   features enabled_; // enabled iterator features
+  int32_t version_{}; // postings format version
+  const block_codec* codec_{}; // block codec of the postings format version
 }; // doc_iterator
 
 void doc_iterator::seek_to_block(doc_id_t target) {
   // check whether it make sense to use skip-list
-  if (skip_levels_.front().doc < target && term_state_.docs_count > postings_writer::BLOCK_SIZE) {
-    skip_context last; // where block starts
-    skip_ctx_ = &last;
+  if (term_state_.docs_count > postings_writer::BLOCK_SIZE) {
+    seek_skip(target);
+
+    // skip only forward and only if the block located by the skip-list
+    // doesn't start after 'target' (possible after a shallow seek)
+    if (skipped_ > (cur_pos_ + relative_pos()) && skip_ctx_.doc < target) {
+      doc_in_->seek(skip_ctx_.doc_ptr);
+      doc_.value = skip_ctx_.doc;
+      cur_pos_ = skipped_;
+      begin_ = end_ = docs_; // will trigger refill in "next"
+      seek_notify(skip_ctx_); // notifies derivatives
+    }
+  }
+}
 
-    // init skip writer in lazy fashion
-    if (!skip_) {
-      auto skip_in = doc_in_->dup();
+void doc_iterator::seek_skip(doc_id_t target) {
+  assert(term_state_.docs_count > postings_writer::BLOCK_SIZE);
 
-      if (!skip_in) {
-        IR_FRMT_ERROR("Failed to duplicate input in: %s", __FUNCTION__);
+  if (skip_levels_.front().doc >= target) {
+    return; // already positioned at the block containing 'target'
+  }
 
-        throw io_error("Failed to duplicate document input");
-      }
+  if (skip_cache_) {
+    seek_skip_index(target);
+    return;
+  }
 
-      skip_in->seek(term_state_.doc_start + term_state_.e_skip_start);
+  // init skip writer in lazy fashion
+  if (!skip_) {
+    auto skip_in = doc_in_->dup();
 
-      skip_.prepare(
-        std::move(skip_in),
-        [this](size_t level, index_input& in) {
-          skip_state& last = *skip_ctx_;
-          auto& last_level = skip_ctx_->level;
-          auto& next = skip_levels_[level];
+    if (!skip_in) {
+      IR_FRMT_ERROR("Failed to duplicate input in: %s", __FUNCTION__);
 
-          if (last_level > level) {
-            // move to the more granular level
-            next = last;
-          } else {
-            // store previous step on the same level
-            last = next;
-          }
+      throw io_error("Failed to duplicate document input");
+    }
 
-          last_level = level;
+    skip_in->seek(term_state_.doc_start + term_state_.e_skip_start);
 
-          if (in.eof()) {
-            // stream exhausted
-            return (next.doc = type_limits<type_t::doc_id_t>::eof());
-          }
+    skip_.prepare(
+      std::move(skip_in),
+      [this](size_t level, index_input& in) {
+        skip_state& last = skip_ctx_;
+        auto& last_level = skip_ctx_.level;
+        auto& next = skip_levels_[level];
 
-          return read_skip(next, in);
-      });
+        if (last_level > level) {
+          // move to the more granular level
+          next = last;
+        } else {
+          // store previous step on the same level
+          last = next;
+        }
 
-      // initialize skip levels
-      const auto num_levels = skip_.num_levels();
-      if (num_levels) {
-        skip_levels_.resize(num_levels);
+        last_level = level;
 
-        // since we store pointer deltas, add postings offset
-        auto& top = skip_levels_.back();
-        top.doc_ptr = term_state_.doc_start;
-        top.pos_ptr = term_state_.pos_start;
-        top.pay_ptr = term_state_.pay_start;
-      }
+        if (in.eof()) {
+          // stream exhausted
+          return (next.doc = type_limits<type_t::doc_id_t>::eof());
+        }
+
+        return read_skip(next, in);
+    });
+
+    // initialize skip levels
+    const auto num_levels = skip_.num_levels();
+    if (num_levels) {
+      skip_levels_.resize(num_levels);
+
+      // since we store pointer deltas, add postings offset
+      auto& top = skip_levels_.back();
+      top.doc_ptr = term_state_.doc_start;
+      top.pos_ptr = term_state_.pos_start;
+      top.pay_ptr = term_state_.pay_start;
     }
+  }
 
-    const size_t skipped = skip_.seek(target);
-    if (skipped > (cur_pos_ + relative_pos())) {
-      doc_in_->seek(last.doc_ptr);
-      doc_.value = last.doc;
-      cur_pos_ = skipped;
-      begin_ = end_ = docs_; // will trigger refill in "next"
-      seek_notify(last); // notifies derivatives
+  skip_ctx_.level = 0;
+  skipped_ = skip_.seek(target);
+}
+
+void doc_iterator::seek_skip_index(doc_id_t target) {
+  assert(skip_cache_);
+
+  if (!skip_index_) {
+    skip_index_ = skip_cache_->find(term_state_.doc_start);
+
+    if (!skip_index_) {
+      skip_index_ = skip_cache_->insert(term_state_.doc_start, load_skip_index());
+    }
+  }
+
+  const auto& index = *skip_index_;
+  const auto block = index.lower_bound(skip_block_, target);
+
+  // 'block' is the skip written right after the block containing 'target',
+  // the previous one points to the beginning of that block
+  if (block) {
+    static_cast<skip_state&>(skip_ctx_) = index[block - 1];
+  }
+
+  if (block < index.size()) {
+    skip_levels_.front() = index[block];
+  } else {
+    skip_levels_.front().doc = type_limits<type_t::doc_id_t>::eof();
+  }
+
+  skip_ctx_.level = 0;
+  skip_block_ = block;
+  skipped_ = block * postings_writer::BLOCK_SIZE;
+}
+
+skip_index::ptr doc_iterator::load_skip_index() {
+  auto skip_in = doc_in_->dup();
+
+  if (!skip_in) {
+    IR_FRMT_ERROR("Failed to duplicate input in: %s", __FUNCTION__);
+
+    throw io_error("Failed to duplicate document input");
+  }
+
+  skip_in->seek(term_state_.doc_start + term_state_.e_skip_start);
+
+  auto index = memory::make_shared<skip_index>();
+  index->reserve(term_state_.docs_count / postings_writer::BLOCK_SIZE);
+
+  // since we store pointer deltas, start with postings offsets
+  skip_state state;
+  state.doc_ptr = term_state_.doc_start;
+  state.pos_ptr = term_state_.pos_start;
+  state.pay_ptr = term_state_.pay_start;
+
+  skip_reader::visit(*skip_in, [this, &state, &index](index_input& in) {
+    read_skip(state, in);
+    index->push_back(state);
+  });
+
+  return index;
+}
+
+doc_id_t doc_iterator::shallow_seek(doc_id_t target) {
+  // skip data is available for long postings only
+  if (term_state_.docs_count > postings_writer::BLOCK_SIZE) {
+    seek_skip(target);
+
+    // level 0 holds the skip written right after the block containing
+    // 'target', there is no skip after the last block of a postings list
+    const auto& block = skip_levels_.front();
+
+    if (!type_limits<type_t::doc_id_t>::eof(block.doc)) {
+      freq_bound_.block = block.freq;
+      return block.doc;
     }
   }
+
+  freq_bound_.block = freq_bound_.value;
+  return type_limits<type_t::doc_id_t>::eof();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1316,28 +1715,68 @@ class mask_doc_iterator final: public DocIterator {
   }
 
   virtual bool next() override {
-    while (doc_iterator_t::next()) {
-      if (mask_.find(this->value()) == mask_.end()) {
-        return true;
-      }
-    }
-
-    return false;
+    return doc_iterator_t::next()
+      && !type_limits<type_t::doc_id_t>::eof(skip(this->value()));
   }
 
   virtual doc_id_t seek(doc_id_t target) override {
-    const auto doc = doc_iterator_t::seek(target);
+    return skip(doc_iterator_t::seek(target));
+  }
+
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    if (size < 2) {
+      return irs::doc_iterator::next_batch(docs, freqs, size);
+    }
+
+    // reserve a slot for the document following a trailing excluded one
+    const auto read = doc_iterator_t::next_batch(docs, freqs, size - 1);
+
+    if (!read) {
+      return 0;
+    }
+
+    const bool excluded_last = mask_.contains(docs[read - 1]);
+    size_t count = 0;
 
-    if (mask_.find(doc) == mask_.end()) {
-      return doc;
+    for (size_t i = 0; i < read; ++i) {
+      if (!mask_.contains(docs[i])) {
+        docs[count] = docs[i];
+
+        if (freqs) {
+          freqs[count] = freqs[i];
+        }
+
+        ++count;
+      }
     }
 
-    this->next();
+    // iterator must not stay on an excluded document
+    if (excluded_last && next()) {
+      docs[count] = this->value();
+
+      if (freqs) {
+        freqs[count] = this->freq_.value;
+      }
+
+      ++count;
+    }
 
-    return this->value();
+    return count; // 0 only if the iterator is exhausted
   }
 
  private:
+  doc_id_t skip(doc_id_t doc) {
+    for (auto target = mask_.next_absent(doc); target != doc;
+         target = mask_.next_absent(doc)) {
+      doc = doc_iterator_t::seek(target);
+    }
+
+    return doc;
+  }
+
   const document_mask& mask_; /* excluded document ids */
 }; // mask_doc_iterator
 
@@ -1400,6 +1839,7 @@ class pos_iterator: public position {
     freq_ = state.freq;
     features_ = state.features;
     enc_buf_ = reinterpret_cast<uint32_t*>(state.enc_buf);
+    codec_ = state.codec;
     tail_start_ = state.tail_start;
     tail_length_ = state.tail_length;
   }
@@ -1439,7 +1879,7 @@ class pos_iterator: public position {
         }
       }
     } else {
-      format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
+      codec_->read_block(*pos_in_, enc_buf_, pos_deltas_);
     }
   }
 
@@ -1449,7 +1889,7 @@ class pos_iterator: public position {
       count -= left;
       while (count >= postings_writer::BLOCK_SIZE) {
         // skip positions
-        skip_positions(*pos_in_);
+        skip_positions(*codec_, *pos_in_);
         count -= postings_writer::BLOCK_SIZE;
       }
       refill();
@@ -1467,6 +1907,7 @@ class pos_iterator: public position {
   uint32_t pos_deltas_[postings_writer::BLOCK_SIZE]; /* buffer to store position deltas */
   const uint32_t* freq_; /* lenght of the posting list for a document */
   uint32_t* enc_buf_; /* auxillary buffer to decode data */
+  const block_codec* codec_{}; // block codec of the postings format version
   uint32_t pend_pos_{}; /* how many positions "behind" we are */
   uint64_t tail_start_; /* file pointer where the last (vInt encoded) pos delta block is */
   size_t tail_length_; /* number of positions in the last (vInt encoded) pos delta block */
@@ -1536,9 +1977,9 @@ class offs_pay_iterator final: public pos_iterator {
       count -= left;
       // skip block by block
       while (count >= postings_writer::BLOCK_SIZE) {
-        skip_positions(*pos_in_);
-        skip_payload(*pay_in_);
-        skip_offsets(*pay_in_);
+        skip_positions(*codec_, *pos_in_);
+        skip_payload(*codec_, *pay_in_);
+        skip_offsets(*codec_, *pay_in_);
         count -= postings_writer::BLOCK_SIZE;
       }
       refill();
@@ -1594,12 +2035,12 @@ class offs_pay_iterator final: public pos_iterator {
         }
       }
     } else {
-      format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
+      codec_->read_block(*pos_in_, enc_buf_, pos_deltas_);
 
       // read payloads
       const uint32_t size = pay_in_->read_vint();
       if (size) {
-        format_traits::read_block(*pay_in_, postings_writer::BLOCK_SIZE, enc_buf_, pay_lengths_);
+        codec_->read_block(*pay_in_, enc_buf_, pay_lengths_);
         string_utils::oversize(pay_data_, size);
 
         #ifdef IRESEARCH_DEBUG
@@ -1612,8 +2053,8 @@ class offs_pay_iterator final: public pos_iterator {
       }
 
       // read offsets
-      format_traits::read_block(*pay_in_, postings_writer::BLOCK_SIZE, enc_buf_, offs_start_deltas_);
-      format_traits::read_block(*pay_in_, postings_writer::BLOCK_SIZE, enc_buf_, offs_lengts_);
+      codec_->read_block(*pay_in_, enc_buf_, offs_start_deltas_);
+      codec_->read_block(*pay_in_, enc_buf_, offs_lengts_);
     }
     pay_data_pos_ = 0;
   }
@@ -1695,16 +2136,16 @@ class offs_iterator final : public pos_iterator {
         }
       }
     } else {
-      format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
+      codec_->read_block(*pos_in_, enc_buf_, pos_deltas_);
 
       // skip payload
       if (features_.payload()) {
-        skip_payload(*pay_in_);
+        skip_payload(*codec_, *pay_in_);
       }
 
       // read offsets
-      format_traits::read_block(*pay_in_, postings_writer::BLOCK_SIZE, enc_buf_, offs_start_deltas_);
-      format_traits::read_block(*pay_in_, postings_writer::BLOCK_SIZE, enc_buf_, offs_lengts_);
+      codec_->read_block(*pay_in_, enc_buf_, offs_start_deltas_);
+      codec_->read_block(*pay_in_, enc_buf_, offs_lengts_);
     }
   }
 
@@ -1714,11 +2155,11 @@ class offs_iterator final : public pos_iterator {
       count -= left;
       // skip block by block
       while (count >= postings_writer::BLOCK_SIZE) {
-        skip_positions(*pos_in_);
+        skip_positions(*codec_, *pos_in_);
         if (features_.payload()) {
-          skip_payload(*pay_in_);
+          skip_payload(*codec_, *pay_in_);
         }
-        skip_offsets(*pay_in_);
+        skip_offsets(*codec_, *pay_in_);
         count -= postings_writer::BLOCK_SIZE;
       }
       refill();
@@ -1791,10 +2232,10 @@ class pay_iterator final : public pos_iterator {
       count -= left;
       // skip block by block
       while (count >= postings_writer::BLOCK_SIZE) {
-        skip_positions(*pos_in_);
-        skip_payload(*pay_in_);
+        skip_positions(*codec_, *pos_in_);
+        skip_payload(*codec_, *pay_in_);
         if (features_.offset()) {
-          skip_offsets(*pay_in_);
+          skip_offsets(*codec_, *pay_in_);
         }
         count -= postings_writer::BLOCK_SIZE;
       }
@@ -1852,12 +2293,12 @@ class pay_iterator final : public pos_iterator {
         }
       }
     } else {
-      format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
+      codec_->read_block(*pos_in_, enc_buf_, pos_deltas_);
 
       /* read payloads */
       const uint32_t size = pay_in_->read_vint();
       if (size) {
-        format_traits::read_block(*pay_in_, postings_writer::BLOCK_SIZE, enc_buf_, pay_lengths_);
+        codec_->read_block(*pay_in_, enc_buf_, pay_lengths_);
         string_utils::oversize(pay_data_, size);
 
         #ifdef IRESEARCH_DEBUG
@@ -1871,7 +2312,7 @@ class pay_iterator final : public pos_iterator {
 
       // skip offsets
       if (features_.offset()) {
-        skip_offsets(*pay_in_);
+        skip_offsets(*codec_, *pay_in_);
       }
     }
     pay_data_pos_ = 0;
@@ -1916,6 +2357,24 @@ class pos_doc_iterator final: public doc_iterator {
     return true;
   }
 
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    const auto count = read_batch(
+      docs, freqs, size,
+      [this](const uint32_t* freqs, size_t size) {
+        // positions of the skipped documents are pending
+        pos_.pend_pos_ += std::accumulate(freqs, freqs + size, uint32_t(0));
+    });
+
+    if (count) {
+      pos_.clear();
+    }
+
+    return count;
+  }
+
  protected:
   virtual void prepare_attributes(
     const ::features& features,
@@ -1954,6 +2413,7 @@ void pos_doc_iterator<PosItrType>::prepare_attributes(
   state.freq = &freq_.value;
   state.features = features_;
   state.enc_buf = enc_buf_;
+  state.codec = codec_;
 
   if (term_freq_ < postings_writer::BLOCK_SIZE) {
     state.tail_start = term_state_.pos_start;
@@ -2218,10 +2678,12 @@ struct segment_meta_writer final : public irs::segment_meta_writer{
   static const string_ref FORMAT_NAME;
 
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_SORT = FORMAT_MIN + 1; // order of documents
+  static const int32_t FORMAT_MAX = FORMAT_SORT;
 
   enum {
     HAS_COLUMN_STORE = 1,
+    SORTED = 2,
   };
 
   virtual void write(
@@ -2253,10 +2715,14 @@ void segment_meta_writer::write(directory& dir, std::string& meta_file, const se
     ));
   }
 
-  const byte_type flags = meta.column_store
+  byte_type flags = meta.column_store
     ? segment_meta_writer::HAS_COLUMN_STORE
     : 0;
 
+  if (!meta.sort.empty()) {
+    flags |= segment_meta_writer::SORTED;
+  }
+
   format_utils::write_header(*out, FORMAT_NAME, FORMAT_MAX);
   write_string(*out, meta.name);
   out->write_vlong(meta.version);
@@ -2264,6 +2730,11 @@ void segment_meta_writer::write(directory& dir, std::string& meta_file, const se
   out->write_vlong(meta.docs_count - meta.live_docs_count); // docs_count >= live_docs_count
   out->write_vlong(meta.size);
   out->write_byte(flags);
+
+  if (flags & segment_meta_writer::SORTED) {
+    write_string(*out, meta.sort);
+  }
+
   write_strings(*out, meta.files);
   format_utils::write_footer(*out);
 }
@@ -2302,7 +2773,7 @@ void segment_meta_reader::read(
 
   const auto checksum = format_utils::checksum(*in);
 
-  format_utils::check_header(
+  const auto format_version = format_utils::check_header(
     *in,
     segment_meta_writer::FORMAT_NAME,
     segment_meta_writer::FORMAT_MIN,
@@ -2323,15 +2794,22 @@ void segment_meta_reader::read(
 
   const auto size = in->read_vlong();
   const auto flags = in->read_byte();
-  auto files = read_strings<segment_meta::file_set>(*in);
+  const auto supported_flags = format_version >= segment_meta_writer::FORMAT_SORT
+    ? (segment_meta_writer::HAS_COLUMN_STORE | segment_meta_writer::SORTED)
+    : segment_meta_writer::HAS_COLUMN_STORE;
 
-  if (flags & ~(segment_meta_writer::HAS_COLUMN_STORE)) {
+  if (flags & ~supported_flags) {
     throw index_error(
       std::string("while reading segment meta '" + name
       + "', error: use of unsupported flags '" + std::to_string(flags) + "'")
     );
   }
 
+  auto sort = flags & segment_meta_writer::SORTED
+    ? read_string<std::string>(*in)
+    : std::string();
+  auto files = read_strings<segment_meta::file_set>(*in);
+
   format_utils::check_footer(*in, checksum);
 
   // ...........................................................................
@@ -2341,6 +2819,7 @@ void segment_meta_reader::read(
   meta.name = std::move(name);
   meta.version = version;
   meta.column_store = flags & segment_meta_writer::HAS_COLUMN_STORE;
+  meta.sort = std::move(sort);
   meta.docs_count = docs_count;
   meta.live_docs_count = live_docs_count;
   meta.size = size;
@@ -2357,7 +2836,8 @@ class document_mask_writer final: public irs::document_mask_writer {
   static const string_ref FORMAT_NAME;
 
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_RUNS = 1; // mask is stored as runs of doc ids
+  static const int32_t FORMAT_MAX = FORMAT_RUNS;
 
   virtual ~document_mask_writer() = default;
 
@@ -2406,11 +2886,28 @@ void document_mask_writer::write(
   assert(docs_mask.size() <= integer_traits<uint32_t>::const_max);
   const auto count = static_cast<uint32_t>(docs_mask.size());
 
+  // runs of consecutive doc ids, e.g. in case of removal by a range query,
+  // are written as (delta from the previous run, run length) pairs
+  uint32_t runs = 0;
+
+  for (auto it = docs_mask.begin(); it != docs_mask.end(); ++runs) {
+    it = docs_mask.lower_bound(docs_mask.next_absent(*it));
+  }
+
   format_utils::write_header(*out, FORMAT_NAME, FORMAT_MAX);
   out->write_vint(count);
+  out->write_vint(runs);
 
-  for (auto mask : docs_mask) {
-    out->write_vint(mask);
+  doc_id_t prev = 0;
+
+  for (auto it = docs_mask.begin(); it != docs_mask.end();) {
+    const auto begin = *it;
+    const auto end = docs_mask.next_absent(begin);
+
+    out->write_vint(begin - prev);
+    out->write_vint(end - begin);
+    prev = end;
+    it = docs_mask.lower_bound(end);
   }
 
   format_utils::write_footer(*out);
@@ -2465,24 +2962,46 @@ bool document_mask_reader::read(
 
   const auto checksum = format_utils::checksum(*in);
 
-  format_utils::check_header(
+  const auto version = format_utils::check_header(
     *in,
     document_mask_writer::FORMAT_NAME,
     document_mask_writer::FORMAT_MIN,
     document_mask_writer::FORMAT_MAX
   );
 
+  static_assert(
+    sizeof(doc_id_t) == sizeof(decltype(in->read_vint())),
+    "sizeof(doc_id) != sizeof(decltype(id))"
+  );
+
   auto count = in->read_vint();
 
-  while (count--) {
-    static_assert(
-      sizeof(doc_id_t) == sizeof(decltype(in->read_vint())),
-      "sizeof(doc_id) != sizeof(decltype(id))"
-    );
+  if (version < document_mask_writer::FORMAT_RUNS) {
+    while (count--) {
+      docs_mask.insert(in->read_vint());
+    }
+  } else {
+    const auto size = docs_mask.size();
+    doc_id_t begin = 0;
+
+    for (auto runs = in->read_vint(); runs; --runs) {
+      begin += in->read_vint();
+      const doc_id_t end = begin + in->read_vint();
+
+      docs_mask.insert_range(begin, end);
+      begin = end;
+    }
 
-    docs_mask.insert(in->read_vint());
+    if (docs_mask.size() - size != count) {
+      throw index_error(string_utils::to_string(
+        "while reading document mask, error: invalid number of documents, expected %u, got %u",
+        count, static_cast<uint32_t>(docs_mask.size() - size)
+      ));
+    }
   }
 
+  docs_mask.optimize();
+
   format_utils::check_footer(*in, checksum);
 
   return true;
@@ -2676,11 +3195,16 @@ bool meta_reader::read(column_meta& column) {
 // |Last block #1 key|Block #1 offset| <-- Columnstore blocks index
 // |Last block #2 key|Block #2 offset|
 // ...
+// |Block #0 min value|Block #0 max value|
+// |Block #1 min value|Block #1 max value| <-- Fixed length column value bounds
+// ...
 // |Bloom filter offset| <- not implemented yet
 // |Footer|
 
 const uint32_t INDEX_BLOCK_SIZE = 1024;
 const size_t MAX_DATA_BLOCK_SIZE = 8192;
+const size_t MAX_DICT_DATA_BLOCK_SIZE = MAX_DATA_BLOCK_SIZE/4; // blocks compressed against a shared dictionary
+const size_t MAX_DICT_SIZE = MAX_DICT_DATA_BLOCK_SIZE; // max size of a dictionary shared by column blocks
 
 // By default we treat columns as a variable length sparse columns
 enum ColumnProperty : uint32_t {
@@ -2692,9 +3216,11 @@ enum ColumnProperty : uint32_t {
 
 ENABLE_BITMASK_ENUM(ColumnProperty);
 
+// writes 'data' compressed as 'compressed', an empty 'compressed' or the one
+// which is not smaller than 'data' makes the data to be stored as is
 ColumnProperty write_compact(
-    irs::index_output& out,
-    irs::compressor& compressor,
+    irs::data_output& out,
+    const irs::bytes_ref& compressed,
     const irs::bytes_ref& data) {
   if (data.empty()) {
     out.write_byte(0); // zig_zag_encode32(0) == 0
@@ -2702,12 +3228,10 @@ ColumnProperty write_compact(
   }
 
   // compressor can only handle size of int32_t, so can use the negative flag as a compression flag
-  compressor.compress(reinterpret_cast<const char*>(data.c_str()), data.size());
-
-  if (compressor.size() < data.size()) {
-    assert(compressor.size() <= irs::integer_traits<int32_t>::const_max);
-    irs::write_zvint(out, int32_t(compressor.size())); // compressed size
-    out.write_bytes(compressor.c_str(), compressor.size());
+  if (!compressed.empty() && compressed.size() < data.size()) {
+    assert(compressed.size() <= irs::integer_traits<int32_t>::const_max);
+    irs::write_zvint(out, int32_t(compressed.size())); // compressed size
+    out.write_bytes(compressed.c_str(), compressed.size());
     irs::write_zvlong(out, data.size() - MAX_DATA_BLOCK_SIZE); // original size
   } else {
     assert(data.size() <= irs::integer_traits<int32_t>::const_max);
@@ -2718,9 +3242,53 @@ ColumnProperty write_compact(
   return CP_SPARSE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @struct data_codec
+/// @brief compression settings of the data blocks of a column
+////////////////////////////////////////////////////////////////////////////////
+struct data_codec {
+  irs::column_codec id{ irs::column_codec::LZ4 };
+  irs::bstring dict; // dictionary shared by all blocks, 'column_codec::LZ4_DICT' only
+}; // data_codec
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class data_decompressor
+/// @brief decompresses data blocks according to the codec of their column
+////////////////////////////////////////////////////////////////////////////////
+class data_decompressor {
+ public:
+  data_decompressor(
+      const irs::decompressor& lz4,
+      const data_codec& codec) NOEXCEPT
+    : lz4_(&lz4), codec_(&codec) {
+  }
+
+  // returns number of decompressed bytes,
+  // or integer_traits<size_t>::const_max in case of error
+  size_t deflate(
+      const char* src, size_t src_size,
+      char* dst, size_t dst_size) const {
+    switch (codec_->id) {
+      case irs::column_codec::LZ4:
+        return lz4_->deflate(src, src_size, dst, dst_size);
+      case irs::column_codec::LZ4HC: // same block format as the fast level
+        return block_.deflate(src, src_size, dst, dst_size);
+      case irs::column_codec::LZ4_DICT:
+        return block_.deflate(src, src_size, dst, dst_size, codec_->dict);
+      default: // blocks of uncompressed columns are never compressed
+        return irs::type_limits<irs::type_t::address_t>::invalid();
+    }
+  }
+
+ private:
+  const irs::decompressor* lz4_;
+  const data_codec* codec_;
+  irs::block_decompressor block_;
+}; // data_decompressor
+
 void read_compact(
     irs::index_input& in,
-    const irs::decompressor& decompressor,
+    const data_decompressor& decompressor,
     irs::bstring& encode_buf,
     irs::bstring& decode_buf) {
   const auto size = irs::read_zvint(in);
@@ -2902,26 +3470,56 @@ class index_block {
 
 //////////////////////////////////////////////////////////////////////////////
 /// @class writer
+/// @note distinct columns may be written by different threads concurrently,
+///       each column by a single thread at a time, data blocks of a column
+///       are prepared in thread-local buffers and appended to the data file
+///       under a lock
 //////////////////////////////////////////////////////////////////////////////
 class writer final : public irs::columnstore_writer {
  public:
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_VALUE_BOUNDS = FORMAT_MIN + 1; // per-block min/max values
+  static const int32_t FORMAT_CODEC = FORMAT_MIN + 2; // per-column codec of data blocks
+  static const int32_t FORMAT_MAX = FORMAT_CODEC;
 
   static const string_ref FORMAT_NAME;
   static const string_ref FORMAT_EXT;
 
   virtual void prepare(directory& dir, const segment_meta& meta) override;
-  virtual column_t push_column() override;
+  using irs::columnstore_writer::push_column;
+  virtual column_t push_column(column_codec codec) override;
   virtual bool commit() override;
   virtual void rollback() NOEXCEPT override;
 
  private:
+  static const size_t BLOCK_CONTEXT_POOL_SIZE = 16;
+
+  // scratch space for packing, compressing and serializing a data block,
+  // columns flushed by different threads use distinct instances
+  struct block_context {
+    DECLARE_UNIQUE_PTR(block_context);
+
+    static ptr make() { return memory::make_unique<block_context>(); }
+
+    uint64_t buf[INDEX_BLOCK_SIZE]; // reusable temporary buffer for packing
+    compressor comp{ 2*MAX_DATA_BLOCK_SIZE };
+    block_compressor block_comp;
+    bytes_output out{ 2*MAX_DATA_BLOCK_SIZE }; // serialized data block
+  }; // block_context
+
+  typedef unbounded_object_pool<block_context> block_context_pool;
+
   class column final : public irs::columnstore_writer::column_output {
    public:
-    explicit column(writer& ctx)
+    column(writer& ctx, column_codec codec)
       : ctx_(&ctx),
-        blocks_index_(*ctx.alloc_) {
+        blocks_index_(*ctx.alloc_),
+        codec_(codec),
+        // a shared dictionary makes up for the redundancy lost by smaller
+        // blocks, which are cheaper to decompress for a single value
+        max_block_size_(column_codec::LZ4_DICT == codec
+          ? MAX_DICT_DATA_BLOCK_SIZE
+          : MAX_DATA_BLOCK_SIZE) {
     }
 
     void prepare(doc_id_t key) {
@@ -2932,9 +3530,12 @@ class writer final : public irs::columnstore_writer {
         return;
       }
 
-      // flush block if we've overcome MAX_DATA_BLOCK_SIZE size
+      // previous value is complete
+      update_bounds();
+
+      // flush block if we've overcome max data block size
       // or reached the end of the index block
-      if (block_buf_.size() >= MAX_DATA_BLOCK_SIZE || block_index_.full()) {
+      if (block_buf_.size() >= max_block_size_ || block_index_.full()) {
         flush_block();
       }
 
@@ -2954,6 +3555,21 @@ class writer final : public irs::columnstore_writer {
       out.write_vint(avg_block_count_); // avg number of elements per block
       out.write_vint(column_index_.total()); // total number of index blocks
       blocks_index_.file >> out; // column blocks index
+
+      // value bounds are tracked for fixed length columns only
+      const bool has_bounds = CP_FIXED == (blocks_props_ & (CP_FIXED | CP_MASK));
+      out.write_byte(byte_type(has_bounds));
+
+      if (has_bounds) {
+        const bytes_ref bounds = bounds_;
+        out.write_bytes(bounds.c_str(), bounds.size()); // per-block value bounds
+      }
+
+      out.write_byte(static_cast<byte_type>(codec_)); // data blocks codec
+
+      if (column_codec::LZ4_DICT == codec_) {
+        write_string(out, dict_); // dictionary shared by data blocks
+      }
     }
 
     void flush() {
@@ -2966,7 +3582,8 @@ class writer final : public irs::columnstore_writer {
       flush_block();
 
       // finish column blocks index
-      column_index_.flush(blocks_index_.stream, ctx_->buf_);
+      auto block_ctx = ctx_->block_contexts_.emplace();
+      column_index_.flush(blocks_index_.stream, block_ctx->buf);
       blocks_index_.stream.flush();
     }
 
@@ -2994,12 +3611,68 @@ class writer final : public irs::columnstore_writer {
     }
 
    private:
-    void flush_block() {
-      if (block_index_.empty()) {
-        // nothing to flush
-        return;
+    // compresses data of the current block with the column codec, returns
+    // an empty reference if the data should be stored as is
+    bytes_ref compress(block_context& block_ctx, const bytes_ref& data) {
+      if (data.empty()) {
+        return bytes_ref::NIL;
       }
 
+      const auto* src = ref_cast<char>(data).c_str();
+
+      switch (codec_) {
+        case column_codec::LZ4:
+          block_ctx.comp.compress(src, data.size());
+          return block_ctx.comp;
+        case column_codec::LZ4HC:
+          block_ctx.block_comp.compress_high(src, data.size());
+          return block_ctx.block_comp;
+        case column_codec::LZ4_DICT:
+          if (dict_.empty()) {
+            // the tail of the first block is the most relevant sample of
+            // column values we have, use it as a dictionary for all blocks
+            const auto size = std::min(data.size(), MAX_DICT_SIZE);
+            dict_.assign(data.c_str() + data.size() - size, size);
+          }
+
+          block_ctx.block_comp.compress(src, data.size(), dict_);
+          return block_ctx.block_comp;
+        default:
+          return bytes_ref::NIL;
+      }
+    }
+
+    // updates value bounds of the current block with the last written value
+    void update_bounds() {
+      if (block_index_.empty() || !(blocks_props_ & CP_FIXED)) {
+        // nothing to update or bounds are not tracked
+        return;
+      }
+
+      const bytes_ref data = block_buf_;
+      const auto offset = block_index_.max_offset();
+      const bytes_ref value(data.c_str() + offset, data.size() - offset);
+
+      if (!has_block_bounds_) {
+        block_min_ = value;
+        block_max_ = value;
+        has_block_bounds_ = true;
+      } else if (value < block_min_) {
+        block_min_ = value;
+      } else if (block_max_ < value) {
+        block_max_ = value;
+      }
+    }
+
+    void flush_block() {
+      if (block_index_.empty()) {
+        // nothing to flush
+        return;
+      }
+
+      // last value is complete
+      update_bounds();
+
       // refresh column properties
       // column is dense IFF
       // - all blocks are dense
@@ -3009,17 +3682,13 @@ class writer final : public irs::columnstore_writer {
       // update max element
       max_ = block_index_.max_key();
 
-      auto& out = *ctx_->data_out_;
-      auto* buf = ctx_->buf_;
+      auto block_ctx = ctx_->block_contexts_.emplace();
+      auto& out = block_ctx->out;
+      auto* buf = block_ctx->buf;
+      const auto min_key = block_index_.min_key();
 
-      // write first block key & where block starts
-      column_index_.push_back(block_index_.min_key(), out.file_pointer());
-
-      if (column_index_.full()) {
-        column_index_.flush(blocks_index_.stream, buf);
-      }
-
-      // flush current block
+      // serialize current block
+      out.reset(); // may hold a partially serialized block on failure
 
       // write total number of elements in the block
       out.write_vint(block_index_.size());
@@ -3030,14 +3699,42 @@ class writer final : public irs::columnstore_writer {
       //   const auto res = expr0() | expr1();
       // otherwise it would violate format layout
       auto block_props = block_index_.flush(out, buf);
-      block_props |= write_compact(out, ctx_->comp_, static_cast<bytes_ref>(block_buf_));
+      const bytes_ref data = block_buf_;
+      block_props |= write_compact(out, compress(*block_ctx, data), data);
       length_ += block_buf_.size();
 
+      // append serialized block to the data file, columns flushed
+      // concurrently share the file
+      uint64_t block_offset;
+      {
+        SCOPED_LOCK(ctx_->mutex_);
+        block_offset = ctx_->data_out_->file_pointer();
+        const bytes_ref block = out;
+        ctx_->data_out_->write_bytes(block.c_str(), block.size());
+      }
+
+      // write first block key & where block starts
+      column_index_.push_back(min_key, block_offset);
+
+      if (column_index_.full()) {
+        column_index_.flush(blocks_index_.stream, buf);
+      }
+
       // refresh blocks properties
       blocks_props_ &= block_props;
       // reset buffer stream after flush
       block_buf_.reset();
 
+      // track value bounds while all blocks are of fixed length
+      if (blocks_props_ & CP_FIXED) {
+        write_string(bounds_, block_min_);
+        write_string(bounds_, block_max_);
+      } else {
+        bounds_.reset();
+      }
+
+      has_block_bounds_ = false;
+
       // refresh column properties
       // column is dense IFF
       // - all blocks are dense
@@ -3051,17 +3748,24 @@ class writer final : public irs::columnstore_writer {
     index_block<INDEX_BLOCK_SIZE> column_index_; // column block index (per block key/offset)
     memory_output blocks_index_; // blocks index
     bytes_output block_buf_{ 2*MAX_DATA_BLOCK_SIZE }; // data buffer
+    bytes_output bounds_; // per-block value bounds (min/max) of flushed blocks
+    bstring block_min_; // min value of the current block
+    bstring block_max_; // max value of the current block
+    bool has_block_bounds_{}; // current block has at least one accounted value
     doc_id_t max_{ type_limits<type_t::doc_id_t>::invalid() }; // max key (among flushed blocks)
     ColumnProperty blocks_props_{ CP_DENSE | CP_FIXED | CP_MASK }; // aggregated column blocks properties
     ColumnProperty column_props_{ CP_DENSE }; // aggregated column block index properties
     uint32_t avg_block_count_{}; // average number of items per block (tail block is not taken into account since it may skew distribution)
     uint32_t avg_block_size_{}; // average size of the block (tail block is not taken into account since it may skew distribution)
+    column_codec codec_; // compression of data blocks
+    bstring dict_; // dictionary shared by data blocks, 'column_codec::LZ4_DICT' only
+    size_t max_block_size_; // data block is flushed once it reaches the size
   }; // column
 
   memory_allocator* alloc_{ &memory_allocator::global() };
-  uint64_t buf_[INDEX_BLOCK_SIZE]; // reusable temporary buffer for packing
   std::deque<column> columns_; // pointers remain valid
-  compressor comp_{ 2*MAX_DATA_BLOCK_SIZE };
+  block_context_pool block_contexts_{ BLOCK_CONTEXT_POOL_SIZE };
+  std::mutex mutex_; // guards 'columns_' and appends to 'data_out_'
   index_output::ptr data_out_;
   std::string filename_;
   directory* dir_;
@@ -3103,10 +3807,12 @@ void writer::prepare(directory& dir, const segment_meta& meta) {
   filename_ = std::move(filename);
 }
 
-columnstore_writer::column_t writer::push_column() {
+columnstore_writer::column_t writer::push_column(column_codec codec) {
+  SCOPED_LOCK_NAMED(mutex_, lock);
   const auto id = columns_.size();
-  columns_.emplace_back(*this);
+  columns_.emplace_back(*this, codec);
   auto& column = columns_.back();
+  lock.unlock();
 
   return std::make_pair(id, [&column] (doc_id_t doc) -> column_output& {
     // to avoid extra (and useless in our case) check for block index
@@ -3167,36 +3873,176 @@ void writer::rollback() NOEXCEPT {
   columns_.clear(); // ensure next flush (without prepare(...)) will use the section without 'data_out_'
 }
 
-template<typename Block, typename Allocator>
-class block_cache : irs::util::noncopyable {
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Block cache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_lru
+/// @brief process-wide LRU cache of decompressed blocks, blocks are identified
+///        by a unique columnstore reader identifier and a block offset
+/// @note cached blocks are immutable and reference counted, i.e. a block
+///       evicted from the cache remains valid while it's still in use
+////////////////////////////////////////////////////////////////////////////////
+class block_lru : util::noncopyable {
  public:
-  block_cache(const Allocator& alloc = Allocator())
-    : cache_(alloc) {
+  typedef irs::version10::column_cache::stats stats_t;
+
+  static const size_t DEFAULT_LIMIT = 256*(1 << 20); // 256 MiB
+
+  struct key_t {
+    uint64_t file; // columnstore reader identifier
+    uint64_t offset; // block offset
+
+    bool operator<(const key_t& rhs) const NOEXCEPT {
+      return file < rhs.file || (file == rhs.file && offset < rhs.offset);
+    }
+  }; // key_t
+
+  static block_lru& instance() {
+    static block_lru cache;
+    return cache;
+  }
+
+  template<typename Block>
+  std::shared_ptr<const Block> find(const key_t& key) {
+    SCOPED_LOCK(mutex_);
+
+    const auto it = map_.find(key);
+
+    if (it == map_.end()) {
+      ++stats_.misses;
+      return nullptr;
+    }
+
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, it->second); // mark as recently used
+
+    return std::static_pointer_cast<const Block>(it->second->block);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns either the specified block or the one cached by another thread
+  //////////////////////////////////////////////////////////////////////////////
+  template<typename Block>
+  std::shared_ptr<const Block> insert(
+      const key_t& key,
+      std::shared_ptr<const Block>&& block) {
+    const size_t memory = block->memory();
+
+    SCOPED_LOCK(mutex_);
+
+    if (memory > limit_) {
+      return std::move(block); // block doesn't fit into the cache
+    }
+
+    const auto res = map_.emplace(key, lru_.end());
+
+    if (!res.second) {
+      // already cached by another thread
+      lru_.splice(lru_.begin(), lru_, res.first->second);
+      return std::static_pointer_cast<const Block>(res.first->second->block);
+    }
+
+    try {
+      lru_.emplace_front(key, block, memory);
+    } catch (...) {
+      map_.erase(res.first);
+      throw;
+    }
+
+    res.first->second = lru_.begin();
+    stats_.memory += memory;
+    ++stats_.blocks;
+    evict(limit_);
+
+    return std::move(block);
   }
-  block_cache(block_cache&& rhs) NOEXCEPT
-    : cache_(std::move(rhs.cache_)) {
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if a block with the specified key would be cached but
+  ///          isn't cached yet, doesn't affect statistics
+  //////////////////////////////////////////////////////////////////////////////
+  bool missing(const key_t& key) const {
+    SCOPED_LOCK(mutex_);
+    return limit_ && map_.end() == map_.find(key);
   }
 
-  template<typename... Args>
-  Block& emplace_back(Args&&... args) {
-    cache_.emplace_back(std::forward<Args>(args)...);
-    return cache_.back();
+  size_t limit() const {
+    SCOPED_LOCK(mutex_);
+    return limit_;
   }
 
-  void pop_back() NOEXCEPT {
-    cache_.pop_back();
+  void limit(size_t limit) {
+    SCOPED_LOCK(mutex_);
+    limit_ = limit;
+    evict(limit_);
+  }
+
+  void clear() {
+    SCOPED_LOCK(mutex_);
+    evict(0);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief evicts all blocks of the specified columnstore reader
+  //////////////////////////////////////////////////////////////////////////////
+  void erase(uint64_t file) NOEXCEPT {
+    SCOPED_LOCK(mutex_);
+
+    for (auto it = map_.lower_bound(key_t{ file, 0 });
+         it != map_.end() && it->first.file == file;) {
+      const auto& victim = *it->second;
+
+      stats_.memory -= victim.memory;
+      --stats_.blocks;
+      ++stats_.evictions;
+      lru_.erase(it->second);
+      it = map_.erase(it);
+    }
+  }
+
+  stats_t stats() const {
+    SCOPED_LOCK(mutex_);
+    return stats_;
   }
 
  private:
-  std::deque<Block, Allocator> cache_; // pointers remain valid
-}; // block_cache
+  struct entry {
+    entry(const key_t& key, std::shared_ptr<const void> block, size_t memory)
+      : key(key), block(std::move(block)), memory(memory) {
+    }
 
-template<typename Block, typename Allocator>
-struct block_cache_traits {
-  typedef Block block_t;
-  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<block_t> allocator_t;
-  typedef block_cache<Block, allocator_t> cache_t;
-};
+    key_t key;
+    std::shared_ptr<const void> block;
+    size_t memory; // estimated memory occupied by a block
+  }; // entry
+
+  typedef std::list<entry> lru_t;
+
+  block_lru() = default;
+
+  void evict(size_t limit) NOEXCEPT {
+    while (stats_.memory > limit) {
+      assert(!lru_.empty());
+      const auto& victim = lru_.back();
+
+      stats_.memory -= victim.memory;
+      --stats_.blocks;
+      ++stats_.evictions;
+      map_.erase(victim.key);
+      lru_.pop_back();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  lru_t lru_; // most recently used blocks first
+  std::map<key_t, lru_t::iterator> map_; // ordered by reader, see erase(...)
+  stats_t stats_;
+  size_t limit_{ DEFAULT_LIMIT };
+}; // block_lru
+
+const size_t block_lru::DEFAULT_LIMIT;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                            Blocks
@@ -3285,7 +4131,7 @@ class sparse_block : util::noncopyable {
     const bstring* data_{};
   }; // iterator
 
-  void load(index_input& in, decompressor& decomp, bstring& buf) {
+  void load(index_input& in, const data_decompressor& decomp, bstring& buf) {
     const uint32_t size = in.read_vint(); // total number of entries in a block
 
     if (!size) {
@@ -3345,6 +4191,11 @@ class sparse_block : util::noncopyable {
     return true;
   }
 
+  // returns estimated amount of memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
   bool visit(const columnstore_reader::values_reader_f& visitor) const {
     bytes_ref value;
 
@@ -3471,7 +4322,7 @@ class dense_block : util::noncopyable {
     doc_id_t base_{};
   }; // iterator
 
-  void load(index_input& in, decompressor& decomp, bstring& buf) {
+  void load(index_input& in, const data_decompressor& decomp, bstring& buf) {
     const uint32_t size = in.read_vint(); // total number of entries in a block
 
     if (!size) {
@@ -3523,6 +4374,11 @@ class dense_block : util::noncopyable {
     return true;
   }
 
+  // returns estimated amount of memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
   bool visit(const columnstore_reader::values_reader_f& visitor) const {
     bytes_ref value;
 
@@ -3650,7 +4506,7 @@ class dense_fixed_offset_block : util::noncopyable {
     doc_id_t value_back_{}; // last valid doc id
   }; // iterator
 
-  void load(index_input& in, decompressor& decomp, bstring& buf) {
+  void load(index_input& in, const data_decompressor& decomp, bstring& buf) {
     size_ = in.read_vint(); // total number of entries in a block
 
     if (!size_) {
@@ -3699,6 +4555,11 @@ class dense_fixed_offset_block : util::noncopyable {
     return true;
   }
 
+  // returns estimated amount of memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
   bool visit(const columnstore_reader::values_reader_f& visitor) const {
     assert(size_);
 
@@ -3796,7 +4657,7 @@ class sparse_mask_block : util::noncopyable {
     );
   }
 
-  void load(index_input& in, decompressor& /*decomp*/, bstring& buf) {
+  void load(index_input& in, const data_decompressor& /*decomp*/, bstring& buf) {
     size_ = in.read_vint(); // total number of entries in a block
 
     if (!size_) {
@@ -3830,6 +4691,11 @@ class sparse_mask_block : util::noncopyable {
     return !(std::end(keys_) == it || *it > key);
   }
 
+  // returns estimated amount of memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this);
+  }
+
   bool visit(const columnstore_reader::values_reader_f& reader) const {
     for (auto begin = std::begin(keys_), end = begin + size_; begin != end; ++begin) {
       if (!reader(*begin, DUMMY)) {
@@ -3917,7 +4783,7 @@ class dense_mask_block {
       max_(type_limits<type_t::doc_id_t>::invalid()) {
   }
 
-  void load(index_input& in, decompressor& /*decomp*/, bstring& /*buf*/) {
+  void load(index_input& in, const data_decompressor& /*decomp*/, bstring& /*buf*/) {
     const auto size = in.read_vint(); // total number of entries in a block
 
     if (!size) {
@@ -3945,6 +4811,11 @@ class dense_mask_block {
     return min_ <= key && key < max_;
   }
 
+  // returns estimated amount of memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this);
+  }
+
   bool visit(const columnstore_reader::values_reader_f& visitor) const {
     for (auto doc = min_; doc < max_; ++doc) {
       if (!visitor(doc, DUMMY)) {
@@ -3960,13 +4831,7 @@ class dense_mask_block {
   doc_id_t max_;
 }; // dense_mask_block
 
-template<typename Allocator = std::allocator<sparse_block>>
-class read_context
-  : public block_cache_traits<sparse_block, Allocator>::cache_t,
-    public block_cache_traits<dense_block, Allocator>::cache_t,
-    public block_cache_traits<dense_fixed_offset_block, Allocator>::cache_t,
-    public block_cache_traits<sparse_mask_block, Allocator>::cache_t,
-    public block_cache_traits<dense_mask_block, Allocator>::cache_t {
+class read_context : util::noncopyable {
  public:
   DECLARE_SHARED_PTR(read_context);
 
@@ -3983,45 +4848,15 @@ class read_context
     return memory::make_shared<read_context>(std::move(clone));
   }
 
-  read_context(index_input::ptr&& in = index_input::ptr(), const Allocator& alloc = Allocator())
-    : block_cache_traits<sparse_block, Allocator>::cache_t(typename block_cache_traits<sparse_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_block, Allocator>::cache_t(typename block_cache_traits<dense_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_fixed_offset_block, Allocator>::cache_t(typename block_cache_traits<dense_fixed_offset_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<sparse_mask_block, Allocator>::cache_t(typename block_cache_traits<sparse_mask_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_mask_block, Allocator>::cache_t(typename block_cache_traits<dense_mask_block, Allocator>::allocator_t(alloc)),
-      buf_(INDEX_BLOCK_SIZE*sizeof(uint32_t), 0),
+  explicit read_context(index_input::ptr&& in = index_input::ptr())
+    : buf_(INDEX_BLOCK_SIZE*sizeof(uint32_t), 0),
       stream_(std::move(in)) {
   }
 
-  template<typename Block, typename... Args>
-  Block& emplace_back(uint64_t offset, Args&&... args) {
-    typename block_cache_traits<Block, Allocator>::cache_t& cache = *this;
-
-    // add cache entry
-    auto& block = cache.emplace_back(std::forward<Args>(args)...);
-
-    try {
-      load(block, offset);
-    } catch (...) {
-      // failed to load block
-      pop_back<Block>();
-
-      throw;
-    }
-
-    return block;
-  }
-
   template<typename Block>
-  void load(Block& block, uint64_t offset) {
+  void load(Block& block, const data_codec& codec, uint64_t offset) {
     stream_->seek(offset); // seek to the offset
-    block.load(*stream_, decomp_, buf_);
-  }
-
-  template<typename Block>
-  void pop_back() NOEXCEPT {
-    typename block_cache_traits<Block, Allocator>::cache_t& cache = *this;
-    cache.pop_back();
+    block.load(*stream_, data_decompressor(decomp_, codec), buf_);
   }
 
  private:
@@ -4030,7 +4865,7 @@ class read_context
   index_input::ptr stream_;
 }; // read_context
 
-typedef read_context<> read_context_t;
+typedef read_context read_context_t;
 
 class context_provider: private util::noncopyable {
  public:
@@ -4038,71 +4873,204 @@ class context_provider: private util::noncopyable {
     : pool_(std::max(size_t(1), max_pool_size)) {
   }
 
-  void prepare(index_input::ptr&& stream) NOEXCEPT {
+  ~context_provider() {
+    wait_prefetched();
+
+    // blocks of the reader will never be requested again
+    block_lru::instance().erase(id_);
+  }
+
+  void prepare(index_input::ptr&& stream, uint64_t id) NOEXCEPT {
     stream_ = std::move(stream);
+    id_ = id;
   }
 
   bounded_object_pool<read_context_t>::ptr get_context() const {
     return pool_.emplace(*stream_);
   }
 
+  // returns identifier of the reader in a block cache
+  uint64_t id() const NOEXCEPT { return id_; }
+
+  // schedules asynchronous execution of the specified block load,
+  // the load is skipped if too many loads are already pending
+  void prefetch(std::function<void()>&& load) const;
+
+  // waits for completion of the scheduled block loads
+  void wait_prefetched() const NOEXCEPT {
+    SCOPED_LOCK_NAMED(prefetch_mutex_, lock);
+    prefetch_cond_.wait(lock, [this]() { return !prefetching_; });
+  }
+
  private:
   mutable bounded_object_pool<read_context_t> pool_;
   index_input::ptr stream_;
+  uint64_t id_{};
+  mutable std::mutex prefetch_mutex_;
+  mutable std::condition_variable prefetch_cond_;
+  mutable size_t prefetching_{}; // number of scheduled block loads
 }; // context_provider
 
-// in case of success caches block pointed
-// instance, nullptr otherwise
-template<typename BlockRef>
-const typename BlockRef::block_t& load_block(
-    const context_provider& ctxs,
-    BlockRef& ref) {
-  typedef typename BlockRef::block_t block_t;
+// number of threads loading blocks ahead of the actual reads
+const size_t PREFETCH_THREADS = 2;
 
-  const auto* cached = ref.pblock.load();
+// max number of pending block loads of all readers, further ones are skipped
+const size_t PREFETCH_MAX_PENDING = 64;
 
-  if (!cached) {
-    auto ctx = ctxs.get_context();
-    assert(ctx);
+void context_provider::prefetch(std::function<void()>&& load) const {
+  static async_utils::thread_pool pool(PREFETCH_THREADS, PREFETCH_THREADS);
+  static std::atomic<size_t> pending{ 0 };
 
-    // load block
-    const auto& block = ctx->template emplace_back<block_t>(ref.offset);
+  if (pending.fetch_add(1) >= PREFETCH_MAX_PENDING) {
+    --pending;
+    return; // prefetching is a hint only
+  }
 
-    // mark block as loaded
-    if (ref.pblock.compare_exchange_strong(cached, &block)) {
-      cached = &block;
-    } else {
-      // already cached by another thread
-      ctx->template pop_back<block_t>();
+  {
+    SCOPED_LOCK(prefetch_mutex_);
+    ++prefetching_;
+  }
+
+  auto done = [this]() NOEXCEPT {
+    --pending;
+
+    SCOPED_LOCK(prefetch_mutex_);
+
+    if (!--prefetching_) {
+      prefetch_cond_.notify_all();
+    }
+  };
+
+  auto task = [load, done]() {
+    try {
+      load();
+    } catch (...) {
+      // the block is loaded again once it's actually read
+      IR_FRMT_WARN("Failed to prefetch a columnstore block");
+    }
+
+    done();
+  };
+
+  try {
+    if (pool.run(std::move(task))) {
+      return;
     }
+  } catch (...) {
+    // unable to schedule, skip the load
   }
 
-  return *cached;
+  done();
 }
 
-// in case of success caches block pointed
-// by 'ref' in the specified 'block' and
-// retuns a pointer to cached instance,
-// nullptr otherwise
-template<typename BlockRef>
-const typename BlockRef::block_t& load_block(
+// returns block located at the specified 'offset',
+// loads and caches the block in case of cache miss
+template<typename Block>
+std::shared_ptr<const Block> load_block(
     const context_provider& ctxs,
-    const BlockRef& ref,
-    typename BlockRef::block_t& block) {
-  const auto* cached = ref.pblock.load();
+    const data_codec& codec,
+    uint64_t offset) {
+  auto& cache = block_lru::instance();
+  const block_lru::key_t key{ ctxs.id(), offset };
+  auto cached = cache.find<Block>(key);
 
   if (!cached) {
-    auto ctx = ctxs.get_context();
-    assert(ctx);
+    auto block = memory::make_shared<Block>();
+
+    {
+      auto ctx = ctxs.get_context();
+      assert(ctx);
+
+      ctx->load(*block, codec, offset);
+    }
+
+    cached = cache.insert<Block>(key, std::move(block));
+  }
+
+  return cached;
+}
+
+// schedules asynchronous loading of the block located at the specified
+// 'offset' into the block cache unless the block is already cached,
+// 'codec' must remain valid until the reader waits for prefetched blocks
+template<typename Block>
+void prefetch_block(
+    const context_provider& ctxs,
+    const data_codec& codec,
+    uint64_t offset) {
+  if (!block_lru::instance().missing({ ctxs.id(), offset })) {
+    return;
+  }
+
+  ctxs.prefetch([&ctxs, &codec, offset]() {
+    load_block<Block>(ctxs, codec, offset);
+  });
+}
 
-    ctx->load(block, ref.offset);
+// returns cached block located at the specified 'offset',
+// otherwise loads the block into the specified 'block'
+// without caching it, 'cached' holds the cached instance
+template<typename Block>
+const Block& load_block(
+    const context_provider& ctxs,
+    const data_codec& codec,
+    uint64_t offset,
+    Block& block,
+    std::shared_ptr<const Block>& cached) {
+  cached = block_lru::instance().find<Block>({ ctxs.id(), offset });
 
-    cached = &block;
+  if (cached) {
+    return *cached;
   }
 
-  return *cached;
+  auto ctx = ctxs.get_context();
+  assert(ctx);
+
+  ctx->load(block, codec, offset);
+
+  return block;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class pinned_blocks
+/// @brief keeps blocks read via 'column_reader::values()' loaded for the
+///        lifetime of a column, so that returned values remain valid,
+///        similar to the unbounded per-reader cache the block cache replaced
+///        pinned blocks aren't bound by the cache limit
+////////////////////////////////////////////////////////////////////////////////
+template<typename Block>
+class pinned_blocks : private util::noncopyable {
+ public:
+  template<typename BlockRef>
+  const Block& pin(
+      const context_provider& ctxs,
+      const data_codec& codec,
+      const BlockRef& ref) {
+    const auto* pinned = ref.pblock.load();
+
+    if (!pinned) {
+      auto block = load_block<Block>(ctxs, codec, ref.offset);
+
+      SCOPED_LOCK(mutex_);
+      pinned = ref.pblock.load();
+
+      if (!pinned) {
+        // not pinned by another thread
+        blocks_.emplace_back(std::move(block));
+        pinned = blocks_.back().get();
+        ref.pblock.store(pinned);
+      }
+    }
+
+    return *pinned;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<const Block>> blocks_;
+}; // pinned_blocks
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @class column
 ////////////////////////////////////////////////////////////////////////////////
@@ -4118,7 +5086,7 @@ class column
 
   virtual ~column() { }
 
-  virtual void read(data_input& in, uint64_t* /*buf*/) {
+  virtual void read(data_input& in, uint64_t* /*buf*/, int32_t /*version*/) {
     count_ = in.read_vint();
     max_ = in.read_vint();
     avg_block_size_ = in.read_vint();
@@ -4128,18 +5096,81 @@ class column
     }
   }
 
+  // reads codec of the column data blocks following the column header
+  void read_codec(data_input& in, int32_t version) {
+    if (version < writer::FORMAT_CODEC) {
+      return; // data blocks are compressed with LZ4
+    }
+
+    const auto id = static_cast<column_codec>(in.read_byte());
+
+    switch (id) {
+      case column_codec::NONE:
+      case column_codec::LZ4:
+      case column_codec::LZ4HC:
+        break;
+      case column_codec::LZ4_DICT:
+        codec_.dict = read_string<bstring>(in);
+        break;
+      default:
+        throw index_error(string_utils::to_string(
+          "while reading column codec, error: invalid codec '%d'",
+          static_cast<int>(id)
+        ));
+    }
+
+    codec_.id = id;
+  }
+
   doc_id_t max() const NOEXCEPT { return max_; }
   virtual size_t size() const NOEXCEPT override { return count_; }
+  virtual column_codec codec() const NOEXCEPT override { return codec_.id; }
   bool empty() const NOEXCEPT { return 0 == size(); }
   uint32_t avg_block_size() const NOEXCEPT { return avg_block_size_; }
   uint32_t avg_block_count() const NOEXCEPT { return avg_block_count_; }
   ColumnProperty props() const NOEXCEPT { return props_; }
+  const data_codec& blocks_codec() const NOEXCEPT { return codec_; }
 
  protected:
   // same as size() but returns uint32_t to avoid type convertions
   uint32_t count() const NOEXCEPT { return count_; }
 
+  // reads value bounds of column blocks following the blocks index
+  void read_bounds(data_input& in, size_t blocks_count, int32_t version) {
+    if (version < writer::FORMAT_VALUE_BOUNDS || !in.read_byte()) {
+      return; // column has no value bounds
+    }
+
+    std::vector<bstring> bounds(2*blocks_count);
+
+    for (auto& bound : bounds) {
+      bound = read_string<bstring>(in);
+    }
+
+    bounds_ = std::move(bounds);
+  }
+
+  // returns false if values of the specified block are known
+  // to be out of the specified range [min, max], where bytes_ref::NIL
+  // denotes an unbounded side of the range
+  bool intersects(
+      size_t block,
+      const bytes_ref& min,
+      const bytes_ref& max) const NOEXCEPT {
+    if (bounds_.empty()) {
+      return true; // unknown bounds
+    }
+
+    assert(2*block + 1 < bounds_.size());
+    const bytes_ref block_min = bounds_[2*block];
+    const bytes_ref block_max = bounds_[2*block + 1];
+
+    return !(block_max < min) && (max.null() || !(max < block_min));
+  }
+
  private:
+  data_codec codec_; // compression of the column data blocks
+  std::vector<bstring> bounds_; // per-block min/max values, empty if unknown
   doc_id_t max_{ type_limits<type_t::doc_id_t>::eof() };
   uint32_t count_{};
   uint32_t avg_block_size_{};
@@ -4162,6 +5193,7 @@ class column_iterator final: public irs::doc_iterator {
      begin_(begin),
      seek_origin_(begin),
      end_(end),
+     prefetched_(begin),
      column_(&column) {
     attrs_.emplace(payload_);
   }
@@ -4195,6 +5227,8 @@ class column_iterator final: public irs::doc_iterator {
       if (!next_block()) {
         return false;
       }
+
+      prefetch(); // sequential read, load the following blocks ahead
     }
 
     return true;
@@ -4203,6 +5237,19 @@ class column_iterator final: public irs::doc_iterator {
  private:
   typedef typename column_t::refs_t refs_t;
 
+  // number of blocks following the current one loaded ahead by 'next()'
+  static const size_t PREFETCH_BLOCKS = 2;
+
+  void prefetch() {
+    const auto* end = begin_ + std::min(size_t(end_ - begin_), size_t(PREFETCH_BLOCKS));
+
+    for (auto* ref = std::max(begin_, prefetched_); ref < end; ++ref) {
+      prefetch_block<block_t>(*column_->ctxs_, column_->blocks_codec(), ref->offset);
+    }
+
+    prefetched_ = std::max(prefetched_, end);
+  }
+
   struct payload_iterator: public irs::payload_iterator {
     const irs::bytes_ref* value_{ nullptr };
     virtual bool next() override { return nullptr != value_; }
@@ -4222,12 +5269,14 @@ class column_iterator final: public irs::doc_iterator {
     }
 
     try {
-      const auto& cached = load_block(*column_->ctxs_, *begin_);
+      auto cached = load_block<block_t>(*column_->ctxs_, column_->blocks_codec(), begin_->offset);
 
-      if (block_ != cached) {
-        block_.reset(cached);
+      if (block_ != *cached) {
+        block_.reset(*cached);
         payload_.value_ = &(block_.value_payload());
       }
+
+      cached_ = std::move(cached); // hold the block while it's in use
     } catch (...) {
       // unable to load block, seal the iterator
       block_.seal();
@@ -4243,11 +5292,13 @@ class column_iterator final: public irs::doc_iterator {
   }
 
   irs::attribute_view attrs_;
+  std::shared_ptr<const block_t> cached_; // current block
   block_iterator_t block_;
   payload_iterator payload_;
   const typename column_t::block_ref* begin_;
   const typename column_t::block_ref* seek_origin_;
   const typename column_t::block_ref* end_;
+  const typename column_t::block_ref* prefetched_; // end of the loaded ahead blocks
   const column_t* column_;
 }; // column_iterator
 
@@ -4255,9 +5306,49 @@ class column_iterator final: public irs::doc_iterator {
 // --SECTION--                                                           Columns
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class column_values_reader
+/// @brief holds the last accessed block and looks up keys within its range
+///        without going to the block cache, a value returned by the reader
+///        remains valid until the next invocation of the same reader,
+///        a copy of the reader holds its own block
+////////////////////////////////////////////////////////////////////////////////
+template<typename Column>
+class column_values_reader {
+ public:
+  typedef typename Column::block_t block_t;
+
+  explicit column_values_reader(const Column& column) NOEXCEPT
+    : column_(&column) {
+  }
+
+  bool operator()(doc_id_t key, bytes_ref& value) {
+    if (!block_ || doc_id_t(key - min_) >= size_) {
+      doc_id_t min, size;
+      auto block = column_->load(key, min, size);
+
+      if (!block) {
+        return false;
+      }
+
+      block_ = std::move(block);
+      min_ = min;
+      size_ = size;
+    }
+
+    return block_->value(key, value);
+  }
+
+ private:
+  std::shared_ptr<const block_t> block_; // current block
+  const Column* column_;
+  doc_id_t min_{}; // min key of the current block
+  doc_id_t size_{}; // number of keys in the range of the current block
+}; // column_values_reader
+
 template<typename Column>
 columnstore_reader::values_reader_f column_values(const Column& column) {
-if (column.empty()) {
+  if (column.empty()) {
     return columnstore_reader::empty_reader();
   }
 
@@ -4266,6 +5357,15 @@ if (column.empty()) {
   };
 }
 
+template<typename Column>
+columnstore_reader::values_reader_f column_values_cursor(const Column& column) {
+  if (column.empty()) {
+    return columnstore_reader::empty_reader();
+  }
+
+  return column_values_reader<Column>(column);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @class sparse_column
 ////////////////////////////////////////////////////////////////////////////////
@@ -4283,8 +5383,8 @@ class sparse_column final : public column {
     : column(props), ctxs_(&ctxs) {
   }
 
-  virtual void read(data_input& in, uint64_t* buf) override {
-    column::read(in, buf); // read common header
+  virtual void read(data_input& in, uint64_t* buf, int32_t version) override {
+    column::read(in, buf, version); // read common header
 
     uint32_t blocks_count = in.read_vint(); // total number of column index blocks
 
@@ -4337,9 +5437,37 @@ class sparse_column final : public column {
     }
     begin->offset = type_limits<type_t::address_t>::invalid();
 
+    read_bounds(in, refs.size() - 1, version); // -1 for upper bound
+
     refs_ = std::move(refs);
   }
 
+  // returns block which may contain the specified key, nullptr if none,
+  // [min, min + size) denotes the range of keys covered by the block
+  std::shared_ptr<const block_t> load(
+      doc_id_t key,
+      doc_id_t& min,
+      doc_id_t& size) const {
+    // find the right block
+    const auto rbegin = refs_.rbegin(); // upper bound
+    const auto rend = refs_.rend();
+    const auto it = std::lower_bound(
+      rbegin, rend, key,
+      [] (const block_ref& lhs, doc_id_t rhs) {
+        return lhs.key > rhs;
+    });
+
+    if (it == rend || it == rbegin) {
+      return nullptr;
+    }
+
+    auto block = load_block<block_t>(*ctxs_, blocks_codec(), it->offset);
+    min = it->key;
+    size = (it - 1)->key - it->key; // next block starts after the range
+
+    return block;
+  };
+
   bool value(doc_id_t key, bytes_ref& value) const {
     // find the right block
     const auto rbegin = refs_.rbegin(); // upper bound
@@ -4354,25 +5482,55 @@ class sparse_column final : public column {
       return false;
     }
 
-    const auto& cached = load_block(*ctxs_, *it);
+    const auto& pinned = pinned_.pin(*ctxs_, blocks_codec(), *it);
 
-    return cached.value(key, value);
+    return pinned.value(key, value);
   };
 
   virtual bool visit(
       const columnstore_reader::values_visitor_f& visitor
   ) const override {
     block_t block; // don't cache new blocks
+    std::shared_ptr<const block_t> cached;
     for (auto begin = refs_.begin(), end = refs_.end()-1; begin != end; ++begin) { // -1 for upper bound
-      const auto& cached = load_block(*ctxs_, *begin, block);
+      const auto& loaded = load_block(*ctxs_, blocks_codec(), begin->offset, block, cached);
+
+      if (!loaded.visit(visitor)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  virtual bool visit_range(
+      const bytes_ref& min,
+      const bytes_ref& max,
+      const columnstore_reader::values_visitor_f& visitor
+  ) const override {
+    block_t block; // don't cache new blocks
+    std::shared_ptr<const block_t> cached;
+    for (size_t i = 0, count = refs_.size() - 1; i < count; ++i) { // -1 for upper bound
+      if (!intersects(i, min, max)) {
+        continue; // skip blocks without values in range
+      }
 
-      if (!cached.visit(visitor)) {
+      const auto& loaded = load_block(*ctxs_, blocks_codec(), refs_[i].offset, block, cached);
+
+      if (!loaded.visit(visitor)) {
         return false;
       }
     }
     return true;
   }
 
+  virtual void prefetch(doc_id_t key, size_t count) const override {
+    for (auto it = find_block(key), end = refs_.end()-1; // -1 for upper bound
+         count && it != end;
+         ++it, --count) {
+      prefetch_block<block_t>(*ctxs_, blocks_codec(), it->offset);
+    }
+  }
+
   virtual irs::doc_iterator::ptr iterator() const override {
     typedef column_iterator<column_t> iterator_t;
 
@@ -4389,6 +5547,10 @@ class sparse_column final : public column {
     return column_values<column_t>(*this);
   }
 
+  virtual columnstore_reader::values_reader_f values_cursor() const override {
+    return column_values_cursor<column_t>(*this);
+  }
+
  private:
   friend class column_iterator<column_t>;
 
@@ -4404,7 +5566,7 @@ class sparse_column final : public column {
 
     doc_id_t key; // min key in a block
     uint64_t offset; // block offset
-    mutable std::atomic<const block_t*> pblock; // pointer to cached block
+    mutable std::atomic<const block_t*> pblock{}; // block pinned by 'values()'
   }; // block_ref
 
   typedef std::vector<block_ref> refs_t;
@@ -4456,6 +5618,7 @@ class sparse_column final : public column {
 
   const context_provider* ctxs_;
   refs_t refs_; // blocks index
+  mutable pinned_blocks<block_t> pinned_; // blocks read via 'values()'
 }; // sparse_column
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4475,8 +5638,8 @@ class dense_fixed_offset_column final : public column {
     : column(prop), ctxs_(&ctxs) {
   }
 
-  virtual void read(data_input& in, uint64_t* buf) override {
-    column::read(in, buf); // read common header
+  virtual void read(data_input& in, uint64_t* buf, int32_t version) override {
+    column::read(in, buf, version); // read common header
 
     size_t blocks_count = in.read_vint(); // total number of column index blocks
 
@@ -4519,10 +5682,34 @@ class dense_fixed_offset_column final : public column {
       begin += blocks_count;
     }
 
+    read_bounds(in, refs.size(), version);
+
     refs_ = std::move(refs);
     min_ = this->max() - this->count() + 1;
   }
 
+  // returns block which may contain the specified key, nullptr if none,
+  // [min, min + size) denotes the range of keys covered by the block
+  std::shared_ptr<const block_t> load(
+      doc_id_t key,
+      doc_id_t& min,
+      doc_id_t& size) const {
+    const auto base_key = key - min_;
+
+    if (base_key >= this->count()) {
+      return nullptr;
+    }
+
+    const auto block_idx = base_key / this->avg_block_count();
+    assert(block_idx < refs_.size());
+
+    auto block = load_block<block_t>(*ctxs_, blocks_codec(), refs_[block_idx].offset);
+    min = min_ + block_idx*this->avg_block_count();
+    size = this->avg_block_count(); // block checks keys past the column end
+
+    return block;
+  }
+
   bool value(doc_id_t key, bytes_ref& value) const {
     const auto base_key = key - min_;
 
@@ -4533,21 +5720,42 @@ class dense_fixed_offset_column final : public column {
     const auto block_idx = base_key / this->avg_block_count();
     assert(block_idx < refs_.size());
 
-    auto& ref = const_cast<block_ref&>(refs_[block_idx]);
-
-    const auto& cached = load_block(*ctxs_, ref);
+    const auto& pinned = pinned_.pin(*ctxs_, blocks_codec(), refs_[block_idx]);
 
-    return cached.value(key, value);
+    return pinned.value(key, value);
   }
 
   virtual bool visit(
       const columnstore_reader::values_visitor_f& visitor
   ) const override {
     block_t block; // don't cache new blocks
+    std::shared_ptr<const block_t> cached;
     for (auto& ref : refs_) {
-      const auto& cached = load_block(*ctxs_, ref, block);
+      const auto& loaded = load_block(*ctxs_, blocks_codec(), ref.offset, block, cached);
+
+      if (!loaded.visit(visitor)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  virtual bool visit_range(
+      const bytes_ref& min,
+      const bytes_ref& max,
+      const columnstore_reader::values_visitor_f& visitor
+  ) const override {
+    block_t block; // don't cache new blocks
+    std::shared_ptr<const block_t> cached;
+    for (size_t i = 0, count = refs_.size(); i < count; ++i) {
+      if (!intersects(i, min, max)) {
+        continue; // skip blocks without values in range
+      }
 
-      if (!cached.visit(visitor)) {
+      const auto& loaded = load_block(*ctxs_, blocks_codec(), refs_[i].offset, block, cached);
+
+      if (!loaded.visit(visitor)) {
         return false;
       }
     }
@@ -4555,6 +5763,14 @@ class dense_fixed_offset_column final : public column {
     return true;
   }
 
+  virtual void prefetch(doc_id_t key, size_t count) const override {
+    for (auto it = find_block(key), end = refs_.end();
+         count && it != end;
+         ++it, --count) {
+      prefetch_block<block_t>(*ctxs_, blocks_codec(), it->offset);
+    }
+  }
+
   virtual irs::doc_iterator::ptr iterator() const override {
     typedef column_iterator<column_t> iterator_t;
 
@@ -4572,10 +5788,14 @@ class dense_fixed_offset_column final : public column {
     return column_values<column_t>(*this);
   }
 
+  virtual columnstore_reader::values_reader_f values_cursor() const override {
+    return column_values_cursor<column_t>(*this);
+  }
+
  private:
   friend class column_iterator<column_t>;
 
-  struct block_ref {
+  struct block_ref : util::noncopyable {
     typedef typename column_t::block_t block_t;
 
     block_ref() = default;
@@ -4586,7 +5806,7 @@ class dense_fixed_offset_column final : public column {
     }
 
     uint64_t offset; // need to store base offset since blocks may not be located sequentially
-    mutable std::atomic<const block_t*> pblock;
+    mutable std::atomic<const block_t*> pblock{}; // block pinned by 'values()'
   }; // block_ref
 
   typedef std::vector<block_ref> refs_t;
@@ -4628,6 +5848,7 @@ class dense_fixed_offset_column final : public column {
 
   const context_provider* ctxs_;
   refs_t refs_;
+  mutable pinned_blocks<block_t> pinned_; // blocks read via 'values()'
   doc_id_t min_{}; // min key
 }; // dense_fixed_offset_column
 
@@ -4644,14 +5865,15 @@ class dense_fixed_offset_column<dense_mask_block> final : public column {
     : column(prop) {
   }
 
-  virtual void read(data_input& in, uint64_t* buf) override {
+  virtual void read(data_input& in, uint64_t* buf, int32_t version) override {
     // we treat data in blocks as "garbage" which could be
     // potentially removed on merge, so we don't validate
     // column properties using such blocks
 
-    column::read(in, buf); // read common header
+    column::read(in, buf, version); // read common header
 
     uint32_t blocks_count = in.read_vint(); // total number of column index blocks
+    const auto total_blocks_count = blocks_count;
 
     while (blocks_count >= INDEX_BLOCK_SIZE) {
       if (!encode::avg::check_block_rl32(in, this->avg_block_count())) {
@@ -4685,6 +5907,8 @@ class dense_fixed_offset_column<dense_mask_block> final : public column {
     }
 
 
+    read_bounds(in, total_blocks_count, version);
+
     min_ = this->max() - this->count();
   }
 
@@ -4710,7 +5934,13 @@ class dense_fixed_offset_column<dense_mask_block> final : public column {
   virtual irs::doc_iterator::ptr iterator() const override;
 
   virtual columnstore_reader::values_reader_f values() const override {
-    return column_values<column_t>(*this);
+    if (empty()) {
+      return columnstore_reader::empty_reader();
+    }
+
+    return [this](doc_id_t key, bytes_ref& value) {
+      return this->value(key, value);
+    };
   }
 
  private:
@@ -4799,6 +6029,13 @@ const column_factory_f g_column_factories[] {                  // CP_DENSE | CP_
   &dense_fixed_offset_column<dense_mask_block>::make           //    1     |    1        1        1
 };
 
+// returns identifier of a columnstore reader in a block cache, identifiers
+// are never reused, so blocks of different readers never alias each other
+uint64_t next_reader_id() NOEXCEPT {
+  static std::atomic<uint64_t> id{ 0 };
+  return ++id;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class reader
 //////////////////////////////////////////////////////////////////////////////
@@ -4808,6 +6045,10 @@ class reader final: public columnstore_reader, public context_provider {
     : context_provider(pool_size) {
   }
 
+  ~reader() {
+    wait_prefetched(); // prefetched blocks are decoded by codecs of 'columns_'
+  }
+
   virtual bool prepare(
     const directory& dir,
     const segment_meta& meta
@@ -4853,7 +6094,7 @@ bool reader::prepare(
   }
 
   // check header
-  format_utils::check_header(
+  const auto version = format_utils::check_header(
     *stream,
     writer::FORMAT_NAME,
     writer::FORMAT_MIN,
@@ -4909,7 +6150,8 @@ bool reader::prepare(
     }
 
     try {
-      column->read(*stream, buf);
+      column->read(*stream, buf, version);
+      column->read_codec(*stream, version);
     } catch (...) {
       IR_FRMT_ERROR("Failed to load column id=" IR_SIZE_T_SPECIFIER, i);
 
@@ -4921,7 +6163,7 @@ bool reader::prepare(
   }
 
   // noexcept
-  context_provider::prepare(std::move(stream));
+  context_provider::prepare(std::move(stream), next_reader_id());
   columns_ = std::move(columns);
 
   return true;
@@ -4964,6 +6206,9 @@ class postings_reader final: public irs::postings_reader {
   index_input::ptr doc_in_;
   index_input::ptr pos_in_;
   index_input::ptr pay_in_;
+  skip_index_cache::ptr skip_cache_{ memory::make_shared<skip_index_cache>() };
+  int32_t version_{}; // postings format version
+  int32_t terms_version_{}; // terms format version
 }; // postings_reader
 
 void postings_reader::prepare(
@@ -4973,7 +6218,7 @@ void postings_reader::prepare(
   std::string buf;
 
   // prepare document input
-  prepare_input(
+  version_ = prepare_input(
     buf, doc_in_, irs::IOAdvice::RANDOM, state,
     postings_writer::DOC_EXT,
     postings_writer::DOC_FORMAT_NAME,
@@ -5025,7 +6270,7 @@ void postings_reader::prepare(
   }
 
   // check postings format
-  format_utils::check_header(in,
+  terms_version_ = format_utils::check_header(in,
     postings_writer::TERMS_FORMAT_NAME,
     postings_writer::TERMS_FORMAT_MIN,
     postings_writer::TERMS_FORMAT_MAX
@@ -5056,8 +6301,15 @@ void postings_reader::decode(
   auto& term_freq = attrs.get<frequency>();
 
   term_meta.docs_count = in.read_vint();
+  term_meta.max_freq = 0;
   if (term_freq) {
     term_freq->value = term_meta.docs_count + in.read_vint();
+
+    if (terms_version_ >= postings_writer::TERMS_FORMAT_BLOCK_MAX) {
+      term_meta.max_freq = term_meta.docs_count > 1
+        ? in.read_vint()
+        : term_freq->value;
+    }
   }
 
   term_meta.doc_start += in.read_vlong();
@@ -5117,7 +6369,8 @@ irs::doc_iterator::ptr postings_reader::iterator(
 
   it->prepare(
     features, enabled, attrs,
-    doc_in_.get(), pos_in_.get(), pay_in_.get()
+    doc_in_.get(), pos_in_.get(), pay_in_.get(),
+    version_, skip_cache_
   );
 
   return it;
@@ -5265,6 +6518,26 @@ format::format(const irs::format::type_id& type) NOEXCEPT
   : irs::format(type) {
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                     column_cache
+// ----------------------------------------------------------------------------
+
+/*static*/ void column_cache::clear() {
+  columns::block_lru::instance().clear();
+}
+
+/*static*/ size_t column_cache::limit() {
+  return columns::block_lru::instance().limit();
+}
+
+/*static*/ void column_cache::limit(size_t limit) {
+  columns::block_lru::instance().limit(limit);
+}
+
+/*static*/ column_cache::stats column_cache::statistics() {
+  return columns::block_lru::instance().stats();
+}
+
 NS_END // version10
 NS_END // root
 
@@ -43,6 +43,45 @@ class IRESEARCH_PLUGIN format : public irs::format {
   explicit format(const irs::format::type_id& type) NOEXCEPT;
 }; // format
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class column_cache
+/// @brief process-wide memory bounded LRU cache of decompressed columnstore
+///        blocks, blocks loaded by a columnstore reader are shared by all
+///        iterators and values readers of its columns, blocks of a
+///        columnstore reader are evicted once the reader is destroyed
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_PLUGIN column_cache {
+  struct stats {
+    size_t hits{}; // number of blocks found in cache
+    size_t misses{}; // number of blocks not found in cache
+    size_t evictions{}; // number of blocks evicted from cache
+    size_t blocks{}; // number of cached blocks
+    size_t memory{}; // estimated amount of memory occupied by cached blocks
+  }; // stats
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief evicts all cached blocks, blocks that are still in use are
+  ///        released once they're no longer referenced
+  //////////////////////////////////////////////////////////////////////////////
+  static void clear();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns memory limit of the cache in bytes (256 MiB by default)
+  //////////////////////////////////////////////////////////////////////////////
+  static size_t limit();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief sets memory limit of the cache in bytes, evicts least recently
+  ///        used blocks if necessary, 0 disables caching
+  //////////////////////////////////////////////////////////////////////////////
+  static void limit(size_t limit);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns snapshot of the cache statistics
+  //////////////////////////////////////////////////////////////////////////////
+  static stats statistics();
+}; // column_cache
+
 NS_END // version10
 NS_END // ROOT
 
@@ -41,21 +41,7 @@
 #include "utils/attributes.hpp"
 #include "utils/string.hpp"
 #include "utils/log.hpp"
-#include "utils/fst_matcher.hpp"
-
-#if defined(_MSC_VER)
-  #pragma warning(disable : 4291)
-#elif defined (__GNUC__)
-  // NOOP
-#endif
-
-#include <fst/matcher.h>
-
-#if defined(_MSC_VER)
-  #pragma warning(default: 4291)
-#elif defined (__GNUC__)
-  // NOOP
-#endif
+#include "utils/thread_utils.hpp"
 
 #if defined(_MSC_VER)
   #pragma warning(disable : 4244)
@@ -185,7 +171,7 @@ inline void prepare_output(
   format_utils::write_header(*out, format, version);
 }
 
-inline void prepare_input(
+inline int32_t prepare_input(
     std::string& str,
     index_input::ptr& in,
     irs::IOAdvice advice,
@@ -211,7 +197,7 @@ inline void prepare_input(
     *checksum = format_utils::checksum(*in);
   }
 
-  format_utils::check_header(*in, format, min_ver, max_ver);
+  return format_utils::check_header(*in, format, min_ver, max_ver);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -459,14 +445,10 @@ class term_iterator : public irs::seek_term_iterator {
   index_input& terms_input() const;
 
  private:
-  typedef term_reader::fst_t fst_t;
-  typedef fst::SortedMatcher<fst_t> sorted_matcher_t;
-  typedef fst::explicit_matcher<sorted_matcher_t> matcher_t; // avoid implicit loops
-
   friend class block_iterator;
 
   struct arc {
-    typedef fst_byte_builder::stateid_t stateid_t;
+    typedef compact_fst::stateid_t stateid_t;
 
     arc() : block{} { }
 
@@ -477,12 +459,12 @@ class term_iterator : public irs::seek_term_iterator {
       rhs.block = nullptr;
     }
 
-    arc(stateid_t state, const byte_weight& weight, block_iterator* block)
+    arc(stateid_t state, const bytes_ref& weight, block_iterator* block)
       : state(state), weight(weight), block(block) {
     }
 
     stateid_t state;
-    byte_weight weight;
+    bytes_ref weight; // points to FST data
     block_iterator* block;
   }; // arc
 
@@ -523,7 +505,7 @@ class term_iterator : public irs::seek_term_iterator {
   }
 
   const term_reader* owner_;
-  matcher_t matcher_;
+  const compact_fst* fst_;
   irs::attribute_view attrs_;
   seek_state_t sstate_;
   block_stack_t block_stack_;
@@ -870,7 +852,7 @@ void block_iterator::reset() {
 
 term_iterator::term_iterator(const term_reader* owner)
   : owner_(owner),
-    matcher_(*owner->fst_, fst::MATCH_INPUT),
+    fst_(&owner->fst()),
     attrs_(2), // version10::term_meta + frequency
     cur_block_(nullptr) {
   assert(owner_);
@@ -894,8 +876,9 @@ bool term_iterator::next() {
   if (!cur_block_) {
     if (term_.empty()) {
       /* iterator at the beginning */
-      const auto& fst = *owner_->fst_;
-      cur_block_ = push_block(fst.Final(fst.Start()), 0);
+      bytes_ref weight;
+      fst_->final(fst_->start(), weight);
+      cur_block_ = push_block(byte_weight(weight.begin(), weight.end()), 0);
       cur_block_->load();
     } else {
       // seek to the term with the specified state was called from
@@ -973,7 +956,7 @@ ptrdiff_t term_iterator::seek_cached(
     auto end = begin + std::min(target.size(), sstate_.size());
 
     for (;begin != end && *pterm == *ptarget; ++begin, ++pterm, ++ptarget) {
-      fst_utils::append(weight, begin->weight);
+      weight.PushBack(begin->weight.begin(), begin->weight.end());
       state = begin->state;
       cur_block = begin->block;
     }
@@ -1007,14 +990,13 @@ ptrdiff_t term_iterator::seek_cached(
 }
 
 SeekResult term_iterator::seek_equal(const bytes_ref& term) {
-  assert(owner_->fst_);
-
-  typedef fst_t::Weight weight_t;
+  assert(fst_);
 
-  const auto& fst = *owner_->fst_;
+  const auto& fst = *fst_;
 
   size_t prefix = 0; // number of current symbol to process
-  arc::stateid_t state = fst.Start(); // start state
+  arc::stateid_t state = fst.start(); // start state
+  bytes_ref weight; // final output of a state
   weight_.Clear(); // clear aggregated fst output
 
   if (cur_block_) {
@@ -1027,25 +1009,26 @@ SeekResult term_iterator::seek_equal(const bytes_ref& term) {
       return SeekResult::FOUND;
     }
   } else {
-    cur_block_ = push_block(fst.Final(state), prefix);
+    fst.final(state, weight);
+    cur_block_ = push_block(byte_weight(weight.begin(), weight.end()), prefix);
   }
 
   term_.oversize(term.size());
   term_.reset(prefix); /* reset to common seek prefix */
   sstate_.resize(prefix); /* remove invalid cached arcs */
 
+  compact_fst::arc arc;
   bool found = fst_byte_builder::final != state;
   while (found && prefix < term.size()) {
-    matcher_.SetState(state);
-    if (found = matcher_.Find(term[prefix])) {
-      const auto& arc = matcher_.Value();
-      term_ += byte_type(arc.ilabel);
-      fst_utils::append(weight_, arc.weight);
+    if (found = fst.find(state, term[prefix], arc)) {
+      term_ += arc.label;
+      weight_.PushBack(arc.weight.begin(), arc.weight.end());
       ++prefix;
 
-      const auto weight = fst.Final(state = arc.nextstate);
-      if (weight_t::One() != weight && weight_t::Zero() != weight) {
-        cur_block_ = push_block(fst::Times(weight_, weight), prefix);
+      if (fst.final(state = arc.target, weight) && !weight.empty()) {
+        byte_weight out(weight_);
+        out.PushBack(weight.begin(), weight.end());
+        cur_block_ = push_block(std::move(out), prefix);
       } else if (fst_byte_builder::final == state) {
         cur_block_ = push_block(std::move(weight_), prefix);
         found = false;
@@ -1149,22 +1132,72 @@ term_reader::term_reader(term_reader&& rhs) NOEXCEPT
     doc_freq_(rhs.doc_freq_),
     term_freq_(rhs.term_freq_),
     field_(std::move(rhs.field_)),
-    fst_(rhs.fst_),
+    fst_buf_(std::move(rhs.fst_buf_)),
+    fst_loaded_(rhs.fst_loaded_.load()),
+    fst_offset_(rhs.fst_offset_),
+    fst_size_(rhs.fst_size_),
     owner_(rhs.owner_) {
   min_term_ref_ = min_term_;
   max_term_ref_ = max_term_;
+
+  if (fst_loaded_) {
+    // owned FST data may be relocated by the move
+    fst_.reset(fst_buf_.empty() ? rhs.fst_.data() : bytes_ref(fst_buf_));
+  }
+
   rhs.min_term_ref_ = bytes_ref::NIL;
   rhs.max_term_ref_ = bytes_ref::NIL;
   rhs.terms_count_ = 0;
   rhs.doc_count_ = 0;
   rhs.doc_freq_ = 0;
   rhs.term_freq_ = 0;
-  rhs.fst_ = nullptr;
+  rhs.fst_.reset(bytes_ref::NIL);
+  rhs.fst_loaded_ = false;
+  rhs.fst_offset_ = 0;
+  rhs.fst_size_ = 0;
   rhs.owner_ = nullptr;
 }
 
-term_reader::~term_reader() {
-  delete fst_;
+term_reader::~term_reader() { }
+
+const compact_fst& term_reader::fst() const {
+  if (fst_loaded_.load(std::memory_order_acquire)) {
+    return fst_;
+  }
+
+  assert(owner_ && owner_->index_in_);
+  SCOPED_LOCK(owner_->fst_mutex_);
+
+  if (!fst_loaded_.load(std::memory_order_relaxed)) {
+    auto& in = *owner_->index_in_;
+    const byte_type* data = in.read_buffer(fst_offset_, fst_size_);
+
+    if (!data) {
+      // terms index isn't directly addressable, read FST into memory
+      fst_buf_.resize(fst_size_);
+      in.seek(fst_offset_);
+
+      if (in.read_bytes(&fst_buf_[0], fst_size_) != fst_size_) {
+        throw io_error(string_utils::to_string(
+          "failed to read FST of field '%s'",
+          field_.name.c_str()
+        ));
+      }
+
+      data = fst_buf_.c_str();
+    }
+
+    if (!fst_.reset(bytes_ref(data, fst_size_))) {
+      throw index_error(string_utils::to_string(
+        "invalid FST of field '%s'",
+        field_.name.c_str()
+      ));
+    }
+
+    fst_loaded_.store(true, std::memory_order_release);
+  }
+
+  return fst_;
 }
 
 seek_term_iterator::ptr term_reader::iterator() const {
@@ -1174,6 +1207,7 @@ seek_term_iterator::ptr term_reader::iterator() const {
 void term_reader::prepare(
     std::istream& in, 
     const feature_map_t& feature_map,
+    int32_t version,
     field_reader& owner
 ) {
   // read field metadata
@@ -1196,9 +1230,34 @@ void term_reader::prepare(
     attrs_.emplace(freq_);
   }
 
-  // read fst
-  fst_ = fst_t::Read(in, fst::FstReadOptions());
-  assert(fst_);
+  if (version >= field_writer::FORMAT_COMPACT_FST) {
+    // FST is loaded lazily on first access
+    fst_size_ = meta_in.read_vlong();
+    fst_offset_ = meta_in.file_pointer();
+    meta_in.seek(fst_offset_ + fst_size_);
+  } else {
+    // legacy FST, convert it into compact form
+    std::unique_ptr<fst_t> fst(fst_t::Read(in, fst::FstReadOptions()));
+
+    if (!fst) {
+      throw index_error(string_utils::to_string(
+        "failed to read FST of field '%s'",
+        field_.name.c_str()
+      ));
+    }
+
+    compact_fst::compile(*fst, fst_buf_);
+    fst_size_ = fst_buf_.size();
+
+    if (!fst_.reset(fst_buf_)) {
+      throw index_error(string_utils::to_string(
+        "invalid FST of field '%s'",
+        field_.name.c_str()
+      ));
+    }
+
+    fst_loaded_ = true;
+  }
 
   owner_ = &owner;
 }
@@ -1447,7 +1506,8 @@ field_writer::field_writer(
     irs::postings_writer::ptr&& pw,
     bool volatile_state,
     uint32_t min_block_size,
-    uint32_t max_block_size)
+    uint32_t max_block_size,
+    int32_t version)
   : suffix(memory_allocator::global()),
     stats(memory_allocator::global()),
     pw(std::move(pw)),
@@ -1456,8 +1516,10 @@ field_writer::field_writer(
     term_count(0),
     min_block_size(min_block_size),
     max_block_size(max_block_size),
+    version_(version),
     volatile_state_(volatile_state) {
   assert(this->pw);
+  assert(version >= FORMAT_MIN && version <= FORMAT_MAX);
   assert(min_block_size > 1);
   assert(min_block_size <= max_block_size);
   assert(2 * (min_block_size - 1) <= max_block_size);
@@ -1481,8 +1543,8 @@ void field_writer::prepare(const irs::flush_state& state) {
 
   // prepare terms and index output
   std::string str;
-  detail::prepare_output(str, terms_out, state, TERMS_EXT, FORMAT_TERMS, FORMAT_MAX);
-  detail::prepare_output(str, index_out, state, TERMS_INDEX_EXT, FORMAT_TERMS_INDEX, FORMAT_MAX);
+  detail::prepare_output(str, terms_out, state, TERMS_EXT, FORMAT_TERMS, version_);
+  detail::prepare_output(str, index_out, state, TERMS_INDEX_EXT, FORMAT_TERMS_INDEX, version_);
   write_segment_features(*index_out, *state.features);
 
   // prepare postings writer
@@ -1628,9 +1690,15 @@ void field_writer::end_field(
   }
 
   // write fst
-  output_buf isb(index_out.get()); // wrap stream to be OpenFST compliant
-  std::ostream os(&isb);
-  fst.Write(os, fst::FstWriteOptions());
+  if (version_ >= FORMAT_COMPACT_FST) {
+    compact_fst::compile(fst, fst_data_);
+    index_out->write_vlong(fst_data_.size());
+    index_out->write_bytes(fst_data_.c_str(), fst_data_.size());
+  } else {
+    output_buf isb(index_out.get()); // wrap stream to be OpenFST compliant
+    std::ostream os(&isb);
+    fst.Write(os, fst::FstWriteOptions());
+  }
 
   stack.clear();
   ++fields_count;
@@ -1679,13 +1747,15 @@ void field_reader::prepare(
   state.meta = &meta;
 
   // check index header 
-  index_input::ptr index_in;
+  auto& index_in = index_in_;
+  index_in.reset();
 
   int64_t checksum = 0;
 
-  detail::prepare_input(
+  // terms index is kept open since FSTs are loaded lazily
+  const auto version = detail::prepare_input(
     str, index_in,
-    irs::IOAdvice::SEQUENTIAL | irs::IOAdvice::READONCE, state,
+    irs::IOAdvice::NORMAL, state,
     field_writer::TERMS_INDEX_EXT,
     field_writer::FORMAT_TERMS_INDEX,
     field_writer::FORMAT_MIN,
@@ -1722,7 +1792,7 @@ void field_reader::prepare(
     fields_.emplace_back();
     auto& field = fields_.back();
 
-    field.prepare(input, feature_map, *this);
+    field.prepare(input, feature_map, version, *this);
 
     const auto& name = field.meta().name;
     const auto res = name_to_field_.emplace(
@@ -24,7 +24,9 @@
 #ifndef IRESEARCH_FORMAT_BURST_TRIE_H
 #define IRESEARCH_FORMAT_BURST_TRIE_H
 
+#include <atomic>
 #include <list>
+#include <mutex>
 
 #include "formats.hpp"
 #include "formats_10_attributes.hpp"
@@ -34,6 +36,7 @@
 #include "store/memory_directory.hpp"
 #include "store/store_utils.hpp"
 #include "utils/buffers.hpp"
+#include "utils/compact_fst.hpp"
 #include "utils/hash_utils.hpp"
 #include "utils/memory.hpp"
 
@@ -240,6 +243,7 @@ class term_reader : public irs::term_reader,
   void prepare(
     std::istream& in,
     const feature_map_t& features,
+    int32_t version,
     field_reader& owner
   );
 
@@ -257,6 +261,9 @@ class term_reader : public irs::term_reader,
   typedef fst::VectorFst<byte_arc> fst_t;
   friend class term_iterator;
 
+  // returns FST of the field, loads it on first access
+  const compact_fst& fst() const;
+
   irs::attribute_view attrs_;
   bstring min_term_;
   bstring max_term_;
@@ -268,7 +275,11 @@ class term_reader : public irs::term_reader,
   uint64_t term_freq_;
   frequency freq_; // total term freq
   field_meta field_;
-  fst_t* fst_; // TODO: use compact fst here!!!
+  mutable compact_fst fst_; // valid only if 'fst_loaded_' is set
+  mutable bstring fst_buf_; // FST data if terms index isn't addressable
+  mutable std::atomic<bool> fst_loaded_{ false };
+  uint64_t fst_offset_{}; // FST offset in terms index
+  uint64_t fst_size_{}; // FST size in bytes
   field_reader* owner_;
 }; // term_reader
 
@@ -280,7 +291,8 @@ NS_END // detail
 class field_writer final : public irs::field_writer {
  public:
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_COMPACT_FST = 1; // FST stored in compact form
+  static const int32_t FORMAT_MAX = FORMAT_COMPACT_FST;
   static const uint32_t DEFAULT_MIN_BLOCK_SIZE = 25;
   static const uint32_t DEFAULT_MAX_BLOCK_SIZE = 48;
 
@@ -292,7 +304,8 @@ class field_writer final : public irs::field_writer {
   field_writer(irs::postings_writer::ptr&& pw,
                bool volatile_state,
                uint32_t min_block_size = DEFAULT_MIN_BLOCK_SIZE,
-               uint32_t max_block_size = DEFAULT_MAX_BLOCK_SIZE);
+               uint32_t max_block_size = DEFAULT_MAX_BLOCK_SIZE,
+               int32_t version = FORMAT_MAX);
 
   virtual void prepare( const irs::flush_state& state ) override;
   virtual void end() override;
@@ -345,6 +358,7 @@ class field_writer final : public irs::field_writer {
   irs::postings_writer::ptr pw; /* postings writer */
   std::vector< detail::entry > stack;
   std::unique_ptr<detail::fst_buffer> fst_buf_; // pimpl buffer used for building FST for fields
+  bstring fst_data_; // buffer used for compiling FST for fields
   detail::volatile_byte_ref last_term; // last pushed term
   std::vector<size_t> prefixes;
   std::pair<bool, detail::volatile_byte_ref> min_term; // current min term in a block
@@ -353,6 +367,7 @@ class field_writer final : public irs::field_writer {
   size_t fields_count{};
   uint32_t min_block_size;
   uint32_t max_block_size;
+  int32_t version_;
   const bool volatile_state_;
 }; // field_writer
 
@@ -375,12 +390,15 @@ class field_reader final : public irs::field_reader {
 
  private:
   friend class detail::term_iterator;
+  friend class detail::term_reader;
 
   std::vector<detail::term_reader> fields_;
   std::unordered_map<hashed_string_ref, term_reader*> name_to_field_;
   std::vector<const detail::term_reader*> fields_mask_;
   irs::postings_reader::ptr pr_;
   irs::index_input::ptr terms_in_;
+  irs::index_input::ptr index_in_; // FSTs are lazily loaded from here
+  std::mutex fst_mutex_; // guards lazy FST loading
 }; // field_reader
 
 NS_END // burst_trie
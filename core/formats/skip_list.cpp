@@ -361,6 +361,34 @@ void skip_reader::load_level(levels_t& levels, index_input::ptr&& stream, size_t
   levels.emplace_back(std::move(stream), step, begin, end); // load level
 }
 
+/*static*/ void skip_reader::visit(index_input& in, const visit_f& visitor) {
+  // read number of levels in a skip-list
+  size_t max_levels = in.read_vint();
+
+  if (!max_levels) {
+    return;
+  }
+
+  // skip levels from n down to 1
+  while (--max_levels) {
+    const auto length = in.read_vlong();
+    in.seek(in.file_pointer() + length);
+  }
+
+  // visit 0 level
+  const auto length = in.read_vlong();
+
+  if (!length) {
+    throw index_error("while visiting level, error: zero length");
+  }
+
+  const auto end = in.file_pointer() + length;
+
+  while (in.file_pointer() < end) {
+    visitor(in);
+  }
+}
+
 void skip_reader::prepare(index_input::ptr&& in, const read_f& read /* = nop */) {
   assert(in && read);
 
@@ -143,6 +143,19 @@ class IRESEARCH_API skip_reader: util::noncopyable {
   //////////////////////////////////////////////////////////////////////////////
   typedef std::function<doc_id_t(size_t, index_input&)> read_f;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief function will be called for every skip of the 0 level
+  /// @param stream where level data resides
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<void(index_input&)> visit_f;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief reads all skips of the 0 level of a skip-list in order
+  /// @param in source data stream positioned at the beginning of a skip-list
+  /// @param visitor visit function
+  //////////////////////////////////////////////////////////////////////////////
+  static void visit(index_input& in, const visit_f& visitor);
+
   //////////////////////////////////////////////////////////////////////////////
   /// @brief constructor
   /// @param skip_0 skip interval for level 0
@@ -263,14 +263,20 @@ class doc_iterator : public irs::doc_iterator {
 class term_iterator : public irs::term_iterator {
  public:
   void reset(const field_data& field, const bytes_ref*& min, const bytes_ref*& max) {
-    // refill postings
+    // refill postings, sort entries of the term hash by term
     postings_.clear();
-    postings_.insert(field.terms_.begin(), field.terms_.end());
+    postings_.reserve(field.terms_.size());
+
+    for (auto& entry : field.terms_) {
+      postings_.emplace_back(&entry);
+    }
+
+    std::sort(postings_.begin(), postings_.end(), utf8_less_t());
 
     max = min = &irs::bytes_ref::NIL;
     if (!postings_.empty()) {
-      min = &(postings_.begin()->first);
-      max = &((--postings_.end())->first);
+      min = &(postings_.front()->first);
+      max = &(postings_.back()->first);
     }
 
     // set field
@@ -298,7 +304,7 @@ class term_iterator : public irs::term_iterator {
     REGISTER_TIMER_DETAILED();
     assert(itr_ != postings_.end());
 
-    const irs::posting& posting = itr_->second;
+    const irs::posting& posting = (*itr_)->second;
 
     // where the term's data starts
     auto ptr = field_->int_writer_->parent().seek(posting.int_start);
@@ -330,7 +336,7 @@ class term_iterator : public irs::term_iterator {
     }
 
     itr_increment_ = true;
-    term_ = itr_->first;
+    term_ = (*itr_)->first;
 
     return true;
   }
@@ -341,16 +347,17 @@ class term_iterator : public irs::term_iterator {
 
  private:
   struct utf8_less_t {
-    bool operator()(const bytes_ref& lhs, const bytes_ref& rhs) const {
-      return utf8_less(lhs.c_str(), lhs.size(), rhs.c_str(), rhs.size());
+    bool operator()(
+        const postings::value_type* lhs,
+        const postings::value_type* rhs) const {
+      return utf8_less(
+        lhs->first.c_str(), lhs->first.size(),
+        rhs->first.c_str(), rhs->first.size()
+      );
     }
   };
 
-  typedef std::map<
-    bytes_ref,
-    std::reference_wrapper<const posting>,
-    utf8_less_t
-  > map_t;
+  typedef std::vector<const postings::value_type*> map_t;
 
   map_t postings_;
   map_t::iterator itr_{ postings_.end() };
@@ -473,7 +480,7 @@ void field_data::init(doc_id_t doc_id) {
 
 data_output& field_data::norms(columnstore_writer& writer) {
   if (!norms_) {
-    auto handle = writer.push_column();
+    auto handle = writer.push_column(column_codec::NONE); // tiny values accessed on every score
     norms_ = std::move(handle.second);
     meta_.norm = handle.first;
   }
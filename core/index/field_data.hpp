@@ -81,6 +81,12 @@ class IRESEARCH_API field_data : util::noncopyable {
 
   bool invert(token_stream& tokens, const flags& features, doc_id_t id);
 
+  // returns approximate amount of memory in-use by the term table
+  size_t memory_active() const NOEXCEPT { return terms_.memory_active(); }
+
+  // returns approximate amount of memory reserved by the term table
+  size_t memory_reserved() const NOEXCEPT { return terms_.memory_reserved(); }
+
  private:
   friend class detail::term_iterator;
   friend class detail::doc_iterator;
@@ -128,16 +134,28 @@ class IRESEARCH_API fields_data: util::noncopyable {
   /// @return approximate amount of memory actively in-use by this instance
   //////////////////////////////////////////////////////////////////////////////
   size_t memory_active() const NOEXCEPT {
-    return byte_writer_.pool_offset()
+    auto active = byte_writer_.pool_offset()
       + int_writer_.pool_offset() * sizeof(int_block_pool::value_type)
       + fields_.size() * sizeof(fields_map::value_type);
+
+    for (auto& entry: fields_) {
+      active += entry.second.memory_active();
+    }
+
+    return active;
   }
 
   //////////////////////////////////////////////////////////////////////////////
   /// @return approximate amount of memory reserved by this instance
   //////////////////////////////////////////////////////////////////////////////
   size_t memory_reserved() const NOEXCEPT {
-    return sizeof(fields_data) + byte_pool_.size() + int_pool_.size();
+    auto reserved = sizeof(fields_data) + byte_pool_.size() + int_pool_.size();
+
+    for (auto& entry: fields_) {
+      reserved += entry.second.memory_reserved();
+    }
+
+    return reserved;
   }
 
   size_t size() const { return fields_.size(); }
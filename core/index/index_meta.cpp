@@ -63,6 +63,7 @@ segment_meta::segment_meta(segment_meta&& rhs) NOEXCEPT
     codec(rhs.codec),
     size(rhs.size),
     version(rhs.version),
+    sort(std::move(rhs.sort)),
     column_store(rhs.column_store) {
   rhs.docs_count = 0;
   rhs.size = 0;
@@ -81,6 +82,7 @@ segment_meta& segment_meta::operator=(segment_meta&& rhs) NOEXCEPT {
     size = rhs.size;
     rhs.size = 0;
     version = rhs.version;
+    sort = std::move(rhs.sort);
     column_store = rhs.column_store;
   }
 
@@ -102,6 +104,7 @@ bool segment_meta::operator!=(const segment_meta& other) const NOEXCEPT {
     || live_docs_count != other.live_docs_count
     || codec != other.codec
     || size != other.size
+    || sort != other.sort
     || column_store != other.column_store
     || files != other.files
   ;
@@ -81,6 +81,7 @@ struct IRESEARCH_API segment_meta {
   format_ptr codec;
   size_t size{}; // size of a segment in bytes
   uint64_t version{};
+  std::string sort; // name of the column documents are ordered by (see index_writer::init_options::comparator), empty == insertion order
   bool column_store{};
 };
 
@@ -152,6 +152,10 @@ struct IRESEARCH_API sub_reader : index_reader {
   virtual const columnstore_reader::column_reader* column_reader(field_id field) const = 0;
 
   const columnstore_reader::column_reader* column_reader(const string_ref& field) const;
+
+  // returns name of the column documents are ordered by, empty == documents
+  // are in no particular order
+  virtual string_ref sort_column() const { return string_ref::NIL; }
 }; // sub_reader
 
 NS_END
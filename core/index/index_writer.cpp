@@ -36,6 +36,7 @@
 #include "utils/range.hpp"
 #include "index_writer.hpp"
 
+#include <exception>
 #include <list>
 #include <sstream>
 
@@ -46,6 +47,7 @@ typedef range<irs::index_writer::modification_context> modification_contexts_ref
 typedef range<irs::segment_writer::update_context> update_contexts_ref;
 
 const size_t NON_UPDATE_RECORD = irs::integer_traits<size_t>::const_max; // non-update
+const size_t DOCS_BATCH_SIZE = 128; // number of documents matched by a removal filter fetched at once
 
 struct flush_segment_context {
   const size_t doc_id_begin_; // starting doc_id to consider in 'segment.meta' (inclusive)
@@ -135,20 +137,24 @@ bool add_document_mask_modified_records(
       continue; // skip invalid iterators
     }
 
-    while (itr->next()) {
-      const auto doc_id = itr->value();
+    irs::doc_id_t docs[DOCS_BATCH_SIZE];
 
-      // if the indexed doc_id was insert()ed after the request for modification
-      // or the indexed doc_id was already masked then it should be skipped
-      if (modification.generation < min_modification_generation
-          || !docs_mask.insert(doc_id).second) {
-        continue; // the current modification query does not match any records
-      }
+    for (size_t count; (count = itr->next_batch(docs, nullptr, DOCS_BATCH_SIZE));) {
+      for (size_t i = 0; i < count; ++i) {
+        const auto doc_id = docs[i];
+
+        // if the indexed doc_id was insert()ed after the request for modification
+        // or the indexed doc_id was already masked then it should be skipped
+        if (modification.generation < min_modification_generation
+            || !docs_mask.insert(doc_id).second) {
+          continue; // the current modification query does not match any records
+        }
 
-      assert(meta.live_docs_count);
-      --meta.live_docs_count; // decrement count of live docs
-      modification.seen = true;
-      modified = true;
+        assert(meta.live_docs_count);
+        --meta.live_docs_count; // decrement count of live docs
+        modification.seen = true;
+        modified = true;
+      }
     }
   }
 
@@ -203,35 +209,39 @@ bool add_document_mask_modified_records(
       continue; // skip invalid iterators
     }
 
-    while (itr->next()) {
-      const auto doc_id = itr->value();
+    irs::doc_id_t docs[DOCS_BATCH_SIZE];
 
-      if (doc_id < ctx.doc_id_begin_ || doc_id >= ctx.doc_id_end_) {
-        continue; // doc_id is not part of the current flush_context
-      }
+    for (size_t count; (count = itr->next_batch(docs, nullptr, DOCS_BATCH_SIZE));) {
+      for (size_t i = 0; i < count; ++i) {
+        const auto doc_id = docs[i];
 
-      auto& doc_ctx = ctx.update_contexts_[doc_id - doc_limits::min()]; // valid because of asserts above
+        if (doc_id < ctx.doc_id_begin_ || doc_id >= ctx.doc_id_end_) {
+          continue; // doc_id is not part of the current flush_context
+        }
 
-      // if the indexed doc_id was insert()ed after the request for modification
-      // or the indexed doc_id was already masked then it should be skipped
-      if (modification.generation < doc_ctx.generation
-          || !ctx.docs_mask_.insert(doc_id).second) {
-        continue; // the current modification query does not match any records
-      }
+        auto& doc_ctx = ctx.update_contexts_[doc_id - doc_limits::min()]; // valid because of asserts above
 
-      // if an update modification and update-value record whose query was not
-      // seen (i.e. replacement value whose filter did not match any documents)
-      // for every update request a replacement 'update-value' is optimistically inserted
-      if (modification.update
-          && doc_ctx.update_id != NON_UPDATE_RECORD
-          && !ctx.modification_contexts_[doc_ctx.update_id].seen) {
-        continue; // the current modification matched a replacement document which in turn did not match any records
-      }
+        // if the indexed doc_id was insert()ed after the request for modification
+        // or the indexed doc_id was already masked then it should be skipped
+        if (modification.generation < doc_ctx.generation
+            || !ctx.docs_mask_.insert(doc_id).second) {
+          continue; // the current modification query does not match any records
+        }
+
+        // if an update modification and update-value record whose query was not
+        // seen (i.e. replacement value whose filter did not match any documents)
+        // for every update request a replacement 'update-value' is optimistically inserted
+        if (modification.update
+            && doc_ctx.update_id != NON_UPDATE_RECORD
+            && !ctx.modification_contexts_[doc_ctx.update_id].seen) {
+          continue; // the current modification matched a replacement document which in turn did not match any records
+        }
 
-      assert(ctx.segment_.meta.live_docs_count);
-      --ctx.segment_.meta.live_docs_count; // decrement count of live docs
-      modification.seen = true;
-      modified = true;
+        assert(ctx.segment_.meta.live_docs_count);
+        --ctx.segment_.meta.live_docs_count; // decrement count of live docs
+        modification.seen = true;
+        modified = true;
+      }
     }
   }
 
@@ -607,6 +617,92 @@ index_writer::documents_context::document::~document() NOEXCEPT {
   }
 }
 
+index_writer::documents_context::batch::batch(
+    documents_context& docs,
+    size_t count
+) {
+  assert(count);
+  auto ctx = docs.update_segment(); // segment limits are checked once per batch
+  assert(docs.segment_.ctx());
+  assert(docs.segment_.ctx()->writer_);
+
+  ctx_ = ctx.get();
+  segment_ = docs.segment_.ctx();
+  update_ = segment_->make_update_context(); // same for every insertion
+  ++segment_->active_count_;
+
+  auto& writer = *(segment_->writer_);
+  auto segment_docs_max = docs.writer_.segment_limits_.segment_docs_max.load();
+  size_t docs_left = integer_traits<doc_id_t>::const_max
+    - std::min(size_t(integer_traits<doc_id_t>::const_max), writer.docs_cached() + doc_limits::min());
+
+  if (segment_docs_max && segment_docs_max > writer.docs_cached()) {
+    docs_left = std::min(docs_left, segment_docs_max - writer.docs_cached());
+  }
+
+  size_ = std::min(count, std::max(docs_left, size_t(1))); // at least a single document as per insert()
+
+  uncomitted_doc_id_begin_ =
+    segment_->uncomitted_doc_id_begin_ > segment_->flushed_update_contexts_.size()
+    ? (segment_->uncomitted_doc_id_begin_ - segment_->flushed_update_contexts_.size()) // uncomitted start in 'writer_'
+    : doc_limits::min() // uncommited start in 'flushed_'
+    ;
+  assert(uncomitted_doc_id_begin_ <= writer.docs_cached() + doc_limits::min());
+
+  try {
+    writer.reserve(
+      size_,
+      writer.docs_cached() + doc_limits::min() - uncomitted_doc_id_begin_ // ensure reset() will be noexcept
+    );
+  } catch (...) {
+    --segment_->active_count_;
+    throw;
+  }
+}
+
+index_writer::documents_context::batch::~batch() NOEXCEPT {
+  segment_->buffered_docs_.store(segment_->writer_->docs_cached());
+
+  // optimization to notify any ongoing flush_all() operations so they wake up earlier
+  if (!--segment_->active_count_) {
+    TRY_SCOPED_LOCK_NAMED(ctx_->mutex_, lock); // lock due to context modification and notification, note: std::mutex::try_lock() does not throw exceptions as per documentation @see https://en.cppreference.com/w/cpp/named_req/Mutex
+
+    if (lock.owns_lock()) {
+      ctx_->pending_segment_context_cond_.notify_all(); // ignore if lock failed because it imples that flush_all() is not waiting for a notification
+    }
+  }
+}
+
+segment_writer& index_writer::documents_context::batch::begin() {
+  auto& writer = *(segment_->writer_);
+
+  assert(uncomitted_doc_id_begin_ <= writer.docs_cached() + doc_limits::min());
+  writer.begin(
+    update_,
+    writer.docs_cached() + doc_limits::min() - uncomitted_doc_id_begin_ // already reserved by the constructor
+  );
+
+  return writer;
+}
+
+bool index_writer::documents_context::batch::commit() {
+  auto& writer = *(segment_->writer_);
+  const auto valid = writer.valid();
+
+  try {
+    writer.commit();
+  } catch (...) {
+    writer.rollback();
+    throw;
+  }
+
+  return valid;
+}
+
+void index_writer::documents_context::batch::rollback() NOEXCEPT {
+  segment_->writer_->rollback(); // implicitly NOEXCEPT since memory reserved by the constructor
+}
+
 index_writer::documents_context::~documents_context() NOEXCEPT {
   assert(segment_.ctx().use_count() == segment_use_count_); // failure may indicate a dangling 'document' instance
 
@@ -936,6 +1032,10 @@ index_writer::segment_context::segment_context(
 void index_writer::segment_context::flush() {
   SCOPED_LOCK(flush_mutex_); // prevent concurrent flush related modifications
 
+  flush_unsafe();
+}
+
+void index_writer::segment_context::flush_unsafe() {
   if (!writer_ || !writer_->initialized() || !writer_->docs_cached()) {
     return; // skip flushing an empty writer
   }
@@ -1090,6 +1190,9 @@ index_writer::index_writer(
     directory& dir,
     format::ptr codec,
     size_t segment_pool_size,
+    size_t flush_threads,
+    size_t merge_threads,
+    merge_writer::comparer&& comparator,
     const segment_options& segment_limits,
     index_meta&& meta,
     committed_state_t&& committed_state
@@ -1105,7 +1208,10 @@ index_writer::index_writer(
     segments_active_(0),
     writer_(codec->get_index_meta_writer()),
     write_lock_(std::move(lock)),
-    write_lock_file_ref_(std::move(lock_file_ref)) {
+    write_lock_file_ref_(std::move(lock_file_ref)),
+    flush_pool_(flush_threads, flush_threads), // keep threads between commits
+    merge_pool_(merge_threads, merge_threads), // keep threads between merges
+    comparator_(std::move(comparator)) {
   assert(codec);
   flush_context_.store(&flush_context_pool_[0]);
 
@@ -1239,6 +1345,9 @@ index_writer::ptr index_writer::make(
     dir,
     codec,
     opts.segment_pool_size,
+    opts.flush_threads,
+    opts.merge_threads,
+    merge_writer::comparer(opts.comparator),
     segment_options(opts),
     std::move(meta),
     std::move(comitted_state)
@@ -1382,7 +1491,7 @@ bool index_writer::consolidate(
   consolidation_segment.meta.name = file_name(meta_.increment()); // increment active meta, not fn arg
 
   ref_tracking_directory dir(dir_); // track references for new segment
-  merge_writer merger(dir);
+  merge_writer merger(dir, &comparator_);
   merger.reserve(candidates.size());
 
   // add consolidated segments to the merge_writer
@@ -1399,7 +1508,7 @@ bool index_writer::consolidate(
   }
 
   // we do not persist segment meta since some removals may come later
-  if (!merger.flush(consolidation_segment, progress)) {
+  if (!merger.flush(consolidation_segment, progress, &merge_pool_)) {
     return false; // nothing to consolidate or consolidation failure
   }
 
@@ -1556,14 +1665,14 @@ bool index_writer::import(
   segment.meta.name = file_name(meta_.increment());
   segment.meta.codec = codec;
 
-  merge_writer merger(dir);
+  merge_writer merger(dir, &comparator_);
   merger.reserve(reader.size());
 
   for (auto& segment : reader) {
     merger.add(segment);
   }
 
-  if (!merger.flush(segment, progress)) {
+  if (!merger.flush(segment, progress, &merge_pool_)) {
     return false; // import failure (no files created, nothing to clean up)
   }
 
@@ -1693,6 +1802,92 @@ index_writer::active_segment_context index_writer::get_segment_context(
   return active_segment_context(segment_ctx, segments_active_);
 }
 
+void index_writer::flush_segments(flush_context& ctx) {
+  REGISTER_TIMER_DETAILED();
+  auto& segments = ctx.pending_segment_contexts_;
+
+  if (!flush_pool_.max_threads() || segments.size() < 2) {
+    for (auto& entry: segments) {
+      entry.segment_->flush_unsafe(); // 'flush_mutex_' is held by flush_all()
+    }
+
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  size_t pending = segments.size();
+  std::exception_ptr error;
+
+  for (auto& entry: segments) {
+    auto& segment = *entry.segment_;
+
+    // 'flush_mutex_' is held by flush_all() until all flushes are finished
+    auto task = [&segment, &mutex, &cond, &pending, &error]() NOEXCEPT {
+      std::exception_ptr task_error;
+
+      try {
+        segment.flush_unsafe();
+      } catch (...) {
+        task_error = std::current_exception();
+      }
+
+      SCOPED_LOCK(mutex);
+
+      if (task_error && !error) {
+        error = std::move(task_error); // report the first failure
+      }
+
+      if (!--pending) {
+        cond.notify_all();
+      }
+    };
+
+    if (!flush_pool_.run(task)) {
+      task(); // pool isn't active, flush in the current thread
+    }
+  }
+
+  // wait for completion, tasks reference local variables
+  SCOPED_LOCK_NAMED(mutex, lock);
+  cond.wait(lock, [&pending]()->bool { return !pending; });
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+bool index_writer::sort_segment(
+    directory& dir,
+    index_meta::index_segment_t& segment) {
+  REGISTER_TIMER_DETAILED();
+  assert(comparator_);
+
+  // the ordered copy of the segment doesn't contain masked documents
+  index_meta::index_segment_t sorted_segment;
+  sorted_segment.meta.codec = segment.meta.codec;
+  sorted_segment.meta.name = file_name(meta_.increment());
+
+  auto reader = segment_reader::open(dir, segment.meta);
+  merge_writer merger(dir, &comparator_);
+
+  merger.add(static_cast<sub_reader::ptr>(reader));
+
+  if (!merger.flush(sorted_segment, {}, &merge_pool_)) {
+    IR_FRMT_WARN(
+      "Failed to order documents of segment '%s', committing it in insertion order",
+      segment.meta.name.c_str()
+    );
+
+    return false;
+  }
+
+  index_utils::flush_index_segment(dir, sorted_segment);
+  segment = std::move(sorted_segment);
+
+  return true;
+}
+
 index_writer::pending_context_t index_writer::flush_all() {
   REGISTER_TIMER_DETAILED();
   bool modified = !type_limits<type_t::index_gen_t>::valid(meta_.last_gen_);
@@ -1732,10 +1927,12 @@ index_writer::pending_context_t index_writer::flush_all() {
 
     // FIXME TODO flush_all() blocks flush_context::emplace(...) and insert()/remove()/replace()
     segment_flush_locks.emplace_back(entry.segment_->flush_mutex_); // prevent concurrent modification of segment_context properties during flush_context::emplace(...)
+  }
 
-    // force a flush of the underlying segment_writer
-    entry.segment_->flush();
+  // force a flush of the underlying segment_writers
+  flush_segments(*ctx);
 
+  for (auto& entry: ctx->pending_segment_contexts_) {
     entry.doc_id_end_ = // may be integer_traits<size_t>::const_max if segment_meta only in this flush_context
       std::min(entry.segment_->uncomitted_doc_id_begin_, entry.doc_id_end_); // update so that can use valid value below
     entry.modification_offset_end_ = std::min(
@@ -2084,6 +2281,14 @@ index_writer::pending_context_t index_writer::flush_all() {
         write_document_mask(
           dir, segment_ctx.segment_.meta, segment_ctx.docs_mask_
         );
+      }
+
+      // doc_ids of flushed segments follow insertion order until all
+      // removals are applied, i.e. the segment may be ordered only now
+      const bool sorted =
+        comparator_ && sort_segment(dir, segment_ctx.segment_);
+
+      if (!sorted && !segment_ctx.docs_mask_.empty()) {
         index_utils::flush_index_segment(dir, segment_ctx.segment_); // write with new mask
       }
 
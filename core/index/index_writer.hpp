@@ -42,6 +42,7 @@
 
 #include <cassert>
 #include <atomic>
+#include <iterator>
 
 NS_ROOT
 
@@ -197,6 +198,44 @@ class IRESEARCH_API index_writer:
       );
     }
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief insert a batch of documents, one per value of the range
+    ///        [begin;end), each filled by the specified functor
+    /// @param func the insertion logic, similar in signature to e.g.:
+    ///        std::function<void(segment_writer::document&, const Value&)>
+    /// @note segment acquisition, segment limits checks and space reservation
+    ///       for doc ids and rollback are done once per batch rather than once
+    ///       per document, i.e. a segment may exceed 'segment_memory_max' by
+    ///       at most a single batch
+    /// @note the changes are not visible until commit()
+    /// @return number of documents successfully inserted
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename Iterator, typename Func>
+    size_t insert(Iterator begin, Iterator end, Func func) {
+      size_t inserted = 0;
+
+      for (auto left = size_t(std::distance(begin, end)); left;) {
+        batch docs(*this, left); // may fit fewer documents than requested
+
+        for (auto count = docs.size(); count; --count, ++begin) {
+          segment_writer::document doc(docs.begin());
+
+          try {
+            func(doc, *begin);
+          } catch (...) {
+            docs.rollback();
+            throw;
+          }
+
+          inserted += size_t(docs.commit());
+        }
+
+        left -= docs.size();
+      }
+
+      return inserted;
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     /// @brief marks all documents matching the filter for removal
     /// @param filter the filter selecting which documents should be removed
@@ -343,6 +382,35 @@ class IRESEARCH_API index_writer:
     void reset() NOEXCEPT;
 
    private:
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief a sequence of document insertions into the same segment
+    ////////////////////////////////////////////////////////////////////////////
+    class IRESEARCH_API batch : private util::noncopyable {
+     public:
+      batch(documents_context& docs, size_t count);
+      ~batch() NOEXCEPT;
+
+      // @return number of documents the batch may hold
+      size_t size() const NOEXCEPT { return size_; }
+
+      // begin a document insertion
+      segment_writer& begin();
+
+      // finish a document insertion started by begin()
+      // @return the document was successfully inserted
+      bool commit();
+
+      // abort a document insertion started by begin()
+      void rollback() NOEXCEPT;
+
+     private:
+      flush_context* ctx_; // for notification upon completion
+      segment_context_ptr segment_; // hold reference to segment to prevent if from going back into the pool
+      segment_writer::update_context update_;
+      size_t size_;
+      size_t uncomitted_doc_id_begin_; // uncomitted start in 'segment_->writer_'
+    };
+
     active_segment_context segment_; // the segment_context used for storing changes (lazy-initialized)
     long segment_use_count_{0}; // segment_.ctx().use_count() at constructor/destructor time must equal
     index_writer& writer_;
@@ -424,6 +492,35 @@ class IRESEARCH_API index_writer:
     ////////////////////////////////////////////////////////////////////////////
     size_t segment_pool_size{128}; // arbitrary size
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief number of threads used for flushing segments in parallel during
+    ///        commit, i.e. commit latency doesn't grow with number of segments
+    ///        0 == flush segments sequentially in the committing thread
+    ////////////////////////////////////////////////////////////////////////////
+    size_t flush_threads{0};
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief number of threads shared by consolidations and imports for
+    ///        merging columns concurrently with each other and with field
+    ///        term data, kept separate from 'flush_threads' so that merges do
+    ///        not compete with ingestion
+    ///        0 == merge in the consolidating/importing thread only
+    /// @note field term data of a merge is written by the calling thread
+    ///       as a whole
+    ////////////////////////////////////////////////////////////////////////////
+    size_t merge_threads{0};
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief order of documents in committed segments, empty == insertion
+    ///        order for flushed segments and merge order for merged ones
+    /// @note segments flushed from inserted documents are ordered once they
+    ///       are committed, segments produced by consolidation and import
+    ///       are ordered by the merge
+    /// @note the order is recorded in segment meta, see
+    ///       'sub_reader::sort_column()'
+    ////////////////////////////////////////////////////////////////////////////
+    merge_writer::comparer comparator;
+
     init_options() {}; // GCC5 requires non-default definition
   };
 
@@ -767,6 +864,13 @@ class IRESEARCH_API index_writer:
     ////////////////////////////////////////////////////////////////////////////
     void flush();
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief same as flush() but does not acquire 'flush_mutex_'
+    /// @note caller must ensure 'flush_mutex_' is held for the whole call,
+    ///       possibly by another thread waiting for the call to finish
+    ////////////////////////////////////////////////////////////////////////////
+    void flush_unsafe();
+
     // returns context for "insert" operation
     segment_writer::update_context make_update_context();
 
@@ -966,12 +1070,17 @@ class IRESEARCH_API index_writer:
     directory& dir, 
     format::ptr codec,
     size_t segment_pool_size,
+    size_t flush_threads,
+    size_t merge_threads,
+    merge_writer::comparer&& comparator,
     const segment_options& segment_limits,
     index_meta&& meta, 
     committed_state_t&& committed_state
   ) NOEXCEPT;
 
   pending_context_t flush_all();
+  void flush_segments(flush_context& ctx); // flush segment_writers of 'ctx'
+  bool sort_segment(directory& dir, index_meta::index_segment_t& segment); // order documents of a flushed segment by 'comparator_'
 
   flush_context_ptr get_flush_context(bool shared = true);
   active_segment_context get_segment_context(flush_context& ctx); // return a usable segment or a nullptr segment if retry is required (e.g. no free segments available)
@@ -998,6 +1107,9 @@ class IRESEARCH_API index_writer:
   index_meta_writer::ptr writer_;
   index_lock::ptr write_lock_; // exclusive write lock for directory
   index_file_refs::ref_t write_lock_file_ref_; // track ref for lock file to preven removal
+  async_utils::thread_pool flush_pool_; // pool for parallel segment flushes, guarded by commit_lock_
+  async_utils::thread_pool merge_pool_; // pool for concurrent column merges of consolidation/import
+  merge_writer::comparer comparator_; // order of documents in committed segments
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // index_writer
 
@@ -70,6 +70,19 @@ struct IRESEARCH_API doc_iterator
   /// (for more information see class description)
   //////////////////////////////////////////////////////////////////////////////
   virtual doc_id_t seek(doc_id_t target) = 0;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief advances iterator by up to 'size' documents at once
+  /// @param docs buffer of at least 'size' elements receiving document ids
+  /// @param freqs nullptr or a buffer of at least 'size' elements receiving
+  ///        term frequencies of the documents, its content is unspecified if
+  ///        the iterator doesn't expose the 'frequency' attribute
+  /// @returns number of documents read, 0 if the iterator is exhausted
+  /// @note after the call 'value()' returns the last document read or 'eof'
+  ///       if the iterator got exhausted, the other attributes of the iterator
+  ///       are unspecified
+  //////////////////////////////////////////////////////////////////////////////
+  virtual size_t next_batch(doc_id_t* docs, uint32_t* freqs, size_t size);
 }; // doc_iterator
 
 // ----------------------------------------------------------------------------
@@ -21,10 +21,14 @@
 /// @author Vasiliy Nabatchikov
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 #include <unordered_map>
 
 #include "merge_writer.hpp"
+#include "analysis/token_attributes.hpp"
 #include "index/field_meta.hpp"
 #include "index/index_meta.hpp"
 #include "index/segment_reader.hpp"
@@ -46,6 +50,39 @@ typedef std::vector<irs::doc_id_t> doc_id_map_t;
 // document mapping function
 typedef std::function<irs::doc_id_t(irs::doc_id_t)> doc_map_f;
 
+//////////////////////////////////////////////////////////////////////////////
+/// @brief document mapping of a merged reader, doc_ids of a reader without
+///        removals are shifted by a constant 'base' (bulk path) and bypass
+///        the generic mapping function
+//////////////////////////////////////////////////////////////////////////////
+struct doc_map_t {
+  doc_map_t() = default;
+
+  explicit doc_map_t(const doc_map_f& func) NOEXCEPT
+    : func(&func) {
+  }
+
+  explicit doc_map_t(irs::doc_id_t base) NOEXCEPT
+    : base(base) {
+  }
+
+  // true if doc_ids are mapped by 'base' offset only
+  bool bulk() const NOEXCEPT {
+    return !func;
+  }
+
+  irs::doc_id_t operator()(irs::doc_id_t doc) const {
+    return func ? (*func)(doc) : base + doc;
+  }
+
+  const doc_map_f* func{};
+  irs::doc_id_t base{};
+}; // doc_map_t
+
+// documents of a sorted merge in order of the new doc_ids,
+// i.e. (index of a reader, doc_id within the reader)
+typedef std::vector<std::pair<uint32_t, irs::doc_id_t>> doc_order_t;
+
 // mapping of old field_id to new field_id
 typedef std::vector<irs::field_id> id_map_t;
 
@@ -250,7 +287,7 @@ struct compound_doc_iterator : public irs::doc_iterator {
     return !static_cast<bool>(progress_);
   }
 
-  void add(irs::doc_iterator::ptr&& postings, const doc_map_f& doc_map) {
+  void add(irs::doc_iterator::ptr&& postings, const doc_map_t& doc_map) {
     if (iterators.empty()) {
       attrs.set(postings->attributes()); // add keys and set values
     } else {
@@ -275,7 +312,7 @@ struct compound_doc_iterator : public irs::doc_iterator {
     return current_id;
   }
 
-  typedef std::pair<irs::doc_iterator::ptr, const doc_map_f*> doc_iterator_t;
+  typedef std::pair<irs::doc_iterator::ptr, const doc_map_t*> doc_iterator_t;
 
   compound_attributes attrs;
   std::vector<doc_iterator_t> iterators;
@@ -310,6 +347,17 @@ bool compound_doc_iterator::next() {
       attrs.set(itr->attributes());
     }
 
+    if (id_map->bulk()) {
+      // reader has no removals, doc_ids are shifted by a constant
+      if (itr->next()) {
+        current_id = id_map->base + itr->value();
+        return true;
+      }
+
+      itr.reset();
+      continue;
+    }
+
     while (itr->next()) {
       current_id = (*id_map)(itr->value());
 
@@ -329,6 +377,206 @@ bool compound_doc_iterator::next() {
   return false;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class sorting_doc_iterator
+/// @brief reads documents of a term over all readers into memory and replays
+///        them in order of the mapped doc_ids, required for sorted merges
+///        where doc_ids of a reader aren't mapped monotonically
+/// @note only postings of the current term are buffered, buffers grown by
+///       a frequent term are released once the next term is read
+//////////////////////////////////////////////////////////////////////////////
+class sorting_doc_iterator : public irs::doc_iterator {
+ public:
+  sorting_doc_iterator() : pos_(*this) { }
+
+  // reads all documents of the specified iterator
+  void reset(irs::doc_iterator& it, const irs::flags& features);
+
+  virtual const irs::attribute_view& attributes() const NOEXCEPT override {
+    return attrs_;
+  }
+
+  virtual bool next() override {
+    if (next_ == docs_.size()) {
+      doc_ = irs::type_limits<irs::type_t::doc_id_t>::eof();
+      return false;
+    }
+
+    auto& entry = docs_[next_++];
+    doc_ = entry.doc;
+    freq_.value = entry.freq;
+    pos_.reset(entry.pos_begin, entry.pos_end);
+    return true;
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    irs::seek(*this, target);
+    return value();
+  }
+
+  virtual irs::doc_id_t value() const override {
+    return doc_;
+  }
+
+ private:
+  struct doc_entry {
+    irs::doc_id_t doc;
+    uint32_t freq;
+    size_t pos_begin; // offset of the first position in 'positions_'
+    size_t pos_end;
+  }; // doc_entry
+
+  struct pos_entry {
+    uint32_t value;
+    uint32_t start; // offset start
+    uint32_t end; // offset end
+    size_t pay_begin; // offset of the payload in 'payloads_'
+    size_t pay_size;
+  }; // pos_entry
+
+  class position final : public irs::position {
+   public:
+    explicit position(const sorting_doc_iterator& owner)
+      : irs::position(2), owner_(&owner) {
+    }
+
+    void prepare(bool offs, bool pay) {
+      attrs_.clear();
+
+      if (offs) {
+        attrs_.emplace(offs_);
+      }
+
+      if (pay) {
+        attrs_.emplace(pay_);
+      }
+    }
+
+    void reset(size_t begin, size_t end) NOEXCEPT {
+      next_ = begin;
+      end_ = end;
+      value_ = irs::type_limits<irs::type_t::pos_t>::invalid();
+    }
+
+    virtual void clear() override {
+      next_ = end_;
+      value_ = irs::type_limits<irs::type_t::pos_t>::invalid();
+    }
+
+    virtual bool next() override {
+      if (next_ == end_) {
+        value_ = irs::type_limits<irs::type_t::pos_t>::eof();
+        return false;
+      }
+
+      auto& entry = owner_->positions_[next_++];
+      value_ = entry.value;
+      offs_.start = entry.start;
+      offs_.end = entry.end;
+      pay_.value = irs::bytes_ref(
+        owner_->payloads_.c_str() + entry.pay_begin, entry.pay_size
+      );
+      return true;
+    }
+
+    virtual value_t value() const override {
+      return value_;
+    }
+
+   private:
+    const sorting_doc_iterator* owner_;
+    irs::offset offs_;
+    irs::payload pay_;
+    size_t next_{};
+    size_t end_{};
+    value_t value_{ irs::type_limits<irs::type_t::pos_t>::invalid() };
+  }; // position
+
+  irs::attribute_view attrs_;
+  irs::frequency freq_;
+  position pos_;
+  std::vector<doc_entry> docs_;
+  std::vector<pos_entry> positions_;
+  irs::bstring payloads_;
+  size_t next_{};
+  irs::doc_id_t doc_{ irs::type_limits<irs::type_t::doc_id_t>::invalid() };
+}; // sorting_doc_iterator
+
+void sorting_doc_iterator::reset(
+    irs::doc_iterator& it,
+    const irs::flags& features) {
+  // arbitrary number of buffered entries retained between terms
+  static const size_t MAX_RETAINED_ENTRIES = size_t(1) << 16;
+
+  if (docs_.capacity() > MAX_RETAINED_ENTRIES
+      || positions_.capacity() > MAX_RETAINED_ENTRIES) {
+    // release buffers of a frequent term
+    decltype(docs_)().swap(docs_);
+    decltype(positions_)().swap(positions_);
+    irs::bstring().swap(payloads_);
+  }
+
+  docs_.clear();
+  positions_.clear();
+  payloads_.clear();
+  attrs_.clear();
+  next_ = 0;
+  doc_ = irs::type_limits<irs::type_t::doc_id_t>::invalid();
+
+  auto& freq = it.attributes().get<irs::frequency>();
+  auto& pos = freq
+    ? it.attributes().get<irs::position>()
+    : irs::attribute_view::ref<irs::position>::NIL;
+  const bool has_offs = features.check<irs::offset>();
+  const bool has_pay = features.check<irs::payload>();
+
+  if (freq) {
+    attrs_.emplace(freq_);
+  }
+
+  if (pos) {
+    pos_.prepare(has_offs, has_pay);
+    attrs_.emplace(pos_);
+  }
+
+  while (it.next()) {
+    const auto pos_begin = positions_.size();
+
+    if (pos) {
+      // attributes of positions may change with a segment
+      auto& attrs = pos->attributes();
+      const auto* offs = has_offs ? attrs.get<irs::offset>().get() : nullptr;
+      const auto* pay = has_pay ? attrs.get<irs::payload>().get() : nullptr;
+
+      while (pos->next()) {
+        pos_entry entry{ pos->value(), 0, 0, payloads_.size(), 0 };
+
+        if (offs) {
+          entry.start = offs->start;
+          entry.end = offs->end;
+        }
+
+        if (pay) {
+          payloads_.append(pay->value.c_str(), pay->value.size());
+          entry.pay_size = pay->value.size();
+        }
+
+        positions_.emplace_back(entry);
+      }
+    }
+
+    docs_.emplace_back(doc_entry{
+      it.value(), freq ? freq->value : 0, pos_begin, positions_.size()
+    });
+  }
+
+  std::sort(
+    docs_.begin(), docs_.end(),
+    [](const doc_entry& lhs, const doc_entry& rhs) {
+      return lhs.doc < rhs.doc;
+  });
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @struct compound_iterator
 //////////////////////////////////////////////////////////////////////////////
@@ -340,7 +588,7 @@ class compound_iterator {
   size_t size() const { return iterators_.size(); }
 
   void add(const irs::sub_reader& reader,
-           const doc_map_f& doc_map) {
+           const doc_map_t& doc_map) {
     iterator_mask_.emplace_back(iterators_.size());
     iterators_.emplace_back(reader.columns(), reader, doc_map);
   }
@@ -411,7 +659,7 @@ class compound_iterator {
     iterator_t(
         Iterator&& it,
         const irs::sub_reader& reader,
-        const doc_map_f& doc_map)
+        const doc_map_t& doc_map)
       : it(std::move(it)),
         reader(&reader), 
         doc_map(&doc_map) {
@@ -425,7 +673,7 @@ class compound_iterator {
 
     Iterator it;
     const irs::sub_reader* reader;
-    const doc_map_f* doc_map;
+    const doc_map_t* doc_map;
   };
 
   const value_type* current_value_{};
@@ -442,9 +690,12 @@ class compound_term_iterator : public irs::term_iterator {
  public:
   static CONSTEXPR const size_t PROGRESS_STEP_TERMS = size_t(1) << 7;
 
-  explicit compound_term_iterator(const irs::merge_writer::flush_progress_t& progress)
+  compound_term_iterator(
+      const irs::merge_writer::flush_progress_t& progress,
+      bool sorted)
     : doc_itr_(progress),
-      progress_(progress, PROGRESS_STEP_TERMS) {
+      progress_(progress, PROGRESS_STEP_TERMS),
+      sorted_(sorted) {
   }
 
   bool aborted() const {
@@ -459,7 +710,7 @@ class compound_term_iterator : public irs::term_iterator {
   }
 
   const irs::field_meta& meta() const NOEXCEPT { return *meta_; }
-  void add(const irs::term_reader& reader, const doc_map_f& doc_map);
+  void add(const irs::term_reader& reader, const doc_map_t& doc_map);
   virtual const irs::attribute_view& attributes() const NOEXCEPT override {
     // no way to merge attributes for the same term spread over multiple iterators
     // would require API change for attributes
@@ -481,11 +732,11 @@ class compound_term_iterator : public irs::term_iterator {
  private:
   struct term_iterator_t {
     irs::seek_term_iterator::ptr first;
-    const doc_map_f* second;
+    const doc_map_t* second;
 
     term_iterator_t(
       irs::seek_term_iterator::ptr&& term_itr,
-      const doc_map_f* doc_map
+      const doc_map_t* doc_map
     ): first(std::move(term_itr)), second(doc_map) {
     }
 
@@ -506,12 +757,14 @@ class compound_term_iterator : public irs::term_iterator {
   std::vector<size_t> term_iterator_mask_; // valid iterators for current term
   std::vector<term_iterator_t> term_iterators_; // all term iterators
   mutable compound_doc_iterator doc_itr_;
+  mutable sorting_doc_iterator sorting_doc_itr_;
   progress_tracker progress_;
+  bool sorted_; // doc_ids of a reader aren't mapped monotonically
 }; // compound_term_iterator
 
 void compound_term_iterator::add(
     const irs::term_reader& reader,
-    const doc_map_f& doc_id_map) {
+    const doc_map_t& doc_id_map) {
   term_iterator_mask_.emplace_back(term_iterators_.size()); // mark as used to trigger next()
   term_iterators_.emplace_back(reader.iterator(), &doc_id_map);
 }
@@ -570,6 +823,13 @@ irs::doc_iterator::ptr compound_term_iterator::postings(const irs::flags& /*feat
     doc_itr_.add(term_itr.first->postings(meta().features), *(term_itr.second));
   }
 
+  if (sorted_) {
+    sorting_doc_itr_.reset(doc_itr_, meta().features);
+
+    // aliasing constructor
+    return irs::doc_iterator::ptr(irs::doc_iterator::ptr(), &sorting_doc_itr_);
+  }
+
   // aliasing constructor
   return irs::doc_iterator::ptr(irs::doc_iterator::ptr(), &doc_itr_);
 }
@@ -582,12 +842,14 @@ class compound_field_iterator : public irs::basic_term_reader {
  public:
   static CONSTEXPR const size_t PROGRESS_STEP_FIELDS = size_t(1);
 
-  explicit compound_field_iterator(const irs::merge_writer::flush_progress_t& progress)
-    : term_itr_(progress),
+  compound_field_iterator(
+      const irs::merge_writer::flush_progress_t& progress,
+      bool sorted)
+    : term_itr_(progress, sorted),
       progress_(progress, PROGRESS_STEP_FIELDS) {
   }
 
-  void add(const irs::sub_reader& reader, const doc_map_f& doc_id_map);
+  void add(const irs::sub_reader& reader, const doc_map_t& doc_id_map);
   bool next();
   size_t size() const { return field_iterators_.size(); }
 
@@ -631,7 +893,7 @@ class compound_field_iterator : public irs::basic_term_reader {
     field_iterator_t(
         irs::field_iterator::ptr&& itr,
         const irs::sub_reader& reader,
-        const doc_map_f& doc_map)
+        const doc_map_t& doc_map)
       : itr(std::move(itr)),
         reader(&reader),
         doc_map(&doc_map) {
@@ -644,7 +906,7 @@ class compound_field_iterator : public irs::basic_term_reader {
 
     irs::field_iterator::ptr itr;
     const irs::sub_reader* reader;
-    const doc_map_f* doc_map;
+    const doc_map_t* doc_map;
   };
   struct term_iterator_t {
     size_t itr_id;
@@ -666,7 +928,7 @@ typedef compound_iterator<irs::column_iterator::ptr> compound_column_iterator_t;
 
 void compound_field_iterator::add(
     const irs::sub_reader& reader,
-    const doc_map_f& doc_id_map) {
+    const doc_map_t& doc_id_map) {
   field_iterator_mask_.emplace_back(term_iterator_t{
     field_iterators_.size(),
     nullptr,
@@ -791,22 +1053,47 @@ class columnstore {
  public:
   static CONSTEXPR const size_t PROGRESS_STEP_COLUMN = size_t(1) << 13;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param readers merged readers in order of 'order' reader indices
+  /// @param order documents of a sorted merge in order of the new doc_ids,
+  ///        nullptr == doc_ids of a reader are mapped monotonically
+  //////////////////////////////////////////////////////////////////////////////
   columnstore(
       irs::directory& dir,
       const irs::segment_meta& meta,
-      const irs::merge_writer::flush_progress_t& progress
-  ) : progress_(progress, PROGRESS_STEP_COLUMN) {
+      const irs::merge_writer::flush_progress_t& progress,
+      const std::vector<const irs::sub_reader*>& readers,
+      const doc_order_t* order
+  ) : progress_(progress, PROGRESS_STEP_COLUMN),
+      readers_(readers),
+      order_(order) {
     auto writer = meta.codec->get_columnstore_writer();
     writer->prepare(dir, meta);
 
     writer_ = std::move(writer);
+
+    if (order_) {
+      values_.resize(readers_.size());
+    }
+  }
+
+  // shares the columnstore writer of 'other', distinct instances may
+  // write their columns concurrently
+  columnstore(const columnstore& other)
+    : progress_(other.progress_),
+      writer_(other.writer_),
+      readers_(other.readers_),
+      order_(other.order_) {
+    if (order_) {
+      values_.resize(readers_.size());
+    }
   }
 
   // inserts live values from the specified 'column' and 'reader' into column
   bool insert(
       const irs::sub_reader& reader,
       irs::field_id column,
-      const doc_map_f& doc_map
+      const doc_map_t& doc_map
   ) {
     const auto* column_reader = reader.column_reader(column);
 
@@ -815,6 +1102,42 @@ class columnstore {
       return true;
     }
 
+    // merged column retains the codec of the first merged column, while
+    // nothing has been written the column may be recreated with another one
+    const auto codec = column_reader->codec();
+
+    if (!column_.second || (empty_ && codec != codec_)) {
+      column_ = writer_->push_column(codec);
+      codec_ = codec;
+    }
+
+    if (order_) {
+      // mapped doc_ids aren't monotonic, values are read in order of
+      // the new doc_ids by 'finish()'
+      const auto it = std::find(readers_.begin(), readers_.end(), &reader);
+      assert(it != readers_.end());
+      values_[size_t(std::distance(readers_.begin(), it))] = column_reader->values_cursor();
+
+      return true;
+    }
+
+    if (doc_map.bulk()) {
+      // reader has no removals, append values shifted by a constant
+      const auto base = doc_map.base;
+
+      return column_reader->visit(
+        [this, base](irs::doc_id_t doc, const irs::bytes_ref& in) {
+          if (!progress_()) {
+            // stop was requsted
+            return false;
+          }
+
+          empty_ = false;
+          column_.second(base + doc).write_bytes(in.c_str(), in.size());
+          return true;
+      });
+    }
+
     return column_reader->visit(
       [this, &doc_map](irs::doc_id_t doc, const irs::bytes_ref& in) {
         if (!progress_()) {
@@ -836,9 +1159,52 @@ class columnstore {
     });
   }
 
+  // writes values of the current column of a sorted merge in order of
+  // the new doc_ids, values are read from the merged columns one at a time
+  bool finish() {
+    if (!order_) {
+      return true;
+    }
+
+    auto clear_values = irs::make_finally([this]() NOEXCEPT {
+      for (auto& values : values_) {
+        values = nullptr;
+      }
+    });
+
+    if (std::none_of(
+          values_.begin(), values_.end(),
+          [](const irs::columnstore_reader::values_reader_f& values) {
+            return static_cast<bool>(values);
+        })) {
+      return true; // no merged columns
+    }
+
+    auto doc = irs::type_limits<irs::type_t::doc_id_t>::min();
+    irs::bytes_ref value;
+
+    for (auto& entry : *order_) {
+      if (!progress_()) {
+        // stop was requsted
+        return false;
+      }
+
+      auto& values = values_[entry.first];
+
+      if (values && values(entry.second, value)) {
+        empty_ = false;
+        column_.second(doc).write_bytes(value.c_str(), value.size());
+      }
+
+      ++doc;
+    }
+
+    return true;
+  }
+
   void reset() {
     if (!empty_) {
-      column_ = writer_->push_column();
+      column_ = irs::columnstore_writer::column_t(); // pushed lazily on insert
       empty_ = true;
     }
   }
@@ -861,6 +1227,10 @@ class columnstore {
   progress_tracker progress_;
   irs::columnstore_writer::ptr writer_;
   irs::columnstore_writer::column_t column_{};
+  irs::column_codec codec_{ irs::column_codec::LZ4 }; // codec of the current column
+  const std::vector<const irs::sub_reader*>& readers_;
+  const doc_order_t* order_; // documents of a sorted merge
+  std::vector<irs::columnstore_reader::values_reader_f> values_; // current column of each reader (sorted merge)
   bool empty_{ false };
 }; // columnstore
 
@@ -877,7 +1247,7 @@ bool write_columns(
 
   auto visitor = [&cs](
       const irs::sub_reader& segment,
-      const doc_map_f& doc_map,
+      const doc_map_t& doc_map,
       const irs::column_meta& column) {
     return cs.insert(segment, column.id, doc_map);
   };
@@ -895,6 +1265,10 @@ bool write_columns(
       return false; // failed to visit all values
     }
 
+    if (!cs.finish()) {
+      return false; // failed to write sorted values
+    }
+
     if (!cs.empty()) {
       cmw->write((*column_itr).name, cs.id());
     } 
@@ -906,31 +1280,107 @@ bool write_columns(
 }
 
 //////////////////////////////////////////////////////////////////////////////
-/// @brief write field term data
+/// @struct merged_column
+/// @brief a column of the merged segment along with the matching columns of
+///        the merged segments, a unit of work of a concurrent column merge
 //////////////////////////////////////////////////////////////////////////////
-bool write_fields(
-    columnstore& cs,
+struct merged_column {
+  struct source {
+    const irs::sub_reader* reader;
+    const doc_map_t* doc_map;
+    irs::field_id id; // column id within 'reader'
+  };
+
+  std::string name;
+  std::vector<source> sources;
+  irs::field_id id{ irs::type_limits<irs::type_t::field_id_t>::invalid() }; // invalid == no values were written
+}; // merged_column
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief collect columns of the merged segments in order of column names
+//////////////////////////////////////////////////////////////////////////////
+void collect_columns(
+    compound_column_iterator_t& column_itr,
+    std::vector<merged_column>& columns
+) {
+  REGISTER_TIMER_DETAILED();
+
+  auto visitor = [&columns](
+      const irs::sub_reader& segment,
+      const doc_map_t& doc_map,
+      const irs::column_meta& column) {
+    columns.back().sources.emplace_back(
+      merged_column::source{ &segment, &doc_map, column.id }
+    );
+    return true;
+  };
+
+  while (column_itr.next()) {
+    columns.emplace_back();
+    columns.back().name = (*column_itr).name;
+    column_itr.visit(visitor);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief write all survived values of the specified 'column' via 'cs'
+//////////////////////////////////////////////////////////////////////////////
+bool write_column(columnstore& cs, merged_column& column) {
+  cs.reset();
+
+  for (auto& source : column.sources) {
+    if (!cs.insert(*source.reader, source.id, *source.doc_map)) {
+      return false; // failed to visit all values
+    }
+  }
+
+  if (!cs.finish()) {
+    return false; // failed to write sorted values
+  }
+
+  if (!cs.empty()) {
+    column.id = cs.id();
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief write meta of the columns written by 'write_column(...)'
+//////////////////////////////////////////////////////////////////////////////
+void write_column_meta(
     irs::directory& dir,
     const irs::segment_meta& meta,
+    const std::vector<merged_column>& columns
+) {
+  auto cmw = meta.codec->get_column_meta_writer();
+
+  cmw->prepare(dir, meta);
+
+  for (auto& column : columns) {
+    if (irs::type_limits<irs::type_t::field_id_t>::valid(column.id)) {
+      cmw->write(column.name, column.id);
+    }
+  }
+
+  cmw->flush();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief write merged norms of every field into separate columns
+//////////////////////////////////////////////////////////////////////////////
+bool write_norms(
+    columnstore& cs,
     compound_field_iterator& field_itr,
-    const irs::flags& fields_features,
+    std::vector<irs::field_id>& norms,
     const irs::merge_writer::flush_progress_t& progress
 ) {
   REGISTER_TIMER_DETAILED();
   assert(cs);
 
-  irs::flush_state flush_state;
-  flush_state.dir = &dir;
-  flush_state.doc_count = meta.docs_count;
-  flush_state.features = &fields_features;
-  flush_state.name = meta.name;
-
-  auto fw = meta.codec->get_field_writer(true);
-  fw->prepare(flush_state);
-
   auto merge_norms = [&cs] (
       const irs::sub_reader& segment,
-      const doc_map_f& doc_map,
+      const doc_map_t& doc_map,
       const irs::field_meta& field) {
     // merge field norms if present
     if (irs::type_limits<irs::type_t::field_id_t>::valid(field.norm)
@@ -944,23 +1394,58 @@ bool write_fields(
   while (field_itr.next()) {
     cs.reset();
 
-    auto& field_meta = field_itr.meta();
-    auto& field_features = field_meta.features;
-
     // remap merge norms
     if (!progress() || !field_itr.visit(merge_norms)) {
       return false;
     }
 
+    if (!cs.finish()) {
+      return false; // failed to write sorted norms
+    }
+
+    norms.emplace_back(
+      cs.empty() ? irs::type_limits<irs::type_t::field_id_t>::invalid() : cs.id()
+    );
+  }
+
+  return !field_itr.aborted();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief write field term data
+/// @param norms merged norm columns in order of fields, see 'write_norms(...)'
+//////////////////////////////////////////////////////////////////////////////
+bool write_fields(
+    irs::directory& dir,
+    const irs::segment_meta& meta,
+    compound_field_iterator& field_itr,
+    const irs::flags& fields_features,
+    const std::vector<irs::field_id>& norms,
+    const irs::merge_writer::flush_progress_t& progress
+) {
+  REGISTER_TIMER_DETAILED();
+
+  irs::flush_state flush_state;
+  flush_state.dir = &dir;
+  flush_state.doc_count = meta.docs_count;
+  flush_state.features = &fields_features;
+  flush_state.name = meta.name;
+
+  auto fw = meta.codec->get_field_writer(true);
+  fw->prepare(flush_state);
+
+  for (size_t i = 0; field_itr.next(); ++i) {
+    if (!progress()) {
+      return false;
+    }
+
+    auto& field_meta = field_itr.meta();
+    assert(i < norms.size());
+
     // write field terms
     auto terms = field_itr.iterator();
 
-    fw->write(
-      field_meta.name,
-      cs.empty() ? irs::type_limits<irs::type_t::field_id_t>::invalid() : cs.id(),
-      field_features,
-      *terms
-    );
+    fw->write(field_meta.name, norms[i], field_meta.features, *terms);
   }
 
   fw->end();
@@ -1004,6 +1489,106 @@ irs::doc_id_t compute_doc_ids(
   return next_id;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @brief computes doc_id_map of every reader so that merged documents are
+///        ordered according to the specified comparer
+/// @param order [out] documents in order of the new doc_ids
+/// @returns next valid doc_id, invalid() on failure
+/// @note values of the sort column of all merged documents are kept in
+///       memory while ordering
+//////////////////////////////////////////////////////////////////////////////
+irs::doc_id_t compute_sorted_doc_ids(
+    std::vector<irs::merge_writer::reader_ctx>& readers,
+    const irs::merge_writer::comparer& comparer,
+    doc_order_t& order
+) NOEXCEPT {
+  REGISTER_TIMER_DETAILED();
+
+  struct doc_entry {
+    size_t reader; // index of a reader in 'readers'
+    irs::doc_id_t doc; // doc_id within the reader
+    size_t offset; // offset of the value in 'data'
+    size_t size; // size of the value, 'npos' for documents without a value
+  };
+
+  static const size_t npos = irs::integer_traits<size_t>::const_max;
+
+  std::vector<doc_entry> docs;
+  irs::bstring data;
+
+  try {
+    for (size_t i = 0, size = readers.size(); i < size; ++i) {
+      auto& reader = *readers[i].reader;
+      auto& doc_id_map = readers[i].doc_id_map;
+
+      doc_id_map.resize(
+        reader.docs_count() + irs::type_limits<irs::type_t::doc_id_t>::min(),
+        irs::type_limits<irs::type_t::doc_id_t>::eof()
+      );
+
+      const auto* column_meta = reader.column(comparer.column);
+      const auto* column = column_meta
+        ? reader.column_reader(column_meta->id)
+        : nullptr;
+      auto values = column
+        ? column->values_cursor()
+        : irs::columnstore_reader::empty_reader();
+      irs::bytes_ref value;
+
+      for (auto docs_itr = reader.docs_iterator(); docs_itr->next();) {
+        const auto doc = docs_itr->value();
+
+        if (values(doc, value)) {
+          docs.emplace_back(doc_entry{ i, doc, data.size(), value.size() });
+          data.append(value.c_str(), value.size());
+        } else {
+          docs.emplace_back(doc_entry{ i, doc, 0, npos });
+        }
+      }
+    }
+
+    std::stable_sort(
+      docs.begin(), docs.end(),
+      [&comparer, &data](const doc_entry& lhs, const doc_entry& rhs) {
+        if (npos == rhs.size) {
+          return npos != lhs.size; // documents without a value go last
+        }
+
+        return npos != lhs.size && comparer.less(
+          irs::bytes_ref(data.c_str() + lhs.offset, lhs.size),
+          irs::bytes_ref(data.c_str() + rhs.offset, rhs.size)
+        );
+    });
+  } catch (...) {
+    IR_FRMT_ERROR(
+      "Failed to order documents by column '%s' while merging segments",
+      comparer.column.c_str()
+    );
+    return irs::type_limits<irs::type_t::doc_id_t>::invalid();
+  }
+
+  data = irs::bstring(); // release values of the sort column
+
+  try {
+    order.reserve(docs.size());
+  } catch (...) {
+    IR_FRMT_ERROR(
+      "Failed to order documents by column '%s' while merging segments",
+      comparer.column.c_str()
+    );
+    return irs::type_limits<irs::type_t::doc_id_t>::invalid();
+  }
+
+  auto next_id = irs::type_limits<irs::type_t::doc_id_t>::min();
+
+  for (auto& entry : docs) {
+    readers[entry.reader].doc_id_map[entry.doc] = next_id++;
+    order.emplace_back(uint32_t(entry.reader), entry.doc);
+  }
+
+  return next_id;
+}
+
 NS_END // LOCAL
 
 NS_ROOT
@@ -1027,7 +1612,8 @@ merge_writer::operator bool() const NOEXCEPT {
 
 bool merge_writer::flush(
     index_meta::index_segment_t& segment,
-    const flush_progress_t& progress /*= {}*/
+    const flush_progress_t& progress /*= {}*/,
+    async_utils::thread_pool* pool /*= nullptr*/
 ) {
   REGISTER_TIMER_DETAILED();
 
@@ -1045,6 +1631,7 @@ bool merge_writer::flush(
     meta.name.clear();
     meta.files.clear();
     meta.column_store = false;
+    meta.sort.clear();
     meta.docs_count = 0;
     meta.live_docs_count = 0;
     meta.size = 0;
@@ -1052,25 +1639,66 @@ bool merge_writer::flush(
   });
 
   static const flush_progress_t progress_noop = []()->bool { return true; };
-  auto& progress_callback = progress ? progress : progress_noop;
+  const bool parallel = pool && pool->max_threads();
+  std::mutex progress_mutex;
+  std::atomic<bool> aborted(false); // one of the concurrent merges failed
+  const flush_progress_t progress_synchronized =
+    [&progress, &progress_mutex, &aborted]()->bool {
+      if (aborted) {
+        return false;
+      }
+
+      SCOPED_LOCK(progress_mutex);
+      return !progress || progress();
+  };
+  auto& progress_callback = parallel
+    ? progress_synchronized
+    : (progress ? progress : progress_noop);
+  const bool sorted = comparator_ != nullptr;
   field_meta_map_t field_meta_map;
-  compound_field_iterator fields_itr(progress_callback);
+  compound_field_iterator fields_itr(progress_callback, sorted);
+  compound_field_iterator norms_itr(progress_callback, sorted);
   compound_column_iterator_t columns_itr;
   irs::flags fields_features;
   doc_id_t base_id = type_limits<type_t::doc_id_t>::min(); // next valid doc_id
+  std::vector<doc_map_t> doc_maps(readers_.size()); // iterators keep pointers
+  std::vector<const sub_reader*> segments; // merged readers in order of 'order'
+  doc_order_t order; // documents in order of the new doc_ids (sorted merge)
+
+  segments.reserve(readers_.size());
 
-  // collect field meta and field term data
   for (auto& reader_ctx : readers_) {
+    segments.emplace_back(reader_ctx.reader.get());
+  }
+
+  if (sorted) {
+    base_id = compute_sorted_doc_ids(readers_, *comparator_, order);
+  }
+
+  // collect field meta and field term data
+  for (size_t i = 0, count = readers_.size(); i < count; ++i) {
+    auto& reader_ctx = readers_[i];
     auto& reader = *reader_ctx.reader;
+    auto& doc_map = doc_maps[i];
     const auto docs_count = reader.docs_count();
 
-    if (reader.live_docs_count() == docs_count) { // segment has no deletes
+    if (sorted) { // documents are mapped by 'compute_sorted_doc_ids(...)'
+      auto& doc_id_map = reader_ctx.doc_id_map;
+
+      reader_ctx.doc_map = [&doc_id_map](doc_id_t doc) NOEXCEPT {
+        return doc >= doc_id_map.size()
+          ? type_limits<type_t::doc_id_t>::eof()
+          : doc_id_map[doc];
+      };
+      doc_map = doc_map_t(reader_ctx.doc_map);
+    } else if (reader.live_docs_count() == docs_count) { // segment has no deletes
       const auto reader_base = base_id - type_limits<type_t::doc_id_t>::min();
       base_id += docs_count;
 
       reader_ctx.doc_map = [reader_base](doc_id_t doc) NOEXCEPT {
         return reader_base + doc;
       };
+      doc_map = doc_map_t(reader_base); // bulk path, no per-doc mapping
     } else { // segment has some deleted docs
       auto& doc_id_map = reader_ctx.doc_id_map;
       base_id = compute_doc_ids(doc_id_map , reader, base_id);
@@ -1080,6 +1708,7 @@ bool merge_writer::flush(
           ? type_limits<type_t::doc_id_t>::eof()
           : doc_id_map[doc];
       };
+      doc_map = doc_map_t(reader_ctx.doc_map);
     }
 
     if (!irs::type_limits<irs::type_t::doc_id_t>::valid(base_id)) {
@@ -1090,13 +1719,20 @@ bool merge_writer::flush(
       return false;
     }
 
-    fields_itr.add(reader, reader_ctx.doc_map);
-    columns_itr.add(reader, reader_ctx.doc_map);
+    fields_itr.add(reader, doc_map);
+    norms_itr.add(reader, doc_map);
+    columns_itr.add(reader, doc_map);
   }
 
   segment.meta.docs_count = base_id - type_limits<type_t::doc_id_t>::min(); // total number of doc_ids
   segment.meta.live_docs_count = segment.meta.docs_count; // all merged documents are live
 
+  if (sorted) {
+    segment.meta.sort = comparator_->column; // record order for readers
+  } else {
+    segment.meta.sort.clear(); // merged segments are in merge order
+  }
+
   if (!progress_callback()) {
     return false; // progress callback requested termination
   }
@@ -1106,7 +1742,9 @@ bool merge_writer::flush(
   //...........................................................................
   REGISTER_TIMER_DETAILED();
   tracking_directory track_dir(dir_); // track writer created files
-  columnstore cs(track_dir, segment.meta, progress_callback);
+  columnstore cs(
+    track_dir, segment.meta, progress_callback, segments, sorted ? &order : nullptr
+  );
 
   if (!cs) {
     return false; // flush failure
@@ -1116,8 +1754,10 @@ bool merge_writer::flush(
     return false; // progress callback requested termination
   }
 
-  // write columns
-  if (!write_columns(cs, track_dir, segment.meta, columns_itr, progress_callback)) {
+  // write norms, the field writer requires ids of the norm columns
+  std::vector<field_id> norms;
+
+  if (!write_norms(cs, norms_itr, norms, progress_callback)) {
     return false; // flush failure
   }
 
@@ -1125,9 +1765,128 @@ bool merge_writer::flush(
     return false; // progress callback requested termination
   }
 
-  // write field meta and field term data
-  if (!write_fields(cs, track_dir, segment.meta, fields_itr, fields_features, progress_callback)) {
-    return false; // flush failure
+  if (!parallel) {
+    // write columns
+    if (!write_columns(cs, track_dir, segment.meta, columns_itr, progress_callback)) {
+      return false; // flush failure
+    }
+
+    if (!progress_callback()) {
+      return false; // progress callback requested termination
+    }
+
+    // write field meta and field term data
+    if (!write_fields(track_dir, segment.meta, fields_itr, fields_features, norms, progress_callback)) {
+      return false; // flush failure
+    }
+  } else {
+    // every column is merged separately by tasks of the 'pool' and, once
+    // field term data is written, by the current thread, data blocks of
+    // concurrently merged columns are appended to the same columnstore,
+    // column meta is written in order of column names after all columns
+    // are merged
+    // field term data is written by the current thread as a whole, i.e.
+    // a merge of a segment dominated by term data is not sped up by the pool
+    std::vector<merged_column> columns;
+
+    collect_columns(columns_itr, columns);
+
+    std::atomic<size_t> next_column(0);
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t pending = 0; // number of scheduled tasks
+    bool columns_result = true;
+    std::exception_ptr error;
+
+    // merges columns until there are none left
+    auto merge_columns = [&]() NOEXCEPT {
+      std::exception_ptr task_error;
+      bool task_result = true;
+
+      try {
+        columnstore shard(cs);
+
+        for (auto i = next_column++;
+             task_result && i < columns.size();
+             i = next_column++) {
+          task_result = progress_callback() && write_column(shard, columns[i]);
+        }
+      } catch (...) {
+        task_error = std::current_exception();
+        task_result = false;
+      }
+
+      if (!task_result) {
+        aborted = true; // terminate other merges as early as possible
+      }
+
+      SCOPED_LOCK(mutex);
+      columns_result &= task_result;
+
+      if (task_error && !error) {
+        error = std::move(task_error);
+      }
+    };
+
+    auto task = [&]() NOEXCEPT {
+      merge_columns();
+
+      SCOPED_LOCK(mutex);
+      --pending;
+      cond.notify_all();
+    };
+
+    for (size_t i = 0, count = std::min(pool->max_threads(), columns.size());
+         i < count;
+         ++i) {
+      {
+        SCOPED_LOCK(mutex);
+        ++pending;
+      }
+
+      if (!pool->run(task)) {
+        // pool isn't active, remaining columns are merged by the current thread
+        SCOPED_LOCK(mutex);
+        --pending;
+        break;
+      }
+    }
+
+    bool fields_result = false;
+    std::exception_ptr fields_error;
+
+    try {
+      fields_result = write_fields(
+        track_dir, segment.meta, fields_itr, fields_features, norms, progress_callback
+      );
+    } catch (...) {
+      fields_error = std::current_exception();
+      aborted = true;
+    }
+
+    if (!fields_error) {
+      merge_columns(); // help merging remaining columns
+    }
+
+    // wait for completion, tasks reference local variables
+    {
+      SCOPED_LOCK_NAMED(mutex, lock);
+      cond.wait(lock, [&pending]()->bool { return !pending; });
+    }
+
+    if (fields_error) {
+      std::rethrow_exception(fields_error);
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    if (!columns_result || !fields_result) {
+      return false; // flush failure
+    }
+
+    write_column_meta(track_dir, segment.meta, columns);
   }
 
   if (!progress_callback()) {
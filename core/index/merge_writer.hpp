@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "index_meta.hpp"
+#include "utils/async_utils.hpp"
 #include "utils/memory.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/string.hpp"
@@ -41,6 +42,27 @@ class IRESEARCH_API merge_writer: public util::noncopyable {
   typedef std::shared_ptr<const irs::sub_reader> sub_reader_ptr;
   typedef std::function<bool()> flush_progress_t;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief order of documents in a merged segment, documents are ordered by
+  ///        values of the specified stored column, documents without a value
+  ///        go last, documents with equivalent values keep the merge order
+  //////////////////////////////////////////////////////////////////////////////
+  struct comparer {
+    typedef std::function<bool(const bytes_ref& lhs, const bytes_ref& rhs)> less_f;
+
+    comparer() = default;
+    comparer(std::string&& column, less_f&& less)
+      : column(std::move(column)), less(std::move(less)) {
+    }
+
+    explicit operator bool() const NOEXCEPT {
+      return !column.empty() && less;
+    }
+
+    std::string column; // name of the column to order documents by
+    less_f less; // strict weak ordering of the column values
+  }; // comparer
+
   struct reader_ctx {
     explicit reader_ctx(sub_reader_ptr reader) NOEXCEPT;
 
@@ -51,13 +73,22 @@ class IRESEARCH_API merge_writer: public util::noncopyable {
 
   merge_writer() NOEXCEPT;
 
-  explicit merge_writer(directory& dir) NOEXCEPT
-    : dir_(dir) {
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param comparator order of documents in the merged segment,
+  ///        nullptr == documents are merged in order of the added readers
+  /// @note 'comparator' must outlive the writer
+  //////////////////////////////////////////////////////////////////////////////
+  explicit merge_writer(
+      directory& dir,
+      const comparer* comparator = nullptr) NOEXCEPT
+    : dir_(dir),
+      comparator_(comparator && *comparator ? comparator : nullptr) {
   }
 
   merge_writer(merge_writer&& rhs) NOEXCEPT
     : dir_(rhs.dir_),
-      readers_(std::move(rhs.readers_)) {
+      readers_(std::move(rhs.readers_)),
+      comparator_(rhs.comparator_) {
   }
 
   merge_writer& operator=(merge_writer&&) = delete;
@@ -80,11 +111,17 @@ class IRESEARCH_API merge_writer: public util::noncopyable {
   /// @brief flush all of the added readers into a single segment
   /// @param segment the segment that was flushed
   /// @param progress report flush progress (abort if 'progress' returns false)
+  /// @param pool if not nullptr, columns are merged by up to
+  ///        'pool->max_threads()' tasks of the 'pool' concurrently with the
+  ///        field term data merged by the calling thread, which then joins
+  ///        the column merge, 'progress' may then be called from several
+  ///        threads (invocations are serialized)
   /// @return merge successful
   //////////////////////////////////////////////////////////////////////////////
   bool flush(
     index_meta::index_segment_t& segment,
-    const flush_progress_t& progress = {}
+    const flush_progress_t& progress = {},
+    async_utils::thread_pool* pool = nullptr
   );
 
   const reader_ctx& operator[](size_t i) const NOEXCEPT {
@@ -101,6 +138,7 @@ class IRESEARCH_API merge_writer: public util::noncopyable {
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
   directory& dir_;
   std::vector<reader_ctx> readers_;
+  const comparer* comparator_{};
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // merge_writer
 
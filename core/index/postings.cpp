@@ -21,7 +21,6 @@
 /// @author Vasiliy Nabatchikov
 ////////////////////////////////////////////////////////////////////////////////
 
-#include "utils/map_utils.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "postings.hpp"
@@ -36,17 +35,58 @@ postings::postings(writer_t& writer):
   writer_(writer) {
 }
 
+void postings::clear() {
+  entries_.clear();
+
+  if (slots_.size() > INITIAL_SLOTS) {
+    // an empty table is far below the load target of a grown table,
+    // release it rather than keep memory sized for the previous contents
+    container_t().swap(entries_);
+    std::vector<slot>().swap(slots_);
+    rehash(INITIAL_SLOTS);
+  } else {
+    std::fill(slots_.begin(), slots_.end(), slot()); // keep allocated table
+  }
+}
+
 postings::emplace_result postings::emplace(const bytes_ref& term) {
   REGISTER_TIMER_DETAILED();
   auto& parent = writer_.parent();
- 
+
   // maximum number to bytes needed for storage of term length and data
   const auto max_term_len = term.size(); // + vencode_size(term.size());
 
   if (writer_t::container::block_type::SIZE < max_term_len) {
     // TODO: maybe move big terms it to a separate storage
     // reject terms that do not fit in a block
-    return std::make_pair(map_.end(), false);
+    return std::make_pair(entries_.end(), false);
+  }
+
+  const size_t hash = std::hash<irs::bytes_ref>()(term);
+
+  // grow table to keep load factor below 3/4
+  if (4*(entries_.size() + 1) > 3*slots_.size()) {
+    rehash(slots_.empty() ? INITIAL_SLOTS : 2*slots_.size());
+  }
+
+  const size_t mask = slots_.size() - 1;
+  slot* target;
+
+  // linear probing, compare terms only if hash fragments match
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    target = &slots_[i];
+
+    if (slot::EMPTY == target->index) {
+      break; // not found
+    }
+
+    if (target->hash == uint32_t(hash)) {
+      auto& entry = entries_[target->index];
+
+      if (entry.first.hash() == hash && entry.first == term) {
+        return std::make_pair(entries_.begin() + target->index, false);
+      }
+    }
   }
 
   const auto slice_end = writer_.pool_offset() + max_term_len;
@@ -61,24 +101,43 @@ postings::emplace_result postings::emplace(const bytes_ref& term) {
 
   assert(size() < type_limits<type_t::doc_id_t>::eof()); // not larger then the static flag
 
-  auto generator = [&term, this](const hashed_bytes_ref& key, const posting&) {
-    // for new terms also write out their value
-    writer_.write(term.c_str(), term.size());
-
-    // reuse hash but point ref at data in pool
-    return hashed_bytes_ref(
-      key.hash(),
-      (writer_.position() - term.size()).buffer(), term.size()
-    );
-  };
-
-  // replace original reference to 'term' provided by the caller
-  // with a reference to the cached copy in 'writer_'
-  return map_utils::try_emplace_update_key(
-    map_,                                     // container
-    generator,                                // key generator
-    make_hashed_ref(term, std::hash<irs::bytes_ref>()) // key
+  // for new terms also write out their value
+  writer_.write(term.c_str(), term.size());
+
+  // point ref at data in pool instead of the reference provided by the caller
+  entries_.emplace_back(
+    std::piecewise_construct,
+    std::forward_as_tuple(hash, (writer_.position() - term.size()).buffer(), term.size()),
+    std::forward_as_tuple()
   );
+
+  target->hash = uint32_t(hash);
+  target->index = uint32_t(entries_.size() - 1);
+
+  return std::make_pair(entries_.end() - 1, true);
+}
+
+void postings::rehash(size_t capacity) {
+  assert(capacity && !(capacity & (capacity - 1))); // power of 2
+
+  std::vector<slot> slots(capacity);
+  const size_t mask = capacity - 1;
+
+  entries_.reserve(capacity - capacity/4); // entries fitting the table
+
+  for (size_t i = 0, count = entries_.size(); i < count; ++i) {
+    const auto hash = entries_[i].first.hash();
+    auto pos = hash & mask;
+
+    while (slot::EMPTY != slots[pos].index) {
+      pos = (pos + 1) & mask;
+    }
+
+    slots[pos].hash = uint32_t(hash);
+    slots[pos].index = uint32_t(i);
+  }
+
+  slots_ = std::move(slots);
 }
 
 NS_END
\ No newline at end of file
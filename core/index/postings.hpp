@@ -24,11 +24,12 @@
 #ifndef IRESEARCH_POSTINGS_H
 #define IRESEARCH_POSTINGS_H
 
-#include <unordered_map>
+#include <vector>
 
 #include "shared.hpp"
 #include "utils/block_pool.hpp"
 #include "utils/hash_utils.hpp"
+#include "utils/integer.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/string.hpp"
 
@@ -52,30 +53,63 @@ struct posting {
   uint32_t offs = 0;
 };
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class postings
+/// @brief open-addressing hash table of in-memory postings of a field,
+///        entries are stored contiguously in insertion order and referenced
+///        by a linearly probed table of (hash fragment, entry index) slots,
+///        term data is stored in the byte block pool of the 'writer'
+//////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API postings: util::noncopyable {
  public:
-  typedef std::unordered_map<hashed_bytes_ref, posting> map_t;
-  typedef std::pair<map_t::iterator, bool> emplace_result;
+  typedef std::pair<hashed_bytes_ref, posting> value_type;
+  typedef std::vector<value_type> container_t;
+  typedef container_t::iterator iterator;
+  typedef container_t::const_iterator const_iterator;
+  typedef std::pair<iterator, bool> emplace_result;
   typedef byte_block_pool::inserter writer_t;
 
   postings(writer_t& writer);
 
-  inline map_t::const_iterator begin() const { return map_.begin(); }
+  inline const_iterator begin() const { return entries_.begin(); }
 
-  inline void clear() { map_.clear(); }
+  void clear();
 
   // on error returns std::ptr(end(), false)
   emplace_result emplace(const bytes_ref& term);
 
-  inline bool empty() const { return map_.empty(); }
+  inline bool empty() const { return entries_.empty(); }
 
-  inline map_t::const_iterator end() const { return map_.end(); }
+  inline const_iterator end() const { return entries_.end(); }
 
-  inline size_t size() const { return map_.size(); }
+  inline size_t size() const { return entries_.size(); }
+
+  // @return approximate amount of memory actively in-use by the table
+  size_t memory_active() const NOEXCEPT {
+    return entries_.size()*sizeof(value_type) + slots_.size()*sizeof(slot);
+  }
+
+  // @return approximate amount of memory reserved by the table
+  size_t memory_reserved() const NOEXCEPT {
+    return entries_.capacity()*sizeof(value_type)
+      + slots_.capacity()*sizeof(slot);
+  }
 
  private:
+  static CONSTEXPR const size_t INITIAL_SLOTS = 1024; // arbitrary initial table size
+
+  struct slot {
+    static const uint32_t EMPTY = integer_traits<uint32_t>::const_max;
+
+    uint32_t hash; // lower bits of the term hash
+    uint32_t index{ EMPTY }; // offset of the entry in 'entries_'
+  }; // slot
+
+  void rehash(size_t capacity);
+
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
-  map_t map_;
+  container_t entries_; // entries in insertion order
+  std::vector<slot> slots_; // size is a power of 2
   writer_t& writer_;
   IRESEARCH_API_PRIVATE_VARIABLES_END
 };
@@ -79,25 +79,12 @@ class mask_doc_iterator final : public irs::doc_iterator {
   }
 
   virtual bool next() override {
-    while (it_->next()) {
-      if (mask_.find(value()) == mask_.end()) {
-        return true;
-      }
-    }
-
-    return false;
+    return it_->next()
+      && !irs::type_limits<irs::type_t::doc_id_t>::eof(skip(value()));
   }
 
   virtual irs::doc_id_t seek(irs::doc_id_t target) override {
-    const auto doc = it_->seek(target);
-
-    if (mask_.find(doc) == mask_.end()) {
-      return doc;
-    }
-
-    next();
-
-    return value();
+    return skip(it_->seek(target));
   }
 
   virtual irs::doc_id_t value() const override {
@@ -108,7 +95,62 @@ class mask_doc_iterator final : public irs::doc_iterator {
     return it_->attributes();
   }
 
+  virtual size_t next_batch(
+      irs::doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    if (size < 2) {
+      return irs::doc_iterator::next_batch(docs, freqs, size);
+    }
+
+    // reserve a slot for the document following a trailing excluded one
+    const auto read = it_->next_batch(docs, freqs, size - 1);
+
+    if (!read) {
+      return 0;
+    }
+
+    const bool excluded_last = mask_.contains(docs[read - 1]);
+    size_t count = 0;
+
+    for (size_t i = 0; i < read; ++i) {
+      if (!mask_.contains(docs[i])) {
+        docs[count] = docs[i];
+
+        if (freqs) {
+          freqs[count] = freqs[i];
+        }
+
+        ++count;
+      }
+    }
+
+    // iterator must not stay on an excluded document
+    if (excluded_last && next()) {
+      docs[count] = value();
+
+      if (freqs) {
+        const auto& freq = attributes().get<irs::frequency>();
+        freqs[count] = freq ? freq->value : 0;
+      }
+
+      ++count;
+    }
+
+    return count; // 0 only if the iterator is exhausted
+  }
+
  private:
+  // skips a whole run of excluded documents with a single seek
+  irs::doc_id_t skip(irs::doc_id_t doc) {
+    for (auto target = mask_.next_absent(doc); target != doc;
+         target = mask_.next_absent(doc)) {
+      doc = it_->seek(target);
+    }
+
+    return doc;
+  }
+
   const irs::document_mask& mask_; // excluded document ids
   irs::doc_iterator::ptr it_;
 }; // mask_doc_iterator
@@ -131,12 +173,15 @@ class masked_docs_iterator
   virtual ~masked_docs_iterator() {}
 
   virtual bool next() override {
-    while (next_ < end_) {
-      current_ = next_++;
+    if (next_ < end_) {
+      current_ = docs_mask_.next_absent(next_);
 
-      if (docs_mask_.find(current_) == docs_mask_.end()) {
+      if (current_ < end_) {
+        next_ = current_ + 1;
         return true;
       }
+
+      next_ = end_;
     }
 
     current_ = irs::type_limits<irs::type_t::doc_id_t>::eof();
@@ -302,6 +347,10 @@ class segment_reader_impl : public sub_reader {
     field_id field
   ) const override;
 
+  virtual string_ref sort_column() const NOEXCEPT override {
+    return sort_column_;
+  }
+
  private:
   DECLARE_SHARED_PTR(segment_reader_impl); // required for NAMED_PTR(...)
   std::vector<column_meta> columns_;
@@ -313,6 +362,7 @@ class segment_reader_impl : public sub_reader {
   std::vector<column_meta*> id_to_column_;
   uint64_t meta_version_;
   std::unordered_map<hashed_string_ref, column_meta*> name_to_column_;
+  std::string sort_column_; // column documents are ordered by
 
   segment_reader_impl(
     const directory& dir,
@@ -434,6 +484,8 @@ doc_iterator::ptr segment_reader_impl::docs_iterator() const {
 
   PTR_NAMED(segment_reader_impl, reader, dir, meta.version, meta.docs_count);
 
+  reader->sort_column_ = meta.sort;
+
   // read document mask
   index_utils::read_document_mask(reader->docs_mask_, dir, meta);
 
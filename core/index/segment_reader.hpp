@@ -119,6 +119,10 @@ class IRESEARCH_API segment_reader final
     return impl_->column_reader(field);
   }
 
+  virtual string_ref sort_column() const override {
+    return impl_->sort_column();
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief converts current 'segment_reader' to 'sub_reader::ptr'
   ////////////////////////////////////////////////////////////////////////////////
@@ -40,10 +40,11 @@
 NS_ROOT
 
 segment_writer::column::column(
-    const string_ref& name, 
-    columnstore_writer& columnstore) {
+    const string_ref& name,
+    columnstore_writer& columnstore,
+    column_codec codec) {
   this->name.assign(name.c_str(), name.size());
-  this->handle = columnstore.push_column();
+  this->handle = columnstore.push_column(codec);
 }
 
 doc_id_t segment_writer::begin(
@@ -53,6 +54,7 @@ doc_id_t segment_writer::begin(
   assert(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1 < type_limits<type_t::doc_id_t>::eof());
   valid_ = true;
   norm_fields_.clear(); // clear norm fields
+  cached_fields_offset_ = 0;
 
   if (docs_mask_.capacity() <= docs_mask_.size() + 1 + reserve_rollback_extra) {
     docs_mask_.reserve(
@@ -69,6 +71,21 @@ doc_id_t segment_writer::begin(
   return doc_id_t(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1); // -1 for 0-based offset
 }
 
+void segment_writer::reserve(
+    size_t count,
+    size_t reserve_rollback_extra /*= 0*/
+) {
+  if (docs_mask_.capacity() <= docs_mask_.size() + count + reserve_rollback_extra) {
+    docs_mask_.reserve(
+      math::roundup_power2(docs_mask_.size() + count + reserve_rollback_extra) // reserve in blocks of power-of-2
+    ); // reserve space for potential rollback
+  }
+
+  if (docs_context_.size() + count > docs_context_.capacity()) {
+    docs_context_.reserve(math::roundup_power2(docs_context_.size() + count)); // reserve in blocks of power-of-2
+  }
+}
+
 segment_writer::ptr segment_writer::make(directory& dir) {
   // can't use make_unique becuase of the private constructor
   return memory::maker<segment_writer>::make(dir);
@@ -109,8 +126,20 @@ segment_writer::segment_writer(directory& dir) NOEXCEPT
   : dir_(dir), initialized_(false) {
 }
 
+field_data& segment_writer::slot(
+    cached_field& cached,
+    const string_ref& name) {
+  // documents of a batch usually share the same set of fields, hence
+  // comparing a name is cheaper than hashing it and probing 'fields_'
+  if (!cached.slot || string_ref(cached.slot->meta().name) != name) {
+    cached.slot = &fields_.get(make_hashed_ref(name, std::hash<string_ref>()));
+  }
+
+  return *cached.slot;
+}
+
 bool segment_writer::index(
-    const hashed_string_ref& name,
+    field_data& slot,
     token_stream& tokens,
     const flags& features) {
   REGISTER_TIMER_DETAILED();
@@ -118,7 +147,6 @@ bool segment_writer::index(
   assert(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1 < type_limits<type_t::doc_id_t>::eof()); // user should check return of begin() != eof()
   auto doc_id =
     doc_id_t(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1); // -1 for 0-based offset
-  auto& slot = fields_.get(name);
   auto& slot_features = slot.meta().features;
 
   // invert only if new field features are a subset of slot features
@@ -136,9 +164,16 @@ bool segment_writer::index(
 }
 
 columnstore_writer::column_output& segment_writer::stream(
-    doc_id_t doc_id, const hashed_string_ref& name) {
+    doc_id_t doc_id,
+    cached_field& cached,
+    const string_ref& name,
+    column_codec codec) {
   REGISTER_TIMER_DETAILED();
 
+  if (cached.stored && string_ref(cached.stored->name) == name) {
+    return cached.stored->handle.second(doc_id);
+  }
+
   static auto generator = [](
       const hashed_string_ref& key,
       const column& value) NOEXCEPT {
@@ -148,12 +183,16 @@ columnstore_writer::column_output& segment_writer::stream(
 
   // replace original reference to 'name' provided by the caller
   // with a reference to the cached copy in 'value'
-  return map_utils::try_emplace_update_key(
+  const auto hashed_name = make_hashed_ref(name, std::hash<string_ref>());
+
+  cached.stored = &map_utils::try_emplace_update_key(
     columns_,                                     // container
     generator,                                    // key generator
-    name,                                         // key
-    name, *col_writer_                            // value
-  ).first->second.handle.second(doc_id);
+    hashed_name,                                  // key
+    hashed_name, *col_writer_, codec              // value
+  ).first->second;
+
+  return cached.stored->handle.second(doc_id);
 }
 
 void segment_writer::finish() {
@@ -218,7 +257,6 @@ void segment_writer::flush_fields() {
 
 size_t segment_writer::flush_doc_mask(const segment_meta &meta) {
   document_mask docs_mask;
-  docs_mask.reserve(docs_mask_.size());
 
   for (size_t doc_id = 0, doc_id_end = docs_mask_.size();
        doc_id < doc_id_end;
@@ -277,6 +315,8 @@ void segment_writer::reset() NOEXCEPT {
   docs_mask_.clear();
   fields_.reset();
   columns_.clear();
+  cached_fields_.clear(); // handles refer to 'fields_' and 'columns_'
+  cached_fields_offset_ = 0;
 
   if (col_writer_) {
     col_writer_->rollback();
@@ -67,6 +67,9 @@ struct index_store_t{};
 ////////////////////////////////////////////////////////////////////////////
 /// @brief Field should be stored only
 /// @note Field must satisfy 'Attribute' concept
+/// @note a stored field may declare compression of its column via
+///       'irs::column_codec column_codec() const', LZ4 is used otherwise,
+///       the codec of the first stored value of a column takes effect
 ////////////////////////////////////////////////////////////////////////////
 struct store_t{};
 #if defined(_MSC_VER) && (_MSC_VER < 1900)
@@ -168,6 +171,10 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   // @return doc_id_t as per type_limits<type_t::doc_id_t>
   doc_id_t begin(const update_context& ctx, size_t reserve_rollback_extra = 0);
 
+  // reserve space for the specified number of subsequent documents
+  // and their potential rollback, e.g. before a batch of begin(...) calls
+  void reserve(size_t count, size_t reserve_rollback_extra = 0);
+
   // @param doc_id the document id as returned by begin(...)
   // @return modifiable update_context for the specified doc_id
   update_context& doc_context(doc_id_t doc_id) {
@@ -234,7 +241,11 @@ class IRESEARCH_API segment_writer: util::noncopyable {
 
  private:
   struct column : util::noncopyable {
-    column(const string_ref& name, columnstore_writer& columnstore);
+    column(
+      const string_ref& name,
+      columnstore_writer& columnstore,
+      column_codec codec
+    );
 
     column(column&& other) NOEXCEPT
       : name(std::move(other.name)),
@@ -245,10 +256,29 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     columnstore_writer::column_t handle;
   };
 
+  // handles of the field inserted at a given position of a document,
+  // reused by subsequent documents having fields in the same order
+  struct cached_field {
+    field_data* slot{};
+    column* stored{};
+  };
+
   segment_writer(directory& dir) NOEXCEPT;
 
+  // @return cached handles for the next field of the current document
+  cached_field& next_field() {
+    if (cached_fields_offset_ >= cached_fields_.size()) {
+      cached_fields_.emplace_back();
+    }
+
+    return cached_fields_[cached_fields_offset_++];
+  }
+
+  // @return field data for the specified field name
+  field_data& slot(cached_field& cached, const string_ref& name);
+
   bool index(
-    const hashed_string_ref& name,
+    field_data& slot,
     token_stream& tokens,
     const flags& features
   );
@@ -257,15 +287,12 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   bool store_worker(Field& field) {
     REGISTER_TIMER_DETAILED();
 
-    const auto name = make_hashed_ref(
-      static_cast<const string_ref&>(field.name()),
-      std::hash<irs::string_ref>()
-    );
+    const string_ref name = static_cast<const string_ref&>(field.name());
 
     assert(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1 < type_limits<type_t::doc_id_t>::eof()); // user should check return of begin() != eof()
     auto doc_id =
       doc_id_t(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1); // -1 for 0-based offset
-    auto& out = stream(doc_id, name);
+    auto& out = stream(doc_id, next_field(), name, stored_codec(field, 0));
 
     if (field.write(out)) {
       return true;
@@ -281,31 +308,25 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   bool index_worker(Field& field) {
     REGISTER_TIMER_DETAILED();
 
-    const auto name = make_hashed_ref(
-      static_cast<const string_ref&>(field.name()),
-      std::hash<irs::string_ref>()
-    );
-
+    const string_ref name = static_cast<const string_ref&>(field.name());
     auto& tokens = static_cast<token_stream&>(field.get_tokens());
     const auto& features = static_cast<const flags&>(field.features());
 
-    return index(name, tokens, features);
+    return index(slot(next_field(), name), tokens, features);
   }
 
   template<typename Field>
   bool index_and_store_worker(Field& field) {
     REGISTER_TIMER_DETAILED();
 
-    const auto name = make_hashed_ref(
-      static_cast<const string_ref&>(field.name()),
-      std::hash<irs::string_ref>()
-    );
+    const string_ref name = static_cast<const string_ref&>(field.name());
+    auto& cached = next_field();
 
     // index field
     auto& tokens = static_cast<token_stream&>(field.get_tokens());
     const auto& features = static_cast<const flags&>(field.features());
 
-    if (!index(name, tokens, features)) {
+    if (!index(slot(cached, name), tokens, features)) {
       return false; // indexing failed
     }
 
@@ -313,7 +334,7 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     assert(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1 < type_limits<type_t::doc_id_t>::eof()); // user should check return of begin() != eof()
     auto doc_id =
       doc_id_t(docs_cached() + type_limits<type_t::doc_id_t>::min() - 1); // -1 for 0-based offset
-    auto& out = stream(doc_id, name);
+    auto& out = stream(doc_id, cached, name, stored_codec(field, 0));
 
     if (field.write(out)) {
       return true;
@@ -324,10 +345,26 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     return false; // store failed
   }
 
-  // returns stream for storing attributes
+  // returns codec declared by a stored field
+  template<typename Field>
+  static auto stored_codec(const Field& field, int)
+      -> decltype(irs::column_codec(field.column_codec())) {
+    return field.column_codec();
+  }
+
+  // returns default codec for a stored field declaring none
+  template<typename Field>
+  static column_codec stored_codec(const Field&, ...) {
+    return column_codec::LZ4;
+  }
+
+  // returns stream for storing attributes,
+  // 'codec' is used if the column has to be created
   columnstore_writer::column_output& stream(
     doc_id_t doc,
-    const hashed_string_ref& name
+    cached_field& cached,
+    const string_ref& name,
+    column_codec codec
   );
 
   void finish(); // finishes document
@@ -342,6 +379,8 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   fields_data fields_;
   std::unordered_map<hashed_string_ref, column> columns_;
   std::unordered_set<field_data*> norm_fields_; // document fields for normalization
+  std::vector<cached_field> cached_fields_; // handles of fields by their position in a document
+  size_t cached_fields_offset_{}; // position of the next field in the current document
   std::string seg_name_;
   field_writer::ptr field_writer_;
   column_meta_writer::ptr col_meta_writer_;
@@ -24,6 +24,7 @@
 #include "composite_reader_impl.hpp"
 #include "search/bitset_doc_iterator.hpp"
 #include "store/store_utils.hpp"
+#include "utils/math_utils.hpp"
 #include "utils/string_utils.hpp"
 
 #include "transaction_store.hpp"
@@ -184,8 +185,9 @@ class store_reader_impl final: public irs::sub_reader {
     ): column_reader_t(std::move(entries)), meta_(meta) { assert(meta_); }
   };
 
-  typedef std::map<irs::string_ref, named_column_reader_t> columns_named_t;
-  typedef std::map<irs::field_id, column_reader_t> columns_unnamed_t;
+  // readers share unmodified columns/terms/fields with their predecessors
+  typedef std::map<irs::string_ref, std::shared_ptr<const named_column_reader_t>> columns_named_t;
+  typedef std::map<irs::field_id, std::shared_ptr<const column_reader_t>> columns_unnamed_t;
 
   struct term_entry_t {
     document_entries_t entries_;
@@ -198,11 +200,12 @@ class store_reader_impl final: public irs::sub_reader {
     ): entries_(std::move(entries)), meta_(meta), name_(name) { assert(name_); }
   };
 
-  typedef std::map<irs::bytes_ref, term_entry_t> term_entries_t;
+  typedef std::map<irs::bytes_ref, std::shared_ptr<const term_entry_t>> term_entries_t;
 
   struct term_reader_t: public irs::term_reader {
     irs::attribute_view attrs_;
     uint64_t doc_count_;
+    irs::bitvector docs_; // documents containing the field
     irs::bytes_ref max_term_{ irs::bytes_ref::NIL };
     const irs::transaction_store::field_meta_builder::ptr meta_; // copy from 'store' because field in store may disapear
     irs::bytes_ref min_term_{ irs::bytes_ref::NIL };
@@ -210,7 +213,6 @@ class store_reader_impl final: public irs::sub_reader {
 
     term_reader_t(const irs::transaction_store::field_meta_builder::ptr& meta)
       : meta_(meta) { assert(meta_); }
-    term_reader_t(term_reader_t&& other) NOEXCEPT;
     virtual const irs::attribute_view& attributes() const NOEXCEPT override {
       return attrs_;
     }
@@ -222,7 +224,7 @@ class store_reader_impl final: public irs::sub_reader {
     virtual size_t size() const override { return terms_.size(); }
   };
 
-  typedef std::map<irs::string_ref, term_reader_t> fields_t;
+  typedef std::map<irs::string_ref, std::shared_ptr<const term_reader_t>> fields_t;
 
   virtual const irs::column_meta* column(const irs::string_ref& name) const override;
   virtual irs::column_iterator::ptr columns() const override;
@@ -239,6 +241,12 @@ class store_reader_impl final: public irs::sub_reader {
   }
   virtual size_t size() const override { return 1; } // only 1 segment
 
+  // state that may be shared with subsequently opened readers
+  const columns_named_t& named_columns() const NOEXCEPT { return columns_named_; }
+  const columns_unnamed_t& unnamed_columns() const NOEXCEPT { return columns_unnamed_; }
+  const fields_t& fields_by_name() const NOEXCEPT { return fields_; }
+  size_t generation() const NOEXCEPT { return generation_; }
+
  private:
   friend irs::store_reader irs::store_reader::reopen() const;
   friend bool irs::store_writer::commit();
@@ -275,7 +283,7 @@ class store_column_iterator final: public irs::column_iterator {
       return false; // already at end
     }
 
-    value_ = itr_->second.meta_.get();
+    value_ = itr_->second->meta_.get();
     ++itr_;
 
     return true;
@@ -551,7 +559,7 @@ class store_field_iterator final: public irs::field_iterator {
       return false; // already at end
     }
 
-    value_ = &(itr_->second);
+    value_ = itr_->second.get();
     ++itr_;
 
     return true;
@@ -609,7 +617,7 @@ class store_term_iterator: public irs::seek_term_iterator {
     }
 
     term_ = next_itr_->first;
-    term_entry_ = &(next_itr_->second);
+    term_entry_ = next_itr_->second.get();
     ++next_itr_;
 
     return true;
@@ -784,15 +792,6 @@ bool store_reader_impl::column_reader_t::visit(
   return true;
 }
 
-store_reader_impl::term_reader_t::term_reader_t(term_reader_t&& other) NOEXCEPT
-  : attrs_(std::move(other.attrs_)),
-    doc_count_(std::move(other.doc_count_)),
-    max_term_(std::move(other.max_term_)),
-    meta_(std::move(other.meta_)),
-    min_term_(std::move(other.min_term_)),
-    terms_(std::move(other.terms_)) {
-}
-
 irs::seek_term_iterator::ptr store_reader_impl::term_reader_t::iterator() const {
   return terms_.empty()
     ? irs::seek_term_iterator::make<empty_seek_term_iterator>()
@@ -817,11 +816,11 @@ store_reader_impl::store_reader_impl(
   for (auto& entry: columns_named_) {
     auto& column = entry.second;
 
-    column_by_id.emplace(column.meta_->id, &column);
+    column_by_id.emplace(column->meta_->id, column.get());
   }
 
   for (auto& entry: columns_unnamed_) {
-    column_by_id.emplace(entry.first, &(entry.second));
+    column_by_id.emplace(entry.first, entry.second.get());
   }
 }
 
@@ -830,7 +829,7 @@ const irs::column_meta* store_reader_impl::column(
 ) const {
   auto itr = columns_named_.find(name);
 
-  return itr == columns_named_.end() ? nullptr : itr->second.meta_.get();
+  return itr == columns_named_.end() ? nullptr : itr->second->meta_.get();
 }
 
 irs::column_iterator::ptr store_reader_impl::columns() const {
@@ -856,7 +855,7 @@ const irs::term_reader* store_reader_impl::field(
 ) const {
   auto itr = fields_.find(field);
 
-  return itr == fields_.end() ? nullptr : &(itr->second);
+  return itr == fields_.end() ? nullptr : itr->second.get();
 }
 
 irs::field_iterator::ptr store_reader_impl::fields() const {
@@ -873,6 +872,8 @@ class transaction_store::store_reader_helper {
  public:
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief fill reader state only for the specified documents
+  /// @param base a reader of the same store whose columns/terms not modified
+  ///        since its generation are shared rather than rebuilt, or nullptr
   /// @note caller must have read lock on store.mutex_
   ////////////////////////////////////////////////////////////////////////////////
   static size_t get_reader_state_unsafe(
@@ -880,110 +881,163 @@ class transaction_store::store_reader_helper {
       store_reader_impl::columns_named_t& columns_named,
       store_reader_impl::columns_unnamed_t& columns_unnamed,
       const transaction_store& store,
-      const bitvector& documents
+      const bitvector& documents,
+      const store_reader_impl* base = nullptr
   ) {
     fields.clear();
     columns_named.clear();
     columns_unnamed.clear();
 
+    if (base && base->generation() < store.reuse_generation_) {
+      base = nullptr; // documents of 'base' may have been flushed/reassigned since
+    }
+
     // copy over non-empty columns into an ordered map
     for (auto& columns_entry: store.columns_named_) {
-      store_reader_impl::document_entries_t entries;
+      auto& column = columns_entry.second;
+
+      if (base && column.generation_ <= base->generation()) {
+        auto itr = base->named_columns().find(columns_entry.first);
 
-      // copy over valid documents
-      for (auto& entry: columns_entry.second.entries_) {
-        if (entry.buf_ && documents.test(entry.doc_id_)) {
-          entries.emplace_back(entry);
+        if (itr != base->named_columns().end()) {
+          columns_named.emplace(itr->first, itr->second); // unmodified column
         }
+
+        continue;
       }
 
+      auto entries = get_entries(column.entries_, documents);
+
       if (entries.empty()) {
         continue; // no docs in column, skip
       }
 
-      std::sort(entries.begin(), entries.end(), DOC_LESS); // sort by doc_id
       columns_named.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(columns_entry.first), // key
-        std::forward_as_tuple(columns_entry.second.meta_, std::move(entries)) // value
+        columns_entry.first, // key
+        memory::make_shared<store_reader_impl::named_column_reader_t>(column.meta_, std::move(entries)) // value
       );
     }
 
     // copy over non-empty columns into an ordered map
     for (auto& columns_entry: store.columns_unnamed_) {
-      store_reader_impl::document_entries_t entries;
+      auto& column = columns_entry.second;
+
+      if (base && column.generation_ <= base->generation()) {
+        auto itr = base->unnamed_columns().find(columns_entry.first);
 
-      // copy over valid documents
-      for (auto& entry: columns_entry.second.entries_) {
-        if (entry.buf_ && documents.test(entry.doc_id_)) {
-          entries.emplace_back(entry);
+        if (itr != base->unnamed_columns().end()) {
+          columns_unnamed.emplace(itr->first, itr->second); // unmodified column
         }
+
+        continue;
       }
 
+      auto entries = get_entries(column.entries_, documents);
+
       if (entries.empty()) {
         continue; // no docs in column, skip
       }
 
-      std::sort(entries.begin(), entries.end(), DOC_LESS); // sort by doc_id
       columns_unnamed.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(columns_entry.first), // key
-        std::forward_as_tuple(std::move(entries)) // value
+        columns_entry.first, // key
+        memory::make_shared<store_reader_impl::column_reader_t>(std::move(entries)) // value
       );
     }
 
     // copy over non-empty fields into an ordered map
     for (auto& field_entry: store.fields_) {
-      bitvector field_docs;
-      store_reader_impl::term_reader_t terms(field_entry.second.meta_);
+      auto& field = field_entry.second;
+      const store_reader_impl::term_reader_t* base_terms = nullptr;
+
+      if (base) {
+        auto itr = base->fields_by_name().find(field_entry.first);
+
+        if (itr != base->fields_by_name().end()) {
+          base_terms = itr->second.get();
+        }
+
+        if (field.generation_ <= base->generation()) {
+          if (base_terms) {
+            fields.emplace(itr->first, itr->second); // unmodified field
+          }
+
+          continue;
+        }
+      }
+
+      auto terms = memory::make_shared<store_reader_impl::term_reader_t>(field.meta_);
+
+      if (base_terms) {
+        terms->docs_ = base_terms->docs_;
+        terms->docs_ &= documents; // exclude removed documents, new ones are in modified terms
+      }
 
       // copy over non-empty terms into an ordered map
-      for (auto& term_entry: field_entry.second.terms_) {
-        store_reader_impl::document_entries_t postings;
-
-        // copy over valid postings
-        for (auto& entry: term_entry.second.entries_) {
-          if (entry.buf_ && documents.test(entry.doc_id_)) {
-            field_docs.set(entry.doc_id_);
-            postings.emplace_back(entry);
+      for (auto& term_entry: field.terms_) {
+        auto& term = term_entry.second;
+
+        if (base_terms && term.generation_ <= base->generation()) {
+          auto itr = base_terms->terms_.find(term_entry.first);
+
+          if (itr != base_terms->terms_.end()) {
+            terms->terms_.emplace(itr->first, itr->second); // unmodified term
           }
+
+          continue;
         }
 
+        auto postings = get_entries(term.entries_, documents);
+
         if (postings.empty()) {
           continue; // no docs in term, skip
         }
 
-        std::sort(postings.begin(), postings.end(), DOC_LESS); // sort by doc_id
-
-        auto& term = terms.terms_.emplace(
-          std::piecewise_construct,
-          std::forward_as_tuple(term_entry.first), // key
-          std::forward_as_tuple(term_entry.second.name_, term_entry.second.meta_, std::move(postings)) // value
-        ).first->first;
-
-        if (terms.min_term_.null() || terms.min_term_ > term) {
-          terms.min_term_ = term; // point at term in reader map
+        for (auto& entry: postings) {
+          terms->docs_.set(entry.doc_id_);
         }
 
-        if (terms.max_term_.null() || terms.max_term_ < term) {
-          terms.max_term_ = term; // point at term in reader map
-        }
+        terms->terms_.emplace(
+          term_entry.first, // key
+          memory::make_shared<store_reader_impl::term_entry_t>(term.name_, term.meta_, std::move(postings)) // value
+        );
       }
 
-      if (terms.terms_.empty()) {
+      if (terms->terms_.empty()) {
         continue; // no terms in field, skip
       }
 
-      terms.doc_count_ = field_docs.count();
-      map_utils::try_emplace(
-        fields,
-        field_entry.first, // key
-        std::move(terms) // value
-      );
+      terms->min_term_ = terms->terms_.begin()->first; // point at term in reader map
+      terms->max_term_ = terms->terms_.rbegin()->first; // point at term in reader map
+      terms->doc_count_ = terms->docs_.count();
+      fields.emplace(field_entry.first, std::move(terms));
     }
 
     return store.generation_; // obtain store generation while under lock
   }
+
+ private:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @return valid entries of the specified documents ordered by doc_id
+  ////////////////////////////////////////////////////////////////////////////////
+  static store_reader_impl::document_entries_t get_entries(
+      const std::vector<document_entry_t>& entries,
+      const bitvector& documents
+  ) {
+    store_reader_impl::document_entries_t result;
+
+    // copy over valid documents
+    for (auto& entry: entries) {
+      if (entry.buf_ && documents.test(entry.doc_id_)) {
+        result.emplace_back(entry);
+      }
+    }
+
+    if (!std::is_sorted(result.begin(), result.end(), DOC_LESS)) {
+      std::sort(result.begin(), result.end(), DOC_LESS); // sort by doc_id
+    }
+
+    return result;
+  }
 };
 
 store_reader::store_reader(impl_ptr&& impl) NOEXCEPT
@@ -1158,6 +1212,8 @@ bool store_writer::commit() {
   ++(store_.generation_); // mark store state as modified
   store_.visible_docs_ |= valid_doc_ids_; // commit doc_ids
   store_.visible_docs_ -= invalid_doc_ids; // commit removals
+  store_.mark_modified(valid_doc_ids_); // terms/columns with new documents
+  store_.mark_modified(invalid_doc_ids); // terms/columns with removed documents
   used_doc_ids_ -= valid_doc_ids_; // exclude 'valid' from 'used' (so commited docs would remain valid when transaction is cleaned up)
   used_doc_ids_ |= invalid_doc_ids; // include 'invalid' into 'used' (so removed docs would be invalidated when transaction is cleaned up)
 
@@ -1279,6 +1335,7 @@ bool store_writer::index(
 
       // if this is the first time this term was seen for this document
       if (irs::integer_traits<size_t>::const_max == term_state_offset_ref) {
+        store_.document_refs(doc.doc_id_).terms_.emplace_back(&*field, &field_term);
         field_term.entries_.emplace_back(doc, out.file_pointer()); // term offset in buffer
 
         static const term_stats_t initial;
@@ -1431,6 +1488,7 @@ bool store_writer::store(
     {
       async_utils::read_write_mutex::write_mutex mutex(store_.mutex_);
       SCOPED_LOCK(mutex);
+      store_.document_refs(doc.doc_id_).columns_.emplace_back(&*column);
       column->entries_.emplace_back(doc, out.file_pointer()); // column offset in buffer
     }
 
@@ -1483,6 +1541,7 @@ transaction_store::transaction_store(size_t pool_size /*= DEFAULT_POOL_SIZE*/)
     column_meta_pool_(pool_size),
     field_meta_pool_(pool_size),
     generation_(0),
+    reuse_generation_(0),
     reusable_(memory::make_shared<bool>(true)),
     used_doc_ids_(type_limits<type_t::doc_id_t>::invalid() + 1),
     visible_docs_(type_limits<type_t::doc_id_t>::invalid() + 1) { // same size as used_doc_ids_
@@ -1494,6 +1553,19 @@ void transaction_store::cleanup() {
   SCOPED_LOCK(mutex);
 
   used_doc_ids_ &= valid_doc_ids_; // remove invalid ids from 'used'
+  reuse_generation_ = generation_ + 1; // unused doc_ids may be reassigned
+
+  {
+    SCOPED_LOCK(last_reader_mutex_);
+    last_reader_.reset();
+  }
+
+  // forget terms/columns of unused doc_ids
+  for (size_t i = 0, count = document_refs_.size(); i < count; ++i) {
+    if (!used_doc_ids_.test(i)) {
+      document_refs_[i] = document_refs_t();
+    }
+  }
 
   // remove unused records from named user columns
   for (auto itr = columns_named_.begin(), end = columns_named_.end(); itr != end;) {
@@ -1592,6 +1664,10 @@ void transaction_store::clear() {
   *reusable_ = false; // prevent existing writers from commiting into the store
   reusable_ = std::move(reusable); // mark new generation
   visible_docs_.clear(); // mark all documents are non-visible
+  reuse_generation_ = generation_ + 1; // visibility changed without marking modified terms/columns
+
+  SCOPED_LOCK(last_reader_mutex_);
+  last_reader_.reset();
 }
 
 store_reader transaction_store::flush() {
@@ -1603,8 +1679,12 @@ store_reader transaction_store::flush() {
   // if a reader with a flushed state was created successfully
   if (reader) {
     ++generation_; // mark state as modified
+    reuse_generation_ = generation_; // flushed documents are no longer visible
     valid_doc_ids_ -= visible_docs_; // remove flushed ids from 'valid'
     visible_docs_.clear(); // remove flushed ids from 'visible'
+
+    SCOPED_LOCK(last_reader_mutex_);
+    last_reader_.reset();
   }
 
   return reader;
@@ -1771,6 +1851,32 @@ transaction_store::field_ref_t transaction_store::get_field(
     ;
 }
 
+void transaction_store::mark_modified(const bitvector& docs) NOEXCEPT {
+  typedef bitvector::word_t word_t;
+  const auto* words = docs.begin();
+
+  for (size_t i = 0, count = docs.size() ? bitset::word(docs.size() - 1) + 1 : 0; i < count; ++i) {
+    for (auto word = words[i]; word; word &= word - 1) { // visit set bits only
+      const auto doc = bitset::bit_offset(i) + math::math_traits<word_t>::ctz(word);
+
+      if (doc >= document_refs_.size()) {
+        return; // no terms/columns for any subsequent doc_id
+      }
+
+      auto& refs = document_refs_[doc];
+
+      for (auto& term: refs.terms_) {
+        term.first->generation_ = generation_;
+        term.second->generation_ = generation_;
+      }
+
+      for (auto* column: refs.columns_) {
+        column->generation_ = generation_;
+      }
+    }
+  }
+}
+
 store_reader transaction_store::reader() const {
   REGISTER_TIMER_DETAILED();
   store_reader_impl::columns_named_t columns_named;
@@ -1778,13 +1884,24 @@ store_reader transaction_store::reader() const {
   bitvector documents;
   store_reader_impl::fields_t fields;
   size_t generation;
+  std::shared_ptr<const sub_reader> base;
+
+  {
+    SCOPED_LOCK(last_reader_mutex_);
+    base = last_reader_;
+  }
 
   {
     async_utils::read_write_mutex::read_mutex mutex(mutex_);
     SCOPED_LOCK(mutex);
     documents = visible_docs_;
     generation = transaction_store::store_reader_helper::get_reader_state_unsafe(
-      fields, columns_named, columns_unnamed, *this, documents
+      fields,
+      columns_named,
+      columns_unnamed,
+      *this,
+      documents,
+      static_cast<const store_reader_impl*>(base.get())
     );
   }
 
@@ -1801,6 +1918,16 @@ store_reader transaction_store::reader() const {
     generation
   );
 
+  {
+    SCOPED_LOCK(last_reader_mutex_);
+
+    // subsequent readers may reuse unmodified state
+    if (!last_reader_
+        || static_cast<const store_reader_impl&>(*last_reader_).generation() < generation) {
+      last_reader_ = reader;
+    }
+  }
+
   return store_reader(std::move(reader));
 }
 
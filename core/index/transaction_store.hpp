@@ -234,6 +234,7 @@ class IRESEARCH_API transaction_store: private util::noncopyable {
 
   struct column_t: private util::noncopyable { // no copy because of ref tracking
     std::vector<document_entry_t> entries_;
+    size_t generation_{}; // store generation when visible entries last changed
     std::atomic<size_t> refs_{}; // ref tracking for term addition/write-pending operations
   };
 
@@ -250,6 +251,7 @@ class IRESEARCH_API transaction_store: private util::noncopyable {
 
   struct postings_t {
     std::vector<document_entry_t> entries_;
+    size_t generation_{}; // store generation when visible entries last changed
     term_meta meta_;
     const bstring_builder::ptr name_;
     postings_t(
@@ -264,6 +266,7 @@ class IRESEARCH_API transaction_store: private util::noncopyable {
   struct terms_t: private util::noncopyable { // no copy because of ref tracking
     const field_meta_builder::ptr meta_;
     ref_t<column_t> norm_col_ref_;
+    size_t generation_{}; // store generation when visible entries of any term last changed
     std::atomic<size_t> refs_{}; // ref tracking for term addition/write-pending operations
     std::unordered_map<hashed_bytes_ref, postings_t> terms_;
     terms_t(
@@ -275,6 +278,12 @@ class IRESEARCH_API transaction_store: private util::noncopyable {
     }
   };
 
+  // terms and columns having entries for a particular document
+  struct document_refs_t {
+    std::vector<std::pair<terms_t*, postings_t*>> terms_;
+    std::vector<column_t*> columns_;
+  };
+
   typedef ref_t<column_named_t> column_ref_t;
   typedef ref_t<terms_t> field_ref_t;
   typedef std::shared_ptr<bool> reusable_t;
@@ -287,6 +296,9 @@ class IRESEARCH_API transaction_store: private util::noncopyable {
   field_meta_pool_t field_meta_pool_;
   std::unordered_map<hashed_string_ref, terms_t> fields_;
   size_t generation_; // current commit generation
+  size_t reuse_generation_; // readers of a lesser generation cannot be reused by newer readers
+  mutable std::shared_ptr<const sub_reader> last_reader_; // the most recent reader, its unmodified state is reused by the next reader
+  mutable std::mutex last_reader_mutex_; // mutex for 'last_reader_'
   std::mutex generation_mutex_; // prevent generation modification during writer commit with removals/updates and flush (used before aquiring write lock on mutex_)
   mutable async_utils::read_write_mutex mutex_; // mutex for 'columns_', 'fields_', 'generation_', 'visible_docs_'
   reusable_t reusable_;
@@ -302,6 +314,19 @@ class IRESEARCH_API transaction_store: private util::noncopyable {
   bitvector used_doc_ids_; // true == doc_id in use (in 'fields_'/'columns_'), false == doc_id can be reused
   bitvector valid_doc_ids_; // true == doc_id part of some tx (implies 'used'), false == doc_id will never be comitted
   bitvector visible_docs_; // true == commited (implies 'valid'), false == not commited or removed
+  std::vector<document_refs_t> document_refs_; // terms/columns of each doc_id, for tracking changes between generations
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @return terms/columns referencing the specified doc_id
+  /// @note caller must have write lock on 'mutex_'
+  ////////////////////////////////////////////////////////////////////////////////
+  document_refs_t& document_refs(doc_id_t doc) {
+    if (doc >= document_refs_.size()) {
+      document_refs_.resize(doc + 1);
+    }
+
+    return document_refs_[doc];
+  }
 
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief find an existing column or create a new column
@@ -327,6 +352,13 @@ class IRESEARCH_API transaction_store: private util::noncopyable {
   /// @return field matching 'name' with a superset of 'features', false == error
   ////////////////////////////////////////////////////////////////////////////////
   field_ref_t get_field(const hashed_string_ref& name, const flags& features);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief mark terms/columns of the specified documents as modified in the
+  ///        current generation
+  /// @note caller must have write lock on 'mutex_'
+  ////////////////////////////////////////////////////////////////////////////////
+  void mark_modified(const bitvector& docs) NOEXCEPT;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
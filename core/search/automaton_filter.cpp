@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "automaton_filter.hpp"
+#include "range_query.hpp"
+#include "analysis/token_attributes.hpp"
+#include "index/index_reader.hpp"
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                            automaton_term_iterator implementation
+// -----------------------------------------------------------------------------
+
+automaton_term_iterator::automaton_term_iterator(
+    const automaton& acceptor,
+    seek_term_iterator::ptr&& it) NOEXCEPT
+  : acceptor_(&acceptor),
+    it_(std::move(it)) {
+  assert(it_);
+}
+
+bool automaton_term_iterator::accept() {
+  while (!acceptor_->accept(it_->value())) {
+    if (!acceptor_->next_bound(it_->value(), bound_)
+        || SeekResult::END == it_->seek_ge(bound_)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool automaton_term_iterator::next() {
+  if (acceptor_->empty()) {
+    return false;
+  }
+
+  return it_->next() && accept();
+}
+
+SeekResult automaton_term_iterator::seek_ge(const bytes_ref& value) {
+  if (acceptor_->empty()) {
+    return SeekResult::END;
+  }
+
+  const auto res = it_->seek_ge(value);
+
+  if (SeekResult::END == res) {
+    return res;
+  }
+
+  if (SeekResult::FOUND == res && acceptor_->accept(value)) {
+    return res;
+  }
+
+  return accept() ? SeekResult::NOT_FOUND : SeekResult::END;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 filter helpers
+// -----------------------------------------------------------------------------
+
+filter::prepared::ptr prepare_automaton_filter(
+    const string_ref& field,
+    const automaton& acceptor,
+    size_t scored_terms_limit,
+    const index_reader& index,
+    const order::prepared& order,
+    boost::boost_t boost) {
+  if (acceptor.empty()) {
+    return filter::prepared::empty();
+  }
+
+  limited_sample_scorer scorer(order.empty() ? 0 : scored_terms_limit); // object for collecting order stats
+  range_query::states_t states(index.size());
+
+  for (const auto& segment : index) {
+    // get term dictionary for field
+    const term_reader* reader = segment.field(field);
+
+    if (!reader) {
+      continue;
+    }
+
+    automaton_term_iterator terms(acceptor, reader->iterator());
+
+    if (!terms.next()) {
+      continue;
+    }
+
+    // get term metadata
+    auto& meta = terms.attributes().get<term_meta>();
+
+    terms.read();
+
+    // get state for current segment
+    auto& state = states.insert(segment);
+    state.reader = reader;
+    state.min_term = terms.value();
+    state.min_cookie = terms.cookie();
+    state.unscored_docs.reset((type_limits<type_t::doc_id_t>::min)() + segment.docs_count()); // highest valid doc_id in reader
+
+    do {
+      // fill scoring candidates
+      scorer.collect(meta ? meta->docs_count : 0, state.count, state, segment, terms);
+      ++state.count;
+
+      // collect cost
+      if (meta) {
+        state.estimation += meta->docs_count;
+      }
+
+      if (!terms.next()) {
+        break;
+      }
+
+      terms.read();
+    } while (true);
+  }
+
+  scorer.score(index, order);
+
+  auto q = memory::make_shared<range_query>(std::move(states));
+
+  // apply boost
+  irs::boost::apply(q->attributes(), boost);
+
+  return q;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
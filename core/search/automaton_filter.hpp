@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_AUTOMATON_FILTER_H
+#define IRESEARCH_AUTOMATON_FILTER_H
+
+#include "filter.hpp"
+#include "index/iterators.hpp"
+#include "utils/automaton.hpp"
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class automaton_term_iterator
+/// @brief iterates over terms of a term dictionary accepted by an automaton,
+///        rejected terms are skipped by seeking the dictionary to the next
+///        candidate, so that only parts of a dictionary reachable by the
+///        automaton are visited
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API automaton_term_iterator final : public seek_term_iterator {
+ public:
+  automaton_term_iterator(
+    const automaton& acceptor,
+    seek_term_iterator::ptr&& it
+  ) NOEXCEPT;
+
+  virtual const attribute_view& attributes() const NOEXCEPT override {
+    return it_->attributes();
+  }
+
+  virtual const bytes_ref& value() const override { return it_->value(); }
+
+  virtual bool next() override;
+
+  virtual void read() override { it_->read(); }
+
+  virtual doc_iterator::ptr postings(const flags& features) const override {
+    return it_->postings(features);
+  }
+
+  virtual SeekResult seek_ge(const bytes_ref& value) override;
+
+  virtual bool seek(const bytes_ref& value) override {
+    return acceptor_->accept(value) && it_->seek(value);
+  }
+
+  virtual bool seek(
+      const bytes_ref& term,
+      const seek_cookie& cookie) override {
+    return it_->seek(term, cookie);
+  }
+
+  virtual seek_cookie::ptr cookie() const override {
+    return it_->cookie();
+  }
+
+ private:
+  // moves to the first accepted term starting from the current one
+  bool accept();
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  const automaton* acceptor_;
+  seek_term_iterator::ptr it_;
+  bstring bound_; // next candidate to seek to
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // automaton_term_iterator
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief prepares a query matching documents containing terms of the
+///        specified field accepted by the specified automaton, scored as
+///        a disjunction of at most 'scored_terms_limit' most frequent terms
+//////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API filter::prepared::ptr prepare_automaton_filter(
+  const string_ref& field,
+  const automaton& acceptor,
+  size_t scored_terms_limit,
+  const index_reader& index,
+  const order::prepared& order,
+  boost::boost_t boost
+);
+
+NS_END // ROOT
+
+#endif // IRESEARCH_AUTOMATON_FILTER_H
@@ -248,6 +248,10 @@ DEFINE_FACTORY_DEFAULT(stats)
 
 typedef bm25_sort::score_t score_t;
 
+// number of documents scored at once by batch scoring, small enough
+// for the intermediate buffers to stay on the stack
+const size_t BATCH_SIZE = 64;
+
 class scorer : public irs::sort::scorer_base<bm25::score_t> {
  public:
   DEFINE_FACTORY_INLINE(scorer)
@@ -268,11 +272,57 @@ class scorer : public irs::sort::scorer_base<bm25::score_t> {
     score_cast(score_buf) = num_ * freq / (norm_const_ + freq);
   }
 
+  virtual bool bound(byte_type* score_buf, uint32_t freq) const NOEXCEPT override {
+    // score is monotonic in 'freq' only for non-negative factors
+    if (num_ < 0.f || norm_const_ < 0.f) {
+      return false;
+    }
+
+    // length norm is non-negative, so the score is bounded by the one
+    // of a document with the max frequency and zero length norm
+    const float_t tf = float_t(std::sqrt(freq));
+    score_cast(score_buf) = num_ * tf / (norm_const_ + tf);
+    return true;
+  }
+
+  virtual bool score(
+      const doc_id_t* /*docs*/,
+      const uint32_t* freqs,
+      size_t size,
+      byte_type* score_buf,
+      size_t stride) override {
+    float_t scores[BATCH_SIZE];
+
+    while (size) {
+      const size_t count = std::min(size, BATCH_SIZE);
+
+      tf(freqs, count, scores);
+      for (size_t i = 0; i < count; ++i) {
+        scores[i] = num_ * scores[i] / (norm_const_ + scores[i]);
+      }
+      score_store(scores, count, score_buf, stride);
+
+      freqs += count;
+      score_buf += count*stride;
+      size -= count;
+    }
+
+    return true;
+  }
+
  protected:
   FORCE_INLINE float_t tf() const NOEXCEPT {
     return float_t(std::sqrt(freq_->value));
   }
 
+  // branch-free loops over contiguous buffers, let compiler vectorize them
+  FORCE_INLINE static void tf(
+      const uint32_t* freqs, size_t size, float_t* tfs) NOEXCEPT {
+    for (size_t i = 0; i < size; ++i) {
+      tfs[i] = float_t(std::sqrt(freqs[i]));
+    }
+  }
+
   const frequency* freq_; // document frequency
   float_t num_; // partially precomputed numerator : boost * (k + 1) * idf
   float_t norm_const_; // 'k' factor
@@ -304,6 +354,38 @@ class norm_scorer final : public scorer {
     score_cast(score_buf) = num_ * freq / (norm_const_ + norm_length_ * norm_->read() + freq);
   }
 
+  virtual bool bound(byte_type* score_buf, uint32_t freq) const NOEXCEPT override {
+    return norm_length_ >= 0.f && scorer::bound(score_buf, freq);
+  }
+
+  virtual bool score(
+      const doc_id_t* docs,
+      const uint32_t* freqs,
+      size_t size,
+      byte_type* score_buf,
+      size_t stride) override {
+    float_t scores[BATCH_SIZE];
+    float_t norms[BATCH_SIZE];
+
+    while (size) {
+      const size_t count = std::min(size, BATCH_SIZE);
+
+      tf(freqs, count, scores);
+      norm_->read(docs, count, norms);
+      for (size_t i = 0; i < count; ++i) {
+        scores[i] = num_ * scores[i] / (norm_const_ + norm_length_ * norms[i] + scores[i]);
+      }
+      score_store(scores, count, score_buf, stride);
+
+      docs += count;
+      freqs += count;
+      score_buf += count*stride;
+      size -= count;
+    }
+
+    return true;
+  }
+
  private:
   const irs::norm* norm_;
   float_t norm_length_{ 0.f }; // precomputed 'k*b/avgD' if norms presetn, '0' otherwise
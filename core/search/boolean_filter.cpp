@@ -44,6 +44,50 @@ std::pair<const irs::filter*, bool> optimize_not(const irs::Not& node) {
   return std::make_pair(inner, neg);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @returns execution context for the nested queries
+/// @note score threshold relates to the score of the whole query, thus it's
+///       not applicable to the nested queries producing partial scores
+//////////////////////////////////////////////////////////////////////////////
+const irs::attribute_view& nested_context(const irs::attribute_view& ctx) {
+  return ctx.contains<irs::score_threshold>()
+    ? irs::attribute_view::empty_instance()
+    : ctx;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @returns disjunction iterator with dynamic pruning created from the
+///          specified iterators or nullptr if pruning is not applicable
+//////////////////////////////////////////////////////////////////////////////
+irs::doc_iterator::ptr make_block_max_disjunction(
+    irs::disjunction::doc_iterators_t& itrs,
+    const irs::order::prepared& ord,
+    const irs::attribute_view& ctx) {
+  auto& threshold = ctx.get<irs::score_threshold>();
+
+  if (!threshold || !irs::block_max_disjunction::applicable(ord)) {
+    return nullptr;
+  }
+
+  // every sub-iterator should provide score upper bounds
+  irs::block_max_disjunction::doc_iterators_t bounded_itrs;
+  bounded_itrs.reserve(itrs.size());
+
+  for (auto& it : itrs) {
+    if (!it->attributes().contains<irs::score_bound>()) {
+      return nullptr;
+    }
+  }
+
+  for (auto& it : itrs) {
+    bounded_itrs.emplace_back(std::move(it.it));
+  }
+
+  return irs::doc_iterator::make<irs::block_max_disjunction>(
+    std::move(bounded_itrs), ord, *threshold
+  );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @returns disjunction iterator created from the specified queries
 //////////////////////////////////////////////////////////////////////////////
@@ -67,9 +111,11 @@ irs::doc_iterator::ptr make_disjunction(
   irs::disjunction::doc_iterators_t itrs;
   itrs.reserve(size);
 
+  const auto& nested_ctx = 1 == size ? ctx : nested_context(ctx);
+
   for (;begin != end; ++begin) {
     // execute query - get doc iterator
-    auto docs = begin->execute(rdr, ord, ctx);
+    auto docs = begin->execute(rdr, ord, nested_ctx);
 
     // filter out empty iterators
     if (!irs::type_limits<irs::type_t::doc_id_t>::eof(docs->value())) {
@@ -77,6 +123,14 @@ irs::doc_iterator::ptr make_disjunction(
     }
   }
 
+  if (&nested_ctx != &ctx && !itrs.empty()) {
+    auto docs = make_block_max_disjunction(itrs, ord, ctx);
+
+    if (docs) {
+      return docs;
+    }
+  }
+
   return irs::make_disjunction<irs::disjunction>(
     std::move(itrs), ord, std::forward<Args>(args)...
   );
@@ -107,8 +161,10 @@ irs::doc_iterator::ptr make_conjunction(
   irs::conjunction::doc_iterators_t itrs;
   itrs.reserve(size);
 
+  const auto& nested_ctx = nested_context(ctx);
+
   for (;begin != end; ++begin) {
-    auto docs = begin->execute(rdr, ord, ctx);
+    auto docs = begin->execute(rdr, ord, nested_ctx);
 
     // filter out empty iterators
     if (irs::type_limits<irs::type_t::doc_id_t>::eof(docs->value())) {
@@ -154,7 +210,7 @@ class boolean_query : public filter::prepared {
 
     // exclusion part does not affect scoring at all
     auto excl = ::make_disjunction(
-      rdr, order::prepared::unordered(), ctx, begin() + excl_, end()
+      rdr, order::prepared::unordered(), nested_context(ctx), begin() + excl_, end()
     );
 
     // got empty iterator for excluded
@@ -294,9 +350,11 @@ class min_match_query final : public boolean_query {
     min_match_disjunction::doc_iterators_t itrs;
     itrs.reserve(size);
 
+    const auto& nested_ctx = nested_context(ctx);
+
     for (;begin != end; ++begin) {
       // execute query - get doc iterator
-      auto docs = begin->execute(rdr, ord, ctx);
+      auto docs = begin->execute(rdr, ord, nested_ctx);
 
       // filter out empty iterators
       if (!type_limits<type_t::doc_id_t>::eof(docs->value())) {
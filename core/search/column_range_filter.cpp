@@ -0,0 +1,309 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "column_range_filter.hpp"
+#include "bitset_doc_iterator.hpp"
+#include "two_phase.hpp"
+#include "cost.hpp"
+#include "formats/empty_term_reader.hpp"
+#include "index/index_reader.hpp"
+#include "search/score_doc_iterators.hpp"
+
+#include <boost/functional/hash.hpp>
+
+NS_LOCAL
+
+typedef irs::detail::range<irs::bstring> range_t;
+
+// returns true if the specified value belongs to the specified range
+bool contains(const range_t& rng, const irs::bytes_ref& value) NOEXCEPT {
+  const irs::bytes_ref min = rng.min;
+  const irs::bytes_ref max = rng.max;
+
+  switch (rng.min_type) {
+    case irs::Bound_Type::INCLUSIVE:
+      if (value < min) return false;
+      break;
+    case irs::Bound_Type::EXCLUSIVE:
+      if (!(min < value)) return false;
+      break;
+    default:
+      break;
+  }
+
+  switch (rng.max_type) {
+    case irs::Bound_Type::INCLUSIVE:
+      if (max < value) return false;
+      break;
+    case irs::Bound_Type::EXCLUSIVE:
+      if (!(value < max)) return false;
+      break;
+    default:
+      break;
+  }
+
+  return true;
+}
+
+class column_range_iterator final : public irs::doc_iterator_base {
+ public:
+  explicit column_range_iterator(
+      const irs::sub_reader& reader,
+      const irs::attribute_store& prepared_filter_attrs,
+      const irs::columnstore_reader::column_reader& column,
+      const range_t& rng,
+      const irs::order::prepared& ord)
+    : doc_iterator_base(ord),
+      column_(&column),
+      rng_(&rng),
+      approx_(column.iterator()),
+      docs_count_(reader.docs_count()) {
+    assert(approx_);
+    payload_ = approx_->attributes().get<irs::payload_iterator>().get();
+
+    // make doc_id accessible via attribute
+    attrs_.emplace(doc_);
+
+    // column iterator is an approximation verified by stored values
+    attrs_.emplace(two_phase_);
+    two_phase_.reset(*approx_, [this]() {
+      doc_.value = approx_->value();
+      return contains(*rng_, payload_ ? payload_->value() : irs::bytes_ref::NIL);
+    });
+
+    // set estimation value, every value in a column may match
+    estimate(column.size());
+
+    // set scorers
+    scorers_ = ord_->prepare_scorers(
+      reader,
+      irs::empty_term_reader(column.size()),
+      prepared_filter_attrs,
+      attributes() // doc_iterator attributes
+    );
+
+    prepare_score([this](irs::byte_type* score) {
+      scorers_.score(*ord_, score);
+    });
+  }
+
+  virtual bool next() override {
+    if (!it_) {
+      scan();
+    }
+
+    const bool next = it_->next();
+    doc_.value = it_->value();
+
+    return next;
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    if (!it_) {
+      scan();
+    }
+
+    return (doc_.value = it_->seek(target));
+  }
+
+  virtual irs::doc_id_t value() const NOEXCEPT override {
+    return doc_.value;
+  }
+
+ private:
+  // evaluates the range over the whole column at once
+  void scan() {
+    docs_.reset((irs::type_limits<irs::type_t::doc_id_t>::min)() + docs_count_);
+
+    const auto min = irs::Bound_Type::UNBOUNDED == rng_->min_type
+      ? irs::bytes_ref::NIL
+      : irs::bytes_ref(rng_->min);
+    const auto max = irs::Bound_Type::UNBOUNDED == rng_->max_type
+      ? irs::bytes_ref::NIL
+      : irs::bytes_ref(rng_->max);
+
+    column_->visit_range(
+      min, max,
+      [this](irs::doc_id_t doc, const irs::bytes_ref& value) {
+        if (contains(*rng_, value)) {
+          docs_.set(doc);
+        }
+
+        return true;
+    });
+
+    it_ = irs::doc_iterator::make<irs::bitset_doc_iterator>(docs_);
+  }
+
+  irs::document doc_;
+  irs::two_phase two_phase_;
+  irs::bitset docs_; // matched documents
+  irs::doc_iterator::ptr it_; // iterator over 'docs_', nullptr until scan
+  const irs::columnstore_reader::column_reader* column_;
+  const range_t* rng_;
+  irs::doc_iterator::ptr approx_; // iterator over documents with values
+  const irs::payload_iterator* payload_; // values of 'approx_'
+  irs::order::prepared::scorers scorers_;
+  uint64_t docs_count_;
+}; // column_range_iterator
+
+// returns a term range query equivalent to the specified column range
+irs::filter::prepared::ptr prepare_terms(
+    const irs::index_reader& reader,
+    const std::string& field,
+    const range_t& rng,
+    const irs::attribute_view& ctx) {
+  irs::by_range filter;
+  filter.field(field);
+
+  if (irs::Bound_Type::UNBOUNDED != rng.min_type) {
+    filter.term<irs::Bound::MIN>(irs::bytes_ref(rng.min))
+      .include<irs::Bound::MIN>(irs::Bound_Type::INCLUSIVE == rng.min_type);
+  }
+
+  if (irs::Bound_Type::UNBOUNDED != rng.max_type) {
+    filter.term<irs::Bound::MAX>(irs::bytes_ref(rng.max))
+      .include<irs::Bound::MAX>(irs::Bound_Type::INCLUSIVE == rng.max_type);
+  }
+
+  return filter.prepare(reader, irs::order::prepared::unordered(), ctx);
+}
+
+class column_range_query final : public irs::filter::prepared {
+ public:
+  explicit column_range_query(
+    const std::string& field,
+    const range_t& rng,
+    irs::filter::prepared::ptr&& terms,
+    irs::attribute_store&& attrs
+  ): irs::filter::prepared(std::move(attrs)),
+     field_(field),
+     rng_(rng),
+     terms_(std::move(terms)) {
+  }
+
+  virtual irs::doc_iterator::ptr execute(
+      const irs::sub_reader& rdr,
+      const irs::order::prepared& ord,
+      const irs::attribute_view& ctx
+  ) const override {
+    const auto* column = rdr.column_reader(field_);
+
+    if (!column || !column->size()) {
+      return irs::doc_iterator::empty();
+    }
+
+    // postings of the matched terms are cheaper than a scan over the column
+    // only if they cover fewer documents than the column has values
+    if (terms_ && rdr.field(field_)) {
+      auto it = terms_->execute(rdr, ord, ctx);
+
+      if (irs::cost::extract(it->attributes()) < column->size()) {
+        return it;
+      }
+    }
+
+    return irs::doc_iterator::make<column_range_iterator>(
+      rdr,
+      attributes(), // prepared_filter attributes
+      *column,
+      rng_,
+      ord
+    );
+  }
+
+ private:
+  std::string field_;
+  range_t rng_;
+  irs::filter::prepared::ptr terms_; // equivalent term range, may be nullptr
+}; // column_range_query
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    by_column_range implementation
+// -----------------------------------------------------------------------------
+
+DEFINE_FILTER_TYPE(by_column_range)
+DEFINE_FACTORY_DEFAULT(by_column_range)
+
+by_column_range::by_column_range() NOEXCEPT
+  : filter(by_column_range::type()) {
+}
+
+bool by_column_range::equals(const filter& rhs) const NOEXCEPT {
+  const auto& trhs = static_cast<const by_column_range&>(rhs);
+
+  return filter::equals(rhs)
+    && fld_ == trhs.fld_
+    && rng_ == trhs.rng_
+    && indexed_ == trhs.indexed_;
+}
+
+size_t by_column_range::hash() const NOEXCEPT {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, filter::hash());
+  ::boost::hash_combine(seed, fld_);
+  ::boost::hash_combine(seed, rng_.min);
+  ::boost::hash_combine(seed, rng_.min_type);
+  ::boost::hash_combine(seed, rng_.max);
+  ::boost::hash_combine(seed, rng_.max_type);
+  ::boost::hash_combine(seed, indexed_);
+  return seed;
+}
+
+filter::prepared::ptr by_column_range::prepare(
+    const index_reader& reader,
+    const order::prepared& order,
+    boost_t filter_boost,
+    const attribute_view& ctx
+) const {
+  filter::prepared::ptr terms;
+
+  // term-level scoring would differ from the column one,
+  // so the choice between the two is made for unordered queries only
+  if (indexed_ && order.empty()) {
+    terms = prepare_terms(reader, fld_, rng_, ctx);
+  }
+
+  attribute_store attrs;
+
+  // skip field-level/term-level statistics because there are no explicit
+  // fields/terms, but still collect index-level statistics
+  // i.e. all fields and terms implicitly match
+  order.prepare_collectors(attrs, reader);
+
+  irs::boost::apply(attrs, boost() * filter_boost); // apply boost
+
+  return filter::prepared::make<column_range_query>(
+    fld_, rng_, std::move(terms), std::move(attrs)
+  );
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_COLUMN_RANGE_FILTER_H
+#define IRESEARCH_COLUMN_RANGE_FILTER_H
+
+#include "range_filter.hpp"
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class by_column_range
+/// @brief user-side filter matching documents which values stored in the
+///        specified column belong to the specified range of byte-wise ordered
+///        values, e.g. numeric values encoded via 'numeric_utils'
+/// @note the filter evaluates the range by a sequential scan over the column
+///       skipping blocks which value bounds don't intersect with the range,
+///       the resulting iterator is also a 'two_phase' one, i.e. intersections
+///       with more selective iterators check only values of candidate docs
+/// @note if the field is declared as 'indexed', i.e. its indexed terms are
+///       exactly its stored values, then for unordered queries each segment
+///       is served either by the term dictionary or by the column scan
+///       whichever has the lower cost estimation
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API by_column_range final : public filter {
+ public:
+  DECLARE_FILTER_TYPE();
+  DECLARE_FACTORY();
+
+  by_column_range() NOEXCEPT;
+
+  using filter::prepare;
+
+  virtual filter::prepared::ptr prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx
+  ) const override;
+
+  by_column_range& field(std::string fld) {
+    fld_ = std::move(fld);
+    return *this;
+  }
+
+  const std::string& field() const {
+    return fld_;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief declares that 'field' is also indexed with terms equal byte-wise
+  ///        to the stored column values, so that a term range may be used
+  ///        instead of a column scan when it is cheaper
+  //////////////////////////////////////////////////////////////////////////////
+  by_column_range& indexed(bool value) NOEXCEPT {
+    indexed_ = value;
+    return *this;
+  }
+
+  bool indexed() const NOEXCEPT {
+    return indexed_;
+  }
+
+  template<Bound B>
+  const bstring& term() const {
+    return get<B>::term(rng_);
+  }
+
+  template<Bound B>
+  by_column_range& term(bstring&& term) {
+    get<B>::term(rng_) = std::move(term);
+
+    if (Bound_Type::UNBOUNDED == get<B>::type(rng_)) {
+      get<B>::type(rng_) = Bound_Type::EXCLUSIVE;
+    }
+
+    return *this;
+  }
+
+  template<Bound B>
+  by_column_range& term(const bytes_ref& term) {
+    get<B>::term(rng_) = term;
+
+    if (term.null()) {
+      get<B>::type(rng_) = Bound_Type::UNBOUNDED;
+    } else if (Bound_Type::UNBOUNDED == get<B>::type(rng_)) {
+      get<B>::type(rng_) = Bound_Type::EXCLUSIVE;
+    }
+
+    return *this;
+  }
+
+  template<Bound B>
+  by_column_range& term(const string_ref& term) {
+    return this->term<B>(ref_cast<byte_type>(term));
+  }
+
+  template<Bound B>
+  by_column_range& include(bool incl) {
+    get<B>::type(rng_) = incl ? Bound_Type::INCLUSIVE : Bound_Type::EXCLUSIVE;
+    return *this;
+  }
+
+  template<Bound B>
+  bool include() const {
+    return Bound_Type::INCLUSIVE == get<B>::type(rng_);
+  }
+
+  virtual size_t hash() const NOEXCEPT override;
+
+ protected:
+  virtual bool equals(const filter& rhs) const NOEXCEPT override;
+
+ private:
+  typedef detail::range<bstring> range_t;
+  template<Bound B> struct get;
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::string fld_;
+  range_t rng_;
+  bool indexed_{ false };
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // by_column_range
+
+template<> struct by_column_range::get<Bound::MIN> {
+  static bstring& term(range_t& rng) { return rng.min; }
+  static const bstring& term(const range_t& rng) { return rng.min; }
+  static Bound_Type& type(range_t& rng) { return rng.min_type; }
+  static const Bound_Type& type(const range_t& rng) { return rng.min_type; }
+}; // get<Bound::MIN>
+
+template<> struct by_column_range::get<Bound::MAX> {
+  static bstring& term(range_t& rng) { return rng.max; }
+  static const bstring& term(const range_t& rng) { return rng.max; }
+  static Bound_Type& type(range_t& rng) { return rng.max_type; }
+  static const Bound_Type& type(const range_t& rng) { return rng.max_type; }
+}; // get<Bound::MAX>
+
+NS_END // ROOT
+
+#endif // IRESEARCH_COLUMN_RANGE_FILTER_H
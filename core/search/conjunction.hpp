@@ -26,6 +26,7 @@
 
 #include "cost.hpp"
 #include "score_doc_iterators.hpp"
+#include "two_phase.hpp"
 #include "analysis/token_attributes.hpp"
 #include "utils/type_limits.hpp"
 
@@ -98,11 +99,31 @@ class conjunction : public doc_iterator_base {
         return cost::extract(lhs->attributes(), cost::MAX) < cost::extract(rhs->attributes(), cost::MAX);
     });
 
+    // navigate approximations of two-phase iterators, verify them only
+    // for documents matched by all approximations
+    approx_.reserve(itrs_.size());
+    for (auto& it : itrs_) {
+      const auto* match = two_phase::extract(it->attributes());
+
+      if (match) {
+        approx_.push_back(&match->approximation());
+        matches_.push_back(match);
+      } else {
+        approx_.push_back(it.it.get());
+      }
+    }
+
     // set front iterator
-    front_ = itrs_.front().it.get();
+    front_ = approx_.front();
 
     // estimate iterator (front's cost is already cached)
-    estimate(cost::extract(front_->attributes(), cost::MAX));
+    estimate(cost::extract(itrs_.front()->attributes(), cost::MAX));
+
+    if (!matches_.empty()) {
+      // expose approximation to the outer iterators
+      attrs_.emplace(two_phase_);
+      two_phase_.reset(approx_itr_, [this]()->bool { return verify(); });
+    }
 
     // copy scores into separate container
     // to avoid extra checks
@@ -143,18 +164,126 @@ class conjunction : public doc_iterator_base {
       return false;
     }
 
-    return !type_limits<type_t::doc_id_t>::eof(converge(front_->value()));
+    return !type_limits<type_t::doc_id_t>::eof(match(converge(front_->value())));
   }
 
   virtual doc_id_t seek(doc_id_t target) override {
+    if (!matches_.empty() && target <= front_->value()) {
+      return front_->value(); // current document is already verified
+    }
+
     if (type_limits<type_t::doc_id_t>::eof(target = front_->seek(target))) {
       return target;
     }
 
-    return converge(target);
+    return match(converge(target));
+  }
+
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* /*freqs*/,
+      size_t size) override {
+    if (size < 2 || !matches_.empty()) {
+      // candidates of two-phase iterators have to be verified one by one
+      return doc_iterator::next_batch(docs, nullptr, size);
+    }
+
+    // candidates come from the cheapest iterator in bulk,
+    // reserve a slot for the match following the last candidate
+    const auto read = front_->next_batch(docs, nullptr, size - 1);
+
+    if (!read) {
+      return 0;
+    }
+
+    const auto last = docs[read - 1];
+    auto target = (type_limits<type_t::doc_id_t>::min)();
+    size_t count = 0;
+
+    for (size_t i = 0; i < read; ++i) {
+      const auto doc = docs[i];
+
+      if (doc >= target && doc == (target = seek_rest(doc))) {
+        docs[count++] = doc;
+      }
+    }
+
+    if (!count || docs[count - 1] != last) {
+      // position iterators at the next match
+      target = converge(front_->seek(std::max(target, last + 1)));
+
+      if (!type_limits<type_t::doc_id_t>::eof(target)) {
+        docs[count++] = target;
+      }
+    }
+
+    return count;
   }
 
  private:
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief conjunction of approximations without verification
+  ////////////////////////////////////////////////////////////////////////////
+  class approximation final : public doc_iterator {
+   public:
+    explicit approximation(conjunction& owner) NOEXCEPT
+      : owner_(&owner) {
+    }
+
+    virtual const attribute_view& attributes() const NOEXCEPT override {
+      return attribute_view::empty_instance();
+    }
+
+    virtual bool next() override {
+      auto& front = *owner_->front_;
+
+      return front.next()
+        && !type_limits<type_t::doc_id_t>::eof(owner_->converge(front.value()));
+    }
+
+    virtual doc_id_t seek(doc_id_t target) override {
+      target = owner_->front_->seek(target);
+
+      return type_limits<type_t::doc_id_t>::eof(target)
+        ? target
+        : owner_->converge(target);
+    }
+
+    virtual doc_id_t value() const override {
+      return owner_->front_->value();
+    }
+
+   private:
+    conjunction* owner_;
+  }; // approximation
+
+  // verifies two-phase iterators on the current document
+  bool verify() const {
+    for (auto* match : matches_) {
+      if (!match->match()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // moves to the first document not less than the converged 'target'
+  // verified by all two-phase iterators
+  doc_id_t match(doc_id_t target) {
+    if (matches_.empty()) {
+      return target;
+    }
+
+    while (!type_limits<type_t::doc_id_t>::eof(target) && !verify()) {
+      target = front_->next()
+        ? converge(front_->value())
+        : type_limits<type_t::doc_id_t>::eof();
+    }
+
+    return target;
+  }
+
   // tries to converge front_ and other iterators to the specified target.
   // if it impossible tries to find first convergence place
   doc_id_t converge(doc_id_t target) {
@@ -173,7 +302,7 @@ class conjunction : public doc_iterator_base {
       return target;
     }
 
-    for (auto it = itrs_.begin()+1, end = itrs_.end(); it != end; ++it) {
+    for (auto it = approx_.begin()+1, end = approx_.end(); it != end; ++it) {
       const auto doc = (*it)->seek(target);
 
       if (target < doc) {
@@ -185,8 +314,12 @@ class conjunction : public doc_iterator_base {
   }
 
   doc_iterators_t itrs_;
+  std::vector<doc_iterator*> approx_; // iterators to navigate in order of 'itrs_'
+  std::vector<const two_phase*> matches_; // two-phase iterators in order of cost
   std::vector<const irs::score*> scores_; // valid sub-scores
   irs::doc_iterator* front_;
+  approximation approx_itr_{ *this };
+  two_phase two_phase_;
 }; // conjunction
 
 //////////////////////////////////////////////////////////////////////////////
@@ -29,6 +29,7 @@
 #include "utils/type_limits.hpp"
 #include "index/iterators.hpp"
 
+#include <cstring>
 #include <queue>
 
 NS_ROOT
@@ -456,9 +457,30 @@ class disjunction : public doc_iterator_base {
     return doc_ = lead()->value();
   }
 
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* /*freqs*/,
+      size_t size) override {
+    if (!window_scores_.empty()) {
+      return next_window(docs, std::min(size, size_t(WINDOW_SIZE)));
+    }
+
+    size_t count = 0;
+
+    // avoid virtual dispatch per document
+    for (; count < size && disjunction::next(); ++count) {
+      docs[count] = doc_;
+    }
+
+    return count;
+  }
+
  private:
   struct resolve_overload_tag{};
 
+  // max number of consecutive doc_ids scored at once by 'next_window(...)'
+  static const size_t WINDOW_SIZE = 128;
+
   disjunction(
       doc_iterators_t&& itrs,
       const order::prepared& ord,
@@ -478,6 +500,180 @@ class disjunction : public doc_iterator_base {
       ord_->prepare_score(score);
       score_impl(score);
     });
+
+    // prepare batch scoring
+    prepare_batch();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief exposes 'score_batch' if every sub-iterator scores its documents
+  ///        in batches, documents are then read by 'next_window(...)'
+  //////////////////////////////////////////////////////////////////////////////
+  void prepare_batch() {
+    if (ord_->empty() || itrs_.empty()) {
+      return;
+    }
+
+    for (auto& it : itrs_) {
+      auto& attrs = it->attributes();
+
+      if (!attrs.contains<score_batch>() || !attrs.contains<frequency>()) {
+        return; // batch scoring is not supported by a sub-iterator
+      }
+    }
+
+    const auto score_size = ord_->size();
+
+    window_docs_.resize(WINDOW_SIZE);
+    window_freqs_.resize(WINDOW_SIZE);
+    window_mask_.resize(WINDOW_SIZE);
+    window_scores_.resize(WINDOW_SIZE*score_size);
+    sub_scores_.resize(WINDOW_SIZE*score_size);
+
+    batch_.prepare([this](
+        const doc_id_t* docs, const uint32_t* /*freqs*/,
+        size_t size, byte_type* scores) {
+      const auto score_size = ord_->size();
+
+      // documents of the last window are scored while being read by
+      // 'next_window(...)', a wrapping iterator may however filter them out
+      // or append the current document read by 'next()' after the window
+      for (size_t i = 0; i < size; ++i, scores += score_size) {
+        const auto slot = size_t(docs[i] - window_min_);
+
+        if (docs[i] >= window_min_
+            && slot < window_size_
+            && window_mask_[slot]) {
+          std::memcpy(scores, window_scores_.c_str() + slot*score_size, score_size);
+        } else {
+          assert(docs[i] == doc_);
+          ord_->prepare_score(scores);
+          score_impl(scores);
+        }
+      }
+    });
+
+    attrs_.emplace(batch_);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief reads documents of the window of 'size' consecutive doc_ids
+  ///        starting from the least document following the current one,
+  ///        sub-iterators are advanced past the window and their documents
+  ///        are scored in batches
+  /// @returns number of documents read, 0 if the iterator is exhausted
+  //////////////////////////////////////////////////////////////////////////////
+  size_t next_window(doc_id_t* docs, size_t size) {
+    if (type_limits<type_t::doc_id_t>::eof(doc_) || !size) {
+      return 0;
+    }
+
+    // position every sub-iterator after the current document
+    auto min = type_limits<type_t::doc_id_t>::eof();
+
+    for (size_t i = 0; i < itrs_.size();) {
+      auto& it = itrs_[i];
+      const auto doc = it->value() == doc_
+        ? (it->next() ? it->value() : type_limits<type_t::doc_id_t>::eof())
+        : (it->value() < doc_ ? it->seek(doc_ + 1) : it->value());
+
+      if (type_limits<type_t::doc_id_t>::eof(doc)) {
+        std::swap(it, itrs_.back());
+        itrs_.pop_back();
+        continue;
+      }
+
+      min = std::min(min, doc);
+      ++i;
+    }
+
+    if (itrs_.empty()) {
+      doc_ = type_limits<type_t::doc_id_t>::eof();
+      return 0;
+    }
+
+    // window of doc_ids [min, max)
+    const auto max = type_limits<type_t::doc_id_t>::eof() - min > size
+      ? doc_id_t(min + size)
+      : type_limits<type_t::doc_id_t>::eof();
+    const auto score_size = ord_->size();
+
+    std::fill(window_mask_.begin(), window_mask_.begin() + size, false);
+    window_min_ = min;
+    window_size_ = size;
+
+    for (size_t i = 0; i < itrs_.size();) {
+      auto& it = itrs_[i];
+      auto& attrs = it->attributes();
+      const auto& freq = attrs.get<frequency>();
+      const auto& batch = attrs.get<score_batch>();
+      assert(freq && batch);
+      bool exhausted = false;
+      size_t count = 0;
+
+      for (auto doc = it->value(); doc < max; doc = it->value()) {
+        window_docs_[count] = doc;
+        window_freqs_[count] = freq->value;
+        ++count;
+
+        if (!it->next()) {
+          exhausted = true;
+          break;
+        }
+      }
+
+      if (count) {
+        batch->evaluate(
+          window_docs_.data(), window_freqs_.data(), count, &sub_scores_[0]
+        );
+
+        for (size_t j = 0; j < count; ++j) {
+          const size_t slot = window_docs_[j] - min;
+          auto* score = &window_scores_[0] + slot*score_size;
+
+          if (!window_mask_[slot]) {
+            window_mask_[slot] = true;
+            ord_->prepare_score(score);
+          }
+
+          ord_->add(score, sub_scores_.c_str() + j*score_size);
+        }
+      }
+
+      if (exhausted) {
+        std::swap(it, itrs_.back());
+        itrs_.pop_back();
+        continue;
+      }
+
+      ++i;
+    }
+
+    // emit documents of the window in order of doc_ids
+    size_t count = 0;
+
+    for (size_t slot = 0; slot < size; ++slot) {
+      if (window_mask_[slot]) {
+        docs[count++] = doc_id_t(min + slot);
+      }
+    }
+
+    assert(count);
+
+    if (itrs_.empty()) {
+      doc_ = type_limits<type_t::doc_id_t>::eof();
+    } else {
+      // restore the heap, every sub-iterator follows the window
+      doc_ = docs[count - 1];
+      std::make_heap(
+        itrs_.begin(), itrs_.end(),
+        [](const doc_iterator_t& lhs, const doc_iterator_t& rhs) {
+          return lhs->value() > rhs->value();
+      });
+      pop(itrs_.begin(), itrs_.end());
+    }
+
+    return count;
   }
 
   template<typename Iterator>
@@ -562,9 +758,245 @@ class disjunction : public doc_iterator_base {
   }
 
   doc_iterators_t itrs_;
+  score_batch batch_;
+  std::vector<doc_id_t> window_docs_; // documents of a sub-iterator in window
+  std::vector<uint32_t> window_freqs_; // frequencies of 'window_docs_'
+  std::vector<bool> window_mask_; // doc_ids of window matched by sub-iterators
+  bstring window_scores_; // accumulated scores of doc_ids of window
+  bstring sub_scores_; // scores of 'window_docs_'
+  doc_id_t window_min_{}; // first doc_id of the last window
+  size_t window_size_{}; // number of doc_ids in the last window
   doc_id_t doc_;
 }; // disjunction
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_max_disjunction
+/// @brief disjunction with dynamic pruning (Block-Max WAND), yields only the
+///        documents which score may reach the current score threshold,
+///        requires score upper bounds to be provided by every sub-iterator
+/// ----------------------------------------------------------------------------
+///   [0]   <-- begin
+///   [1]      | lead (iterators positioned at the current document)
+///   [n]      |
+///   [n+1]    | tail (iterators positioned after the current document)
+///   ...      |
+///   [m]   <-- end
+/// ----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+class block_max_disjunction final : public doc_iterator_base {
+ public:
+  struct doc_iterator_t : score_iterator_adapter {
+    doc_iterator_t(doc_iterator::ptr&& it) NOEXCEPT
+      : score_iterator_adapter(std::move(it)) {
+      bound = this->it->attributes().get<irs::score_bound>().get();
+    }
+
+    irs::score_bound* bound; // score upper bounds
+  }; // doc_iterator_t
+
+  typedef std::vector<doc_iterator_t> doc_iterators_t;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if dynamic pruning is applicable for the specified order,
+  ///          i.e. a document with greater scores in every bucket is
+  ///          considered to be better
+  //////////////////////////////////////////////////////////////////////////////
+  static bool applicable(const order::prepared& ord) {
+    return !ord.empty() && std::all_of(
+      ord.begin(), ord.end(),
+      [](const order::prepared::prepared_sort& entry) {
+        return entry.reverse;
+    });
+  }
+
+  block_max_disjunction(
+      doc_iterators_t&& itrs,
+      const order::prepared& ord,
+      const score_threshold& threshold)
+    : doc_iterator_base(ord),
+      itrs_(std::move(itrs)),
+      buf_(ord.size(), 0),
+      threshold_(&threshold),
+      doc_(itrs_.empty()
+        ? type_limits<type_t::doc_id_t>::eof()
+        : type_limits<type_t::doc_id_t>::invalid()) {
+    assert(applicable(ord));
+    assert(std::all_of(
+      itrs_.begin(), itrs_.end(),
+      [](const doc_iterator_t& it) { return nullptr != it.bound; }
+    ));
+
+    // estimate disjunction
+    estimate([this](){
+      return std::accumulate(
+        itrs_.begin(), itrs_.end(), cost::cost_t(0),
+        [](cost::cost_t lhs, const doc_iterator_t& rhs) {
+          return lhs + cost::extract(rhs->attributes(), 0);
+      });
+    });
+
+    // prepare score
+    prepare_score([this](byte_type* score) {
+      ord_->prepare_score(score);
+
+      for (size_t i = 0; i < lead_; ++i) {
+        detail::score_add(score, *ord_, itrs_[i]);
+      }
+    });
+  }
+
+  virtual doc_id_t value() const NOEXCEPT override {
+    return doc_;
+  }
+
+  virtual bool next() override {
+    if (type_limits<type_t::doc_id_t>::eof(doc_)) {
+      return false;
+    }
+
+    if (!type_limits<type_t::doc_id_t>::valid(doc_)) {
+      // initial state, position every iterator
+      for (auto& it : itrs_) {
+        it->next();
+      }
+    } else {
+      // move lead iterators past the current document
+      for (size_t i = 0; i < lead_; ++i) {
+        itrs_[i]->next();
+      }
+    }
+
+    return !type_limits<type_t::doc_id_t>::eof(find_next());
+  }
+
+  virtual doc_id_t seek(doc_id_t target) override {
+    if (target <= doc_) {
+      return doc_;
+    }
+
+    for (auto& it : itrs_) {
+      if (it->value() < target) {
+        it->seek(target);
+      }
+    }
+
+    return find_next();
+  }
+
+ private:
+  bool competitive(const byte_type* bound) const {
+    const auto& threshold = threshold_->value;
+
+    // document may be collected unless its upper bound is worse than threshold
+    return threshold.empty() || !ord_->less(threshold.c_str(), bound);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief finds the first competitive document not less than the minimum
+  ///        document of all sub-iterators
+  //////////////////////////////////////////////////////////////////////////////
+  doc_id_t find_next() {
+    lead_ = 0;
+
+    for (;;) {
+      // remove exhausted iterators
+      itrs_.erase(
+        std::remove_if(
+          itrs_.begin(), itrs_.end(),
+          [](const doc_iterator_t& it) {
+            return type_limits<type_t::doc_id_t>::eof(it->value());
+        }),
+        itrs_.end()
+      );
+
+      std::sort(
+        itrs_.begin(), itrs_.end(),
+        [](const doc_iterator_t& lhs, const doc_iterator_t& rhs) {
+          return lhs->value() < rhs->value();
+      });
+
+      // find pivot, i.e. the first iterator at which the sum of
+      // score upper bounds of the preceding iterators becomes competitive
+      const size_t size = itrs_.size();
+      auto* buf = &buf_[0];
+      size_t pivot = 0;
+
+      ord_->prepare_score(buf);
+      for (; pivot < size; ++pivot) {
+        ord_->add(buf, itrs_[pivot].bound->max());
+
+        if (competitive(buf)) {
+          break;
+        }
+      }
+
+      if (pivot == size) {
+        // no competitive documents left
+        return doc_ = type_limits<type_t::doc_id_t>::eof();
+      }
+
+      const auto pivot_doc = itrs_[pivot]->value();
+
+      // take into account all iterators positioned at the pivot document
+      while (pivot + 1 < size && itrs_[pivot + 1]->value() == pivot_doc) {
+        ++pivot;
+      }
+
+      // check score upper bounds of the blocks containing the pivot document
+      auto block_end = type_limits<type_t::doc_id_t>::eof();
+
+      ord_->prepare_score(buf);
+      for (size_t i = 0; i <= pivot; ++i) {
+        auto& bound = *itrs_[i].bound;
+
+        block_end = std::min(block_end, bound.shallow_seek(pivot_doc));
+        ord_->add(buf, bound.block());
+      }
+
+      if (competitive(buf)) {
+        if (itrs_.front()->value() == pivot_doc) {
+          // all iterators up to the pivot are positioned at the pivot document
+          lead_ = pivot + 1;
+          return doc_ = pivot_doc;
+        }
+
+        // move lagging iterators to the pivot document
+        for (size_t i = 0; i < pivot && itrs_[i]->value() < pivot_doc; ++i) {
+          itrs_[i]->seek(pivot_doc);
+        }
+
+        continue;
+      }
+
+      // no document up to the end of the shortest block can be competitive
+      auto target = block_end;
+
+      if (!type_limits<type_t::doc_id_t>::eof(target)) {
+        ++target;
+      }
+
+      if (pivot + 1 < size) {
+        target = std::min(target, itrs_[pivot + 1]->value());
+      }
+
+      if (type_limits<type_t::doc_id_t>::eof(target)) {
+        // score upper bounds hold till the end of postings
+        return doc_ = type_limits<type_t::doc_id_t>::eof();
+      }
+
+      for (size_t i = 0; i <= pivot; ++i) {
+        itrs_[i]->seek(target);
+      }
+    }
+  }
+
+  doc_iterators_t itrs_;
+  bstring buf_; // buffer for accumulating score upper bounds
+  const score_threshold* threshold_;
+  size_t lead_{}; // number of iterators positioned at the current document
+  doc_id_t doc_;
+}; // block_max_disjunction
+
 //////////////////////////////////////////////////////////////////////////////
 /// @returns disjunction iterator created from the specified sub iterators
 //////////////////////////////////////////////////////////////////////////////
@@ -24,7 +24,9 @@
 #ifndef IRESEARCH_EXCLUSION_H
 #define IRESEARCH_EXCLUSION_H
 
+#include "two_phase.hpp"
 #include "index/iterators.hpp"
+#include "utils/type_limits.hpp"
 
 NS_ROOT
 
@@ -33,30 +35,53 @@ NS_ROOT
 ////////////////////////////////////////////////////////////////////////////////
 class exclusion final : public doc_iterator {
  public:
-  exclusion(doc_iterator::ptr&& incl, doc_iterator::ptr&& excl) NOEXCEPT
+  exclusion(doc_iterator::ptr&& incl, doc_iterator::ptr&& excl)
     : incl_(std::move(incl)), excl_(std::move(excl)) {
     assert(incl_);
     assert(excl_);
+
+    // navigate approximations of two-phase iterators, verify them only
+    // for documents that survive the exclusion
+    incl_match_ = two_phase::extract(incl_->attributes());
+    excl_match_ = two_phase::extract(excl_->attributes());
+    incl_approx_ = incl_match_ ? &incl_match_->approximation() : incl_.get();
+    excl_approx_ = excl_match_ ? &excl_match_->approximation() : excl_.get();
+
+    // approximation of the included iterator isn't aware of exclusions,
+    // i.e. expose attributes of the included iterator with own two-phase
+    static_cast<attribute_view::base_t&>(attrs_) = incl_->attributes();
+    attrs_.remove<two_phase>();
+
+    if (incl_match_) {
+      attrs_.emplace(two_phase_);
+      two_phase_.reset(*incl_approx_, [this]()->bool {
+        return !excluded(incl_approx_->value()) && incl_match_->match();
+      });
+    }
   }
 
   virtual doc_id_t value() const override {
-    return incl_->value();
+    return incl_approx_->value();
   }
 
   virtual bool next() override {
-    if (!incl_->next()) {
+    if (!incl_approx_->next()) {
       return false;
     }
 
-    return !type_limits<type_t::doc_id_t>::eof(next(incl_->value()));
+    return !type_limits<type_t::doc_id_t>::eof(next(incl_approx_->value()));
   }
 
   virtual doc_id_t seek(doc_id_t target) override {
     if (!type_limits<type_t::doc_id_t>::valid(target)) {
-      return incl_->value();
+      return incl_approx_->value();
+    }
+
+    if (incl_match_ && target <= incl_approx_->value()) {
+      return incl_approx_->value(); // current document is already verified
     }
 
-    if (type_limits<type_t::doc_id_t>::eof(target = incl_->seek(target))) {
+    if (type_limits<type_t::doc_id_t>::eof(target = incl_approx_->seek(target))) {
       return target;
     }
 
@@ -64,29 +89,31 @@ class exclusion final : public doc_iterator {
   }
 
   virtual const attribute_view& attributes() const NOEXCEPT override {
-    return incl_->attributes();
+    return attrs_;
   }
 
  private:
-  // moves iterator to next not excluded
-  // document not less than "target"
-  doc_id_t next(doc_id_t target) {
-    auto excl = excl_->value();
+  // returns true if the specified document
+  // is matched by the excluded iterator
+  bool excluded(doc_id_t target) {
+    auto excl = excl_approx_->value();
 
     if (excl < target) {
-      excl = excl_->seek(target);
+      excl = excl_approx_->seek(target);
     }
 
-    for (; excl == target; ) {
-      if (!incl_->next()) {
-        return incl_->value();
-      }
-
-      target = incl_->value();
+    return excl == target && (!excl_match_ || excl_match_->match());
+  }
 
-      if (excl < target) {
-        excl = excl_->seek(target);
+  // moves iterator to next not excluded
+  // document not less than "target"
+  doc_id_t next(doc_id_t target) {
+    while (excluded(target) || (incl_match_ && !incl_match_->match())) {
+      if (!incl_approx_->next()) {
+        return incl_approx_->value();
       }
+
+      target = incl_approx_->value();
     }
 
     return target;
@@ -94,6 +121,12 @@ class exclusion final : public doc_iterator {
 
   doc_iterator::ptr incl_;
   doc_iterator::ptr excl_;
+  doc_iterator* incl_approx_; // navigated part of 'incl_'
+  doc_iterator* excl_approx_; // navigated part of 'excl_'
+  const two_phase* incl_match_; // nullptr unless 'incl_' is two-phase
+  const two_phase* excl_match_; // nullptr unless 'excl_' is two-phase
+  attribute_view attrs_;
+  two_phase two_phase_;
 }; // exclusion
 
 NS_END // ROOT
@@ -0,0 +1,357 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "filter_cache.hpp"
+#include "index/segment_reader.hpp"
+#include "search/score_doc_iterators.hpp"
+#include "utils/thread_utils.hpp"
+#include "utils/type_limits.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+
+NS_LOCAL
+
+typedef irs::type_limits<irs::type_t::doc_id_t> doc_limits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class cached_doc_iterator
+/// @brief iterator over documents stored in a 'filter_cache' entry
+////////////////////////////////////////////////////////////////////////////////
+class cached_doc_iterator final : public irs::doc_iterator_base {
+ public:
+  explicit cached_doc_iterator(irs::filter_cache::docs_ptr&& docs)
+    : doc_iterator_base(irs::order::prepared::unordered()),
+      docs_(std::move(docs)), // keep entry alive even if evicted
+      next_(docs_->begin()) {
+    // make doc_id accessible via attribute
+    attrs_.emplace(doc_);
+
+    // exact number of matched documents is known
+    estimate(docs_->size());
+  }
+
+  virtual bool next() NOEXCEPT override {
+    if (next_ == docs_->end()) {
+      doc_.value = doc_limits::eof();
+      return false;
+    }
+
+    doc_.value = *next_;
+    ++next_;
+    return true;
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) NOEXCEPT override {
+    if (target <= doc_.value) {
+      return doc_.value;
+    }
+
+    next_ = docs_->lower_bound(target);
+    next();
+
+    return doc_.value;
+  }
+
+  virtual irs::doc_id_t value() const NOEXCEPT override {
+    return doc_.value;
+  }
+
+ private:
+  irs::document doc_;
+  irs::filter_cache::docs_ptr docs_;
+  irs::filter_cache::docs_t::const_iterator next_; // next document to return
+}; // cached_doc_iterator
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class cached_query
+/// @brief serves unscored results of a nested query from a 'filter_cache'
+////////////////////////////////////////////////////////////////////////////////
+class cached_query final : public irs::filter::prepared {
+ public:
+  cached_query(
+      irs::filter::prepared::ptr&& query,
+      const std::shared_ptr<const irs::filter>& filter,
+      irs::filter_cache& cache,
+      bool admitted) NOEXCEPT
+    : query_(std::move(query)),
+      filter_(filter),
+      cache_(&cache),
+      admitted_(admitted) {
+  }
+
+  virtual irs::doc_iterator::ptr execute(
+      const irs::sub_reader& rdr,
+      const irs::order::prepared& ord,
+      const irs::attribute_view& ctx
+  ) const override {
+    // only segments reused across reader reopens have a stable identity
+    const auto* segment = dynamic_cast<const irs::segment_reader*>(&rdr);
+
+    if (!segment || !ord.empty()) {
+      return query_->execute(rdr, ord, ctx);
+    }
+
+    const irs::sub_reader::ptr impl(*segment);
+    auto docs = cache_->get(*filter_, impl);
+
+    if (!docs) {
+      auto it = query_->execute(rdr, ord, ctx);
+
+      if (!admitted_) {
+        return it;
+      }
+
+      irs::filter_cache::docs_t matched;
+
+      while (it->next()) {
+        matched.insert(it->value());
+      }
+
+      matched.optimize();
+      docs = cache_->put(filter_, impl, std::move(matched));
+    }
+
+    return irs::doc_iterator::make<cached_doc_iterator>(std::move(docs));
+  }
+
+ private:
+  irs::filter::prepared::ptr query_;
+  std::shared_ptr<const irs::filter> filter_;
+  irs::filter_cache* cache_;
+  bool admitted_; // results may be cached
+}; // cached_query
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                       filter_cache implementation
+// -----------------------------------------------------------------------------
+
+filter_cache::filter_cache(
+    size_t memory_limit,
+    size_t min_frequency /*= DEFAULT_MIN_FREQUENCY*/,
+    size_t history_size /*= DEFAULT_HISTORY_SIZE*/)
+  : history_(history_size, 0),
+    min_frequency_(min_frequency) {
+  stats_.limit = memory_limit;
+}
+
+/*static*/ size_t filter_cache::hash(
+    const filter& filter,
+    const sub_reader* segment) NOEXCEPT {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, filter.hash());
+  ::boost::hash_combine(seed, segment);
+  return seed;
+}
+
+bool filter_cache::admit(const filter& filter) {
+  const auto hash = filter.hash();
+
+  SCOPED_LOCK(mutex_);
+
+  if (history_.empty()) {
+    return min_frequency_ <= 1;
+  }
+
+  // current use counts as well
+  const size_t frequency = 1 + std::count(history_.begin(), history_.end(), hash);
+
+  history_[history_pos_] = hash;
+  history_pos_ = (history_pos_ + 1) % history_.size();
+
+  return frequency >= min_frequency_;
+}
+
+filter_cache::docs_ptr filter_cache::get(
+    const filter& filter,
+    const sub_reader::ptr& segment) {
+  const auto hash = filter_cache::hash(filter, segment.get());
+
+  SCOPED_LOCK(mutex_);
+
+  for (auto range = index_.equal_range(hash); range.first != range.second;) {
+    const auto it = range.first->second;
+    ++range.first; // 'erase' below invalidates current position
+
+    if (it->segment.expired()) {
+      erase(it); // segment is no longer in use, e.g. it has been merged
+      continue;
+    }
+
+    if (it->key == segment.get() && *it->filter == filter) {
+      entries_.splice(entries_.begin(), entries_, it); // mark as recently used
+      ++stats_.hits;
+      return it->docs;
+    }
+  }
+
+  ++stats_.misses;
+  return nullptr;
+}
+
+filter_cache::docs_ptr filter_cache::put(
+    const std::shared_ptr<const irs::filter>& filter,
+    const sub_reader::ptr& segment,
+    docs_t&& docs) {
+  assert(filter && segment);
+  auto cached = std::make_shared<const docs_t>(std::move(docs));
+  const auto hash = filter_cache::hash(*filter, segment.get());
+  const auto memory = sizeof(entry) + cached->memory();
+
+  SCOPED_LOCK(mutex_);
+
+  if (memory > stats_.limit) {
+    return cached; // entry does not fit the cache at all
+  }
+
+  // drop entry for the same key that may have been put concurrently
+  for (auto range = index_.equal_range(hash); range.first != range.second;) {
+    const auto it = range.first->second;
+    ++range.first;
+
+    if (it->key == segment.get() && *it->filter == *filter) {
+      erase(it);
+    }
+  }
+
+  purge(); // entries of segments no longer in use are never hit
+
+  // evict least recently used entries
+  while (!entries_.empty() && stats_.memory + memory > stats_.limit) {
+    erase(std::prev(entries_.end()));
+    ++stats_.evictions;
+  }
+
+  entries_.emplace_front();
+
+  auto& entry = entries_.front();
+  entry.filter = filter;
+  entry.segment = segment;
+  entry.key = segment.get();
+  entry.docs = cached;
+  entry.hash = hash;
+  entry.memory = memory;
+
+  index_.emplace(hash, entries_.begin());
+  stats_.memory += memory;
+  ++stats_.entries;
+
+  return cached;
+}
+
+void filter_cache::erase(entries_t::iterator it) {
+  for (auto range = index_.equal_range(it->hash); range.first != range.second; ++range.first) {
+    if (range.first->second == it) {
+      index_.erase(range.first);
+      break;
+    }
+  }
+
+  stats_.memory -= it->memory;
+  --stats_.entries;
+  entries_.erase(it);
+}
+
+void filter_cache::purge() {
+  for (auto it = entries_.begin(), end = entries_.end(); it != end;) {
+    if (it->segment.expired()) {
+      erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void filter_cache::clear() {
+  SCOPED_LOCK(mutex_);
+  index_.clear();
+  entries_.clear();
+  stats_.memory = 0;
+  stats_.entries = 0;
+}
+
+filter_cache::stats filter_cache::statistics() const {
+  SCOPED_LOCK(mutex_);
+  return stats_;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             cached implementation
+// -----------------------------------------------------------------------------
+
+DEFINE_FILTER_TYPE(cached)
+DEFINE_FACTORY_DEFAULT(cached)
+
+cached::cached() NOEXCEPT
+  : irs::filter(cached::type()) {
+}
+
+filter::prepared::ptr cached::prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx) const {
+  if (!filter_) {
+    return prepared::empty();
+  }
+
+  boost *= this->boost();
+
+  auto query = filter_->prepare(rdr, ord, boost, ctx);
+
+  if (!cache_ || !ord.empty()) {
+    return query; // scored results are never cached
+  }
+
+  return filter::prepared::make<cached_query>(
+    std::move(query), filter_, *cache_, cache_->admit(*filter_)
+  );
+}
+
+size_t cached::hash() const NOEXCEPT {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, filter::hash());
+  if (filter_) {
+    ::boost::hash_combine<const irs::filter&>(seed, *filter_);
+  }
+  return seed;
+}
+
+bool cached::equals(const iresearch::filter& rhs) const NOEXCEPT {
+  const auto& trhs = static_cast<const cached&>(rhs);
+
+  return filter::equals(rhs)
+    && ((!empty() && !trhs.empty() && *filter_ == *trhs.filter_)
+        || (empty() && trhs.empty()));
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
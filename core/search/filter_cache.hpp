@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_FILTER_CACHE_H
+#define IRESEARCH_FILTER_CACHE_H
+
+#include "filter.hpp"
+#include "index/index_reader.hpp"
+#include "utils/roaring_bitmap.hpp"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class filter_cache
+/// @brief memory bounded LRU cache of documents matched by unscored filters,
+///        entries are keyed by a filter and a segment they were evaluated
+///        against, a filter is admitted to the cache only after it has been
+///        used at least 'min_frequency' times among the recently used filters
+/// @note entries refer to segments via 'sub_reader::ptr', i.e. they remain
+///       valid as long as a segment is reused by 'directory_reader::reopen'
+/// @note thread-safe
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API filter_cache : util::noncopyable {
+ public:
+  typedef roaring_bitmap docs_t;
+  typedef std::shared_ptr<const docs_t> docs_ptr;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief cache statistics
+  //////////////////////////////////////////////////////////////////////////////
+  struct stats {
+    size_t hits{}; // number of lookups satisfied by the cache
+    size_t misses{}; // number of lookups not satisfied by the cache
+    size_t evictions{}; // number of entries evicted due to memory limit
+    size_t entries{}; // number of cached entries
+    size_t memory{}; // approximate amount of memory occupied by entries
+    size_t limit{}; // memory limit
+  }; // stats
+
+  static const size_t DEFAULT_MIN_FREQUENCY = 2;
+  static const size_t DEFAULT_HISTORY_SIZE = 256;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param memory_limit max amount of memory occupied by cached entries
+  /// @param min_frequency number of uses a filter needs among the last
+  ///        'history_size' ones to become eligible for caching
+  //////////////////////////////////////////////////////////////////////////////
+  explicit filter_cache(
+    size_t memory_limit,
+    size_t min_frequency = DEFAULT_MIN_FREQUENCY,
+    size_t history_size = DEFAULT_HISTORY_SIZE
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief records a use of the specified filter
+  /// @returns true if results of the filter should be cached
+  //////////////////////////////////////////////////////////////////////////////
+  bool admit(const filter& filter);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns documents matched by the specified filter in the specified
+  ///          segment or nullptr if there is no such entry
+  //////////////////////////////////////////////////////////////////////////////
+  docs_ptr get(const filter& filter, const sub_reader::ptr& segment);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief caches documents matched by the specified filter in the specified
+  ///        segment evicting least recently used entries if necessary
+  /// @returns cached documents
+  //////////////////////////////////////////////////////////////////////////////
+  docs_ptr put(
+    const std::shared_ptr<const filter>& filter,
+    const sub_reader::ptr& segment,
+    docs_t&& docs
+  );
+
+  void clear();
+
+  stats statistics() const;
+
+ private:
+  struct entry {
+    std::shared_ptr<const irs::filter> filter;
+    std::weak_ptr<const sub_reader> segment; // do not prolong segment lifetime
+    const sub_reader* key; // segment identity
+    docs_ptr docs;
+    size_t hash;
+    size_t memory;
+  }; // entry
+
+  typedef std::list<entry> entries_t; // most recently used first
+  typedef std::unordered_multimap<size_t, entries_t::iterator> index_t;
+
+  static size_t hash(const filter& filter, const sub_reader* segment) NOEXCEPT;
+
+  void erase(entries_t::iterator it); // requires 'mutex_' to be held
+  void purge(); // requires 'mutex_' to be held
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  mutable std::mutex mutex_;
+  entries_t entries_;
+  index_t index_;
+  std::vector<size_t> history_; // hashes of recently used filters
+  size_t history_pos_{};
+  size_t min_frequency_;
+  stats stats_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // filter_cache
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class cached
+/// @brief filter that serves results of a nested unscored filter from the
+///        specified 'filter_cache', materializing them on demand
+/// @note scored queries are delegated to the nested filter as is
+/// @note the nested filter is a part of cache keys, it must not be modified
+///       after the first execution, assign a new one instead
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API cached: public filter {
+ public:
+  DECLARE_FILTER_TYPE();
+  DECLARE_FACTORY();
+
+  cached() NOEXCEPT;
+
+  filter_cache* cache() const NOEXCEPT { return cache_; }
+
+  cached& cache(filter_cache* cache) NOEXCEPT {
+    cache_ = cache;
+    return *this;
+  }
+
+  const iresearch::filter* filter() const {
+    return filter_.get();
+  }
+
+  template<typename T>
+  const T* filter() const {
+    typedef typename std::enable_if <
+      std::is_base_of<iresearch::filter, T>::value, T
+    >::type type;
+
+    return static_cast<const type*>(filter_.get());
+  }
+
+  template<typename T>
+  T& filter() {
+    typedef typename std::enable_if <
+      std::is_base_of<iresearch::filter, T>::value, T
+    >::type type;
+
+    auto ptr = type::make();
+    auto& ref = static_cast<type&>(*ptr);
+    filter_ = std::move(ptr);
+    return ref;
+  }
+
+  void clear() { filter_.reset(); }
+  bool empty() const { return nullptr == filter_; }
+
+  using filter::prepare;
+
+  virtual filter::prepared::ptr prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx
+  ) const override;
+
+  virtual size_t hash() const NOEXCEPT override;
+
+ protected:
+  virtual bool equals(const iresearch::filter& rhs) const NOEXCEPT override;
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::shared_ptr<const iresearch::filter> filter_; // shared with cache entries
+  filter_cache* cache_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // cached
+
+NS_END // ROOT
+
+#endif // IRESEARCH_FILTER_CACHE_H
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_LEVENSHTEIN_FILTER_H
+#define IRESEARCH_LEVENSHTEIN_FILTER_H
+
+#include "term_filter.hpp"
+
+#include <algorithm>
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class by_edit_distance
+/// @brief user-side filter matching terms within the specified Levenshtein
+///        distance from a term
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API by_edit_distance final : public by_term {
+ public:
+  DECLARE_FILTER_TYPE();
+  DECLARE_FACTORY();
+
+  static const byte_type MAX_DISTANCE = 2;
+
+  by_edit_distance() NOEXCEPT;
+
+  using by_term::field;
+
+  by_edit_distance& field(std::string fld) {
+    by_term::field(std::move(fld));
+    return *this;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the max number of character edits, distances greater than
+  ///        MAX_DISTANCE are clamped
+  //////////////////////////////////////////////////////////////////////////////
+  by_edit_distance& max_distance(byte_type distance) {
+    max_distance_ = std::min(distance, byte_type(MAX_DISTANCE));
+    return *this;
+  }
+
+  byte_type max_distance() const { return max_distance_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief count transposition of adjacent characters as a single edit
+  //////////////////////////////////////////////////////////////////////////////
+  by_edit_distance& with_transpositions(bool value) {
+    with_transpositions_ = value;
+    return *this;
+  }
+
+  bool with_transpositions() const { return with_transpositions_; }
+
+  using filter::prepare;
+
+  virtual filter::prepared::ptr prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx
+  ) const override;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the maximum number of most frequent terms to consider for scoring
+  //////////////////////////////////////////////////////////////////////////////
+  by_edit_distance& scored_terms_limit(size_t limit) {
+    scored_terms_limit_ = limit;
+    return *this;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the maximum number of most frequent terms to consider for scoring
+  //////////////////////////////////////////////////////////////////////////////
+  size_t scored_terms_limit() const {
+    return scored_terms_limit_;
+  }
+
+  virtual size_t hash() const NOEXCEPT override;
+
+ protected:
+  virtual bool equals(const filter& rhs) const NOEXCEPT override;
+
+ private:
+  size_t scored_terms_limit_{1024};
+  byte_type max_distance_{1};
+  bool with_transpositions_{false};
+}; // by_edit_distance
+
+NS_END
+
+#endif
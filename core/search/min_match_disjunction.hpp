@@ -25,6 +25,7 @@
 #define IRESEARCH_MIN_MATCH_DISJUNCTION_H
 
 #include "disjunction.hpp"
+#include "two_phase.hpp"
 
 NS_ROOT
 
@@ -48,21 +49,33 @@ class min_match_disjunction : public doc_iterator_base {
     cost_iterator_adapter(irs::doc_iterator::ptr&& it) NOEXCEPT
       : score_iterator_adapter(std::move(it)) {
       est = cost::extract(this->it->attributes(), cost::MAX);
+      match = two_phase::extract(this->it->attributes());
+      approx = match ? &match->approximation() : this->it.get();
     }
 
     cost_iterator_adapter(cost_iterator_adapter&& rhs) NOEXCEPT
-      : score_iterator_adapter(std::move(rhs)), est(rhs.est) {
+      : score_iterator_adapter(std::move(rhs)),
+        est(rhs.est), match(rhs.match), approx(rhs.approx) {
     }
 
     cost_iterator_adapter& operator=(cost_iterator_adapter&& rhs) NOEXCEPT {
       if (this != &rhs) {
         score_iterator_adapter::operator=(std::move(rhs));
         est = rhs.est;
+        match = rhs.match;
+        approx = rhs.approx;
       }
       return *this;
     }
 
+    // navigation goes through the approximation of a two-phase iterator
+    doc_iterator* operator->() const NOEXCEPT {
+      return approx;
+    }
+
     cost::cost_t est;
+    const two_phase* match; // nullptr unless iterator is two-phase
+    doc_iterator* approx; // navigated part of 'it'
   }; // cost_iterator_adapter
 
   typedef cost_iterator_adapter doc_iterator_t;
@@ -79,11 +92,15 @@ class min_match_disjunction : public doc_iterator_base {
     assert(!itrs_.empty());
     assert(min_match_count_ >= 1 && min_match_count_ <= itrs_.size());
 
+    two_phase_ = std::any_of(
+      itrs_.begin(), itrs_.end(),
+      [](const doc_iterator_t& it) { return nullptr != it.match; });
+
     // sort subnodes in ascending order by their cost
     std::sort(
       itrs_.begin(), itrs_.end(),
       [](const doc_iterator_t& lhs, const doc_iterator_t& rhs) {
-        return cost::extract(lhs->attributes(), 0) < cost::extract(rhs->attributes(), 0);
+        return cost::extract(lhs.it->attributes(), 0) < cost::extract(rhs.it->attributes(), 0);
     });
 
     // estimate disjunction
@@ -92,7 +109,7 @@ class min_match_disjunction : public doc_iterator_base {
         // estimate only first min_match_count_ subnodes
         itrs_.begin(), itrs_.end(), cost::cost_t(0),
         [](cost::cost_t lhs, const doc_iterator_t& rhs) {
-          return lhs + cost::extract(rhs->attributes(), 0);
+          return lhs + cost::extract(rhs.it->attributes(), 0);
       });
     });
 
@@ -140,7 +157,15 @@ class min_match_disjunction : public doc_iterator_base {
       do {
         add_lead();
         if (lead_ >= min_match_count_) {
-          return !type_limits<type_t::doc_id_t>::eof(doc_ = top);
+          if (type_limits<type_t::doc_id_t>::eof(doc_ = top) || !two_phase_) {
+            return !type_limits<type_t::doc_id_t>::eof(doc_);
+          }
+
+          if (verify()) {
+            return true;
+          }
+
+          break; // not enough matches, start next iteration
         }
       } while (top == this->top()->value());
     }
@@ -194,7 +219,8 @@ class min_match_disjunction : public doc_iterator_base {
 
     // check if we still satisfy search criteria
     if (lead_ >= min_match_count_) {
-      return doc_ = target;
+      doc_ = target;
+      return accept();
     }
 
     // main search loop
@@ -211,7 +237,8 @@ class min_match_disjunction : public doc_iterator_base {
           // valid iterator, doc == target
           add_lead();
           if (lead_ >= min_match_count_) {
-            return (doc_ = target);
+            doc_ = target;
+            return accept();
           }
         } else {
           // invalid iterator, doc != target
@@ -361,29 +388,84 @@ class min_match_disjunction : public doc_iterator_base {
     ++lead_;
   }
 
-  inline void score_impl(byte_type* lhs) {
-    assert(!itrs_.empty());
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief push all head iterators positioned at the current doc to lead
+  //////////////////////////////////////////////////////////////////////////////
+  inline void hitch_head() {
+    while (lead() != itrs_.begin() && top()->value() <= doc_) {
+      if (top()->value() == doc_) {
+        // got hit here
+        add_lead();
+      } else if (type_limits<type_t::doc_id_t>::eof(top()->seek(doc_))) {
+        // iterator exhausted
+        if (!remove_top()) {
+          return;
+        }
+      } else {
+        refresh_top();
+      }
+    }
+  }
 
-    // push all valid iterators to lead
-    {
-      for(auto lead = this->lead(), begin = itrs_.begin();
-          lead != begin && top()->value() <= doc_;) {
-        // hitch head
-        if (top()->value() == doc_) {
-          // got hit here
-          add_lead();
-          --lead;
-        } else {
-          if (type_limits<type_t::doc_id_t>::eof(top()->seek(doc_))) {
-            // iterator exhausted
-            remove_top();
-          } else {
-            refresh_top();
-          }
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief verifies two-phase iterators of the lead group, the ones failed
+  ///        to match the current doc are moved to the head
+  /// @returns true - if the current doc satisfies the min_match_count_
+  ///          condition, false - otherwise
+  //////////////////////////////////////////////////////////////////////////////
+  bool verify() {
+    hitch_head();
+
+    for (auto it = lead(), end = itrs_.end(); it != end;) {
+      if (!it->match || it->match->match()) {
+        ++it;
+        continue;
+      }
+
+      if (!(*it)->next()) {
+        --lead_;
+
+        // iterator exhausted
+        if (!remove_lead(it)) {
+          return false;
         }
+
+#ifdef _MSC_VER
+        // Microsoft invalidates iterator
+        it = lead();
+#endif
+
+        // update end
+        end = itrs_.end();
+      } else {
+        // move back to head
+        push_head(it);
+        --lead_;
+        ++it;
       }
     }
 
+    return lead_ >= min_match_count_;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief accepts the current doc if it's verified, moves to the next
+  ///        matching doc otherwise
+  //////////////////////////////////////////////////////////////////////////////
+  inline doc_id_t accept() {
+    if (two_phase_ && !verify()) {
+      next();
+    }
+
+    return doc_;
+  }
+
+  inline void score_impl(byte_type* lhs) {
+    assert(!itrs_.empty());
+
+    // push all valid iterators to lead
+    hitch_head();
+
     // score lead iterators
     std::for_each(
       lead(), itrs_.end(),
@@ -396,6 +478,7 @@ class min_match_disjunction : public doc_iterator_base {
   size_t min_match_count_; // minimum number of hits
   size_t lead_; // number of iterators in lead group
   doc_id_t doc_; // current doc
+  bool two_phase_; // at least one of sub iterators is two-phase
 }; // min_match_disjunction
 
 NS_END // ROOT
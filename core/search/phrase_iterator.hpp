@@ -26,6 +26,7 @@
 
 #include "shared.hpp"
 #include "conjunction.hpp"
+#include "two_phase.hpp"
 
 NS_ROOT
 
@@ -59,6 +60,13 @@ class phrase_iterator final : public doc_iterator_base {
     // set attributes
     attrs_.emplace(phrase_freq_); // phrase frequency
     attrs_.emplace(doc_); // document (required by scorers)
+    attrs_.emplace(two_phase_); // verify positions only if required
+
+    // approximation by terms, positions are verified on demand
+    two_phase_.reset(approx_, [this]()->bool {
+      doc_.value = approx_.value();
+      return 0 != (phrase_freq_.value = phrase_freq());
+    });
 
     // set scorers
     scorers_ = ord_->prepare_scorers(segment, field, stats, attributes());
@@ -138,6 +146,7 @@ class phrase_iterator final : public doc_iterator_base {
   conjunction approx_; // first approximation (conjunction over all words in a phrase)
   document doc_; // document itself
   frequency phrase_freq_; // freqency of the phrase in a document
+  two_phase two_phase_; // approximation by terms and verification by positions
   positions_t pos_; // list of desired positions along with corresponding attributes
 }; // phrase_iterator
 
@@ -152,6 +152,9 @@ void limited_sample_scorer::score(
     scored_state.state.scored_states.emplace(
       scored_state.state_offset, itr->second->filter_attrs
     );
+    scored_state.state.scored_cookies.emplace(
+      scored_state.state_offset, std::move(scored_state.cookie)
+    );
   }
 }
 
@@ -193,19 +196,19 @@ doc_iterator::ptr range_query::execute(
     ));
   }
 
-  size_t last_offset = 0;
-
   // add an iterator for each of the scored states
   for (auto& entry: state->scored_states) {
     auto offset = entry.first;
     auto& stats = entry.second;
-    assert(offset >= last_offset);
+    auto cookie = state->scored_cookies.find(offset);
 
-    if (!skip(*terms, offset - last_offset)) {
-      continue; // reached end of iterator
+    // use bytes_ref::NIL here since we just "jump" to the cached state
+    if (cookie == state->scored_cookies.end()
+        || !cookie->second
+        || !terms->seek(bytes_ref::NIL, *cookie->second)) {
+      continue; // some internal error that caused the term to disappear
     }
 
-    last_offset = offset;
     itrs.emplace_back(doc_iterator::make<basic_doc_iterator>(
       rdr,
       *state->reader,
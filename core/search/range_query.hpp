@@ -58,6 +58,7 @@ struct range_state {
     estimation = std::move(other.estimation);
     count = std::move(other.count);
     scored_states = std::move(other.scored_states);
+    scored_cookies = std::move(other.scored_cookies);
     unscored_docs = std::move(other.unscored_docs);
     other.reader = nullptr;
     other.count = 0;
@@ -76,6 +77,10 @@ struct range_state {
   // range_query::execute(...) expects an orderd map
   std::map<size_t, attribute_store> scored_states;
 
+  // cookies of scored terms by their offset in range_state, allow to reach
+  // scored terms directly, e.g. when matched terms are not adjacent
+  std::map<size_t, seek_term_iterator::cookie_ptr> scored_cookies;
+
   // matching doc_ids that may have been skipped while collecting statistics and should not be scored by the disjunction
   bitset unscored_docs;
 }; // reader_state
@@ -127,7 +132,7 @@ class limited_sample_scorer {
 
 //////////////////////////////////////////////////////////////////////////////
 /// @class range_query
-/// @brief compiled query suitable for filters with continious range of terms
+/// @brief compiled query suitable for filters matching multiple terms
 ///        like "by_range" or "by_prefix". 
 //////////////////////////////////////////////////////////////////////////////
 class range_query : public filter::prepared {
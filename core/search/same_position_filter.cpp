@@ -25,6 +25,7 @@
 #include "same_position_filter.hpp"
 #include "term_query.hpp"
 #include "conjunction.hpp"
+#include "two_phase.hpp"
 
 #include "index/field_meta.hpp"
 
@@ -44,8 +45,13 @@ class same_position_iterator final : public conjunction {
       const order::prepared& ord,
       positions_t&& pos)
     : conjunction(std::move(itrs), ord),
-      pos_(std::move(pos)) {
+      pos_(std::move(pos)),
+      approx_(*this) {
     assert(!pos_.empty());
+
+    // approximation by terms, positions are verified on demand
+    attrs_.emplace(two_phase_);
+    two_phase_.reset(approx_, [this]()->bool { return find_same_position(); });
   }
 
 #if defined(_MSC_VER)
@@ -78,7 +84,44 @@ class same_position_iterator final : public conjunction {
     return this->value();
   }
 
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    // every candidate has to be verified by positions
+    return doc_iterator::next_batch(docs, freqs, size);
+  }
+
  private:
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief conjunction of terms without verification of positions
+  ////////////////////////////////////////////////////////////////////////////
+  class approximation final : public doc_iterator {
+   public:
+    explicit approximation(same_position_iterator& owner) NOEXCEPT
+      : owner_(&owner) {
+    }
+
+    virtual const attribute_view& attributes() const NOEXCEPT override {
+      return attribute_view::empty_instance();
+    }
+
+    virtual bool next() override {
+      return owner_->conjunction::next();
+    }
+
+    virtual doc_id_t seek(doc_id_t target) override {
+      return owner_->conjunction::seek(target);
+    }
+
+    virtual doc_id_t value() const override {
+      return owner_->conjunction::value();
+    }
+
+   private:
+    same_position_iterator* owner_;
+  }; // approximation
+
   bool find_same_position() {
     auto target = type_limits<type_t::pos_t>::min();
 
@@ -100,6 +143,8 @@ class same_position_iterator final : public conjunction {
   }
 
   positions_t pos_;
+  approximation approx_;
+  two_phase two_phase_;
 }; // same_position_iterator
 
 // per segment terms state
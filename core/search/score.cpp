@@ -24,6 +24,8 @@
 #include "shared.hpp"
 #include "score.hpp"
 
+#include "utils/type_limits.hpp"
+
 NS_LOCAL
 
 const irs::score EMPTY_SCORE;
@@ -46,6 +48,34 @@ score::score() NOEXCEPT
   : func_([](byte_type*){}) {
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                      score_bound
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_bound)
+
+score_bound::score_bound() NOEXCEPT
+  : func_([](doc_id_t, byte_type*) {
+      return type_limits<type_t::doc_id_t>::eof();
+    }) {
+}
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                                      score_batch
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_batch)
+
+score_batch::score_batch() NOEXCEPT
+  : func_([](const doc_id_t*, const uint32_t*, size_t, byte_type*){}) {
+}
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                                  score_threshold
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_threshold)
+
 NS_END // ROOT
 
 // -----------------------------------------------------------------------------
@@ -88,6 +88,138 @@ class IRESEARCH_API score : public attribute {
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // score
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_bound
+/// @brief represents upper bounds of the document scores produced by an
+///        iterator, both for all documents and for the block of documents
+///        containing a given target
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API score_bound : public attribute {
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves the block cursor to the block containing 'target' and
+  ///        stores upper bound of the block scores into the specified buffer
+  /// @returns the last document of the block, eof() if unknown
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<doc_id_t(doc_id_t, byte_type*)> shallow_seek_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_bound() NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns upper bound of the score of every document of an iterator
+  //////////////////////////////////////////////////////////////////////////////
+  const byte_type* max() const NOEXCEPT {
+    return max_.c_str();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns upper bound of the score of every document in the block
+  ///          located by the last call to 'shallow_seek(...)'
+  //////////////////////////////////////////////////////////////////////////////
+  const byte_type* block() const NOEXCEPT {
+    return block_.c_str();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves the block cursor to the block containing 'target' without
+  ///        moving the owning iterator, 'target' must not decrease
+  /// @returns the last document of the block, eof() if unknown
+  //////////////////////////////////////////////////////////////////////////////
+  doc_id_t shallow_seek(doc_id_t target) {
+    assert(func_);
+    return func_(target, &block_[0]);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief prepares score buffers for the specified order
+  /// @returns buffer for the upper bound of the score of every document
+  //////////////////////////////////////////////////////////////////////////////
+  byte_type* prepare(const order::prepared& ord, shallow_seek_f&& func) {
+    max_.resize(ord.size());
+    block_.resize(ord.size());
+    ord.prepare_score(&max_[0]);
+    ord.prepare_score(&block_[0]);
+    func_ = std::move(func);
+
+    return &max_[0];
+  }
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  bstring max_;
+  bstring block_;
+  shallow_seek_f func_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // score_bound
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_batch
+/// @brief evaluates scores of a batch of documents produced by an iterator,
+///        e.g. via 'doc_iterator::next_batch(...)', at once
+/// @note an iterator may require the batch to consist of documents returned
+///       by its last 'next_batch(...)' call, possibly filtered, plus its
+///       current document, e.g. a disjunction scoring documents while
+///       reading them, scores are matched to documents by their ids
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API score_batch : public attribute {
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief stores scores of 'size' documents having the specified ids and
+  ///        in-document frequencies into the specified buffer
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<void(
+    const doc_id_t*, const uint32_t*, size_t, byte_type*
+  )> score_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_batch() NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief evaluates scores of 'size' documents, the score of the i-th
+  ///        document is stored at 'scores + i*ord.size()'
+  /// @param freqs in-document frequencies of the documents, must not be nullptr
+  //////////////////////////////////////////////////////////////////////////////
+  void evaluate(
+      const doc_id_t* docs,
+      const uint32_t* freqs,
+      size_t size,
+      byte_type* scores) const {
+    assert(func_);
+    func_(docs, freqs, size, scores);
+  }
+
+  void prepare(score_f&& func) {
+    func_ = std::move(func);
+  }
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  score_f func_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // score_batch
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_threshold
+/// @brief represents the score a document has to reach in order to be
+///        collected, i.e. the score of the worst entry of a full top-k heap,
+///        documents which score is worse may be skipped by the query
+/// @note passed via query execution context, empty value denotes no threshold
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API score_threshold : attribute {
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_threshold() = default;
+
+  void clear() {
+    value.clear();
+  }
+
+  bstring value;
+}; // score_threshold
+
 NS_END // ROOT
 
 #endif // IRESEARCH_SCORE_H
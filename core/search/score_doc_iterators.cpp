@@ -60,6 +60,52 @@ basic_doc_iterator::basic_doc_iterator(
   prepare_score([this](byte_type* score) {
     scorers_.score(*ord_, score);
   });
+
+  // set score upper bounds
+  prepare_bound();
+
+  // set batch scoring
+  prepare_batch();
+}
+
+void basic_doc_iterator::prepare_bound() {
+  auto* freq = it_->attributes().get<frequency_bound>().get();
+
+  if (!freq || ord_->empty()) {
+    return; // frequency bounds are not supported by postings
+  }
+
+  auto* max = bound_.prepare(
+    *ord_,
+    [this, freq](doc_id_t target, byte_type* score) {
+      const auto doc = freq->shallow_seek(target);
+      scorers_.bound(*ord_, score, freq->block);
+      return doc;
+  });
+
+  if (scorers_.bound(*ord_, max, freq->value)) {
+    attrs_.emplace(bound_);
+  }
+}
+
+void basic_doc_iterator::prepare_batch() {
+  if (ord_->empty()
+      || !it_->attributes().contains<frequency>()
+      || !scorers_.score(*ord_, nullptr, nullptr, 0, nullptr)) {
+    return; // batch scoring is not supported by scorers
+  }
+
+  batch_.prepare([this](
+      const doc_id_t* docs, const uint32_t* freqs,
+      size_t size, byte_type* scores) {
+    scorers_.score(*ord_, docs, freqs, size, scores);
+  });
+
+  attrs_.emplace(batch_);
+
+  // expose frequencies of the postings for consumers of batches,
+  // e.g. a disjunction reading documents of the sub-iterators one by one
+  attrs_.emplace(*it_->attributes().get<frequency>());
 }
 
 #if defined(_MSC_VER)
@@ -91,8 +91,18 @@ class basic_doc_iterator final : public doc_iterator_base {
     return it_->seek(target);
   }
 
+  virtual size_t next_batch(
+      doc_id_t* docs, uint32_t* freqs, size_t size) override {
+    return it_->next_batch(docs, freqs, size);
+  }
+
  private:
+  void prepare_bound();
+  void prepare_batch();
+
   order::prepared::scorers scorers_;
+  irs::score_bound bound_;
+  irs::score_batch batch_;
   doc_iterator::ptr it_;
   const attribute_store* stats_;
 }; // basic_doc_iterator
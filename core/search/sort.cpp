@@ -300,6 +300,58 @@ void order::prepared::scorers::score(
   });
 }
 
+bool order::prepared::scorers::bound(
+  const order::prepared& ord, byte_type* scr, uint32_t freq
+) const {
+  size_t i = 0;
+
+  for (auto& scorer : scorers_) {
+    const sort::prepared& bucket = *ord[i++].bucket;
+
+    if (scorer) {
+      if (!scorer->bound(scr, freq)) {
+        return false;
+      }
+    } else {
+      bucket.prepare_score(scr); // score is never set by a missing scorer
+    }
+
+    scr += bucket.size();
+  }
+
+  return true;
+}
+
+bool order::prepared::scorers::score(
+    const order::prepared& ord,
+    const doc_id_t* docs,
+    const uint32_t* freqs,
+    size_t size,
+    byte_type* scr
+) const {
+  const size_t stride = ord.size();
+  size_t i = 0;
+
+  for (auto& scorer : scorers_) {
+    const sort::prepared& bucket = *ord[i++].bucket;
+
+    if (scorer) {
+      if (!scorer->score(docs, freqs, size, scr, stride)) {
+        return false;
+      }
+    } else {
+      // score is never set by a missing scorer
+      for (size_t j = 0; j < size; ++j) {
+        bucket.prepare_score(scr + j*stride);
+      }
+    }
+
+    scr += bucket.size();
+  }
+
+  return true;
+}
+
 order::prepared::prepared() : size_(0) { }
 
 order::prepared::collectors order::prepared::prepare_collectors(
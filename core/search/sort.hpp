@@ -29,6 +29,7 @@
 #include "utils/attributes_provider.hpp"
 #include "utils/iterator.hpp"
 
+#include <cstring>
 #include <vector>
 
 NS_ROOT
@@ -131,6 +132,32 @@ class IRESEARCH_API sort {
     /// @brief set the document score based on the stored state
     ////////////////////////////////////////////////////////////////////////////////
     virtual void score(byte_type* score_buf) = 0;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set the upper bound of the score of documents having the
+    ///        'frequency' attribute value not greater than the specified one
+    /// @returns false if the scorer is unable to provide such a bound
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual bool bound(byte_type* /*score_buf*/, uint32_t /*freq*/) const {
+      return false;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set the scores of 'size' documents of the segment the scorer was
+    ///        prepared for, e.g. as returned by 'doc_iterator::next_batch(...)',
+    ///        the score of the i-th document is stored at 'score_buf + i*stride'
+    /// @param freqs in-document frequencies of the documents, must not be nullptr
+    /// @returns false if the scorer is unable to score documents in batches
+    /// @note scorer state (attributes of the scored iterator) isn't used
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual bool score(
+        const doc_id_t* /*docs*/,
+        const uint32_t* /*freqs*/,
+        size_t /*size*/,
+        byte_type* /*score_buf*/,
+        size_t /*stride*/) {
+      return false;
+    }
   }; // scorer
 
   template <typename T>
@@ -142,6 +169,24 @@ class IRESEARCH_API sort {
       assert(score_buf);
       return *reinterpret_cast<T*>(score_buf);
     }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief store 'size' contiguous scores into the buffer of a batch, i.e.
+    ///        the i-th score goes to 'score_buf + i*stride'
+    ////////////////////////////////////////////////////////////////////////////////
+    static void score_store(
+        const T* scores, size_t size,
+        byte_type* score_buf, size_t stride) NOEXCEPT {
+      if (sizeof(T) == stride) {
+        std::memcpy(score_buf, scores, size*sizeof(T));
+        return;
+      }
+
+      for (auto* end = scores + size; scores != end; ++scores) {
+        std::memcpy(score_buf, scores, sizeof(T));
+        score_buf += stride;
+      }
+    }
   }; // scorer_base
 
   //////////////////////////////////////////////////////////////////////////////
@@ -553,6 +598,26 @@ class IRESEARCH_API order final {
 
       void score(const prepared& ord, byte_type* score) const;
 
+      //////////////////////////////////////////////////////////////////////////
+      /// @brief set the upper bound of the score of documents having the
+      ///        'frequency' attribute value not greater than 'freq'
+      /// @returns false if any of the scorers is unable to provide a bound
+      //////////////////////////////////////////////////////////////////////////
+      bool bound(const prepared& ord, byte_type* score, uint32_t freq) const;
+
+      //////////////////////////////////////////////////////////////////////////
+      /// @brief set the scores of 'size' documents, the score of the i-th
+      ///        document is stored at 'score + i*ord.size()'
+      /// @returns false if any of the scorers is unable to score in batches
+      //////////////////////////////////////////////////////////////////////////
+      bool score(
+        const prepared& ord,
+        const doc_id_t* docs,
+        const uint32_t* freqs,
+        size_t size,
+        byte_type* score
+      ) const;
+
      private:
       IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
       std::vector<sort::scorer::ptr> scorers_;
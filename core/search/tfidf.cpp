@@ -195,6 +195,10 @@ DEFINE_FACTORY_DEFAULT(idf)
 
 typedef tfidf_sort::score_t score_t;
 
+// number of documents scored at once by batch scoring, small enough
+// for the intermediate buffers to stay on the stack
+const size_t BATCH_SIZE = 64;
+
 class scorer : public irs::sort::scorer_base<tfidf::score_t> {
  public:
   DEFINE_FACTORY_INLINE(scorer)
@@ -212,11 +216,52 @@ class scorer : public irs::sort::scorer_base<tfidf::score_t> {
     score_cast(score_buf) = tfidf();
   }
 
+  virtual bool bound(byte_type* score_buf, uint32_t freq) const NOEXCEPT override {
+    // score is monotonic in 'freq' only for non-negative boost,
+    // length norm never exceeds 1 so it doesn't affect the bound
+    if (idf_ < 0.f) {
+      return false;
+    }
+
+    score_cast(score_buf) = idf_ * float_t(std::sqrt(freq));
+    return true;
+  }
+
+  virtual bool score(
+      const doc_id_t* /*docs*/,
+      const uint32_t* freqs,
+      size_t size,
+      byte_type* score_buf,
+      size_t stride) override {
+    float_t scores[BATCH_SIZE];
+
+    while (size) {
+      const size_t count = std::min(size, BATCH_SIZE);
+
+      tfidf(freqs, count, scores);
+      score_store(scores, count, score_buf, stride);
+
+      freqs += count;
+      score_buf += count*stride;
+      size -= count;
+    }
+
+    return true;
+  }
+
  protected:
   FORCE_INLINE float_t tfidf() const NOEXCEPT {
    return idf_ * float_t(std::sqrt(freq_->value));
   }
 
+  // branch-free loop over contiguous buffers, let compiler vectorize it
+  FORCE_INLINE void tfidf(
+      const uint32_t* freqs, size_t size, float_t* values) const NOEXCEPT {
+    for (size_t i = 0; i < size; ++i) {
+      values[i] = idf_ * float_t(std::sqrt(freqs[i]));
+    }
+  }
+
  private:
   float_t idf_; // precomputed : boost * idf
   const frequency* freq_;
@@ -240,6 +285,34 @@ class norm_scorer final : public scorer {
     score_cast(score_buf) = tfidf() * norm_->read();
   }
 
+  virtual bool score(
+      const doc_id_t* docs,
+      const uint32_t* freqs,
+      size_t size,
+      byte_type* score_buf,
+      size_t stride) override {
+    float_t scores[BATCH_SIZE];
+    float_t norms[BATCH_SIZE];
+
+    while (size) {
+      const size_t count = std::min(size, BATCH_SIZE);
+
+      tfidf(freqs, count, scores);
+      norm_->read(docs, count, norms);
+      for (size_t i = 0; i < count; ++i) {
+        scores[i] *= norms[i];
+      }
+      score_store(scores, count, score_buf, stride);
+
+      docs += count;
+      freqs += count;
+      score_buf += count*stride;
+      size -= count;
+    }
+
+    return true;
+  }
+
  private:
   const irs::norm* norm_;
 }; // norm_scorer
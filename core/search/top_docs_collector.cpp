@@ -0,0 +1,395 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "top_docs_collector.hpp"
+#include "index/index_reader.hpp"
+#include "utils/thread_utils.hpp"
+#include "utils/type_limits.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+NS_ROOT
+
+top_docs_collector::top_docs_collector(
+    const order::prepared& ord,
+    size_t limit,
+    const string_ref& sort_column /*= string_ref::NIL*/)
+  : ord_(&ord),
+    limit_(limit),
+    sort_column_(sort_column.c_str(), sort_column.size()),
+    scores_(limit * ord.size(), 0),
+    default_score_(ord.size(), 0) {
+  heap_.reserve(limit_);
+  threshold_.value.reserve(ord_->size());
+  ctx_.emplace(threshold_);
+
+  if (!ord_->empty()) {
+    ord_->prepare_score(&default_score_[0]);
+  }
+}
+
+bool top_docs_collector::less(
+    const byte_type* lhs_score, size_t lhs_segment, doc_id_t lhs_doc,
+    const slot& rhs) const {
+  const auto* rhs_score = score(rhs);
+
+  if (ord_->less(lhs_score, rhs_score)) {
+    return true;
+  }
+
+  if (ord_->less(rhs_score, lhs_score)) {
+    return false;
+  }
+
+  // equal scores, the earlier document ranks first
+  return lhs_segment < rhs.segment_ord
+    || (lhs_segment == rhs.segment_ord && lhs_doc < rhs.doc);
+}
+
+void top_docs_collector::next_segment(const sub_reader& segment) NOEXCEPT {
+  if (segment_ != &segment) {
+    if (segment_) {
+      ++segment_ord_;
+    }
+
+    segment_ = &segment;
+  }
+}
+
+void top_docs_collector::collect(
+    const index_reader& index,
+    const filter::prepared& filter) {
+  for (auto& segment : index) {
+    collect(segment, filter);
+  }
+}
+
+/*static*/ const size_t top_docs_collector::DEFAULT_RANGE_DOCS;
+
+void top_docs_collector::collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    async_utils::thread_pool& pool,
+    size_t range_docs /*= DEFAULT_RANGE_DOCS*/) {
+  struct range {
+    const sub_reader* segment;
+    doc_id_t begin;
+    doc_id_t end;
+  };
+
+  if (!limit_) {
+    return;
+  }
+
+  // split the index into ranges, large segments are split by document ids
+  std::vector<range> ranges;
+
+  for (auto& segment : index) {
+    auto begin = type_limits<type_t::doc_id_t>::min();
+
+    if (range_docs) {
+      const auto end = begin + segment.docs_count();
+
+      for (; end - begin > range_docs; begin += doc_id_t(range_docs)) {
+        ranges.push_back(range{ &segment, begin, doc_id_t(begin + range_docs) });
+      }
+    }
+
+    ranges.push_back(range{ &segment, begin, type_limits<type_t::doc_id_t>::eof() });
+  }
+
+  const size_t workers = std::min(pool.max_threads(), ranges.size());
+
+  if (workers < 2) {
+    for (auto& entry : ranges) {
+      collect(*entry.segment, filter, entry.begin, entry.end);
+    }
+
+    return;
+  }
+
+  // every range is collected into a separate collector, so that partial
+  // results could be merged in order regardless of the execution order
+  std::vector<std::unique_ptr<top_docs_collector>> partials(ranges.size());
+  std::atomic<size_t> next_range(0);
+  std::mutex mutex;
+  std::condition_variable cond;
+  size_t pending = workers;
+  std::exception_ptr error;
+
+  auto task = [this, &filter, &ranges, &partials, &next_range,
+               &mutex, &cond, &pending, &error]() NOEXCEPT {
+    std::exception_ptr task_error;
+
+    try {
+      // pick pending ranges until there are no more left
+      for (size_t i; (i = next_range++) < ranges.size(); ) {
+        auto& entry = ranges[i];
+        auto& partial = partials[i];
+
+        partial = memory::make_unique<top_docs_collector>(
+          *ord_, limit_, sort_column_
+        );
+        partial->collect(*entry.segment, filter, entry.begin, entry.end);
+      }
+    } catch (...) {
+      next_range = ranges.size(); // stop other workers
+      task_error = std::current_exception();
+    }
+
+    SCOPED_LOCK(mutex);
+
+    if (task_error && !error) {
+      error = std::move(task_error); // report the first failure
+    }
+
+    if (!--pending) {
+      cond.notify_all();
+    }
+  };
+
+  for (size_t i = 0; i < workers; ++i) {
+    if (!pool.run(task)) {
+      task(); // pool isn't active, collect in the current thread
+    }
+  }
+
+  // wait for completion, tasks reference local variables
+  {
+    SCOPED_LOCK_NAMED(mutex, lock);
+    cond.wait(lock, [&pending]()->bool { return !pending; });
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  // merge partial results in index order
+  for (auto& partial : partials) {
+    hits_ += partial->hits_;
+
+    for (auto& slot : partial->heap_) {
+      collect(*slot.segment, slot.doc, partial->score(slot));
+    }
+  }
+}
+
+void top_docs_collector::collect(
+    const sub_reader& segment,
+    const filter::prepared& filter) {
+  collect(
+    segment, filter,
+    type_limits<type_t::doc_id_t>::min(),
+    type_limits<type_t::doc_id_t>::eof()
+  );
+}
+
+void top_docs_collector::collect(
+    const sub_reader& segment,
+    const filter::prepared& filter,
+    doc_id_t begin,
+    doc_id_t end) {
+  if (!limit_) {
+    return;
+  }
+
+  const bool scored = !ord_->empty();
+
+  if (!scored && heap_.size() == limit_) {
+    return; // no chance for the rest of documents to get into the collector
+  }
+
+  // pass the score threshold to the query for early termination
+  auto docs = segment.mask(filter.execute(segment, *ord_, ctx_));
+  const irs::score& score = irs::score::extract(docs->attributes());
+  const byte_type* score_value = score.empty()
+    ? default_score_.c_str()
+    : score.c_str();
+
+  next_segment(segment);
+
+  if (type_limits<type_t::doc_id_t>::min() < begin
+      && type_limits<type_t::doc_id_t>::eof(docs->seek(begin))) {
+    return;
+  }
+
+  // documents of a segment ordered the same way as the query ranks them
+  // come best first, i.e. none of the documents following the one that
+  // didn't get into the collector can get into it either
+  const bool ordered = scored
+    && !sort_column_.empty()
+    && segment.sort_column() == sort_column_;
+  const auto& batch = docs->attributes().get<irs::score_batch>();
+
+  if (scored && batch) {
+    // document the iterator was positioned at by 'seek(begin)'
+    if (type_limits<type_t::doc_id_t>::min() < begin) {
+      if (docs->value() >= end) {
+        return;
+      }
+
+      ++hits_;
+      score.evaluate();
+
+      if (!collect(segment, docs->value(), score_value) && ordered) {
+        return;
+      }
+    }
+
+    collect(segment, *docs, *batch, end, ordered);
+    return;
+  }
+
+  for (bool next = type_limits<type_t::doc_id_t>::min() < begin || docs->next();
+       next && docs->value() < end;
+       next = docs->next()) {
+    ++hits_;
+
+    if (!score.empty()) {
+      score.evaluate();
+    }
+
+    if (!collect(segment, docs->value(), score_value) && ordered) {
+      break; // documents are coming best first
+    }
+
+    if (!scored && heap_.size() == limit_) {
+      break; // documents are coming in order
+    }
+  }
+}
+
+void top_docs_collector::collect(
+    const sub_reader& segment,
+    doc_iterator& docs,
+    const score_batch& batch,
+    doc_id_t end,
+    bool ordered) {
+  static const size_t BATCH_SIZE = 128; // arbitrary number of documents
+
+  doc_id_t ids[BATCH_SIZE];
+  uint32_t freqs[BATCH_SIZE];
+  const size_t score_size = ord_->size();
+
+  batch_scores_.resize(BATCH_SIZE*score_size);
+
+  for (size_t count; (count = docs.next_batch(ids, freqs, BATCH_SIZE));) {
+    batch.evaluate(ids, freqs, count, &batch_scores_[0]);
+
+    for (size_t i = 0; i < count; ++i) {
+      if (ids[i] >= end) {
+        return;
+      }
+
+      ++hits_;
+
+      if (!collect(segment, ids[i], batch_scores_.c_str() + i*score_size)
+          && ordered) {
+        return; // documents are coming best first
+      }
+    }
+  }
+}
+
+bool top_docs_collector::collect(
+    const sub_reader& segment,
+    doc_id_t doc,
+    const byte_type* score_value) {
+  const auto less = [this](const slot& lhs, const slot& rhs) {
+    return this->less(score(lhs), lhs.segment_ord, lhs.doc, rhs);
+  };
+
+  next_segment(segment);
+
+  if (sorted_) {
+    // restore heap after visitation
+    std::make_heap(heap_.begin(), heap_.end(), less);
+    sorted_ = false;
+  }
+
+  const size_t score_size = ord_->size();
+
+  if (heap_.size() < limit_) {
+    const size_t offset = heap_.size() * score_size;
+
+    std::memcpy(&scores_[0] + offset, score_value, score_size);
+    heap_.push_back(slot{ &segment, segment_ord_, offset, doc });
+    std::push_heap(heap_.begin(), heap_.end(), less);
+  } else if (limit_ && this->less(score_value, segment_ord_, doc, heap_.front())) {
+    // replace the worst document
+    std::pop_heap(heap_.begin(), heap_.end(), less);
+
+    auto& worst = heap_.back();
+    std::memcpy(&scores_[0] + worst.offset, score_value, score_size);
+    worst.segment = &segment;
+    worst.segment_ord = segment_ord_;
+    worst.doc = doc;
+    std::push_heap(heap_.begin(), heap_.end(), less);
+  } else {
+    return false;
+  }
+
+  if (score_size && heap_.size() == limit_) {
+    // buffer is preallocated, no allocation happens
+    threshold_.value.assign(score(heap_.front()), score_size);
+  }
+
+  return true;
+}
+
+bool top_docs_collector::visit(const visitor_f& visitor) {
+  if (!sorted_) {
+    std::sort_heap(
+      heap_.begin(), heap_.end(),
+      [this](const slot& lhs, const slot& rhs) {
+        return less(score(lhs), lhs.segment_ord, lhs.doc, rhs);
+    });
+    sorted_ = true;
+  }
+
+  for (auto& slot : heap_) {
+    if (!visitor(entry{ slot.segment, score(slot), slot.doc })) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void top_docs_collector::clear() NOEXCEPT {
+  heap_.clear();
+  threshold_.clear();
+  segment_ = nullptr;
+  segment_ord_ = 0;
+  hits_ = 0;
+  sorted_ = false;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
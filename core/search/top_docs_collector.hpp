@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_TOP_DOCS_COLLECTOR_H
+#define IRESEARCH_TOP_DOCS_COLLECTOR_H
+
+#include "filter.hpp"
+#include "score.hpp"
+#include "utils/async_utils.hpp"
+#include "utils/noncopyable.hpp"
+
+NS_ROOT
+
+struct index_reader;
+struct sub_reader;
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class top_docs_collector
+/// @brief collects the best 'limit' documents matched by a query across all
+///        segments of an index according to a specified order
+/// @note the collector keeps a fixed-size binary heap over the preallocated
+///       score buffers, i.e. there are no allocations per collected document
+/// @note documents with equal scores are ordered by segment, then by id
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API top_docs_collector : private util::noncopyable {
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collected document
+  //////////////////////////////////////////////////////////////////////////////
+  struct entry {
+    const sub_reader* segment; // segment the document belongs to
+    const byte_type* score; // document score, valid until the next collect
+    doc_id_t doc; // document id within the segment
+  }; // entry
+
+  typedef std::function<bool(const entry&)> visitor_f;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief default minimal number of documents in a segment range executed
+  ///        as a separate task by the parallel 'collect(...)'
+  //////////////////////////////////////////////////////////////////////////////
+  static const size_t DEFAULT_RANGE_DOCS = 65536;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param sort_column name of the column 'ord' ranks documents by, i.e.
+  ///        documents of a segment ordered by the column come best first
+  ///        (see 'sub_reader::sort_column()') and collection of such a
+  ///        segment stops at the first document that doesn't get into the
+  ///        collector, empty == 'ord' doesn't follow the order of any column
+  //////////////////////////////////////////////////////////////////////////////
+  top_docs_collector(
+    const order::prepared& ord,
+    size_t limit,
+    const string_ref& sort_column = string_ref::NIL
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief executes the query against every segment of the specified index
+  ///        and collects matched documents
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(const index_reader& index, const filter::prepared& filter);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief executes the query against every segment of the specified index
+  ///        concurrently on the specified pool and collects matched documents
+  /// @param range_docs segments having more documents are split into ranges
+  ///        of 'range_docs' documents executed independently, 0 - don't split
+  /// @note idle workers pick the next pending range, partial results are
+  ///       merged in segment order, i.e. collected documents are the same as
+  ///       the ones collected by the sequential 'collect(...)'
+  /// @note 'filter' must be prepared against the specified index
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    async_utils::thread_pool& pool,
+    size_t range_docs = DEFAULT_RANGE_DOCS
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief executes the query against the specified segment and collects
+  ///        matched documents, deleted documents are skipped
+  /// @note in case of empty order execution stops as soon as 'limit'
+  ///       documents are collected
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(const sub_reader& segment, const filter::prepared& filter);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collects a single document of the specified segment,
+  ///        segments are expected to be passed in order
+  /// @returns true if the document is among the best documents collected
+  //////////////////////////////////////////////////////////////////////////////
+  bool collect(
+    const sub_reader& segment, doc_id_t doc, const byte_type* score
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief score a document has to reach to get into the collector,
+  ///        empty until 'limit' documents are collected
+  /// @note may be passed to a query execution context for early termination
+  //////////////////////////////////////////////////////////////////////////////
+  const score_threshold& threshold() const NOEXCEPT { return threshold_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief visits collected documents, best first
+  /// @returns false if the visitor has terminated visitation, true otherwise
+  //////////////////////////////////////////////////////////////////////////////
+  bool visit(const visitor_f& visitor);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief resets the collector to the initial state, keeps allocated memory
+  //////////////////////////////////////////////////////////////////////////////
+  void clear() NOEXCEPT;
+
+  size_t limit() const NOEXCEPT { return limit_; }
+  size_t size() const NOEXCEPT { return heap_.size(); }
+  bool empty() const NOEXCEPT { return heap_.empty(); }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns number of documents produced by the queries, documents skipped
+  ///          by the queries due to the score threshold or left unvisited in
+  ///          segments ordered by 'sort_column' are not counted, i.e. a lower
+  ///          bound on the number of matching documents unless the queries
+  ///          are executed without pruning
+  //////////////////////////////////////////////////////////////////////////////
+  size_t hits() const NOEXCEPT { return hits_; }
+
+ private:
+  struct slot {
+    const sub_reader* segment;
+    size_t segment_ord; // ordinal of the segment within collect(...) calls
+    size_t offset; // offset of the score in 'scores_'
+    doc_id_t doc;
+  }; // slot
+
+  const byte_type* score(const slot& slot) const NOEXCEPT {
+    return scores_.c_str() + slot.offset;
+  }
+
+  // true if 'lhs' ranks before 'rhs'
+  bool less(
+    const byte_type* lhs_score, size_t lhs_segment, doc_id_t lhs_doc,
+    const slot& rhs
+  ) const;
+
+  void next_segment(const sub_reader& segment) NOEXCEPT;
+
+  // collects matched documents in range [begin, end) of the segment
+  void collect(
+    const sub_reader& segment,
+    const filter::prepared& filter,
+    doc_id_t begin,
+    doc_id_t end
+  );
+
+  // collects documents preceding 'end' read and scored in batches
+  // @param ordered documents come best first
+  void collect(
+    const sub_reader& segment,
+    doc_iterator& docs,
+    const score_batch& batch,
+    doc_id_t end,
+    bool ordered
+  );
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  const order::prepared* ord_;
+  size_t limit_;
+  std::string sort_column_; // column 'ord_' ranks documents by
+  std::vector<slot> heap_; // worst document on top
+  bstring scores_; // preallocated scores of 'limit_' documents
+  bstring default_score_; // score of documents matched by unscored queries
+  bstring batch_scores_; // scores of a batch of documents
+  score_threshold threshold_;
+  attribute_view ctx_; // query execution context
+  const sub_reader* segment_{}; // current segment
+  size_t segment_ord_{}; // ordinal of the current segment
+  size_t hits_{};
+  bool sorted_{}; // 'heap_' is sorted by 'visit(...)'
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // top_docs_collector
+
+NS_END // ROOT
+
+#endif // IRESEARCH_TOP_DOCS_COLLECTOR_H
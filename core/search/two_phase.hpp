@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_TWO_PHASE_H
+#define IRESEARCH_TWO_PHASE_H
+
+#include "index/iterators.hpp"
+#include "utils/attributes.hpp"
+
+#include <functional>
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class two_phase
+/// @brief splits iteration of a doc_iterator into a cheap approximation over
+///        a superset of its documents and a separate verification step, e.g.
+///        a phrase is approximated by the conjunction of its terms and
+///        verified by positions
+/// @note a consumer either advances the owning iterator or advances
+///       'approximation()' and calls 'match()' at most once per document,
+///       the owner's value() and attributes are valid after a
+///       successful 'match()'
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API two_phase : public attribute {
+ public:
+  typedef std::function<bool()> match_f;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns a "two_phase" attribute in the specified "src" collection
+  ///          or nullptr if there is no such attribute
+  //////////////////////////////////////////////////////////////////////////////
+  static const two_phase* extract(const attribute_view& src) NOEXCEPT {
+    const auto& attr = src.get<iresearch::two_phase>();
+    return attr && *attr ? attr.get() : nullptr;
+  }
+
+  DECLARE_ATTRIBUTE_TYPE();
+  two_phase() = default;
+
+  explicit operator bool() const NOEXCEPT {
+    return approx_ && match_;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns iterator over a superset of documents of the owning iterator
+  //////////////////////////////////////////////////////////////////////////////
+  doc_iterator& approximation() const NOEXCEPT {
+    assert(approx_);
+    return *approx_;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the current document of the approximation matches
+  //////////////////////////////////////////////////////////////////////////////
+  bool match() const {
+    assert(match_);
+    return match_();
+  }
+
+  void reset(doc_iterator& approx, match_f&& match) {
+    approx_ = &approx;
+    match_ = std::move(match);
+  }
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  doc_iterator* approx_{};
+  match_f match_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // two_phase
+
+NS_END // ROOT
+
+#endif // IRESEARCH_TWO_PHASE_H
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "wildcard_filter.hpp"
+#include "automaton_filter.hpp"
+
+#include <boost/functional/hash.hpp>
+
+NS_ROOT
+
+DEFINE_FILTER_TYPE(by_wildcard)
+DEFINE_FACTORY_DEFAULT(by_wildcard)
+
+by_wildcard::by_wildcard() NOEXCEPT
+  : by_term(by_wildcard::type()) {
+}
+
+filter::prepared::ptr by_wildcard::prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& /*ctx*/) const {
+  const auto acceptor = make_wildcard_automaton(term());
+
+  return prepare_automaton_filter(
+    field(), acceptor, scored_terms_limit_, rdr, ord, this->boost() * boost
+  );
+}
+
+size_t by_wildcard::hash() const NOEXCEPT {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, by_term::hash());
+  ::boost::hash_combine(seed, scored_terms_limit_);
+  return seed;
+}
+
+bool by_wildcard::equals(const filter& rhs) const NOEXCEPT {
+  const auto& trhs = static_cast<const by_wildcard&>(rhs);
+  return by_term::equals(rhs)
+    && scored_terms_limit_ == trhs.scored_terms_limit_;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -102,6 +102,14 @@ struct IRESEARCH_API index_input : public data_input {
   // specified offset without changing current position
   virtual int64_t checksum(size_t offset) const = 0;
 
+  // returns pointer to 'size' bytes of the underlying storage starting at
+  // a specified offset or nullptr if storage is not directly addressable,
+  // returned memory remains valid until the input is closed
+  virtual const byte_type* read_buffer(
+      size_t /*offset*/, size_t /*size*/) const NOEXCEPT {
+    return nullptr;
+  }
+
  private:
   index_input& operator=( const index_input& ) = delete;
 }; // index_input
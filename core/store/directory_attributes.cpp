@@ -73,6 +73,21 @@ void fd_pool_size::clear() NOEXCEPT {
   size = FD_POOL_DEFAULT_SIZE;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      fs_read_mode
+// -----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(fs_read_mode)
+DEFINE_FACTORY_DEFAULT(fs_read_mode)
+
+fs_read_mode::fs_read_mode() NOEXCEPT
+  : mode(STREAM) {
+}
+
+void fs_read_mode::clear() NOEXCEPT {
+  mode = STREAM;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   index_file_refs
 // -----------------------------------------------------------------------------
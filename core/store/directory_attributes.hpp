@@ -78,6 +78,26 @@ struct IRESEARCH_API fd_pool_size: public stored_attribute {
   size_t size;
 }; // fd_pool_size
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class fs_read_mode
+/// @brief the way data is read from files where applicable, e.g. fs_directory
+///        STREAM by default, POSITIONAL has to be requested explicitly
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API fs_read_mode: public stored_attribute {
+  enum mode_t {
+    STREAM, // buffered stream per input, reopened inputs use a pool of handles (default)
+    POSITIONAL // positional reads, all inputs share a single file descriptor
+  };
+
+  DECLARE_ATTRIBUTE_TYPE();
+  DECLARE_FACTORY();
+
+  fs_read_mode() NOEXCEPT;
+  void clear() NOEXCEPT;
+
+  mode_t mode;
+}; // fs_read_mode
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class index_file_refs
 /// @brief represents a ref_counter for index related files
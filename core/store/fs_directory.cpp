@@ -494,6 +494,169 @@ fs_index_input::file_handle::ptr pooled_fs_index_input::reopen(
   return handle;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class positional_fs_index_input
+/// @brief reads data at explicit offsets, i.e. there is neither a shared file
+///        position nor a stdio buffer copy and no seek per buffer refill,
+///        all duplicated/reopened instances share a single file descriptor
+//////////////////////////////////////////////////////////////////////////////
+class positional_fs_index_input final : public buffered_index_input {
+ public:
+  static index_input::ptr open(
+    const file_path_t name, IOAdvice /*advice*/
+  ) NOEXCEPT {
+    assert(name);
+
+    auto handle = file_handle::make();
+
+    handle->handle = file_open(name, "rb");
+
+    if (nullptr == handle->handle) {
+      auto path = boost::locale::conv::utf_to_utf<char>(name);
+
+      // even win32 uses 'errno' for error codes in calls to file_open(...)
+      IR_FRMT_ERROR("Failed to open input file, error: %d, path: %s", errno, path.c_str());
+
+      return nullptr;
+    }
+
+    handle->fd = file_no(handle->handle.get());
+
+    uint64_t size;
+
+    if (!file_utils::byte_size(size, handle->fd)) {
+      auto path = boost::locale::conv::utf_to_utf<char>(name);
+      #ifdef _WIN32
+        auto error = GetLastError();
+      #else
+        auto error = errno;
+      #endif
+
+      IR_FRMT_ERROR("Failed to get stat for input file, error: %d, path: %s", error, path.c_str());
+
+      return nullptr;
+    }
+
+    handle->size = size;
+
+    const auto buf_size = ::buffer_size(handle->handle.get());
+
+    try {
+      return index_input::make<positional_fs_index_input>(
+        std::move(handle), buf_size
+      );
+    } catch(...) {
+      IR_LOG_EXCEPTION();
+    }
+
+    return nullptr;
+  }
+
+  virtual int64_t checksum(size_t offset) const override {
+    const auto begin = file_pointer();
+    const auto end = (std::min)(begin + offset, handle_->size);
+
+    crc32c crc;
+    byte_type buf[1024];
+
+    for (auto pos = begin; pos < end; ) {
+      const auto to_read = (std::min)(end - pos, sizeof buf);
+      read(pos, buf, to_read);
+      crc.process_bytes(buf, to_read);
+      pos += to_read;
+    }
+
+    return crc.checksum();
+  }
+
+  virtual ptr dup() const override {
+    return index_input::make<positional_fs_index_input>(*this);
+  }
+
+  virtual size_t length() const override {
+    return handle_->size;
+  }
+
+  // there is no shared state except the file descriptor itself
+  virtual ptr reopen() const override {
+    return dup();
+  }
+
+ protected:
+  virtual void seek_internal(size_t pos) override {
+    if (pos >= handle_->size) {
+      throw io_error(string_utils::to_string(
+        "seek out of range for input file, length '" IR_SIZE_T_SPECIFIER "', position '" IR_SIZE_T_SPECIFIER "'",
+        handle_->size, pos
+      ));
+    }
+
+    pos_ = pos;
+  }
+
+  virtual size_t read_internal(byte_type* b, size_t len) override {
+    read(pos_, b, len);
+    pos_ += len;
+
+    return len;
+  }
+
+ private:
+  struct file_handle {
+    DECLARE_SHARED_PTR(file_handle);
+    DECLARE_FACTORY();
+
+    file_utils::handle_t handle; // native file handle
+    int fd{ -1 }; // file descriptor of 'handle'
+    size_t size{}; // file size
+  }; // file_handle
+
+  DEFINE_FACTORY_INLINE(index_input)
+
+  positional_fs_index_input(
+      file_handle::ptr&& handle,
+      size_t buffer_size) NOEXCEPT
+    : buffered_index_input(buffer_size),
+      handle_(std::move(handle)),
+      pos_(0) {
+    assert(handle_);
+  }
+
+  positional_fs_index_input(const positional_fs_index_input&) = default;
+  positional_fs_index_input& operator=(const positional_fs_index_input&) = delete;
+
+  // reads exactly 'len' bytes starting at 'pos'
+  void read(size_t pos, byte_type* b, size_t len) const {
+    assert(b);
+
+    for (size_t read = 0; read < len; ) {
+      const auto res = file_utils::read_at(
+        handle_->fd, pos + read, b + read, len - read
+      );
+
+      if (res < 0) {
+        // read error
+        throw io_error(string_utils::to_string(
+          "failed to read from input file, read '" IR_SIZE_T_SPECIFIER "' out of '" IR_SIZE_T_SPECIFIER "' bytes, error '%d'",
+          read, len, errno
+        ));
+      }
+
+      if (0 == res) {
+        // read past eof
+        throw eof_error();
+      }
+
+      read += size_t(res);
+    }
+  }
+
+  file_handle::ptr handle_; // shared file handle
+  size_t pos_; // current input stream position
+}; // positional_fs_index_input
+
+DEFINE_FACTORY_DEFAULT(positional_fs_index_input::file_handle)
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                       fs_directory implementation
 // -----------------------------------------------------------------------------
@@ -571,11 +734,16 @@ index_input::ptr fs_directory::open(
     IOAdvice advice) const NOEXCEPT {
   try {
     utf8_path path;
-    auto pool_size =
-      const_cast<attribute_store&>(attributes()).emplace<fd_pool_size>()->size;
+    auto& attrs = const_cast<attribute_store&>(attributes());
 
     (path/=dir_)/=name;
 
+    if (fs_read_mode::POSITIONAL == attrs.emplace<fs_read_mode>()->mode) {
+      return positional_fs_index_input::open(path.c_str(), advice);
+    }
+
+    auto pool_size = attrs.emplace<fd_pool_size>()->size;
+
     return fs_index_input::open(path.c_str(), pool_size, advice);
   } catch(...) {
     IR_LOG_EXCEPTION();
@@ -465,6 +465,11 @@ class IRESEARCH_API bytes_ref_input : public index_input {
 
   virtual int64_t checksum(size_t offset) const override final;
 
+  virtual const byte_type* read_buffer(
+      size_t offset, size_t size) const NOEXCEPT override final {
+    return offset + size <= data_.size() ? data_.c_str() + offset : nullptr;
+  }
+
  private:
   bytes_ref data_;
   const byte_type* pos_{ data_.begin() };
@@ -0,0 +1,635 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2018 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "store_utils_adaptive.hpp"
+#include "data_input.hpp"
+#include "data_output.hpp"
+#include "directory.hpp"
+
+#include "error/error.hpp"
+#include "utils/bytes_utils.hpp"
+#include "utils/bit_packing.hpp"
+#include "utils/cpuinfo.hpp"
+#include "utils/log.hpp"
+#include "utils/math_utils.hpp"
+#include "utils/std.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#ifdef IRESEARCH_SSE2
+  #include <immintrin.h>
+
+  #if defined(__GNUC__)
+    #define IRESEARCH_TARGET_AVX2 __attribute__((target("avx2")))
+  #else
+    #define IRESEARCH_TARGET_AVX2
+  #endif
+#endif
+
+NS_LOCAL
+
+using namespace irs;
+using namespace irs::encode::adaptive;
+
+typedef bytes_io<uint32_t, sizeof(uint32_t)> vint_io;
+typedef void(*unpack_f)(const uint32_t* RESTRICT, uint32_t* RESTRICT);
+
+const uint32_t LANES = 4; // number of interleaved lanes of packed data
+const uint32_t MAX_BITS = 32;
+
+CONSTEXPR uint32_t mask32(uint32_t bits) NOEXCEPT {
+  return uint32_t((uint64_t(1) << bits) - 1);
+}
+
+// number of bytes of packed data with the specified number of bits
+CONSTEXPR size_t packed_bytes(uint32_t bits) NOEXCEPT {
+  return BLOCK_SIZE / 8 * bits;
+}
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                            packed data decoders
+// ----------------------------------------------------------------------------
+
+void unpack_scalar(
+    const uint32_t* RESTRICT in,
+    uint32_t* RESTRICT out,
+    uint32_t bits) NOEXCEPT {
+  const uint32_t mask = mask32(bits);
+
+  for (size_t lane = 0; lane < LANES; ++lane) {
+    size_t word = lane;
+    uint32_t shift = 0;
+
+    for (size_t i = lane; i < BLOCK_SIZE; i += LANES) {
+      uint32_t value = in[word] >> shift;
+      shift += bits;
+
+      if (shift >= 32) {
+        shift -= 32;
+        word += LANES;
+
+        if (shift) {
+          value |= in[word] << (bits - shift);
+        }
+      }
+
+      out[i] = value & mask;
+    }
+  }
+}
+
+template<uint32_t Bits>
+void unpack_scalar(const uint32_t* RESTRICT in, uint32_t* RESTRICT out) {
+  unpack_scalar(in, out, Bits);
+}
+
+#ifdef IRESEARCH_SSE2
+
+// decodes all lanes at once, every 128-bit word holds a word of each lane
+template<uint32_t Bits>
+void unpack_sse2(const uint32_t* RESTRICT in, uint32_t* RESTRICT out) {
+  const __m128i* src = reinterpret_cast<const __m128i*>(in);
+  __m128i* dst = reinterpret_cast<__m128i*>(out);
+  const __m128i mask = _mm_set1_epi32(int(mask32(Bits)));
+  const uint32_t count = BLOCK_SIZE / LANES;
+
+  __m128i cur = _mm_loadu_si128(src);
+  uint32_t shift = 0;
+
+  for (uint32_t i = 0; i < count; ++i) {
+    __m128i value = _mm_srli_epi32(cur, int(shift));
+    shift += Bits;
+
+    if (shift >= 32 && i + 1 < count) {
+      shift -= 32;
+      cur = _mm_loadu_si128(++src);
+
+      if (shift) {
+        value = _mm_or_si128(value, _mm_slli_epi32(cur, int(Bits - shift)));
+      }
+    }
+
+    _mm_storeu_si128(dst + i, _mm_and_si128(value, mask));
+  }
+}
+
+// decodes both halves of all lanes at once, the second half of a lane
+// starts 'Bits/2' words after the first one and thus has the same
+// bit offsets only if the number of bits is even
+template<uint32_t Bits>
+IRESEARCH_TARGET_AVX2 void unpack_avx2(
+    const uint32_t* RESTRICT in,
+    uint32_t* RESTRICT out) {
+  static_assert(0 == Bits % 2, "number of bits must be even");
+
+  const __m128i* src = reinterpret_cast<const __m128i*>(in);
+  __m128i* dst = reinterpret_cast<__m128i*>(out);
+  const __m256i mask = _mm256_set1_epi32(int(mask32(Bits)));
+  const uint32_t count = BLOCK_SIZE / LANES / 2;
+  const uint32_t half = Bits / 2;
+
+  __m256i cur = _mm256_inserti128_si256(
+    _mm256_castsi128_si256(_mm_loadu_si128(src)),
+    _mm_loadu_si128(src + half), 1
+  );
+  uint32_t shift = 0;
+
+  for (uint32_t i = 0; i < count; ++i) {
+    __m256i value = _mm256_srli_epi32(cur, int(shift));
+    shift += Bits;
+
+    if (shift >= 32 && i + 1 < count) {
+      shift -= 32;
+      ++src;
+      cur = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(src)),
+        _mm_loadu_si128(src + half), 1
+      );
+
+      if (shift) {
+        value = _mm256_or_si256(value, _mm256_slli_epi32(cur, int(Bits - shift)));
+      }
+    }
+
+    value = _mm256_and_si256(value, mask);
+    _mm_storeu_si128(dst + i, _mm256_castsi256_si128(value));
+    _mm_storeu_si128(dst + i + count, _mm256_extracti128_si256(value, 1));
+  }
+}
+
+// odd number of bits is handled by the SSE2 decoder
+template<uint32_t Bits, bool Even = (0 == Bits % 2)>
+struct avx2_kernel {
+  static unpack_f get() NOEXCEPT { return &unpack_sse2<Bits>; }
+};
+
+template<uint32_t Bits>
+struct avx2_kernel<Bits, true> {
+  static unpack_f get() NOEXCEPT { return &unpack_avx2<Bits>; }
+};
+
+#endif // IRESEARCH_SSE2
+
+// decoders for every number of bits, index == number of bits
+struct kernels {
+  unpack_f scalar[MAX_BITS + 1]{};
+  unpack_f sse2[MAX_BITS + 1]{};
+  unpack_f avx2[MAX_BITS + 1]{};
+
+  kernels() NOEXCEPT {
+    fill<1>();
+  }
+
+  const unpack_f* get(isa_t isa) const NOEXCEPT {
+    switch (isa) {
+      case isa_t::SSE2: return sse2;
+      case isa_t::AVX2: return avx2;
+      default: return scalar;
+    }
+  }
+
+ private:
+  template<uint32_t Bits>
+  typename std::enable_if<(Bits > MAX_BITS)>::type fill() NOEXCEPT { }
+
+  template<uint32_t Bits>
+  typename std::enable_if<(Bits <= MAX_BITS)>::type fill() NOEXCEPT {
+    scalar[Bits] = &unpack_scalar<Bits>;
+#ifdef IRESEARCH_SSE2
+    sse2[Bits] = &unpack_sse2<Bits>;
+    avx2[Bits] = avx2_kernel<Bits>::get();
+#endif
+    fill<Bits + 1>();
+  }
+};
+
+const kernels& all_kernels() NOEXCEPT {
+  static const kernels KERNELS;
+  return KERNELS;
+}
+
+isa_t detect_isa() NOEXCEPT {
+#ifdef IRESEARCH_SSE2
+  return cpuinfo::support_avx2() ? isa_t::AVX2 : isa_t::SSE2;
+#else
+  return isa_t::SCALAR;
+#endif
+}
+
+// decoders selected once according to the current CPU
+const unpack_f* best_kernels() NOEXCEPT {
+  static const unpack_f* KERNELS = all_kernels().get(detect_isa());
+  return KERNELS;
+}
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                                 block encodings
+// ----------------------------------------------------------------------------
+
+void write_packed(
+    data_output& out,
+    const uint32_t* RESTRICT decoded,
+    uint32_t* RESTRICT encoded,
+    uint32_t bits) {
+  pack(decoded, encoded, bits);
+  out.write_bytes(reinterpret_cast<const byte_type*>(encoded), packed_bytes(bits));
+}
+
+void read_packed(
+    data_input& in,
+    uint32_t* RESTRICT encoded,
+    uint32_t* RESTRICT decoded,
+    uint32_t bits) {
+  const auto required = packed_bytes(bits);
+
+#ifdef IRESEARCH_DEBUG
+  const auto read = in.read_bytes(reinterpret_cast<byte_type*>(encoded), required);
+  assert(read == required);
+  UNUSED(read);
+#else
+  in.read_bytes(reinterpret_cast<byte_type*>(encoded), required);
+#endif // IRESEARCH_DEBUG
+
+  best_kernels()[bits](encoded, decoded);
+}
+
+// returns size of the bitmap of the specified span in bytes
+CONSTEXPR size_t dense_bytes(uint64_t span) NOEXCEPT {
+  return size_t((span + 7) / 8);
+}
+
+void write_dense(
+    data_output& out,
+    const uint32_t* RESTRICT decoded,
+    uint32_t* RESTRICT encoded,
+    uint32_t span) {
+  const auto size = dense_bytes(span);
+  assert(size <= BLOCK_SIZE*sizeof(uint32_t));
+  auto* bitmap = reinterpret_cast<byte_type*>(encoded);
+  std::memset(bitmap, 0, size);
+
+  uint32_t sum = 0;
+  for (size_t i = 1; i < BLOCK_SIZE; ++i) {
+    sum += decoded[i];
+    const uint32_t bit = sum - 1;
+    bitmap[bit / 8] |= byte_type(1 << (bit % 8));
+  }
+  assert(sum == span);
+
+  out.write_vint(decoded[0]);
+  out.write_vint(span);
+  out.write_bytes(bitmap, size);
+}
+
+void read_dense(
+    data_input& in,
+    uint32_t* RESTRICT encoded,
+    uint32_t* RESTRICT decoded) {
+  decoded[0] = in.read_vint();
+
+  const uint32_t span = in.read_vint();
+  const auto size = dense_bytes(span);
+
+  if (size > BLOCK_SIZE*sizeof(uint32_t)) {
+    IR_FRMT_ERROR("Invalid dense block span '" IR_UINT32_T_SPECIFIER "'", span);
+
+    throw index_error("invalid dense block span");
+  }
+
+  auto* bitmap = reinterpret_cast<byte_type*>(encoded);
+  in.read_bytes(bitmap, size);
+
+  uint32_t* value = decoded + 1;
+  uint32_t* const end = decoded + BLOCK_SIZE;
+  uint32_t prev = 0;
+
+  for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+    // little-endian 64-bit word of the bitmap
+    const size_t count = std::min(sizeof(uint64_t), size - i);
+    uint64_t word = 0;
+    for (size_t j = 0; j < count; ++j) {
+      word |= uint64_t(bitmap[i + j]) << (8*j);
+    }
+
+    while (word) {
+      if (value == end) {
+        throw index_error("invalid dense block bitmap");
+      }
+
+      const auto sum = uint32_t(8*i + math::ctz64(word)) + 1;
+      *value++ = sum - prev;
+      prev = sum;
+      word &= word - 1;
+    }
+  }
+
+  if (value != end) {
+    throw index_error("invalid dense block bitmap");
+  }
+}
+
+void write_pfor(
+    data_output& out,
+    const uint32_t* RESTRICT decoded,
+    uint32_t* RESTRICT encoded,
+    uint32_t bits) {
+  assert(bits < MAX_BITS);
+
+  out.write_vint(bits);
+
+  if (bits) {
+    write_packed(out, decoded, encoded, bits);
+  }
+
+  byte_type exceptions[BLOCK_SIZE];
+  size_t count = 0;
+
+  for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+    if (decoded[i] >> bits) {
+      exceptions[count++] = byte_type(i);
+    }
+  }
+
+  out.write_vint(uint32_t(count));
+  out.write_bytes(exceptions, count);
+
+  for (size_t i = 0; i < count; ++i) {
+    out.write_vint(decoded[exceptions[i]] >> bits);
+  }
+}
+
+void read_pfor(
+    data_input& in,
+    uint32_t* RESTRICT encoded,
+    uint32_t* RESTRICT decoded) {
+  const uint32_t bits = in.read_vint();
+
+  if (bits >= MAX_BITS) {
+    IR_FRMT_ERROR("Invalid number of bits '" IR_UINT32_T_SPECIFIER "' in pfor block", bits);
+
+    throw index_error("invalid number of bits in pfor block");
+  }
+
+  if (bits) {
+    read_packed(in, encoded, decoded, bits);
+  } else {
+    std::fill(decoded, decoded + BLOCK_SIZE, 0);
+  }
+
+  const uint32_t count = in.read_vint();
+
+  if (count > BLOCK_SIZE) {
+    throw index_error("invalid number of exceptions in pfor block");
+  }
+
+  byte_type exceptions[BLOCK_SIZE];
+  in.read_bytes(exceptions, count);
+
+  for (size_t i = 0; i < count; ++i) {
+    decoded[exceptions[i] % BLOCK_SIZE] |= in.read_vint() << bits;
+  }
+}
+
+NS_END // LOCAL
+
+NS_ROOT
+NS_BEGIN(encode)
+NS_BEGIN(adaptive)
+
+isa_t best_isa() NOEXCEPT {
+  static const isa_t ISA = detect_isa();
+  return ISA;
+}
+
+bool supported(isa_t isa) NOEXCEPT {
+  switch (isa) {
+    case isa_t::SCALAR:
+      return true;
+#ifdef IRESEARCH_SSE2
+    case isa_t::SSE2:
+      return true;
+    case isa_t::AVX2:
+      return cpuinfo::support_avx2();
+#endif
+    default:
+      return false;
+  }
+}
+
+void pack(
+    const uint32_t* RESTRICT decoded,
+    uint32_t* RESTRICT encoded,
+    uint32_t bits) {
+  assert(bits && bits <= MAX_BITS);
+  const uint32_t mask = mask32(bits);
+
+  std::memset(encoded, 0, packed_bytes(bits));
+
+  for (size_t lane = 0; lane < LANES; ++lane) {
+    size_t word = lane;
+    uint32_t shift = 0;
+
+    for (size_t i = lane; i < BLOCK_SIZE; i += LANES) {
+      const uint32_t value = decoded[i] & mask;
+      encoded[word] |= value << shift;
+      shift += bits;
+
+      if (shift >= 32) {
+        shift -= 32;
+        word += LANES;
+
+        if (shift) {
+          encoded[word] |= value >> (bits - shift);
+        }
+      }
+    }
+  }
+}
+
+void unpack(
+    const uint32_t* RESTRICT encoded,
+    uint32_t* RESTRICT decoded,
+    uint32_t bits,
+    isa_t isa) {
+  assert(bits && bits <= MAX_BITS);
+  assert(supported(isa));
+  all_kernels().get(isa)[bits](encoded, decoded);
+}
+
+uint32_t write_block(
+    data_output& out,
+    const uint32_t* RESTRICT decoded,
+    uint32_t* RESTRICT encoded,
+    bool deltas) {
+  assert(encoded);
+  assert(decoded);
+
+  if (irstd::all_equal(decoded, decoded + BLOCK_SIZE)) {
+    out.write_vint(ALL_EQUAL);
+    out.write_vint(*decoded);
+    return ALL_EQUAL;
+  }
+
+  // histogram of bit lengths of values
+  uint32_t lengths[MAX_BITS + 1]{};
+  uint64_t span = 0;
+  bool increasing = deltas;
+
+  for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+    ++lengths[packed::bits_required_32(decoded[i])];
+
+    if (i) {
+      span += decoded[i];
+      increasing &= (0 != decoded[i]);
+    }
+  }
+
+  uint32_t max_bits = MAX_BITS;
+  while (!lengths[max_bits]) {
+    --max_bits;
+  }
+  assert(max_bits); // not all values are equal
+
+  // plain bit packing
+  uint32_t header = max_bits;
+  uint32_t pfor_bits = 0;
+  size_t min_size = packed_bytes(max_bits);
+
+  // patched bit packing, exceptions store high bits as vints
+  size_t count = 0; // number of exceptions
+  for (uint32_t bits = max_bits; bits--; ) {
+    count += lengths[bits + 1];
+
+    size_t high_size = 0; // size of high bits of exceptions
+    for (uint32_t length = bits + 1; length <= max_bits; ++length) {
+      high_size += lengths[length]*((length - bits + 6) / 7);
+    }
+
+    const size_t size = vint_io::vsize(bits) + packed_bytes(bits)
+      + vint_io::vsize(uint32_t(count)) + count + high_size;
+
+    if (size < min_size) {
+      header = PFOR;
+      min_size = size;
+      pfor_bits = bits;
+    }
+  }
+
+  // bitmap of prefix sums
+  if (increasing && dense_bytes(span) < min_size) {
+    const size_t size = vint_io::vsize(decoded[0])
+      + vint_io::vsize(uint32_t(span)) + dense_bytes(span);
+
+    if (size < min_size) {
+      out.write_vint(DENSE);
+      write_dense(out, decoded, encoded, uint32_t(span));
+      return DENSE;
+    }
+  }
+
+  out.write_vint(header);
+
+  if (PFOR == header) {
+    write_pfor(out, decoded, encoded, pfor_bits);
+  } else {
+    write_packed(out, decoded, encoded, header);
+  }
+
+  return header;
+}
+
+void read_block(
+    data_input& in,
+    uint32_t* RESTRICT encoded,
+    uint32_t* RESTRICT decoded) {
+  assert(encoded);
+  assert(decoded);
+
+  const uint32_t header = in.read_vint();
+
+  if (header && header <= MAX_BITS) {
+    read_packed(in, encoded, decoded, header);
+    return;
+  }
+
+  switch (header) {
+    case ALL_EQUAL:
+      std::fill(decoded, decoded + BLOCK_SIZE, in.read_vint());
+      return;
+    case DENSE:
+      read_dense(in, encoded, decoded);
+      return;
+    case PFOR:
+      read_pfor(in, encoded, decoded);
+      return;
+  }
+
+  IR_FRMT_ERROR("Invalid block header '" IR_UINT32_T_SPECIFIER "'", header);
+
+  throw index_error("invalid block header");
+}
+
+void skip_block(index_input& in) {
+  const uint32_t header = in.read_vint();
+
+  if (header && header <= MAX_BITS) {
+    in.seek(in.file_pointer() + packed_bytes(header));
+    return;
+  }
+
+  switch (header) {
+    case ALL_EQUAL:
+      in.read_vint();
+      return;
+    case DENSE: {
+      in.read_vint();
+
+      const uint32_t span = in.read_vint();
+      in.seek(in.file_pointer() + dense_bytes(span));
+      return;
+    }
+    case PFOR: {
+      const uint32_t bits = in.read_vint();
+      in.seek(in.file_pointer() + packed_bytes(bits));
+
+      const uint32_t count = in.read_vint();
+      in.seek(in.file_pointer() + count);
+
+      for (uint32_t i = 0; i < count; ++i) {
+        in.read_vint();
+      }
+      return;
+    }
+  }
+
+  IR_FRMT_ERROR("Invalid block header '" IR_UINT32_T_SPECIFIER "'", header);
+
+  throw index_error("invalid block header");
+}
+
+NS_END // adaptive
+NS_END // encode
+NS_END // ROOT
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2018 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_STORE_UTILS_ADAPTIVE_H
+#define IRESEARCH_STORE_UTILS_ADAPTIVE_H
+
+#include "shared.hpp"
+
+NS_ROOT
+
+struct data_input;
+struct data_output;
+struct index_input;
+
+NS_BEGIN(encode)
+
+// ----------------------------------------------------------------------------
+// --SECTION--                          adaptive block encode/decode helpers
+// ----------------------------------------------------------------------------
+//
+// Every block holds exactly BLOCK_SIZE values and starts with a header
+// denoting the encoding chosen for that particular block:
+//   <ALL_EQUAL>   <Value>
+//   <1..32>       <PackedData>
+//   <DENSE>       <FirstValue><Span><Bitmap>
+//   <PFOR>        <NumberOfBits><PackedData><NumberOfExceptions>
+//                   <ExceptionIndexes><ExceptionHighBits>
+//
+// PackedData is laid out in 4 interleaved 32-bit lanes, i.e. a value 'i'
+// belongs to the lane 'i % 4' and a word 'j' of a lane 'l' is stored at
+// the position '4*j + l', so that a lane-wise decoder can unpack 4 (or 8)
+// values per instruction.
+//
+// DENSE is only used for blocks of deltas of a strictly increasing sequence,
+// a bit 'i' of the Bitmap is set if 'i + 1' is a prefix sum of the deltas
+// following the first one, Span is a sum of those deltas.
+//
+// PFOR stores low bits of every value packed, and high bits of the values
+// exceeding NumberOfBits as a list of exceptions.
+//
+// ----------------------------------------------------------------------------
+
+NS_BEGIN(adaptive)
+
+const uint32_t BLOCK_SIZE = 128;
+const uint32_t ALL_EQUAL = 0U;
+const uint32_t DENSE = 33U;
+const uint32_t PFOR = 34U;
+
+// instruction sets a packed data decoder may use
+enum class isa_t {
+  SCALAR,
+  SSE2,
+  AVX2
+};
+
+// returns the best instruction set supported by the current CPU,
+// used by 'read_block'
+IRESEARCH_API isa_t best_isa() NOEXCEPT;
+
+// returns true if the specified instruction set is supported
+// by the current CPU and the library build
+IRESEARCH_API bool supported(isa_t isa) NOEXCEPT;
+
+// packs BLOCK_SIZE low 'bits' of values into 'bits*BLOCK_SIZE/32' words
+IRESEARCH_API void pack(
+  const uint32_t* RESTRICT decoded,
+  uint32_t* RESTRICT encoded,
+  uint32_t bits
+);
+
+// unpacks BLOCK_SIZE values previously packed with 'pack'
+// using the specified instruction set
+IRESEARCH_API void unpack(
+  const uint32_t* RESTRICT encoded,
+  uint32_t* RESTRICT decoded,
+  uint32_t bits,
+  isa_t isa
+);
+
+// writes block of BLOCK_SIZE values choosing the most compact encoding,
+// 'deltas' denotes that 'decoded' contains deltas of an increasing sequence
+// returns the header of the written block
+// 'encoded' must have a capacity of at least BLOCK_SIZE values
+IRESEARCH_API uint32_t write_block(
+  data_output& out,
+  const uint32_t* RESTRICT decoded,
+  uint32_t* RESTRICT encoded,
+  bool deltas
+);
+
+// reads block of BLOCK_SIZE values previously written with 'write_block'
+// 'encoded' must have a capacity of at least BLOCK_SIZE values
+IRESEARCH_API void read_block(
+  data_input& in,
+  uint32_t* RESTRICT encoded,
+  uint32_t* RESTRICT decoded
+);
+
+// skips block previously written with 'write_block'
+IRESEARCH_API void skip_block(index_input& in);
+
+NS_END // adaptive
+NS_END // encode
+NS_END // ROOT
+
+#endif
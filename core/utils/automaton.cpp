@@ -0,0 +1,998 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "automaton.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+
+NS_LOCAL
+
+using irs::byte_type;
+
+const uint32_t MAX_CODE_POINT = 0x10FFFF;
+const byte_type MIN_TAIL[] = { 0x80, 0x80, 0x80 }; // min continuation bytes
+const byte_type MAX_TAIL[] = { 0xBF, 0xBF, 0xBF }; // max continuation bytes
+
+// returns number of bytes written
+size_t utf8_encode(uint32_t cp, byte_type* out) NOEXCEPT {
+  if (cp < 0x80) {
+    out[0] = byte_type(cp);
+    return 1;
+  }
+
+  if (cp < 0x800) {
+    out[0] = byte_type(0xC0 | (cp >> 6));
+    out[1] = byte_type(0x80 | (cp & 0x3F));
+    return 2;
+  }
+
+  if (cp < 0x10000) {
+    out[0] = byte_type(0xE0 | (cp >> 12));
+    out[1] = byte_type(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = byte_type(0x80 | (cp & 0x3F));
+    return 3;
+  }
+
+  out[0] = byte_type(0xF0 | (cp >> 18));
+  out[1] = byte_type(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = byte_type(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = byte_type(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+// returns length of a well-formed UTF-8 sequence at 'begin', 0 otherwise
+size_t utf8_length(const byte_type* begin, const byte_type* end) NOEXCEPT {
+  const auto lead = *begin;
+  const size_t length = lead < 0x80 ? 1
+    : (lead >> 5) == 0x6 ? 2
+    : (lead >> 4) == 0xE ? 3
+    : (lead >> 3) == 0x1E ? 4
+    : 0;
+
+  if (!length || size_t(end - begin) < length) {
+    return 0;
+  }
+
+  for (size_t i = 1; i < length; ++i) {
+    if ((begin[i] & 0xC0) != 0x80) {
+      return 0;
+    }
+  }
+
+  return length;
+}
+
+uint32_t utf8_decode(const byte_type* begin, size_t length) NOEXCEPT {
+  switch (length) {
+    case 1: return begin[0];
+    case 2: return ((begin[0] & 0x1F) << 6) | (begin[1] & 0x3F);
+    case 3: return ((begin[0] & 0x0F) << 12) | ((begin[1] & 0x3F) << 6)
+                   | (begin[2] & 0x3F);
+    default: return ((begin[0] & 0x07) << 18) | ((begin[1] & 0x3F) << 12)
+                    | ((begin[2] & 0x3F) << 6) | (begin[3] & 0x3F);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class nfa
+/// @brief non-deterministic automaton over bytes with epsilon transitions
+////////////////////////////////////////////////////////////////////////////////
+class nfa {
+ public:
+  typedef uint32_t state_id;
+
+  state_id add_state() {
+    states_.emplace_back();
+    return state_id(states_.size() - 1);
+  }
+
+  void accept(state_id state) { states_[state].accept = true; }
+
+  void add_arc(state_id from, byte_type min, byte_type max, state_id to) {
+    assert(min <= max);
+    states_[from].arcs.push_back(arc{ min, max, to });
+  }
+
+  void add_epsilon(state_id from, state_id to) {
+    states_[from].epsilons.push_back(to);
+  }
+
+  // adds path 'from' -> 'to' labeled with the specified bytes
+  void add_bytes(state_id from, state_id to, const byte_type* bytes, size_t size) {
+    assert(size);
+    for (; size > 1; --size, ++bytes) {
+      const auto next = add_state();
+      add_arc(from, *bytes, *bytes, next);
+      from = next;
+    }
+    add_arc(from, *bytes, *bytes, to);
+  }
+
+  // adds paths 'from' -> 'to' labeled with UTF-8 encoded code points [min, max]
+  void add_range(state_id from, state_id to, uint32_t min, uint32_t max) {
+    static const uint32_t BOUNDS[] = { 0x7F, 0x7FF, 0xFFFF, MAX_CODE_POINT };
+
+    uint32_t lower = 0;
+    for (auto upper : BOUNDS) {
+      const auto begin = std::max(min, lower);
+      const auto end = std::min(max, upper);
+
+      if (begin <= end) {
+        byte_type lo[4], hi[4];
+        const auto size = utf8_encode(begin, lo);
+        UNUSED(utf8_encode(end, hi));
+        add_sequences(from, to, lo, hi, size);
+      }
+
+      lower = upper + 1;
+    }
+  }
+
+  void add_any(state_id from, state_id to) {
+    add_range(from, to, 0, MAX_CODE_POINT);
+  }
+
+  // converts automaton to a DFA, returns false if state limit is exceeded
+  bool determinize(state_id start, irs::automaton& out) const;
+
+ private:
+  struct arc {
+    byte_type min;
+    byte_type max;
+    state_id target;
+  };
+
+  struct state {
+    std::vector<arc> arcs;
+    std::vector<state_id> epsilons;
+    bool accept{ false };
+  };
+
+  typedef std::vector<state_id> state_set; // sorted
+
+  // adds paths for byte sequences in [lo, hi] of the same length, every byte
+  // except the first one is a continuation byte
+  void add_sequences(
+      state_id from, state_id to,
+      const byte_type* lo, const byte_type* hi, size_t size) {
+    if (1 == size) {
+      add_arc(from, lo[0], hi[0], to);
+      return;
+    }
+
+    const auto tail = size - 1;
+
+    if (lo[0] == hi[0]
+        || (!std::memcmp(lo + 1, MIN_TAIL, tail)
+            && !std::memcmp(hi + 1, MAX_TAIL, tail))) {
+      const auto next = add_state();
+      add_arc(from, lo[0], hi[0], next);
+      add_sequences(next, to, lo + 1, hi + 1, tail);
+      return;
+    }
+
+    auto next = add_state();
+    add_arc(from, lo[0], lo[0], next);
+    add_sequences(next, to, lo + 1, MAX_TAIL, tail);
+
+    if (hi[0] - lo[0] > 1) {
+      next = add_state();
+      add_arc(from, lo[0] + 1, hi[0] - 1, next);
+      add_sequences(next, to, MIN_TAIL, MAX_TAIL, tail);
+    }
+
+    next = add_state();
+    add_arc(from, hi[0], hi[0], next);
+    add_sequences(next, to, MIN_TAIL, hi + 1, tail);
+  }
+
+  void closure(state_set& set) const {
+    std::vector<state_id> stack(set.begin(), set.end());
+    std::vector<bool> seen(states_.size());
+
+    for (auto s : set) {
+      seen[s] = true;
+    }
+
+    while (!stack.empty()) {
+      const auto s = stack.back();
+      stack.pop_back();
+
+      for (auto target : states_[s].epsilons) {
+        if (!seen[target]) {
+          seen[target] = true;
+          set.push_back(target);
+          stack.push_back(target);
+        }
+      }
+    }
+
+    std::sort(set.begin(), set.end());
+  }
+
+  std::vector<state> states_;
+}; // nfa
+
+bool nfa::determinize(state_id start, irs::automaton& out) const {
+  std::map<state_set, irs::automaton::state_id> ids;
+  std::deque<const state_set*> queue;
+
+  auto get_id = [&](state_set&& set)->irs::automaton::state_id {
+    auto it = ids.find(set);
+
+    if (it == ids.end()) {
+      const bool accept = std::any_of(
+        set.begin(), set.end(),
+        [this](state_id s) { return states_[s].accept; });
+      it = ids.emplace(std::move(set), out.add_state(accept)).first;
+      queue.push_back(&it->first);
+    }
+
+    return it->second;
+  };
+
+  out = irs::automaton();
+
+  state_set initial{ start };
+  closure(initial);
+  get_id(std::move(initial));
+
+  std::vector<uint16_t> bounds;
+
+  for (irs::automaton::state_id id = 0; !queue.empty(); ++id) {
+    if (out.size() > irs::automaton::MAX_STATES) {
+      return false;
+    }
+
+    const auto& set = *queue.front();
+    queue.pop_front();
+
+    // split label space into intervals with the same set of arcs
+    bounds.clear();
+    for (auto s : set) {
+      for (auto& a : states_[s].arcs) {
+        bounds.push_back(a.min);
+        bounds.push_back(uint16_t(a.max) + 1);
+      }
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    irs::automaton::transition last{ 0, 0, irs::automaton::INVALID_STATE };
+
+    for (size_t i = 1; i < bounds.size(); ++i) {
+      const auto min = bounds[i - 1];
+      const auto max = bounds[i] - 1;
+      state_set targets;
+
+      for (auto s : set) {
+        for (auto& a : states_[s].arcs) {
+          if (a.min <= min && max <= a.max) {
+            targets.push_back(a.target);
+          }
+        }
+      }
+
+      if (targets.empty()) {
+        continue;
+      }
+
+      std::sort(targets.begin(), targets.end());
+      targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+      closure(targets);
+
+      const auto target = get_id(std::move(targets));
+
+      // merge adjacent intervals leading to the same state
+      if (last.target == target && uint16_t(last.max) + 1 == min) {
+        last.max = byte_type(max);
+        continue;
+      }
+
+      if (last.target != irs::automaton::INVALID_STATE) {
+        out.add_transition(id, last.min, last.max, last.target);
+      }
+
+      last = irs::automaton::transition{ byte_type(min), byte_type(max), target };
+    }
+
+    if (last.target != irs::automaton::INVALID_STATE) {
+      out.add_transition(id, last.min, last.max, last.target);
+    }
+  }
+
+  out.prune();
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class regexp_parser
+/// @brief parses regular expressions into a tree of nodes
+////////////////////////////////////////////////////////////////////////////////
+class regexp_parser {
+ public:
+  static const size_t UNBOUNDED = irs::integer_traits<size_t>::const_max;
+  static const size_t MAX_REPEAT = 1000;
+
+  typedef std::vector<std::pair<uint32_t, uint32_t>> ranges_t;
+
+  struct node {
+    enum type_t { CLASS, CONCAT, ALTERNATION, REPEAT };
+
+    explicit node(type_t type) : type(type) { }
+
+    type_t type;
+    ranges_t ranges; // CLASS
+    std::vector<node> children; // CONCAT, ALTERNATION, REPEAT
+    size_t min{}; // REPEAT
+    size_t max{}; // REPEAT
+  }; // node
+
+  struct parse_error { };
+
+  explicit regexp_parser(const irs::bytes_ref& pattern) {
+    auto* begin = pattern.begin();
+    auto* end = pattern.end();
+
+    while (begin != end) {
+      const auto length = utf8_length(begin, end);
+
+      if (!length) {
+        throw parse_error();
+      }
+
+      cps_.push_back(utf8_decode(begin, length));
+      begin += length;
+    }
+  }
+
+  node parse() {
+    auto root = parse_alternation();
+
+    if (pos_ != cps_.size()) {
+      throw parse_error(); // e.g. unbalanced ')'
+    }
+
+    return root;
+  }
+
+  static void compile(nfa& automaton, const node& n, nfa::state_id from, nfa::state_id to) {
+    switch (n.type) {
+      case node::CLASS:
+        for (auto& range : n.ranges) {
+          automaton.add_range(from, to, range.first, range.second);
+        }
+        break;
+      case node::CONCAT:
+        if (n.children.empty()) {
+          automaton.add_epsilon(from, to);
+          break;
+        }
+
+        for (size_t i = 0, last = n.children.size() - 1; i < last; ++i) {
+          const auto next = automaton.add_state();
+          compile(automaton, n.children[i], from, next);
+          from = next;
+        }
+
+        compile(automaton, n.children.back(), from, to);
+        break;
+      case node::ALTERNATION:
+        for (auto& child : n.children) {
+          compile(automaton, child, from, to);
+        }
+        break;
+      case node::REPEAT: {
+        auto& child = n.children.front();
+
+        for (size_t i = 0; i < n.min; ++i) {
+          const auto next = automaton.add_state();
+          compile(automaton, child, from, next);
+          from = next;
+        }
+
+        if (UNBOUNDED == n.max) {
+          const auto loop = automaton.add_state();
+          automaton.add_epsilon(from, loop);
+          compile(automaton, child, loop, loop);
+          automaton.add_epsilon(loop, to);
+          break;
+        }
+
+        for (size_t i = n.min; i < n.max; ++i) {
+          const auto next = automaton.add_state();
+          automaton.add_epsilon(from, to);
+          compile(automaton, child, from, next);
+          from = next;
+        }
+
+        automaton.add_epsilon(from, to);
+      } break;
+    }
+  }
+
+ private:
+  bool eof() const NOEXCEPT { return pos_ == cps_.size(); }
+  uint32_t peek() const NOEXCEPT { return cps_[pos_]; }
+
+  uint32_t consume() {
+    if (eof()) {
+      throw parse_error();
+    }
+
+    return cps_[pos_++];
+  }
+
+  node parse_alternation() {
+    auto n = parse_concat();
+
+    if (eof() || '|' != peek()) {
+      return n;
+    }
+
+    node alternation(node::ALTERNATION);
+    alternation.children.push_back(std::move(n));
+
+    while (!eof() && '|' == peek()) {
+      ++pos_;
+      alternation.children.push_back(parse_concat());
+    }
+
+    return alternation;
+  }
+
+  node parse_concat() {
+    node concat(node::CONCAT);
+
+    while (!eof() && '|' != peek() && ')' != peek()) {
+      concat.children.push_back(parse_repeat());
+    }
+
+    if (1 == concat.children.size()) {
+      return std::move(concat.children.front());
+    }
+
+    return concat;
+  }
+
+  node parse_repeat() {
+    auto n = parse_atom();
+
+    while (!eof()) {
+      size_t min, max;
+
+      switch (peek()) {
+        case '*': min = 0; max = UNBOUNDED; ++pos_; break;
+        case '+': min = 1; max = UNBOUNDED; ++pos_; break;
+        case '?': min = 0; max = 1; ++pos_; break;
+        case '{':
+          ++pos_;
+          min = max = parse_number();
+
+          if (!eof() && ',' == peek()) {
+            ++pos_;
+            max = !eof() && '}' == peek() ? UNBOUNDED : parse_number();
+          }
+
+          if ('}' != consume() || min > max) {
+            throw parse_error();
+          }
+          break;
+        default:
+          return n;
+      }
+
+      node repeat(node::REPEAT);
+      repeat.min = min;
+      repeat.max = max;
+      repeat.children.push_back(std::move(n));
+      n = std::move(repeat);
+    }
+
+    return n;
+  }
+
+  size_t parse_number() {
+    size_t value = 0;
+    bool empty = true;
+
+    while (!eof() && peek() >= '0' && peek() <= '9') {
+      value = value * 10 + (consume() - '0');
+      empty = false;
+
+      if (value > MAX_REPEAT) {
+        throw parse_error();
+      }
+    }
+
+    if (empty) {
+      throw parse_error();
+    }
+
+    return value;
+  }
+
+  node parse_atom() {
+    const auto cp = consume();
+    node n(node::CLASS);
+
+    switch (cp) {
+      case '(':
+        n = parse_alternation();
+        if (')' != consume()) {
+          throw parse_error();
+        }
+        break;
+      case '.':
+        n.ranges.emplace_back(0, MAX_CODE_POINT);
+        break;
+      case '[':
+        parse_class(n.ranges);
+        break;
+      case '\\':
+        parse_escape(n.ranges);
+        break;
+      case '*': case '+': case '?': case '{': case ')': case '|':
+        throw parse_error(); // nothing to repeat
+      default:
+        n.ranges.emplace_back(cp, cp);
+        break;
+    }
+
+    return n;
+  }
+
+  void parse_escape(ranges_t& ranges) {
+    const auto cp = consume();
+
+    switch (cp) {
+      case 'd':
+        ranges.emplace_back('0', '9');
+        break;
+      case 'w':
+        ranges.emplace_back('0', '9');
+        ranges.emplace_back('A', 'Z');
+        ranges.emplace_back('_', '_');
+        ranges.emplace_back('a', 'z');
+        break;
+      case 's':
+        ranges.emplace_back('\t', '\r');
+        ranges.emplace_back(' ', ' ');
+        break;
+      default:
+        ranges.emplace_back(cp, cp);
+        break;
+    }
+  }
+
+  void parse_class(ranges_t& ranges) {
+    const bool negate = !eof() && '^' == peek();
+
+    if (negate) {
+      ++pos_;
+    }
+
+    ranges_t items;
+
+    for (bool first = true;; first = false) {
+      auto cp = consume();
+
+      if (']' == cp && !first) {
+        break;
+      }
+
+      if ('\\' == cp) {
+        parse_escape(items);
+        continue;
+      }
+
+      auto max = cp;
+
+      if (pos_ + 1 < cps_.size() && '-' == peek() && ']' != cps_[pos_ + 1]) {
+        ++pos_;
+        max = consume();
+
+        if (max < cp) {
+          throw parse_error();
+        }
+      }
+
+      items.emplace_back(cp, max);
+    }
+
+    // normalize
+    std::sort(items.begin(), items.end());
+    ranges_t merged;
+
+    for (auto& item : items) {
+      if (!merged.empty() && item.first <= merged.back().second + 1) {
+        merged.back().second = std::max(merged.back().second, item.second);
+      } else {
+        merged.push_back(item);
+      }
+    }
+
+    if (!negate) {
+      ranges.insert(ranges.end(), merged.begin(), merged.end());
+      return;
+    }
+
+    uint32_t next = 0;
+    for (auto& range : merged) {
+      if (next < range.first) {
+        ranges.emplace_back(next, range.first - 1);
+      }
+      next = range.second + 1;
+    }
+
+    if (next <= MAX_CODE_POINT) {
+      ranges.emplace_back(next, MAX_CODE_POINT);
+    }
+  }
+
+  std::vector<uint32_t> cps_;
+  size_t pos_{};
+}; // regexp_parser
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          automaton implementation
+// -----------------------------------------------------------------------------
+
+automaton::state_id automaton::add_state(bool accept /*= false*/) {
+  states_.emplace_back(accept);
+  return state_id(states_.size() - 1);
+}
+
+void automaton::add_transition(
+    state_id from, byte_type min, byte_type max, state_id to) {
+  assert(from < states_.size() && min <= max);
+  auto& arcs = states_[from].arcs;
+  assert(arcs.empty() || arcs.back().max < min);
+  arcs.push_back(transition{ min, max, to });
+}
+
+void automaton::prune() {
+  if (states_.empty()) {
+    return;
+  }
+
+  // find states from which an accepting state is reachable
+  std::vector<std::vector<state_id>> sources(states_.size());
+  std::vector<state_id> stack;
+  std::vector<bool> live(states_.size());
+
+  for (state_id s = 0; s < states_.size(); ++s) {
+    for (auto& arc : states_[s].arcs) {
+      sources[arc.target].push_back(s);
+    }
+
+    if (states_[s].accept) {
+      live[s] = true;
+      stack.push_back(s);
+    }
+  }
+
+  while (!stack.empty()) {
+    const auto s = stack.back();
+    stack.pop_back();
+
+    for (auto source : sources[s]) {
+      if (!live[source]) {
+        live[source] = true;
+        stack.push_back(source);
+      }
+    }
+  }
+
+  if (!live.front()) {
+    states_.assign(1, state(false)); // accepts nothing
+    return;
+  }
+
+  // renumber live states preserving their order, start state remains first
+  std::vector<state_id> ids(states_.size(), INVALID_STATE);
+  state_id next = 0;
+
+  for (state_id s = 0; s < states_.size(); ++s) {
+    if (live[s]) {
+      ids[s] = next++;
+    }
+  }
+
+  std::vector<state> states;
+  states.reserve(next);
+
+  for (state_id s = 0; s < states_.size(); ++s) {
+    if (!live[s]) {
+      continue;
+    }
+
+    states.emplace_back(states_[s].accept);
+    auto& arcs = states.back().arcs;
+
+    for (auto& arc : states_[s].arcs) {
+      if (live[arc.target]) {
+        arcs.push_back(transition{ arc.min, arc.max, ids[arc.target] });
+      }
+    }
+  }
+
+  states_ = std::move(states);
+}
+
+automaton::state_id automaton::next(
+    state_id state, byte_type label) const NOEXCEPT {
+  assert(state < states_.size());
+  const auto& arcs = states_[state].arcs;
+
+  const auto it = std::lower_bound(
+    arcs.begin(), arcs.end(), label,
+    [](const transition& arc, byte_type label) { return arc.max < label; }
+  );
+
+  return it != arcs.end() && it->min <= label ? it->target : INVALID_STATE;
+}
+
+bool automaton::accept(const bytes_ref& term) const NOEXCEPT {
+  if (states_.empty()) {
+    return false;
+  }
+
+  auto state = start();
+
+  for (auto label : term) {
+    if (INVALID_STATE == (state = next(state, label))) {
+      return false;
+    }
+  }
+
+  return accept(state);
+}
+
+void automaton::complete(state_id state, bstring& bound) const {
+  // the smallest accepted suffix is either empty or starts with the smallest
+  // label, stop on cycles where the smallest suffix is infinite
+  std::vector<bool> visited(states_.size());
+
+  while (!states_[state].accept && !visited[state]) {
+    visited[state] = true;
+    assert(!states_[state].arcs.empty()); // all states are live
+
+    const auto& arc = states_[state].arcs.front();
+    bound += arc.min;
+    state = arc.target;
+  }
+}
+
+bool automaton::next_bound(const bytes_ref& term, bstring& bound) const {
+  if (empty()) {
+    return false;
+  }
+
+  // follow the term as far as possible
+  std::vector<state_id> path(1, start());
+
+  for (auto label : term) {
+    const auto state = next(path.back(), label);
+
+    if (INVALID_STATE == state) {
+      break;
+    }
+
+    path.push_back(state);
+  }
+
+  // the whole term is a valid prefix, the smallest greater candidate extends it
+  if (path.size() > term.size()) {
+    const auto& arcs = states_[path.back()].arcs;
+
+    if (!arcs.empty()) {
+      bound.assign(term.c_str(), term.size());
+      bound += arcs.front().min;
+      complete(arcs.front().target, bound);
+      return true;
+    }
+  }
+
+  // otherwise find the longest prefix followed by a greater label
+  for (size_t i = std::min(path.size(), term.size()); i > 0;) {
+    --i;
+    const auto label = term[i];
+
+    for (auto& arc : states_[path[i]].arcs) {
+      if (arc.max > label) {
+        bound.assign(term.c_str(), i);
+        bound += std::max(arc.min, byte_type(label + 1));
+        complete(arc.target, bound);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 automaton helpers
+// -----------------------------------------------------------------------------
+
+automaton make_wildcard_automaton(const bytes_ref& pattern) {
+  nfa builder;
+  auto state = builder.add_state();
+  const auto start = state;
+
+  for (auto* begin = pattern.begin(), *end = pattern.end(); begin != end; ++begin) {
+    switch (*begin) {
+      case '*':
+        builder.add_any(state, state);
+        break;
+      case '?': {
+        const auto next = builder.add_state();
+        builder.add_any(state, next);
+        state = next;
+      } break;
+      case '\\':
+        if (begin + 1 != end) {
+          ++begin; // escaped character, multi-byte ones are never special
+        }
+        // fall through
+      default: {
+        const auto next = builder.add_state();
+        builder.add_arc(state, *begin, *begin, next);
+        state = next;
+      } break;
+    }
+  }
+
+  builder.accept(state);
+
+  automaton acceptor;
+
+  if (!builder.determinize(start, acceptor)) {
+    IR_FRMT_ERROR(
+      "Too many states in automaton for wildcard pattern of size " IR_SIZE_T_SPECIFIER,
+      pattern.size()
+    );
+
+    return automaton();
+  }
+
+  return acceptor;
+}
+
+automaton make_regexp_automaton(const bytes_ref& pattern) {
+  nfa builder;
+  const auto start = builder.add_state();
+  const auto end = builder.add_state();
+
+  try {
+    regexp_parser parser(pattern);
+    regexp_parser::compile(builder, parser.parse(), start, end);
+  } catch (const regexp_parser::parse_error&) {
+    IR_FRMT_ERROR(
+      "Failed to parse regular expression of size " IR_SIZE_T_SPECIFIER,
+      pattern.size()
+    );
+
+    return automaton();
+  }
+
+  builder.accept(end);
+
+  automaton acceptor;
+
+  if (!builder.determinize(start, acceptor)) {
+    IR_FRMT_ERROR(
+      "Too many states in automaton for regular expression of size " IR_SIZE_T_SPECIFIER,
+      pattern.size()
+    );
+
+    return automaton();
+  }
+
+  return acceptor;
+}
+
+automaton make_levenshtein_automaton(
+    const bytes_ref& target,
+    byte_type max_distance,
+    bool with_transpositions /*= false*/) {
+  // split target into characters, malformed bytes are treated as characters
+  std::vector<bytes_ref> chars;
+
+  for (auto* begin = target.begin(), *end = target.end(); begin != end;) {
+    const auto length = std::max(size_t(1), utf8_length(begin, end));
+    chars.emplace_back(begin, length);
+    begin += length;
+  }
+
+  // state (i, e): 'i' characters of the target consumed with 'e' edits
+  const size_t size = chars.size();
+  const size_t edits = size_t(max_distance) + 1;
+  auto id = [edits](size_t i, size_t e) { return nfa::state_id(i*edits + e); };
+
+  nfa builder;
+
+  for (size_t i = 0, count = (size + 1)*edits; i < count; ++i) {
+    builder.add_state();
+  }
+
+  for (size_t i = 0; i <= size; ++i) {
+    for (size_t e = 0; e < edits; ++e) {
+      const auto from = id(i, e);
+
+      if (i < size) {
+        builder.add_bytes(from, id(i + 1, e), chars[i].c_str(), chars[i].size());
+      }
+
+      if (e + 1 == edits) {
+        continue; // no more edits allowed
+      }
+
+      builder.add_any(from, id(i, e + 1)); // insertion
+
+      if (i < size) {
+        builder.add_any(from, id(i + 1, e + 1)); // substitution
+        builder.add_epsilon(from, id(i + 1, e + 1)); // deletion
+      }
+
+      if (with_transpositions && i + 1 < size) {
+        const auto swapped = builder.add_state();
+        builder.add_bytes(from, swapped, chars[i + 1].c_str(), chars[i + 1].size());
+        builder.add_bytes(swapped, id(i + 2, e + 1), chars[i].c_str(), chars[i].size());
+      }
+    }
+  }
+
+  for (size_t e = 0; e < edits; ++e) {
+    builder.accept(id(size, e));
+  }
+
+  automaton acceptor;
+
+  if (!builder.determinize(id(0, 0), acceptor)) {
+    IR_FRMT_ERROR(
+      "Too many states in Levenshtein automaton for term of size " IR_SIZE_T_SPECIFIER ", distance %u",
+      target.size(), unsigned(max_distance)
+    );
+
+    return automaton();
+  }
+
+  return acceptor;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
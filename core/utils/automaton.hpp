@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_AUTOMATON_H
+#define IRESEARCH_AUTOMATON_H
+
+#include "shared.hpp"
+#include "integer.hpp"
+#include "string.hpp"
+
+#include <vector>
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class automaton
+/// @brief deterministic finite automaton over bytes, i.e. UTF-8 encoded terms,
+///        only states from which an accepting state is reachable are kept
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API automaton {
+ public:
+  typedef uint32_t state_id;
+
+  static const state_id INVALID_STATE = integer_traits<state_id>::const_max;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief max number of states produced by the builders below, patterns
+  ///        exceeding the limit are rejected
+  //////////////////////////////////////////////////////////////////////////////
+  static const size_t MAX_STATES = 10000;
+
+  struct transition {
+    byte_type min; // inclusive
+    byte_type max; // inclusive
+    state_id target;
+  }; // transition
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief creates an automaton accepting nothing
+  //////////////////////////////////////////////////////////////////////////////
+  automaton() = default;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief adds a new state, the first added state is the start one
+  //////////////////////////////////////////////////////////////////////////////
+  state_id add_state(bool accept = false);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief adds transition [min, max] -> target from the specified state
+  /// @note transitions of a state must be added in ascending order and must
+  ///       not overlap
+  //////////////////////////////////////////////////////////////////////////////
+  void add_transition(state_id from, byte_type min, byte_type max, state_id to);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief removes states from which no accepting state is reachable
+  //////////////////////////////////////////////////////////////////////////////
+  void prune();
+
+  state_id start() const NOEXCEPT {
+    return states_.empty() ? INVALID_STATE : 0;
+  }
+
+  bool accept(state_id state) const NOEXCEPT {
+    return state < states_.size() && states_[state].accept;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns state reachable from the specified one via the specified label,
+  ///          INVALID_STATE if there is no such state
+  //////////////////////////////////////////////////////////////////////////////
+  state_id next(state_id state, byte_type label) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the specified term is accepted by the automaton
+  //////////////////////////////////////////////////////////////////////////////
+  bool accept(const bytes_ref& term) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief finds a lower bound of accepted terms greater than the specified
+  ///        one, i.e. there is no accepted term in (term, bound)
+  /// @returns false if there is no accepted term greater than the specified
+  /// @note bound is always greater than the term, so seeking a sorted term
+  ///       dictionary to bounds of terms it stops at guarantees progress
+  //////////////////////////////////////////////////////////////////////////////
+  bool next_bound(const bytes_ref& term, bstring& bound) const;
+
+  const std::vector<transition>& transitions(state_id state) const NOEXCEPT {
+    assert(state < states_.size());
+    return states_[state].arcs;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the automaton accepts nothing
+  //////////////////////////////////////////////////////////////////////////////
+  bool empty() const NOEXCEPT {
+    return states_.empty()
+      || (!states_.front().accept && states_.front().arcs.empty());
+  }
+
+  size_t size() const NOEXCEPT { return states_.size(); }
+
+ private:
+  struct state {
+    explicit state(bool accept) : accept(accept) { }
+
+    std::vector<transition> arcs; // sorted by labels
+    bool accept;
+  }; // state
+
+  // appends the smallest prefix of terms accepted from the specified state
+  void complete(state_id state, bstring& bound) const;
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::vector<state> states_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // automaton
+
+//////////////////////////////////////////////////////////////////////////////
+/// @returns automaton accepting terms matching the specified wildcard pattern,
+///          '*' matches any sequence of characters, '?' matches any single
+///          character, '\' escapes the next character
+//////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API automaton make_wildcard_automaton(const bytes_ref& pattern);
+
+//////////////////////////////////////////////////////////////////////////////
+/// @returns automaton accepting terms matching the whole specified regular
+///          expression or an empty automaton if the expression is invalid
+/// @note supported syntax: literals, '.', character classes '[a-z]'/'[^a-z]',
+///       '\d', '\w', '\s', groups '(...)', alternation '|' and quantifiers
+///       '*', '+', '?', '{n}', '{n,}', '{n,m}'
+//////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API automaton make_regexp_automaton(const bytes_ref& pattern);
+
+//////////////////////////////////////////////////////////////////////////////
+/// @returns automaton accepting terms within the specified Levenshtein
+///          distance (in characters) from the specified target
+/// @param with_transpositions count transposition of adjacent characters
+///        as a single edit (Damerau-Levenshtein distance)
+//////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API automaton make_levenshtein_automaton(
+  const bytes_ref& target,
+  byte_type max_distance,
+  bool with_transpositions = false
+);
+
+NS_END // ROOT
+
+#endif // IRESEARCH_AUTOMATON_H
@@ -0,0 +1,308 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "compact_fst.hpp"
+#include "bytes_utils.hpp"
+#include "noncopyable.hpp"
+
+#if defined(_MSC_VER)
+  // NOOP
+#elif defined (__GNUC__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wsign-compare"
+  #pragma GCC diagnostic ignored "-Wunused-local-typedefs"
+#endif
+
+#include "fst_utils.hpp"
+#include "fst.hpp"
+
+#if defined(_MSC_VER)
+  // NOOP
+#elif defined (__GNUC__)
+  #pragma GCC diagnostic pop
+#endif
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+NS_LOCAL
+
+const size_t HEADER_SIZE = 2*sizeof(uint32_t) + 3 + sizeof(uint32_t);
+
+// number of bytes required to store the specified value
+irs::byte_type width(uint32_t value) NOEXCEPT {
+  irs::byte_type width = 1;
+
+  for (value >>= 8; value; value >>= 8) {
+    ++width;
+  }
+
+  return width;
+}
+
+void write_fixed(irs::bstring& out, uint32_t value, irs::byte_type width) {
+  while (width--) {
+    out.push_back(irs::byte_type(value >> (8*width)));
+  }
+}
+
+inline uint32_t read_fixed(const irs::byte_type* in, irs::byte_type width) NOEXCEPT {
+  uint32_t value = 0;
+
+  while (width--) {
+    value = (value << 8) | *in++;
+  }
+
+  return value;
+}
+
+NS_END // LOCAL
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                       compact_fst implementation
+// -----------------------------------------------------------------------------
+
+/*static*/ void compact_fst::compile(const vector_byte_fst& fst, bstring& out) {
+  typedef fst::ArcIterator<vector_byte_fst> arc_iterator_t;
+
+  const auto num_states = stateid_t(fst.NumStates());
+
+  // outputs are deduplicated, empty output is always at position 0
+  bstring weights(1, 0);
+  std::unordered_map<bstring, uint32_t> weight_refs;
+  auto weight_ref = [&weights, &weight_refs](const byte_weight& weight)->uint32_t {
+    if (!weight.Size()) {
+      return 0;
+    }
+
+    bstring key(weight.c_str(), weight.Size());
+    const auto res = weight_refs.emplace(std::move(key), uint32_t(weights.size()));
+
+    if (res.second) {
+      auto it = std::back_inserter(weights);
+      irs::vwrite<uint32_t>(it, uint32_t(weight.Size()));
+      weights.append(weight.c_str(), weight.Size());
+    }
+
+    return res.first->second;
+  };
+
+  // collect output references
+  std::vector<uint32_t> refs;
+  refs.reserve(fst.NumStates());
+
+  for (stateid_t state = 0; state < num_states; ++state) {
+    const auto& final = fst.Final(state);
+
+    if (byte_weight::Zero() != final) {
+      refs.push_back(weight_ref(final));
+    }
+
+    for (arc_iterator_t it(fst, state); !it.Done(); it.Next()) {
+      refs.push_back(weight_ref(it.Value().weight));
+    }
+  }
+
+  const auto target_width = width(num_states ? num_states - 1 : 0);
+  const auto weight_width = width(uint32_t(weights.size() - 1));
+
+  // write states
+  std::vector<uint32_t> offsets;
+  offsets.reserve(num_states);
+  bstring states;
+  auto ref = refs.begin();
+
+  for (stateid_t state = 0; state < num_states; ++state) {
+    offsets.push_back(uint32_t(states.size()));
+
+    const bool final = byte_weight::Zero() != fst.Final(state);
+    const auto num_arcs = uint32_t(fst.NumArcs(state));
+    auto it = std::back_inserter(states);
+
+    irs::vwrite<uint32_t>(it, (num_arcs << 1) | uint32_t(final));
+
+    if (final) {
+      write_fixed(states, *ref++, weight_width);
+    }
+
+    // arcs of states built by fst_builder are sorted by label
+    for (arc_iterator_t it(fst, state); !it.Done(); it.Next()) {
+      assert(!it.Position() || states.back() < it.Value().ilabel);
+      states.push_back(byte_type(it.Value().ilabel));
+    }
+
+    for (arc_iterator_t it(fst, state); !it.Done(); it.Next()) {
+      write_fixed(states, uint32_t(it.Value().nextstate), target_width);
+    }
+
+    for (arc_iterator_t it(fst, state); !it.Done(); it.Next()) {
+      write_fixed(states, *ref++, weight_width);
+    }
+  }
+
+  assert(refs.end() == ref);
+
+  const auto offset_width = width(uint32_t(states.size()));
+
+  out.clear();
+  out.reserve(
+    HEADER_SIZE + offsets.size()*offset_width + states.size() + weights.size()
+  );
+  write_fixed(out, num_states, sizeof(uint32_t));
+  write_fixed(out, num_states ? stateid_t(fst.Start()) : 0, sizeof(uint32_t));
+  out.push_back(offset_width);
+  out.push_back(target_width);
+  out.push_back(weight_width);
+  write_fixed(out, uint32_t(states.size()), sizeof(uint32_t));
+
+  for (const auto offset : offsets) {
+    write_fixed(out, offset, offset_width);
+  }
+
+  out += states;
+  out += weights;
+}
+
+bool compact_fst::reset(const bytes_ref& data) NOEXCEPT {
+  *this = compact_fst();
+
+  if (data.size() < HEADER_SIZE) {
+    return false;
+  }
+
+  const auto* begin = data.c_str();
+  const auto num_states = read_fixed(begin, sizeof(uint32_t));
+  const auto start = read_fixed(begin + sizeof(uint32_t), sizeof(uint32_t));
+  const auto offset_width = begin[2*sizeof(uint32_t)];
+  const auto target_width = begin[2*sizeof(uint32_t) + 1];
+  const auto weight_width = begin[2*sizeof(uint32_t) + 2];
+  const auto states_size = read_fixed(begin + 2*sizeof(uint32_t) + 3, sizeof(uint32_t));
+  const size_t offsets_size = size_t(num_states)*offset_width;
+
+  if (!offset_width || offset_width > sizeof(uint32_t)
+      || !target_width || target_width > sizeof(uint32_t)
+      || !weight_width || weight_width > sizeof(uint32_t)
+      || (num_states && start >= num_states)
+      || HEADER_SIZE + offsets_size + states_size >= data.size()) {
+    return false;
+  }
+
+  data_ = data;
+  offsets_ = begin + HEADER_SIZE;
+  states_ = offsets_ + offsets_size;
+  weights_ = bytes_ref(
+    states_ + states_size,
+    data.size() - HEADER_SIZE - offsets_size - states_size
+  );
+  num_states_ = num_states;
+  start_ = start;
+  offset_width_ = offset_width;
+  target_width_ = target_width;
+  weight_width_ = weight_width;
+
+  return true;
+}
+
+compact_fst::state_ref compact_fst::state(stateid_t state) const NOEXCEPT {
+  assert(state < num_states_);
+
+  const byte_type* in = states_ + read_fixed(offsets_ + size_t(state)*offset_width_, offset_width_);
+  const auto header = irs::vread<uint32_t>(in);
+
+  state_ref ref;
+  ref.num_arcs = header >> 1;
+  ref.final = nullptr;
+
+  if (header & 1) {
+    ref.final = in;
+    in += weight_width_;
+  }
+
+  ref.labels = in;
+
+  return ref;
+}
+
+bytes_ref compact_fst::weight(const byte_type* ref) const NOEXCEPT {
+  const byte_type* in = weights_.c_str() + read_fixed(ref, weight_width_);
+  const auto size = irs::vread<uint32_t>(in);
+
+  assert(in + size <= weights_.c_str() + weights_.size());
+  return bytes_ref(in, size);
+}
+
+size_t compact_fst::num_arcs(stateid_t state) const NOEXCEPT {
+  return this->state(state).num_arcs;
+}
+
+bool compact_fst::final(stateid_t state, bytes_ref& weight) const NOEXCEPT {
+  const auto ref = this->state(state);
+
+  if (!ref.final) {
+    return false;
+  }
+
+  weight = this->weight(ref.final);
+  return true;
+}
+
+compact_fst::arc compact_fst::at(const state_ref& state, size_t i) const NOEXCEPT {
+  assert(i < state.num_arcs);
+
+  const auto* targets = state.labels + state.num_arcs;
+  const auto* weights = targets + state.num_arcs*target_width_;
+
+  arc arc;
+  arc.label = state.labels[i];
+  arc.target = read_fixed(targets + i*target_width_, target_width_);
+  arc.weight = weight(weights + i*weight_width_);
+
+  return arc;
+}
+
+compact_fst::arc compact_fst::at(stateid_t state, size_t i) const NOEXCEPT {
+  return at(this->state(state), i);
+}
+
+bool compact_fst::find(
+    stateid_t state, byte_type label, arc& arc) const NOEXCEPT {
+  const auto ref = this->state(state);
+  const auto* end = ref.labels + ref.num_arcs;
+  const auto* it = std::lower_bound(ref.labels, end, label);
+
+  if (it == end || *it != label) {
+    return false;
+  }
+
+  arc = at(ref, size_t(std::distance(ref.labels, it)));
+  return true;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
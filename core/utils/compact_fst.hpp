@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_COMPACT_FST_H
+#define IRESEARCH_COMPACT_FST_H
+
+#include "shared.hpp"
+#include "string.hpp"
+#include "fst_decl.hpp"
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class compact_fst
+/// @brief read-only view of a byte FST serialized into a flat block of
+///        memory, the block is accessed in place, e.g. directly from a
+///        memory mapped file, and is never deserialized
+/// @note block layout (fixed-width integers are stored in big-endian order):
+///       header: num_states (4 bytes), start state (4 bytes),
+///               offset/target/weight widths (1 byte each),
+///               states size (4 bytes)
+///       offsets: state offsets within the states section
+///       states: vint (num_arcs << 1 | final), [final output ref],
+///               arc labels (sorted), arc targets, arc output refs
+///       outputs: vint length + bytes, reference 0 denotes empty output
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API compact_fst {
+ public:
+  typedef uint32_t stateid_t;
+
+  struct arc {
+    bytes_ref weight; // arc output
+    stateid_t target; // next state
+    byte_type label;
+  }; // arc
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief serializes the specified FST into compact representation
+  //////////////////////////////////////////////////////////////////////////////
+  static void compile(const vector_byte_fst& fst, bstring& out);
+
+  compact_fst() = default;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief resets the view to the specified compiled FST
+  /// @note data is not copied and must outlive the view
+  /// @returns false if the data is malformed
+  //////////////////////////////////////////////////////////////////////////////
+  bool reset(const bytes_ref& data) NOEXCEPT;
+
+  bool empty() const NOEXCEPT { return 0 == num_states_; }
+  stateid_t start() const NOEXCEPT { return start_; }
+  size_t num_states() const NOEXCEPT { return num_states_; }
+  size_t num_arcs(stateid_t state) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the specified state is final, 'weight' is set to the
+  ///          final output in this case
+  //////////////////////////////////////////////////////////////////////////////
+  bool final(stateid_t state, bytes_ref& weight) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief finds an outgoing arc of the specified state by its label
+  /// @returns true if the arc exists
+  //////////////////////////////////////////////////////////////////////////////
+  bool find(stateid_t state, byte_type label, arc& arc) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns i-th outgoing arc of the specified state, arcs are sorted by label
+  //////////////////////////////////////////////////////////////////////////////
+  arc at(stateid_t state, size_t i) const NOEXCEPT;
+
+  const bytes_ref& data() const NOEXCEPT { return data_; }
+
+ private:
+  struct state_ref {
+    const byte_type* labels;
+    const byte_type* final;
+    size_t num_arcs;
+  }; // state_ref
+
+  state_ref state(stateid_t state) const NOEXCEPT;
+  arc at(const state_ref& state, size_t i) const NOEXCEPT;
+  bytes_ref weight(const byte_type* ref) const NOEXCEPT;
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  bytes_ref data_;
+  const byte_type* offsets_{};
+  const byte_type* states_{};
+  bytes_ref weights_;
+  stateid_t num_states_{};
+  stateid_t start_{};
+  byte_type offset_width_{};
+  byte_type target_width_{};
+  byte_type weight_width_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // compact_fst
+
+NS_END // ROOT
+
+#endif // IRESEARCH_COMPACT_FST_H
@@ -28,6 +28,7 @@
 #include "utils/type_limits.hpp"
 
 #include <lz4.h>
+#include <lz4hc.h>
 
 NS_ROOT
 
@@ -107,4 +108,92 @@ size_t decompressor::deflate(
     : lz4_size;
 }
 
+block_compressor::block_compressor()
+  : stream_(LZ4_createStream(), [](void* ptr)->void { LZ4_freeStream(reinterpret_cast<LZ4_stream_t*>(ptr)); }) {
+}
+
+void block_compressor::compress(
+    const char* src, size_t size,
+    const bytes_ref& dict /*= bytes_ref::NIL*/) {
+  assert(size <= std::numeric_limits<int>::max()); // LZ4 API uses int
+  assert(dict.size() <= std::numeric_limits<int>::max()); // LZ4 API uses int
+  const auto src_size = static_cast<int>(size);
+
+  string_utils::oversize(buf_, LZ4_compressBound(src_size));
+
+  auto* buf = &(buf_[0]);
+  const auto buf_size = static_cast<int>(std::min(
+    buf_.size(),
+    static_cast<size_t>(std::numeric_limits<int>::max())) // LZ4 API uses int
+  );
+
+  int lz4_size;
+
+  if (dict.empty()) {
+    lz4_size = LZ4_compress_default(src, buf, src_size, buf_size);
+  } else {
+    auto* stream = reinterpret_cast<LZ4_stream_t*>(stream_.get());
+
+    // loading a dictionary resets the stream, hence blocks remain independent
+    LZ4_loadDict(stream, ref_cast<char>(dict).c_str(), static_cast<int>(dict.size()));
+    lz4_size = LZ4_compress_fast_continue(stream, src, buf, src_size, buf_size, 0); // 0 == use default acceleration
+  }
+
+  if (lz4_size <= 0 && src_size) {
+    this->size_ = 0;
+
+    throw index_error("while compressing block, error: LZ4 returned non-positive size");
+  }
+
+  this->data_ = reinterpret_cast<const byte_type*>(buf);
+  this->size_ = std::max(0, lz4_size);
+}
+
+void block_compressor::compress_high(const char* src, size_t size) {
+  assert(size <= std::numeric_limits<int>::max()); // LZ4 API uses int
+  const auto src_size = static_cast<int>(size);
+
+  string_utils::oversize(buf_, LZ4_compressBound(src_size));
+
+  auto* buf = &(buf_[0]);
+  const auto buf_size = static_cast<int>(std::min(
+    buf_.size(),
+    static_cast<size_t>(std::numeric_limits<int>::max())) // LZ4 API uses int
+  );
+
+  const auto lz4_size = LZ4_compress_HC(src, buf, src_size, buf_size, LZ4HC_CLEVEL_DEFAULT);
+
+  if (lz4_size <= 0 && src_size) {
+    this->size_ = 0;
+
+    throw index_error("while compressing block, error: LZ4 HC returned non-positive size");
+  }
+
+  this->data_ = reinterpret_cast<const byte_type*>(buf);
+  this->size_ = std::max(0, lz4_size);
+}
+
+size_t block_decompressor::deflate(
+    const char* src, size_t src_size,
+    char* dst, size_t dst_size,
+    const bytes_ref& dict /*= bytes_ref::NIL*/) const {
+  assert(src_size <= integer_traits<int>::const_max); // LZ4 API uses int
+  assert(dict.size() <= integer_traits<int>::const_max); // LZ4 API uses int
+
+  const auto max_size = static_cast<int>(
+    std::min(dst_size, static_cast<size_t>(integer_traits<int>::const_max)) // LZ4 API uses int
+  );
+
+  const auto lz4_size = dict.empty()
+    ? LZ4_decompress_safe(src, dst, static_cast<int>(src_size), max_size)
+    : LZ4_decompress_safe_usingDict(
+        src, dst, static_cast<int>(src_size), max_size,
+        ref_cast<char>(dict).c_str(), static_cast<int>(dict.size())
+      );
+
+  return lz4_size < 0
+    ? type_limits<type_t::address_t>::invalid() // corrupted index
+    : lz4_size;
+}
+
 NS_END
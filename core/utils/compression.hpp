@@ -68,6 +68,49 @@ class IRESEARCH_API decompressor {
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // decompressor
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_compressor
+/// @brief compresses blocks independently of each other, so that any block
+///        can be decompressed on its own via 'block_decompressor'
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API block_compressor: public bytes_ref, private util::noncopyable {
+ public:
+  block_compressor();
+
+  // compresses 'src' at the fast compression level,
+  // a non-empty 'dict' is used as a dictionary preceding the data
+  void compress(
+    const char* src, size_t size,
+    const bytes_ref& dict = bytes_ref::NIL
+  );
+
+  // compresses 'src' at the high compression level, which is considerably
+  // slower than the fast one but produces a smaller output of the same format
+  void compress_high(const char* src, size_t size);
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::string buf_;
+  std::shared_ptr<void> stream_; // hide internal LZ4 implementation
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // block_compressor
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_decompressor
+/// @brief decompresses blocks produced by 'block_compressor'
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API block_decompressor {
+ public:
+  // returns number of decompressed bytes,
+  // or integer_traits<size_t>::const_max in case of error,
+  // 'dict' must match the one used for compression
+  size_t deflate(
+    const char* src, size_t src_size,
+    char* dst, size_t dst_size,
+    const bytes_ref& dict = bytes_ref::NIL
+  ) const;
+}; // block_decompressor
+
 NS_END // NS_ROOT
 
 #endif
@@ -22,20 +22,80 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "cpuinfo.hpp"
+#include "bit_utils.hpp"
+
+#if !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__))
+  #include <cpuid.h>
+  #define IRESEARCH_CPUID
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #define IRESEARCH_CPUID
+#endif
+
+NS_LOCAL
 
+#ifdef IRESEARCH_CPUID
+
+void cpuid(int leaf, int* info) {
 #if defined(_MSC_VER)
+  __cpuidex(info, leaf, 0);
+#else
+  unsigned int regs[4]{};
+  __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
 
-#include "bit_utils.hpp"
+  for (size_t i = 0; i < 4; ++i) {
+    info[i] = static_cast<int>(regs[i]);
+  }
+#endif
+}
+
+// returns extended control register XCR0
+uint64_t xgetbv() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (uint64_t(edx) << 32) | eax;
+#endif
+}
+
+#endif // IRESEARCH_CPUID
+
+NS_END
 
 NS_ROOT
 
 const cpuinfo cpuinfo::instance_;
 
+cpuinfo::cpuinfo() {
+#ifdef IRESEARCH_CPUID
+  int f0_cpuinfo[4];
+  cpuid(0, f0_cpuinfo);
+
+  const int max_leaf = f0_cpuinfo[0];
+
+  if (max_leaf >= 1) {
+    cpuid(1, f1_cpuinfo_);
+
+    // XSAVE/XRSTOR enabled by OS, YMM state is preserved
+    avx_os_ = check_bit<27>(f1_cpuinfo_[2]) && 6 == (xgetbv() & 6);
+  }
+
+  if (max_leaf >= 7) {
+    cpuid(7, f7_cpuinfo_);
+  }
+#endif
+}
+
 /*static*/ bool cpuinfo::support_popcnt() {
   // according to https://msdn.microsoft.com/en-us/library/bb385231.aspx
   return check_bit<23>(instance_.f1_cpuinfo_[2]);
 }
 
-NS_END
+/*static*/ bool cpuinfo::support_avx2() {
+  return instance_.avx_os_
+    && check_bit<28>(instance_.f1_cpuinfo_[2]) // AVX
+    && check_bit<5>(instance_.f7_cpuinfo_[1]); // AVX2
+}
 
-#endif
+NS_END
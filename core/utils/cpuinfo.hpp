@@ -24,28 +24,39 @@
 #ifndef IRESEARCH_CPUID_ID
 #define IRESEARCH_CPUID_ID
 
-#if defined(_MSC_VER)
-
 #include "shared.hpp"
-#include <intrin.h>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
 
 NS_ROOT
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class cpuinfo
+/// @brief instruction set extensions supported by the current CPU, queried
+///        once on library load so that optimized code paths can be selected
+///        at runtime rather than at compile time
+////////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API cpuinfo {
  public:
   static bool support_popcnt();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if both CPU and OS support AVX2 instructions
+  //////////////////////////////////////////////////////////////////////////////
+  static bool support_avx2();
+
  private:
   static const cpuinfo instance_;
 
-  cpuinfo() {
-    __cpuid( f1_cpuinfo_, 1 );
-  }
+  cpuinfo();
 
-  int f1_cpuinfo_[4];
+  int f1_cpuinfo_[4]{}; // EAX, EBX, ECX, EDX of CPUID leaf 1
+  int f7_cpuinfo_[4]{}; // EAX, EBX, ECX, EDX of CPUID leaf 7
+  bool avx_os_{}; // OS saves YMM registers on context switch
 };
 
 NS_END
 
 #endif
-
-#endif
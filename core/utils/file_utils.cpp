@@ -696,6 +696,36 @@ handle_t open(FILE* file, const file_path_t mode) NOEXCEPT {
   #endif
 }
 
+ptrdiff_t read_at(int fd, uint64_t offset, void* buf, size_t size) NOEXCEPT {
+  #ifdef _WIN32
+    HANDLE handle = HANDLE(::_get_osfhandle(fd));
+
+    if (INVALID_HANDLE_VALUE == handle) {
+      return -1;
+    }
+
+    OVERLAPPED overlapped{};
+    overlapped.Offset = DWORD(offset);
+    overlapped.OffsetHigh = DWORD(offset >> 32);
+
+    DWORD read;
+
+    if (!::ReadFile(handle, buf, DWORD(size), &read, &overlapped)) {
+      return ERROR_HANDLE_EOF == GetLastError() ? 0 : -1;
+    }
+
+    return ptrdiff_t(read);
+  #else
+    ssize_t read;
+
+    do {
+      read = ::pread(fd, buf, size, off_t(offset));
+    } while (read < 0 && EINTR == errno); // retry if interrupted by a signal
+
+    return read;
+  #endif
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        path utils
 // -----------------------------------------------------------------------------
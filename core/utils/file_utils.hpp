@@ -126,6 +126,14 @@ typedef std::unique_ptr<FILE, file_deleter> handle_t;
 handle_t open(const file_path_t path, const file_path_t mode) NOEXCEPT;
 handle_t open(FILE* file, const file_path_t mode) NOEXCEPT;
 
+//////////////////////////////////////////////////////////////////////////////
+/// @brief reads up to 'size' bytes starting at the specified offset of a file
+///        without using/changing the position of the file descriptor,
+///        i.e. may be called concurrently for the same descriptor
+/// @returns number of bytes read, 0 on EOF, -1 on error
+//////////////////////////////////////////////////////////////////////////////
+ptrdiff_t read_at(int fd, uint64_t offset, void* buf, size_t size) NOEXCEPT;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        path utils
 // -----------------------------------------------------------------------------
@@ -0,0 +1,603 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "roaring_bitmap.hpp"
+#include "math_utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+NS_LOCAL
+
+const uint32_t CONTAINER_SIZE = 1U << 16; // values per container
+const size_t BITSET_WORDS = CONTAINER_SIZE / 64;
+const size_t BITSET_BYTES = BITSET_WORDS * sizeof(uint64_t);
+
+inline uint32_t high_bits(uint32_t value) NOEXCEPT {
+  return value >> 16;
+}
+
+inline uint32_t low_bits(uint32_t value) NOEXCEPT {
+  return value & 0xFFFF;
+}
+
+inline size_t ctz(uint64_t value) NOEXCEPT {
+  return irs::math::math_traits<uint64_t>::ctz(value);
+}
+
+inline size_t pop(uint64_t value) NOEXCEPT {
+  return irs::math::math_traits<uint64_t>::pop(value);
+}
+
+// returns the index of the first position in 'words' starting from 'low'
+// where the bit (optionally inverted) is set, 'CONTAINER_SIZE' if none
+template<bool Invert>
+uint32_t find_bit(const std::vector<uint64_t>& words, uint32_t low) NOEXCEPT {
+  assert(BITSET_WORDS == words.size());
+
+  size_t i = low / 64;
+  uint64_t word = (Invert ? ~words[i] : words[i]) & (~UINT64_C(0) << (low % 64));
+
+  while (!word) {
+    if (++i == BITSET_WORDS) {
+      return CONTAINER_SIZE;
+    }
+
+    word = Invert ? ~words[i] : words[i];
+  }
+
+  return uint32_t(i*64 + ctz(word));
+}
+
+// returns the position of the run containing 'low' or the run
+// preceeding 'low', number of runs if there is no such run
+size_t find_run(const std::vector<uint16_t>& runs, uint32_t low) NOEXCEPT {
+  size_t begin = 0, end = runs.size() / 2;
+
+  // find the first run starting after 'low'
+  while (begin < end) {
+    const size_t mid = begin + (end - begin) / 2;
+
+    if (runs[2*mid] <= low) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+
+  return begin ? begin - 1 : runs.size() / 2;
+}
+
+NS_END // LOCAL
+
+NS_ROOT
+
+/*static*/ const size_t roaring_bitmap::ARRAY_MAX;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         container implementation
+// -----------------------------------------------------------------------------
+
+uint32_t roaring_bitmap::container::lower_bound(uint32_t low) const NOEXCEPT {
+  if (low >= CONTAINER_SIZE) {
+    return CONTAINER_SIZE;
+  }
+
+  switch (type) {
+    case container_type::ARRAY: {
+      const auto it = std::lower_bound(values.begin(), values.end(), low);
+      return values.end() == it ? CONTAINER_SIZE : *it;
+    }
+    case container_type::BITSET:
+      return find_bit<false>(bits, low);
+    case container_type::RUN: {
+      const size_t run = find_run(values, low);
+      const size_t runs = values.size() / 2;
+
+      if (run < runs && low <= uint32_t(values[2*run]) + values[2*run+1]) {
+        return low; // 'low' is inside of the run
+      }
+
+      const size_t next = run < runs ? run + 1 : 0;
+      return next < runs ? values[2*next] : CONTAINER_SIZE;
+    }
+  }
+
+  assert(false);
+  return CONTAINER_SIZE;
+}
+
+uint32_t roaring_bitmap::container::next_absent(uint32_t low) const NOEXCEPT {
+  if (low >= CONTAINER_SIZE) {
+    return CONTAINER_SIZE;
+  }
+
+  switch (type) {
+    case container_type::ARRAY: {
+      auto it = std::lower_bound(values.begin(), values.end(), low);
+
+      for (; it != values.end() && *it == low; ++it, ++low) { }
+
+      return low;
+    }
+    case container_type::BITSET:
+      return find_bit<true>(bits, low);
+    case container_type::RUN: {
+      const size_t run = find_run(values, low);
+
+      if (run < values.size() / 2) {
+        const uint32_t last = uint32_t(values[2*run]) + values[2*run+1];
+
+        // adjacent runs are always merged, so the value next to the run is absent
+        if (low <= last) {
+          return last + 1;
+        }
+      }
+
+      return low;
+    }
+  }
+
+  assert(false);
+  return CONTAINER_SIZE;
+}
+
+bool roaring_bitmap::container::contains(uint32_t low) const NOEXCEPT {
+  switch (type) {
+    case container_type::ARRAY:
+      return std::binary_search(values.begin(), values.end(), low);
+    case container_type::BITSET:
+      return 0 != (bits[low / 64] & (UINT64_C(1) << (low % 64)));
+    case container_type::RUN: {
+      const size_t run = find_run(values, low);
+
+      return run < values.size() / 2
+        && low <= uint32_t(values[2*run]) + values[2*run+1];
+    }
+  }
+
+  assert(false);
+  return false;
+}
+
+size_t roaring_bitmap::container::runs() const NOEXCEPT {
+  if (container_type::RUN == type) {
+    return values.size() / 2;
+  }
+
+  size_t count = 0;
+
+  for (auto begin = lower_bound(0); begin < CONTAINER_SIZE;) {
+    begin = lower_bound(next_absent(begin));
+    ++count;
+  }
+
+  return count;
+}
+
+bool roaring_bitmap::container::insert(uint32_t low) {
+  if (container_type::RUN == type) {
+    if (contains(low)) {
+      return false;
+    }
+
+    cardinality < ARRAY_MAX ? to_array() : to_bitset();
+  }
+
+  if (container_type::ARRAY == type) {
+    const auto it = std::lower_bound(values.begin(), values.end(), low);
+
+    if (it != values.end() && *it == low) {
+      return false;
+    }
+
+    if (cardinality < ARRAY_MAX) {
+      values.insert(it, uint16_t(low));
+      ++cardinality;
+      return true;
+    }
+
+    to_bitset();
+  }
+
+  assert(container_type::BITSET == type);
+  auto& word = bits[low / 64];
+  const auto mask = UINT64_C(1) << (low % 64);
+
+  if (word & mask) {
+    return false;
+  }
+
+  word |= mask;
+  ++cardinality;
+  return true;
+}
+
+void roaring_bitmap::container::insert_range(uint32_t low, uint32_t high) {
+  assert(low <= high && high < CONTAINER_SIZE);
+
+  if (container_type::ARRAY == type
+      && cardinality + (high - low + 1) <= ARRAY_MAX) {
+    std::vector<uint16_t> range(high - low + 1);
+    std::iota(range.begin(), range.end(), uint16_t(low));
+
+    std::vector<uint16_t> merged;
+    merged.reserve(values.size() + range.size());
+    std::set_union(
+      values.begin(), values.end(), range.begin(), range.end(),
+      std::back_inserter(merged)
+    );
+
+    values = std::move(merged);
+    cardinality = uint32_t(values.size());
+    return;
+  }
+
+  to_bitset();
+
+  const size_t first = low / 64, last = high / 64;
+
+  for (size_t i = first; i <= last; ++i) {
+    auto mask = ~UINT64_C(0);
+
+    if (i == first) {
+      mask &= ~UINT64_C(0) << (low % 64);
+    }
+
+    if (i == last) {
+      mask &= ~UINT64_C(0) >> (63 - high % 64);
+    }
+
+    cardinality += uint32_t(pop(mask & ~bits[i]));
+    bits[i] |= mask;
+  }
+}
+
+bool roaring_bitmap::container::erase(uint32_t low) {
+  if (container_type::RUN == type) {
+    if (!contains(low)) {
+      return false;
+    }
+
+    cardinality <= ARRAY_MAX ? to_array() : to_bitset();
+  }
+
+  if (container_type::ARRAY == type) {
+    const auto it = std::lower_bound(values.begin(), values.end(), low);
+
+    if (it == values.end() || *it != low) {
+      return false;
+    }
+
+    values.erase(it);
+    --cardinality;
+    return true;
+  }
+
+  assert(container_type::BITSET == type);
+  auto& word = bits[low / 64];
+  const auto mask = UINT64_C(1) << (low % 64);
+
+  if (!(word & mask)) {
+    return false;
+  }
+
+  word &= ~mask;
+
+  if (--cardinality <= ARRAY_MAX) {
+    to_array();
+  }
+
+  return true;
+}
+
+void roaring_bitmap::container::to_array() {
+  if (container_type::ARRAY == type) {
+    return;
+  }
+
+  assert(cardinality <= ARRAY_MAX);
+  std::vector<uint16_t> array;
+  array.reserve(cardinality);
+
+  for (auto low = lower_bound(0); low < CONTAINER_SIZE; low = lower_bound(low + 1)) {
+    array.push_back(uint16_t(low));
+  }
+
+  values = std::move(array);
+  bits = std::vector<uint64_t>();
+  type = container_type::ARRAY;
+}
+
+void roaring_bitmap::container::to_bitset() {
+  if (container_type::BITSET == type) {
+    return;
+  }
+
+  bits.assign(BITSET_WORDS, 0);
+
+  if (container_type::ARRAY == type) {
+    for (const auto low : values) {
+      bits[low / 64] |= UINT64_C(1) << (low % 64);
+    }
+  } else {
+    assert(container_type::RUN == type);
+    const auto runs = std::move(values);
+
+    type = container_type::BITSET;
+    cardinality = 0;
+
+    for (size_t i = 0, size = runs.size(); i < size; i += 2) {
+      insert_range(runs[i], uint32_t(runs[i]) + runs[i+1]);
+    }
+  }
+
+  values = std::vector<uint16_t>();
+  type = container_type::BITSET;
+}
+
+void roaring_bitmap::container::to_runs() {
+  if (container_type::RUN == type) {
+    return;
+  }
+
+  std::vector<uint16_t> runs;
+  runs.reserve(2*this->runs());
+
+  for (auto begin = lower_bound(0); begin < CONTAINER_SIZE;) {
+    const auto end = next_absent(begin);
+
+    runs.push_back(uint16_t(begin));
+    runs.push_back(uint16_t(end - begin - 1));
+    begin = lower_bound(end);
+  }
+
+  values = std::move(runs);
+  bits = std::vector<uint64_t>();
+  type = container_type::RUN;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    const_iterator implementation
+// -----------------------------------------------------------------------------
+
+roaring_bitmap::const_iterator&
+roaring_bitmap::const_iterator::operator++() NOEXCEPT {
+  assert(begin_ != end_);
+  low_ = begin_->lower_bound(low_ + 1);
+
+  if (low_ >= CONTAINER_SIZE) {
+    // containers are never empty
+    low_ = ++begin_ == end_ ? 0 : begin_->lower_bound(0);
+  }
+
+  return *this;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    roaring_bitmap implementation
+// -----------------------------------------------------------------------------
+
+roaring_bitmap::roaring_bitmap(std::initializer_list<value_type> values) {
+  for (const auto value : values) {
+    insert(value);
+  }
+}
+
+roaring_bitmap::containers_t::const_iterator roaring_bitmap::find_container(
+    uint32_t key) const NOEXCEPT {
+  const auto it = std::lower_bound(
+    containers_.begin(), containers_.end(), key,
+    [](const container& lhs, uint32_t key) { return lhs.key < key; }
+  );
+
+  return it != containers_.end() && it->key == key ? it : containers_.end();
+}
+
+roaring_bitmap::containers_t::iterator roaring_bitmap::get_container(
+    uint32_t key) {
+  // fast path for ascending inserts
+  if (!containers_.empty() && containers_.back().key == key) {
+    return containers_.end() - 1;
+  }
+
+  const auto it = std::lower_bound(
+    containers_.begin(), containers_.end(), key,
+    [](const container& lhs, uint32_t key) { return lhs.key < key; }
+  );
+
+  if (it != containers_.end() && it->key == key) {
+    return it;
+  }
+
+  return containers_.emplace(it, key);
+}
+
+std::pair<roaring_bitmap::const_iterator, bool> roaring_bitmap::insert(
+    value_type value) {
+  const auto low = low_bits(value);
+  const auto it = get_container(high_bits(value));
+  const bool inserted = it->insert(low);
+
+  size_ += size_t(inserted);
+
+  return std::make_pair(
+    const_iterator(it, containers_.end(), low), inserted
+  );
+}
+
+void roaring_bitmap::insert_range(value_type begin, value_type end) {
+  if (begin >= end) {
+    return;
+  }
+
+  const value_type last = end - 1;
+
+  for (auto key = high_bits(begin), last_key = high_bits(last); ; ++key) {
+    const auto low = key == high_bits(begin) ? low_bits(begin) : 0;
+    const auto high = key == last_key ? low_bits(last) : CONTAINER_SIZE - 1;
+
+    auto& container = *get_container(key);
+    const auto cardinality = container.cardinality;
+
+    container.insert_range(low, high);
+    size_ += container.cardinality - cardinality;
+
+    if (key == last_key) {
+      break;
+    }
+  }
+}
+
+size_t roaring_bitmap::erase(value_type value) {
+  auto it = containers_.begin() + std::distance(
+    containers_.cbegin(), find_container(high_bits(value))
+  );
+
+  if (it == containers_.end() || !it->erase(low_bits(value))) {
+    return 0;
+  }
+
+  if (!it->cardinality) {
+    containers_.erase(it);
+  }
+
+  --size_;
+  return 1;
+}
+
+bool roaring_bitmap::contains(value_type value) const NOEXCEPT {
+  const auto it = find_container(high_bits(value));
+
+  return it != containers_.end() && it->contains(low_bits(value));
+}
+
+roaring_bitmap::const_iterator roaring_bitmap::find(
+    value_type value) const NOEXCEPT {
+  const auto low = low_bits(value);
+  const auto it = find_container(high_bits(value));
+
+  return it != containers_.end() && it->contains(low)
+    ? const_iterator(it, containers_.end(), low)
+    : end();
+}
+
+roaring_bitmap::const_iterator roaring_bitmap::lower_bound(
+    value_type value) const NOEXCEPT {
+  const auto key = high_bits(value);
+  auto it = std::lower_bound(
+    containers_.begin(), containers_.end(), key,
+    [](const container& lhs, uint32_t key) { return lhs.key < key; }
+  );
+
+  if (it == containers_.end()) {
+    return end();
+  }
+
+  if (it->key == key) {
+    const auto low = it->lower_bound(low_bits(value));
+
+    if (low < CONTAINER_SIZE) {
+      return const_iterator(it, containers_.end(), low);
+    }
+
+    if (++it == containers_.end()) {
+      return end();
+    }
+  }
+
+  return const_iterator(it, containers_.end(), it->lower_bound(0));
+}
+
+roaring_bitmap::value_type roaring_bitmap::next_absent(
+    value_type value) const NOEXCEPT {
+  for (auto key = high_bits(value), low = low_bits(value);; ++key, low = 0) {
+    const auto it = find_container(key);
+
+    if (it == containers_.end()) {
+      return (key << 16) | low;
+    }
+
+    const auto absent = it->next_absent(low);
+
+    if (absent < CONTAINER_SIZE) {
+      return (key << 16) | absent;
+    }
+
+    if (key == high_bits(std::numeric_limits<value_type>::max())) {
+      return std::numeric_limits<value_type>::max();
+    }
+  }
+}
+
+void roaring_bitmap::optimize() {
+  for (auto& container : containers_) {
+    const size_t run_bytes = 2*sizeof(uint16_t)*container.runs();
+    const size_t array_bytes = container.cardinality <= ARRAY_MAX
+      ? container.cardinality*sizeof(uint16_t)
+      : std::numeric_limits<size_t>::max();
+
+    if (run_bytes < std::min(array_bytes, BITSET_BYTES)) {
+      container.to_runs();
+    } else if (array_bytes <= BITSET_BYTES) {
+      container.to_array();
+    } else {
+      container.to_bitset();
+    }
+
+    container.values.shrink_to_fit();
+  }
+
+  containers_.shrink_to_fit();
+}
+
+size_t roaring_bitmap::memory() const NOEXCEPT {
+  size_t size = containers_.capacity()*sizeof(container);
+
+  for (auto& container : containers_) {
+    size += container.values.capacity()*sizeof(uint16_t)
+          + container.bits.capacity()*sizeof(uint64_t);
+  }
+
+  return size;
+}
+
+roaring_bitmap::const_iterator roaring_bitmap::begin() const NOEXCEPT {
+  return containers_.empty()
+    ? end()
+    : const_iterator(containers_.begin(), containers_.end(), containers_.front().lower_bound(0));
+}
+
+bool roaring_bitmap::operator==(const roaring_bitmap& rhs) const NOEXCEPT {
+  // same values may be stored in containers of different types
+  return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_ROARING_BITMAP_H
+#define IRESEARCH_ROARING_BITMAP_H
+
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+#include "shared.hpp"
+#include "integer.hpp"
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class roaring_bitmap
+/// @brief compressed set of 32-bit unsigned integers, values are partitioned
+///        by their 16 high bits into containers, each container stores the
+///        16 low bits either as a sorted array, a bitset or a list of runs,
+///        whichever is the most compact one
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API roaring_bitmap {
+ public:
+  typedef uint32_t value_type;
+  typedef size_t size_type;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief max cardinality of an array container, containers with a greater
+  ///        cardinality are stored as bitsets
+  //////////////////////////////////////////////////////////////////////////////
+  static const size_t ARRAY_MAX = 4096;
+
+  enum class container_type : byte_type {
+    ARRAY = 0, // sorted array of values
+    BITSET, // 2^16 bits
+    RUN // sorted list of [start, start+length] runs
+  }; // container_type
+
+ private:
+  struct container {
+    explicit container(uint32_t key) NOEXCEPT
+      : key(key), cardinality(0), type(container_type::ARRAY) {
+    }
+
+    // returns the smallest value >= 'low' in a container, 2^16 if none
+    uint32_t lower_bound(uint32_t low) const NOEXCEPT;
+
+    // returns the smallest value >= 'low' not in a container, 2^16 if none
+    uint32_t next_absent(uint32_t low) const NOEXCEPT;
+
+    bool contains(uint32_t low) const NOEXCEPT;
+
+    // returns number of runs of consecutive values in a container
+    size_t runs() const NOEXCEPT;
+
+    bool insert(uint32_t low);
+    void insert_range(uint32_t low, uint32_t high); // [low, high]
+    bool erase(uint32_t low);
+
+    void to_array();
+    void to_bitset();
+    void to_runs();
+
+    uint32_t key; // 16 high bits of values
+    uint32_t cardinality;
+    container_type type;
+    std::vector<uint16_t> values; // ARRAY: values, RUN: (start, length) pairs
+    std::vector<uint64_t> bits; // BITSET: 2^16 bits
+  }; // container
+
+  typedef std::vector<container> containers_t;
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////
+  /// @class const_iterator
+  /// @brief iterates over values in ascending order
+  ////////////////////////////////////////////////////////////////////////////
+  class IRESEARCH_API const_iterator
+    : public std::iterator<std::forward_iterator_tag, const value_type> {
+   public:
+    const_iterator() = default;
+
+    value_type operator*() const NOEXCEPT {
+      return (begin_->key << 16) | low_;
+    }
+
+    const_iterator& operator++() NOEXCEPT;
+
+    const_iterator operator++(int) NOEXCEPT {
+      const auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& rhs) const NOEXCEPT {
+      return begin_ == rhs.begin_ && low_ == rhs.low_;
+    }
+
+    bool operator!=(const const_iterator& rhs) const NOEXCEPT {
+      return !(*this == rhs);
+    }
+
+   private:
+    friend class roaring_bitmap;
+
+    const_iterator(
+        containers_t::const_iterator begin,
+        containers_t::const_iterator end,
+        uint32_t low) NOEXCEPT
+      : begin_(begin), end_(end), low_(low) {
+    }
+
+    containers_t::const_iterator begin_; // current container
+    containers_t::const_iterator end_;
+    uint32_t low_{}; // 16 low bits of the current value
+  }; // const_iterator
+
+  typedef const_iterator iterator;
+
+  roaring_bitmap() = default;
+  roaring_bitmap(std::initializer_list<value_type> values);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief adds a value to the set
+  /// @returns iterator to the value and true if the value was not in the set
+  //////////////////////////////////////////////////////////////////////////////
+  std::pair<const_iterator, bool> insert(value_type value);
+
+  std::pair<const_iterator, bool> emplace(value_type value) {
+    return insert(value);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief adds values [begin, end) to the set
+  //////////////////////////////////////////////////////////////////////////////
+  void insert_range(value_type begin, value_type end);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief removes a value from the set
+  /// @returns number of removed values
+  //////////////////////////////////////////////////////////////////////////////
+  size_t erase(value_type value);
+
+  bool contains(value_type value) const NOEXCEPT;
+
+  size_t count(value_type value) const NOEXCEPT {
+    return size_t(contains(value));
+  }
+
+  const_iterator find(value_type value) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns iterator to the smallest value not less than the specified one
+  //////////////////////////////////////////////////////////////////////////////
+  const_iterator lower_bound(value_type value) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the smallest value not less than the specified one which is not
+  ///          in the set, max value of 'value_type' if there is no such value
+  /// @note skips runs of values a word/run at a time
+  //////////////////////////////////////////////////////////////////////////////
+  value_type next_absent(value_type value) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief converts containers into the most compact representation,
+  ///        e.g. long sequences of consecutive values are turned into runs
+  //////////////////////////////////////////////////////////////////////////////
+  void optimize();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief for compatibility with associative containers, no-op
+  //////////////////////////////////////////////////////////////////////////////
+  void reserve(size_t /*size*/) NOEXCEPT { }
+
+  void clear() NOEXCEPT {
+    containers_.clear();
+    size_ = 0;
+  }
+
+  size_t size() const NOEXCEPT { return size_; }
+  bool empty() const NOEXCEPT { return 0 == size_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns approximate amount of memory occupied by the values in bytes
+  //////////////////////////////////////////////////////////////////////////////
+  size_t memory() const NOEXCEPT;
+
+  const_iterator begin() const NOEXCEPT;
+  const_iterator end() const NOEXCEPT {
+    return const_iterator(containers_.end(), containers_.end(), 0);
+  }
+
+  bool operator==(const roaring_bitmap& rhs) const NOEXCEPT;
+  bool operator!=(const roaring_bitmap& rhs) const NOEXCEPT {
+    return !(*this == rhs);
+  }
+
+ private:
+  containers_t::const_iterator find_container(uint32_t key) const NOEXCEPT;
+  containers_t::iterator get_container(uint32_t key);
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  containers_t containers_; // sorted by key
+  size_t size_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // roaring_bitmap
+
+NS_END // ROOT
+
+#endif // IRESEARCH_ROARING_BITMAP_H
@@ -41,6 +41,8 @@
 #include "utils/locale_utils.hpp"
 #include "utils/runtime_utils.hpp"
 
+#include <tuple>
+
 namespace tests {
   class TextAnalyzerParserTestSuite: public ::testing::Test {
 
@@ -266,6 +268,129 @@ TEST_F(TextAnalyzerParserTestSuite, test_text_analyzer) {
   }
 }
 
+TEST_F(TextAnalyzerParserTestSuite, test_ascii_words) {
+  typedef std::tuple<std::string, uint32_t, uint32_t> token_t; // value + offsets
+  std::unordered_set<std::string> emptySet;
+  auto locale = irs::locale_utils::locale("C.UTF-8");
+
+  auto assert_tokens = [&locale, &emptySet](
+      const std::string& data, const std::vector<token_t>& expected
+  )->void {
+    text_token_stream stream(locale, emptySet);
+    auto& offset = stream.attributes().get<iresearch::offset>();
+    auto& value = stream.attributes().get<iresearch::term_attribute>();
+
+    ASSERT_TRUE(stream.reset(data));
+
+    for (auto& token : expected) {
+      ASSERT_TRUE(stream.next());
+      ASSERT_EQ(std::get<0>(token), std::string((char*)(value->value().c_str()), value->value().size()));
+      ASSERT_EQ(std::get<1>(token), offset->start);
+      ASSERT_EQ(std::get<2>(token), offset->end);
+    }
+
+    ASSERT_FALSE(stream.next());
+  };
+
+  // word boundaries of ASCII words match the ones found by ICU
+  assert_tokens(
+    " Can't e.g. 3.14,15 foo_bar _ __ a:b x.1 CR\r\nLF End.",
+    {
+      token_t("can't", 1, 6), token_t("e.g", 7, 10), token_t("3.14,15", 12, 19),
+      token_t("foo_bar", 20, 27), token_t("__", 30, 32), token_t("a", 33, 34),
+      token_t("b", 35, 36), token_t("x", 37, 38), token_t("1", 39, 40),
+      token_t("cr", 41, 43), token_t("lf", 45, 47), token_t("end", 48, 51)
+    }
+  );
+
+  // non-ASCII words in between ASCII ones, offsets are in UTF-16 code units
+  assert_tokens(
+    "abc d\xC3\xA9" "f ghi.j \xF0\x9F\x98\x80x jkl D\xC3\x89J\xC3\x80 vu mno",
+    {
+      token_t("abc", 0, 3), token_t("def", 4, 7), token_t("ghi.j", 8, 13),
+      token_t("x", 16, 17), token_t("jkl", 18, 21), token_t("deja", 22, 26),
+      token_t("vu", 27, 29), token_t("mno", 30, 33)
+    }
+  );
+
+  // ASCII word followed by a combining mark is handled by ICU
+  assert_tokens("ab.c\xCC\x81 ", { token_t("ab.c", 0, 5) });
+
+  // reset
+  {
+    text_token_stream stream(locale, emptySet);
+    auto& value = stream.attributes().get<iresearch::term_attribute>();
+
+    ASSERT_TRUE(stream.reset("d\xC3\xA9j\xC3\xA0 vu"));
+    ASSERT_TRUE(stream.next());
+    ASSERT_EQ("deja", std::string((char*)(value->value().c_str()), value->value().size()));
+    ASSERT_TRUE(stream.reset("Abc"));
+    ASSERT_TRUE(stream.next());
+    ASSERT_EQ("abc", std::string((char*)(value->value().c_str()), value->value().size()));
+    ASSERT_FALSE(stream.next());
+  }
+}
+
+TEST_F(TextAnalyzerParserTestSuite, test_cached_words) {
+  std::unordered_set<std::string> stopwordSet = { "the" };
+  auto locale = irs::locale_utils::locale("en_US.UTF-8");
+  text_token_stream stream(locale, stopwordSet);
+  auto& pValue = stream.attributes().get<iresearch::term_attribute>();
+
+  auto assert_tokens = [&stream, &pValue](
+      const std::string& data, const std::vector<std::string>& expected
+  )->void {
+    ASSERT_TRUE(stream.reset(data));
+
+    for (auto& token : expected) {
+      ASSERT_TRUE(stream.next());
+      ASSERT_EQ(token, std::string((char*)(pValue->value().c_str()), pValue->value().size()));
+    }
+
+    ASSERT_FALSE(stream.next());
+  };
+
+  ASSERT_EQ(0, stream.cache_statistics().hits);
+  ASSERT_EQ(0, stream.cache_statistics().misses);
+
+  // words are cached as found in the input
+  assert_tokens(
+    "The runners running the RUNNING runners d\xC3\xA9j\xC3\xA0 D\xC3\xA9j\xC3\xA0 d\xC3\xA9j\xC3\xA0",
+    { "runner", "run", "run", "runner", "deja", "deja", "deja" }
+  );
+  ASSERT_EQ(2, stream.cache_statistics().hits);
+  ASSERT_EQ(7, stream.cache_statistics().misses);
+
+  // cached outcomes (including ignored words) survive reset
+  assert_tokens("the runners D\xC3\xA9j\xC3\xA0", { "runner", "deja" });
+  ASSERT_EQ(5, stream.cache_statistics().hits);
+  ASSERT_EQ(7, stream.cache_statistics().misses);
+
+  // long words are not cached
+  const std::string long_word(100, 'a');
+  assert_tokens(long_word + " " + long_word, { long_word, long_word });
+  ASSERT_EQ(5, stream.cache_statistics().hits);
+  ASSERT_EQ(9, stream.cache_statistics().misses);
+
+  // the cache is bounded, evicted words are processed again
+  {
+    std::string data;
+    std::vector<std::string> expected;
+
+    for (size_t i = 0; i < 4096; ++i) {
+      expected.emplace_back("w" + std::to_string(i));
+      data += expected.back() + " ";
+    }
+
+    assert_tokens(data, expected);
+    assert_tokens(data, expected);
+
+    const auto stats = stream.cache_statistics();
+    ASSERT_EQ(5 + 9 + 2*4096, stats.hits + stats.misses);
+    ASSERT_GT(stats.misses, 9 + 4096);
+  }
+}
+
 TEST_F(TextAnalyzerParserTestSuite, test_load_stopwords) {
   std::unordered_set<std::string> emptySet;
   std::string sField = "test field";
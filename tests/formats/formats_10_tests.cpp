@@ -27,12 +27,16 @@
 #include "store/memory_directory.hpp"
 #include "store/fs_directory.hpp"
 #include "utils/bit_packing.hpp"
+#include "utils/misc.hpp"
 #include "utils/type_limits.hpp"
 #include "formats/formats_10.hpp"
 #include "formats/formats_10_attributes.hpp"
+#include "formats/formats_burst_trie.hpp"
 #include "formats_test_case_base.hpp"
 #include "formats/format_utils.hpp"
 
+#include <thread>
+
 class format_10_test_case : public tests::format_test_case_base {
  protected:
   const size_t VERSION10_POSTINGS_WRITER_BLOCK_SIZE = 128;
@@ -710,6 +714,27 @@ class format_10_test_case : public tests::format_test_case_base {
           }
         }
 
+        // interleave seeks of iterators sharing skip data
+        {
+          auto lhs = reader->iterator(field.features, read_attrs, field.features);
+          auto rhs = reader->iterator(field.features, read_attrs, field.features);
+
+          postings lhs_expected(docs.begin(), docs.end(), field.features);
+          postings rhs_expected(docs.begin(), docs.end(), field.features);
+          for (size_t i = 0, size = docs.size(); i < size; i += 311) {
+            if (2*i < size) {
+              const auto rhs_doc = docs[2*i];
+              ASSERT_EQ(rhs_doc, rhs->seek(rhs_doc));
+              ASSERT_EQ(rhs_doc, rhs_expected.seek(rhs_doc));
+              assert_positions(rhs_expected, *rhs);
+            }
+
+            ASSERT_EQ(docs[i], lhs->seek(docs[i]));
+            ASSERT_EQ(docs[i], lhs_expected.seek(docs[i]));
+            assert_positions(lhs_expected, *lhs);
+          }
+        }
+
         // seek for INVALID_DOC
         {
           auto it = reader->iterator(field.features, read_attrs, irs::flags::empty_instance());
@@ -882,6 +907,285 @@ class format_10_test_case : public tests::format_test_case_base {
       postings_seek(docs, { irs::frequency::type(), irs::position::type(), irs::offset::type(), irs::payload::type() });
     }
   }
+
+  void postings_frequency_bound(irs::doc_id_t count) {
+    // postings with varying in-document frequency
+    class freq_postings : public irs::doc_iterator {
+     public:
+      explicit freq_postings(irs::doc_id_t count): count_(count) {
+        attrs_.emplace(freq_);
+      }
+
+      static uint32_t freq(irs::doc_id_t doc) { return 1 + (doc*7) % 50; }
+
+      bool next() override {
+        if (doc_ >= count_) {
+          doc_ = irs::type_limits<irs::type_t::doc_id_t>::eof();
+          return false;
+        }
+
+        freq_.value = freq(++doc_);
+        return true;
+      }
+
+      irs::doc_id_t value() const override { return doc_; }
+
+      irs::doc_id_t seek(irs::doc_id_t target) override {
+        irs::seek(*this, target);
+        return value();
+      }
+
+      const irs::attribute_view& attributes() const NOEXCEPT override {
+        return attrs_;
+      }
+
+     private:
+      irs::attribute_view attrs_;
+      irs::frequency freq_;
+      irs::doc_id_t count_;
+      irs::doc_id_t doc_{ irs::type_limits<irs::type_t::doc_id_t>::invalid() };
+    }; // freq_postings
+
+    const size_t block_size = VERSION10_POSTINGS_WRITER_BLOCK_SIZE;
+    irs::field_meta field;
+    field.features = { irs::frequency::type() };
+
+    auto max_freq = [](irs::doc_id_t begin, irs::doc_id_t end) {
+      uint32_t max = 0;
+      for (; begin <= end; ++begin) {
+        max = std::max(max, freq_postings::freq(begin));
+      }
+      return max;
+    };
+
+    auto codec = std::dynamic_pointer_cast<const irs::version10::format>(get_codec());
+    ASSERT_NE(nullptr, codec);
+    auto writer = codec->get_postings_writer(false);
+    ASSERT_NE(nullptr, writer);
+    irs::postings_writer::state term_meta; // must be destroyed before the writer
+    uint64_t term_freq = 0;
+
+    // write postings
+    {
+      irs::flush_state state;
+      state.dir = &dir();
+      state.doc_count = count + 1;
+      state.name = "segment_name";
+      state.features = &field.features;
+
+      auto out = dir().create("attributes");
+      ASSERT_FALSE(!out);
+
+      writer->prepare(*out, state);
+      writer->begin_field(field.features);
+
+      freq_postings it(count);
+      term_meta = writer->write(it);
+
+      auto& typed_meta = dynamic_cast<irs::version10::term_meta&>(*term_meta);
+      ASSERT_EQ(count, typed_meta.docs_count);
+      ASSERT_EQ(max_freq(1, count), typed_meta.max_freq);
+
+      for (irs::doc_id_t doc = 1; doc <= count; ++doc) {
+        term_freq += freq_postings::freq(doc);
+      }
+
+      writer->encode(*out, *term_meta);
+      writer->end();
+    }
+
+    // read postings
+    {
+      irs::segment_meta meta;
+      meta.name = "segment_name";
+
+      irs::reader_state state;
+      state.dir = &dir();
+      state.meta = &meta;
+
+      auto in = dir().open("attributes", irs::IOAdvice::NORMAL);
+      ASSERT_FALSE(!in);
+
+      auto reader = codec->get_postings_reader();
+      ASSERT_NE(nullptr, reader);
+      reader->prepare(*in, state, field.features);
+
+      irs::frequency freq;
+      freq.value = uint32_t(term_freq);
+      irs::version10::term_meta read_meta;
+      irs::attribute_view read_attrs;
+      read_attrs.emplace(freq);
+      read_attrs.emplace(read_meta);
+      reader->decode(*in, field.features, read_attrs, read_meta);
+      ASSERT_EQ(max_freq(1, count), read_meta.max_freq);
+
+      // bounds are not exposed unless frequency is requested
+      {
+        auto it = reader->iterator(field.features, read_attrs, irs::flags::empty_instance());
+        ASSERT_FALSE(it->attributes().get<irs::frequency_bound>());
+      }
+
+      // shallow seek doesn't move the iterator
+      {
+        auto it = reader->iterator(field.features, read_attrs, field.features);
+        auto& bound = it->attributes().get<irs::frequency_bound>();
+        ASSERT_TRUE(bool(bound));
+        ASSERT_EQ(max_freq(1, count), bound->value);
+
+        for (irs::doc_id_t target = 1; target <= count; target += 61) {
+          const irs::doc_id_t block_begin = irs::doc_id_t(((target - 1) / block_size) * block_size + 1);
+          const irs::doc_id_t block_end = irs::doc_id_t(block_begin + block_size - 1);
+
+          if (block_end < count) {
+            ASSERT_EQ(block_end, bound->shallow_seek(target));
+            ASSERT_EQ(max_freq(block_begin, block_end), bound->block);
+          } else {
+            // tail block isn't covered by the skip list
+            ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(bound->shallow_seek(target)));
+            ASSERT_EQ(bound->value, bound->block);
+          }
+        }
+
+        ASSERT_FALSE(irs::type_limits<irs::type_t::doc_id_t>::valid(it->value()));
+        ASSERT_TRUE(it->next());
+        ASSERT_EQ(1, it->value());
+      }
+
+      // interleave shallow seeks with regular seeks
+      {
+        auto it = reader->iterator(field.features, read_attrs, field.features);
+        auto& bound = it->attributes().get<irs::frequency_bound>();
+        auto& doc_freq = it->attributes().get<irs::frequency>();
+        ASSERT_TRUE(bool(bound));
+        ASSERT_TRUE(bool(doc_freq));
+
+        for (irs::doc_id_t target = 5; target <= count; target += 97) {
+          bound->shallow_seek(target + irs::doc_id_t(block_size));
+          ASSERT_EQ(target, it->seek(target));
+          ASSERT_EQ(freq_postings::freq(target), doc_freq->value);
+          ASSERT_TRUE(it->next());
+          ASSERT_EQ(target + 1, it->value());
+          ASSERT_EQ(freq_postings::freq(target + 1), doc_freq->value);
+        }
+      }
+    }
+  }
+
+  void postings_next_batch() {
+    const irs::doc_id_t count = 1000; // 7 full blocks and a tail
+    std::vector<irs::doc_id_t> docs;
+    for (irs::doc_id_t doc = 1; doc <= count; ++doc) {
+      docs.push_back(doc*2);
+    }
+
+    irs::field_meta field;
+    field.features = { irs::frequency::type(), irs::position::type() };
+
+    auto codec = std::dynamic_pointer_cast<const irs::version10::format>(get_codec());
+    ASSERT_NE(nullptr, codec);
+    auto writer = codec->get_postings_writer(false);
+    ASSERT_NE(nullptr, writer);
+    irs::postings_writer::state term_meta; // must be destroyed before the writer
+
+    // write postings
+    {
+      irs::flush_state state;
+      state.dir = &dir();
+      state.doc_count = docs.back() + 1;
+      state.name = "segment_name";
+      state.features = &field.features;
+
+      auto out = dir().create("attributes");
+      ASSERT_FALSE(!out);
+
+      writer->prepare(*out, state);
+      writer->begin_field(field.features);
+
+      postings it(docs.begin(), docs.end(), field.features);
+      term_meta = writer->write(it);
+
+      writer->encode(*out, *term_meta);
+      writer->end();
+    }
+
+    // read postings
+    irs::segment_meta meta;
+    meta.name = "segment_name";
+
+    irs::reader_state state;
+    state.dir = &dir();
+    state.meta = &meta;
+
+    auto in = dir().open("attributes", irs::IOAdvice::NORMAL);
+    ASSERT_FALSE(!in);
+
+    auto reader = codec->get_postings_reader();
+    ASSERT_NE(nullptr, reader);
+    reader->prepare(*in, state, field.features);
+
+    irs::frequency freq;
+    freq.value = 10;
+    irs::version10::term_meta read_meta;
+    irs::attribute_view read_attrs;
+    read_attrs.emplace(freq);
+    read_attrs.emplace(read_meta);
+    reader->decode(*in, field.features, read_attrs, read_meta);
+
+    const irs::flags doc_features{ irs::frequency::type() };
+    const irs::flags& pos_features = field.features;
+
+    // whole postings list, various batch sizes
+    for (const size_t size : { 1, 3, 127, 128, 129, 1000, 1001 }) {
+      for (auto* features : { &doc_features, &pos_features }) {
+        auto it = reader->iterator(field.features, read_attrs, *features);
+        std::vector<irs::doc_id_t> batch(size);
+        std::vector<uint32_t> freqs(size);
+        std::vector<irs::doc_id_t> actual;
+
+        for (size_t read; (read = it->next_batch(&batch[0], &freqs[0], size));) {
+          ASSERT_LE(read, size);
+          ASSERT_TRUE(batch[read - 1] == it->value() || irs::type_limits<irs::type_t::doc_id_t>::eof(it->value()));
+
+          ASSERT_TRUE(std::all_of(freqs.begin(), freqs.begin() + read,
+                                  [](uint32_t freq) { return 10 == freq; }));
+
+          actual.insert(actual.end(), batch.begin(), batch.begin() + read);
+        }
+
+        ASSERT_EQ(docs, actual);
+        ASSERT_FALSE(it->next());
+        ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->value()));
+      }
+    }
+
+    // batches interleaved with seeks and nexts, positions are consistent
+    {
+      auto it = reader->iterator(field.features, read_attrs, field.features);
+      postings expected(docs.begin(), docs.end(), field.features);
+      irs::doc_id_t batch[100];
+
+      ASSERT_TRUE(it->next());
+      ASSERT_TRUE(expected.next());
+      ASSERT_EQ(100, it->next_batch(batch, nullptr, 100));
+      ASSERT_EQ(docs[100], batch[99]);
+      ASSERT_EQ(docs[101], it->seek(docs[101]));
+      ASSERT_EQ(docs[101], expected.seek(docs[101]));
+      assert_positions(expected, *it);
+      ASSERT_EQ(100, it->next_batch(batch, nullptr, 100));
+      ASSERT_EQ(docs[102], batch[0]);
+      ASSERT_EQ(docs[201], batch[99]);
+      ASSERT_TRUE(it->next());
+      ASSERT_EQ(docs[202], expected.seek(docs[202]));
+      ASSERT_EQ(expected.value(), it->value());
+      assert_positions(expected, *it);
+      ASSERT_EQ(docs[700], it->seek(docs[700]));
+      ASSERT_EQ(100, it->next_batch(batch, nullptr, 100));
+      ASSERT_EQ(docs[800], batch[99]);
+      ASSERT_TRUE(it->next());
+      ASSERT_EQ(docs[801], expected.seek(docs[801]));
+      assert_positions(expected, *it);
+    }
+  }
 }; // format_10_test_case
 
 // ----------------------------------------------------------------------------
@@ -912,6 +1216,15 @@ TEST_F(memory_format_10_test_case, postings_seek) {
   postings_seek();
 }
 
+TEST_F(memory_format_10_test_case, postings_frequency_bound) {
+  postings_frequency_bound(1000); // 7 full blocks and a tail
+  postings_frequency_bound(20000); // long enough for a flat skip index
+}
+
+TEST_F(memory_format_10_test_case, postings_next_batch) {
+  postings_next_batch();
+}
+
 TEST_F(memory_format_10_test_case, segment_meta_rw) {
   segment_meta_read_write();
 }
@@ -964,6 +1277,416 @@ TEST_F(memory_format_10_test_case, document_mask_rw) {
   document_mask_read_write();
 }
 
+TEST_F(memory_format_10_test_case, document_mask_read_v0) {
+  irs::segment_meta meta("_1", nullptr);
+  meta.version = 42;
+
+  // document mask stored as a list of doc ids
+  {
+    auto writer = codec()->get_document_mask_writer();
+    auto out = dir().create(writer->filename(meta));
+    ASSERT_FALSE(!out);
+
+    irs::format_utils::write_header(*out, "iresearch_10_doc_mask", 0);
+    out->write_vint(4);
+    out->write_vint(7);
+    out->write_vint(1);
+    out->write_vint(3);
+    out->write_vint(2);
+    irs::format_utils::write_footer(*out);
+  }
+
+  auto reader = codec()->get_document_mask_reader();
+  irs::document_mask actual;
+  ASSERT_TRUE(reader->read(dir(), meta, actual));
+  ASSERT_EQ((irs::document_mask{ 1, 2, 3, 7 }), actual);
+}
+
+TEST_F(memory_format_10_test_case, fields_read_v0) {
+  // terms index with FSTs stored in OpenFST format
+  auto& format = dynamic_cast<const irs::version10::format&>(*codec());
+  fields_read_write(irs::field_writer::make<irs::burst_trie::field_writer>(
+    format.get_postings_writer(false),
+    false,
+    irs::burst_trie::field_writer::DEFAULT_MIN_BLOCK_SIZE,
+    irs::burst_trie::field_writer::DEFAULT_MAX_BLOCK_SIZE,
+    irs::burst_trie::field_writer::FORMAT_MIN
+  ));
+}
+
+TEST_F(memory_format_10_test_case, columns_shared_block_cache) {
+  irs::segment_meta segment("block_cache", nullptr);
+  segment.codec = codec();
+  irs::field_id id;
+  const irs::doc_id_t MAX_DOCS = 5000;
+
+  auto expected_value = [](irs::doc_id_t doc) {
+    return std::string(doc % 7 + 1, char('a' + doc % 26)) + std::to_string(doc);
+  };
+
+  // sparse column with variable length values, i.e. many blocks
+  {
+    auto writer = codec()->get_columnstore_writer();
+    writer->prepare(dir(), segment);
+
+    auto column = writer->push_column();
+    id = column.first;
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; doc += 2) {
+      irs::write_string(column.second(doc), expected_value(doc));
+      ++segment.docs_count;
+    }
+
+    ASSERT_TRUE(writer->commit());
+  }
+
+  const auto limit = irs::version10::column_cache::limit();
+  auto restore_limit = irs::make_finally([limit]() {
+    irs::version10::column_cache::limit(limit);
+  });
+
+  irs::version10::column_cache::clear();
+  ASSERT_EQ(0, irs::version10::column_cache::statistics().blocks);
+  ASSERT_EQ(0, irs::version10::column_cache::statistics().memory);
+
+  // waits until the cache contains at least 'count' blocks or a timeout,
+  // returns number of cached blocks
+  auto wait_blocks = [](size_t count) {
+    for (size_t i = 0; i < 500; ++i) {
+      const auto blocks = irs::version10::column_cache::statistics().blocks;
+
+      if (blocks >= count) {
+        return blocks;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return irs::version10::column_cache::statistics().blocks;
+  };
+
+  auto read_all = [&](const irs::columnstore_reader& reader) {
+    auto* column = reader.column(id);
+    ASSERT_NE(nullptr, column);
+    auto values = column->values_cursor();
+    irs::bytes_ref actual;
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; ++doc) {
+      ASSERT_EQ(bool(doc % 2), values(doc, actual));
+
+      if (doc % 2) {
+        ASSERT_EQ(expected_value(doc), irs::to_string<irs::string_ref>(actual.c_str()));
+      }
+    }
+  };
+
+  // blocks loaded by one values reader are reused by another one
+  // of the same columnstore reader, but not by another columnstore reader
+  {
+    const auto initial_misses = irs::version10::column_cache::statistics().misses;
+    auto reader0 = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader0->prepare(dir(), segment));
+    read_all(*reader0);
+
+    const auto stats = irs::version10::column_cache::statistics();
+    ASSERT_LT(1, stats.blocks);
+    ASSERT_LT(0, stats.memory);
+    ASSERT_EQ(stats.blocks, stats.misses - initial_misses);
+
+    read_all(*reader0);
+
+    const auto shared_stats = irs::version10::column_cache::statistics();
+    ASSERT_EQ(stats.misses, shared_stats.misses);
+    ASSERT_EQ(stats.blocks, shared_stats.blocks);
+    ASSERT_EQ(stats.hits + stats.blocks, shared_stats.hits);
+
+    auto reader1 = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader1->prepare(dir(), segment));
+    read_all(*reader1);
+
+    const auto own_stats = irs::version10::column_cache::statistics();
+    ASSERT_EQ(stats.misses + stats.blocks, own_stats.misses);
+    ASSERT_EQ(2*stats.blocks, own_stats.blocks);
+
+    // blocks of a destroyed reader are evicted
+    reader1.reset();
+    ASSERT_EQ(stats.blocks, irs::version10::column_cache::statistics().blocks);
+    ASSERT_EQ(stats.memory, irs::version10::column_cache::statistics().memory);
+    reader0.reset();
+    ASSERT_EQ(0, irs::version10::column_cache::statistics().blocks);
+    ASSERT_EQ(0, irs::version10::column_cache::statistics().memory);
+  }
+
+  // values of the current block are read without going to the cache,
+  // copies of a values cursor hold their own blocks
+  {
+    irs::version10::column_cache::clear();
+
+    auto reader = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), segment));
+    auto* column = reader->column(id);
+    ASSERT_NE(nullptr, column);
+
+    auto values = column->values_cursor();
+    irs::bytes_ref actual;
+    ASSERT_TRUE(values(1, actual));
+    const auto stats = irs::version10::column_cache::statistics();
+    ASSERT_TRUE(values(3, actual));
+    ASSERT_EQ(expected_value(3), irs::to_string<irs::string_ref>(actual.c_str()));
+    ASSERT_FALSE(values(4, actual));
+    ASSERT_EQ(stats.hits, irs::version10::column_cache::statistics().hits);
+    ASSERT_EQ(stats.misses, irs::version10::column_cache::statistics().misses);
+
+    auto copy = values;
+    irs::bytes_ref copy_actual;
+    ASSERT_TRUE(copy(1, copy_actual));
+    ASSERT_TRUE(values(MAX_DOCS - 1, actual)); // another block
+    ASSERT_EQ(expected_value(1), irs::to_string<irs::string_ref>(copy_actual.c_str()));
+    ASSERT_EQ(expected_value(MAX_DOCS - 1), irs::to_string<irs::string_ref>(actual.c_str()));
+  }
+
+  // values read via 'values()' remain valid for the lifetime of the column,
+  // even if the blocks don't fit into the cache, the reader may be shared
+  {
+    irs::version10::column_cache::limit(1);
+
+    auto reader = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), segment));
+    auto* column = reader->column(id);
+    ASSERT_NE(nullptr, column);
+
+    const auto values = column->values();
+    std::vector<irs::bytes_ref> actual(MAX_DOCS + 1);
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; doc += 2) {
+      ASSERT_TRUE(values(doc, actual[doc]));
+    }
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; doc += 2) {
+      ASSERT_EQ(expected_value(doc), irs::to_string<irs::string_ref>(actual[doc].c_str()));
+    }
+
+    std::atomic<size_t> mismatches{ 0 };
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < 4; ++i) {
+      threads.emplace_back([&values, &expected_value, &mismatches]() {
+        irs::bytes_ref value;
+
+        for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; doc += 2) {
+          if (!values(doc, value)
+              || expected_value(doc) != irs::to_string<irs::string_ref>(value.c_str())) {
+            ++mismatches;
+          }
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ASSERT_EQ(0, mismatches);
+    irs::version10::column_cache::limit(limit);
+  }
+
+  // prefetch
+  {
+    irs::version10::column_cache::clear();
+
+    auto reader = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), segment));
+    auto* column = reader->column(id);
+    ASSERT_NE(nullptr, column);
+
+    column->prefetch(1, 2); // loaded asynchronously
+    ASSERT_EQ(2, wait_blocks(2));
+    column->prefetch(MAX_DOCS + 1, 2); // nothing to prefetch
+    ASSERT_EQ(2, irs::version10::column_cache::statistics().blocks);
+
+    const auto stats = irs::version10::column_cache::statistics();
+    auto values = column->values_cursor();
+    irs::bytes_ref actual;
+    ASSERT_TRUE(values(1, actual));
+    ASSERT_EQ(expected_value(1), irs::to_string<irs::string_ref>(actual.c_str()));
+    ASSERT_EQ(stats.misses, irs::version10::column_cache::statistics().misses);
+    ASSERT_EQ(stats.hits + 1, irs::version10::column_cache::statistics().hits);
+  }
+
+  // sequential iteration loads the following blocks ahead
+  {
+    irs::version10::column_cache::clear();
+
+    auto reader = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), segment));
+    auto* column = reader->column(id);
+    ASSERT_NE(nullptr, column);
+
+    auto it = column->iterator();
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(1, it->value());
+    ASSERT_EQ(3, wait_blocks(3)); // current block and 2 following ones
+
+    // scheduled loads are finished before the reader is destroyed
+    ASSERT_TRUE(it->next());
+    it.reset();
+    reader.reset();
+    ASSERT_EQ(0, irs::version10::column_cache::statistics().blocks);
+  }
+
+  // memory limit, blocks in use survive eviction
+  {
+    irs::version10::column_cache::limit(1);
+    ASSERT_EQ(0, irs::version10::column_cache::statistics().blocks);
+    ASSERT_EQ(0, irs::version10::column_cache::statistics().memory);
+
+    auto reader = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), segment));
+    read_all(*reader);
+
+    auto* column = reader->column(id);
+    ASSERT_NE(nullptr, column);
+    auto it = column->iterator();
+    ASSERT_NE(nullptr, it);
+    auto& payload = it->attributes().get<irs::payload_iterator>();
+    ASSERT_FALSE(!payload);
+
+    irs::doc_id_t expected_doc = 1;
+    for (; it->next(); expected_doc += 2) {
+      ASSERT_EQ(expected_doc, it->value());
+      ASSERT_TRUE(payload->next());
+      ASSERT_EQ(expected_value(expected_doc), irs::to_string<irs::string_ref>(payload->value().c_str()));
+      irs::version10::column_cache::clear();
+    }
+    ASSERT_EQ(MAX_DOCS + 1, expected_doc);
+    ASSERT_EQ(0, irs::version10::column_cache::statistics().blocks);
+  }
+}
+
+TEST_F(memory_format_10_test_case, columns_codec) {
+  const irs::doc_id_t MAX_DOCS = 5000;
+
+  // many small similar values
+  auto expected_value = [](irs::doc_id_t doc) {
+    return "{ \"id\": " + std::to_string(doc)
+      + ", \"name\": \"" + std::string(doc % 7 + 1, char('a' + doc % 26))
+      + "\", \"tags\": [ \"tag" + std::to_string(doc % 13) + "\" ] }";
+  };
+
+  auto write_read = [&](irs::column_codec codec) {
+    irs::segment_meta segment(
+      "codec" + std::to_string(static_cast<int>(codec)), nullptr
+    );
+    segment.codec = this->codec();
+    irs::field_id sparse_id, dense_id;
+
+    {
+      auto writer = this->codec()->get_columnstore_writer();
+      writer->prepare(dir(), segment);
+
+      auto sparse = writer->push_column(codec);
+      sparse_id = sparse.first;
+      auto dense = writer->push_column(codec);
+      dense_id = dense.first;
+
+      for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; ++doc) {
+        if (doc % 2) {
+          irs::write_string(sparse.second(doc), expected_value(doc));
+        }
+
+        dense.second(doc).write_int(doc % 17);
+        ++segment.docs_count;
+      }
+
+      EXPECT_TRUE(writer->commit());
+    }
+
+    irs::version10::column_cache::clear(); // do not reuse blocks of other segments
+
+    auto reader = this->codec()->get_columnstore_reader();
+    EXPECT_TRUE(reader->prepare(dir(), segment));
+
+    auto* sparse = reader->column(sparse_id);
+    EXPECT_NE(nullptr, sparse);
+    EXPECT_EQ(codec, sparse->codec());
+    auto* dense = reader->column(dense_id);
+    EXPECT_NE(nullptr, dense);
+    EXPECT_EQ(codec, dense->codec());
+
+    auto sparse_values = sparse->values();
+    auto dense_values = dense->values();
+    irs::bytes_ref actual;
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; ++doc) {
+      EXPECT_EQ(bool(doc % 2), sparse_values(doc, actual));
+
+      if (doc % 2) {
+        EXPECT_EQ(expected_value(doc), irs::to_string<irs::string_ref>(actual.c_str()));
+      }
+
+      EXPECT_TRUE(dense_values(doc, actual));
+      irs::bytes_ref_input in(actual);
+      EXPECT_EQ(doc % 17, in.read_int());
+    }
+
+    // visit
+    irs::doc_id_t expected_doc = 1;
+    EXPECT_TRUE(sparse->visit([&](irs::doc_id_t doc, const irs::bytes_ref& value) {
+      EXPECT_EQ(expected_doc, doc);
+      EXPECT_EQ(expected_value(doc), irs::to_string<irs::string_ref>(value.c_str()));
+      expected_doc += 2;
+      return true;
+    }));
+    EXPECT_EQ(MAX_DOCS + 1, expected_doc);
+
+    uint64_t length;
+    EXPECT_TRUE(dir().length(length, segment.name + ".cs"));
+
+    return length;
+  };
+
+  const auto none = write_read(irs::column_codec::NONE);
+  const auto lz4 = write_read(irs::column_codec::LZ4);
+  const auto lz4hc = write_read(irs::column_codec::LZ4HC);
+  const auto lz4_dict = write_read(irs::column_codec::LZ4_DICT);
+  ASSERT_FALSE(HasFailure());
+
+  ASSERT_LT(lz4, none);
+  ASSERT_LT(lz4hc, lz4);
+  ASSERT_LT(lz4_dict, none); // smaller blocks, but still compressed
+
+  // columnstore written by a version preceding codecs
+  {
+    irs::segment_meta segment("codec_v1", nullptr);
+    segment.codec = codec();
+    segment.docs_count = 1;
+
+    {
+      auto out = dir().create(segment.name + ".cs");
+      ASSERT_FALSE(!out);
+
+      irs::format_utils::write_header(*out, "iresearch_10_columnstore", 1);
+      const auto index_offset = out->file_pointer();
+      out->write_vlong(1); // number of columns
+      out->write_vint(15); // column properties: dense column of dense mask blocks
+      out->write_vint(1); // total number of items
+      out->write_vint(1); // max column key
+      out->write_vint(0); // avg data block size
+      out->write_vint(0); // avg number of elements per block
+      out->write_vint(0); // total number of index blocks
+      out->write_byte(0); // no value bounds
+      out->write_long(index_offset);
+      irs::format_utils::write_footer(*out);
+    }
+
+    auto reader = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), segment));
+    auto* column = reader->column(0);
+    ASSERT_NE(nullptr, column);
+    ASSERT_EQ(irs::column_codec::LZ4, column->codec());
+  }
+}
+
 TEST_F(memory_format_10_test_case, reuse_postings_writer) {
   postings_writer_reuse();
 }
@@ -1002,6 +1725,11 @@ TEST_F(fs_format_10_test_case, postings_seek) {
   postings_seek();
 }
 
+TEST_F(fs_format_10_test_case, postings_frequency_bound) {
+  postings_frequency_bound(1000); // 7 full blocks and a tail
+  postings_frequency_bound(20000); // long enough for a flat skip index
+}
+
 TEST_F(fs_format_10_test_case, postings_rw) {
   postings_read_write();
   postings_read_write_single_doc();
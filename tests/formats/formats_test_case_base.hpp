@@ -504,7 +504,7 @@ class format_test_case_base : public index_test_base {
     }
   }
 
-  void fields_read_write() {
+  void fields_read_write(irs::field_writer::ptr writer = nullptr) {
     // create sorted && unsorted terms
     typedef std::set<irs::bytes_ref> sorted_terms_t;
     typedef std::vector<irs::bytes_ref> unsorted_terms_t;
@@ -540,7 +540,10 @@ class format_test_case_base : public index_test_base {
       // should use sorted terms on write
       terms<sorted_terms_t::iterator> terms(sorted_terms.begin(), sorted_terms.end());
 
-      auto writer = codec()->get_field_writer(false);
+      if (!writer) {
+        writer = codec()->get_field_writer(false);
+      }
+
       writer->prepare(state);
       writer->write(field.name, field.norm, field.features, terms);
       writer->end();
@@ -800,6 +803,45 @@ class format_test_case_base : public index_test_base {
         ASSERT_EQ(meta.size, read_meta.size);
         ASSERT_EQ(meta.files, read_meta.files);
         ASSERT_EQ(meta.column_store, read_meta.column_store);
+        ASSERT_TRUE(read_meta.sort.empty());
+      }
+    }
+
+    // read valid meta of a sorted segment
+    {
+      iresearch::segment_meta meta;
+      meta.name = "sorted_meta_name";
+      meta.docs_count = 453;
+      meta.live_docs_count = 453;
+      meta.size = 666;
+      meta.version = 100;
+      meta.sort = "sort_column";
+
+      meta.files.emplace("file1");
+      meta.files.emplace("index_file2");
+
+      std::string filename;
+
+      // write segment meta
+      {
+        auto writer = codec()->get_segment_meta_writer();
+        writer->write(dir(), filename, meta);
+      }
+
+      // read segment meta
+      {
+        irs::segment_meta read_meta;
+        read_meta.name = meta.name;
+        read_meta.version = 100;
+
+        auto reader = codec()->get_segment_meta_reader();
+        reader->read(dir(), read_meta);
+        ASSERT_EQ(meta.name, read_meta.name);
+        ASSERT_EQ(meta.docs_count, read_meta.docs_count);
+        ASSERT_EQ(meta.files, read_meta.files);
+        ASSERT_FALSE(read_meta.column_store);
+        ASSERT_EQ(meta.sort, read_meta.sort);
+        ASSERT_EQ(meta, read_meta);
       }
     }
 
@@ -838,7 +880,9 @@ class format_test_case_base : public index_test_base {
   }
 
   void document_mask_read_write() {
-    const std::unordered_set<iresearch::doc_id_t> mask_set = { 1, 4, 5, 7, 10, 12 };
+    irs::document_mask mask_set = { 1, 4, 5, 7, 10, 12 };
+    mask_set.insert_range(100, 70000); // long run of masked documents
+    mask_set.insert(70001);
     iresearch::segment_meta meta("_1", nullptr);
     meta.version = 42;
 
@@ -1213,6 +1213,49 @@ TEST_F(skip_reader_test, seek) {
   }
 }
 
+TEST_F(skip_reader_test, visit) {
+  size_t count = 1932;
+  size_t max_levels = 5;
+  size_t skip = 8;
+
+  irs::skip_writer writer(skip, skip);
+  irs::memory_directory dir;
+
+  // write skip number for level 0 and level number otherwise
+  {
+    size_t num = 0;
+    writer.prepare(
+      max_levels, count,
+      [&num](size_t level, irs::index_output& out) {
+        out.write_vint(uint32_t(level ? level : ++num));
+    });
+
+    for (size_t i = 1; i <= count; ++i) {
+      writer.skip(i);
+    }
+
+    auto out = dir.create("docs");
+    ASSERT_FALSE(!out);
+    writer.flush(*out);
+    out->write_vint(42); // data after a skip-list
+  }
+  ASSERT_LT(1, writer.num_levels());
+
+  auto in = dir.open("docs", irs::IOAdvice::NORMAL);
+  ASSERT_FALSE(!in);
+
+  std::vector<uint32_t> skips;
+  irs::skip_reader::visit(*in, [&skips](irs::index_input& in) {
+    skips.push_back(in.read_vint());
+  });
+
+  ASSERT_EQ(count / skip, skips.size());
+  for (size_t i = 0; i < skips.size(); ++i) {
+    ASSERT_EQ(i + 1, skips[i]);
+  }
+  ASSERT_EQ(42, in->read_vint());
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
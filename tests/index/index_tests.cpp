@@ -11355,6 +11355,40 @@ class tfidf : public Base {
 
 class memory_index_test 
   : public tests::cases::tfidf<tests::memory_test_case_base> {
+ protected:
+  // writes 'simple_sequential.json' into several segments, removes the
+  // document named 'C' and consolidates the segments into a single one,
+  // 'count' receives the number of written documents
+  void consolidate_sequential(
+      const irs::index_writer::init_options& options,
+      size_t& count) {
+    tests::json_doc_generator gen(
+      resource("simple_sequential.json"),
+      &tests::generic_json_field_factory
+    );
+
+    auto writer = open_writer(irs::OM_CREATE, options);
+    count = 0;
+
+    for (const tests::document* doc; (doc = gen.next()); ++count) {
+      ASSERT_TRUE(insert(*writer,
+        doc->indexed.begin(), doc->indexed.end(),
+        doc->stored.begin(), doc->stored.end()
+      ));
+
+      if (0 == count % 10) {
+        writer->commit(); // every commit adds a segment
+      }
+    }
+
+    auto query = irs::iql::query_builder().build("name==C", std::locale::classic());
+    writer->documents().remove(std::move(query.filter));
+    writer->commit();
+    ASSERT_LT(1, open_reader().size());
+
+    ASSERT_TRUE(writer->consolidate(irs::index_utils::consolidation_policy(irs::index_utils::consolidate_count())));
+    writer->commit();
+  }
 }; // memory_index_test
 
 TEST_F(memory_index_test, arango_demo_docs) {
@@ -11490,6 +11524,295 @@ TEST_F(memory_index_test, concurrent_add_mt) {
   }
 }
 
+TEST_F(memory_index_test, segment_mask_next_batch) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    &tests::generic_json_field_factory
+  );
+
+  {
+    auto writer = open_writer();
+    const tests::document* doc;
+
+    while ((doc = gen.next())) {
+      ASSERT_TRUE(insert(*writer,
+        doc->indexed.begin(), doc->indexed.end(),
+        doc->stored.begin(), doc->stored.end()
+      ));
+    }
+
+    writer->commit();
+
+    // leading run, a document in the middle and the last document
+    auto query = irs::iql::query_builder().build(
+      "name==A || name==B || name==F || name==G || name==%",
+      std::locale::classic()
+    );
+    writer->documents().remove(std::move(query.filter));
+    writer->commit();
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+  ASSERT_EQ(27, segment.live_docs_count());
+
+  auto postings = [&segment]() {
+    auto* terms = segment.field("same");
+    EXPECT_NE(nullptr, terms);
+    auto term = terms->iterator();
+    EXPECT_TRUE(term->next());
+    return segment.mask(term->postings(irs::flags{ irs::frequency::type() }));
+  };
+
+  std::vector<irs::doc_id_t> expected;
+  for (auto it = postings(); it->next();) {
+    expected.push_back(it->value());
+  }
+  ASSERT_EQ(27, expected.size());
+
+  for (size_t size = 1; size <= expected.size() + 1; ++size) {
+    auto it = postings();
+    std::vector<irs::doc_id_t> docs(size);
+    std::vector<uint32_t> freqs(size);
+    std::vector<irs::doc_id_t> actual;
+
+    for (size_t count; (count = it->next_batch(&docs[0], &freqs[0], size));) {
+      ASSERT_LE(count, size);
+      ASSERT_TRUE(docs[count - 1] == it->value() || irs::type_limits<irs::type_t::doc_id_t>::eof(it->value()));
+      ASSERT_TRUE(std::all_of(freqs.begin(), freqs.begin() + count,
+                              [](uint32_t freq) { return 1 == freq; }));
+      actual.insert(actual.end(), docs.begin(), docs.begin() + count);
+    }
+
+    ASSERT_EQ(expected, actual);
+    ASSERT_FALSE(it->next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->value()));
+  }
+
+  // batches interleaved with seeks
+  {
+    auto it = postings();
+    irs::doc_id_t docs[4];
+    auto count = it->next_batch(docs, nullptr, 4);
+    ASSERT_LT(0, count);
+    ASSERT_TRUE(std::equal(docs, docs + count, expected.begin()));
+    ASSERT_EQ(expected[10], it->seek(expected[10]));
+    count = it->next_batch(docs, nullptr, 4);
+    ASSERT_LT(0, count);
+    ASSERT_TRUE(std::equal(docs, docs + count, expected.begin() + 11));
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(expected[11 + count], it->value());
+  }
+}
+
+TEST_F(memory_index_test, consolidate_sorted) {
+  // order documents by 'name' descending
+  irs::index_writer::init_options options;
+  options.comparator = irs::merge_writer::comparer(
+    "name",
+    [](const irs::bytes_ref& lhs, const irs::bytes_ref& rhs) {
+      return irs::to_string<irs::string_ref>(rhs.c_str())
+        < irs::to_string<irs::string_ref>(lhs.c_str());
+  });
+
+  size_t count;
+  ASSERT_NO_FATAL_FAILURE(consolidate_sequential(options, count));
+
+  auto reader = open_reader();
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+  ASSERT_EQ(count - 1, segment.docs_count());
+  ASSERT_EQ(count - 1, segment.live_docs_count());
+  ASSERT_EQ("name", segment.sort_column()); // order is recorded in segment meta
+
+  auto* column = segment.column_reader("name");
+  ASSERT_NE(nullptr, column);
+  auto values = column->values();
+  irs::bytes_ref actual_value;
+  std::vector<std::string> names;
+
+  for (auto docs = segment.docs_iterator(); docs->next();) {
+    ASSERT_TRUE(values(docs->value(), actual_value));
+    names.emplace_back(irs::to_string<irs::string_ref>(actual_value.c_str()));
+  }
+
+  ASSERT_TRUE(std::is_sorted(names.rbegin(), names.rend()));
+  ASSERT_EQ(names.end(), std::find(names.begin(), names.end(), "C"));
+
+  // the first matched document is the greatest one
+  auto prepared = irs::iql::query_builder().build("same==xyz", std::locale::classic()).filter->prepare(reader);
+  auto docs = prepared->execute(segment);
+  ASSERT_TRUE(docs->next());
+  ASSERT_TRUE(values(docs->value(), actual_value));
+  ASSERT_EQ(names.front(), irs::to_string<irs::string_ref>(actual_value.c_str()));
+}
+
+TEST_F(memory_index_test, commit_sorted) {
+  // order documents by 'name' descending
+  irs::index_writer::init_options options;
+  options.comparator = irs::merge_writer::comparer(
+    "name",
+    [](const irs::bytes_ref& lhs, const irs::bytes_ref& rhs) {
+      return irs::to_string<irs::string_ref>(rhs.c_str())
+        < irs::to_string<irs::string_ref>(lhs.c_str());
+  });
+
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    &tests::generic_json_field_factory
+  );
+
+  auto writer = open_writer(irs::OM_CREATE, options);
+  size_t count = 0;
+
+  for (const tests::document* doc; (doc = gen.next()); ++count) {
+    ASSERT_TRUE(insert(*writer,
+      doc->indexed.begin(), doc->indexed.end(),
+      doc->stored.begin(), doc->stored.end()
+    ));
+
+    if (5 == count) {
+      // removal applies to the segment being flushed
+      auto query = irs::iql::query_builder().build("name==C", std::locale::classic());
+      writer->documents().remove(std::move(query.filter));
+    }
+
+    if (0 == count % 10) {
+      writer->commit();
+    }
+  }
+
+  writer->commit();
+
+  auto reader = open_reader();
+  ASSERT_LT(1, reader.size());
+  size_t docs_count = 0;
+
+  for (auto& segment : reader) {
+    // ordered copy of a flushed segment doesn't contain removed documents
+    ASSERT_EQ("name", segment.sort_column());
+    ASSERT_EQ(segment.docs_count(), segment.live_docs_count());
+    docs_count += segment.docs_count();
+
+    auto* column = segment.column_reader("name");
+    ASSERT_NE(nullptr, column);
+    auto values = column->values();
+    irs::bytes_ref actual_value;
+    std::vector<std::string> names;
+
+    for (auto docs = segment.docs_iterator(); docs->next();) {
+      ASSERT_TRUE(values(docs->value(), actual_value));
+      names.emplace_back(irs::to_string<irs::string_ref>(actual_value.c_str()));
+    }
+
+    ASSERT_TRUE(std::is_sorted(names.rbegin(), names.rend()));
+    ASSERT_EQ(names.end(), std::find(names.begin(), names.end(), "C"));
+
+    // postings follow the order of the column
+    auto prepared = irs::iql::query_builder().build("same==xyz", std::locale::classic()).filter->prepare(reader);
+    auto docs = prepared->execute(segment);
+    ASSERT_TRUE(docs->next());
+    ASSERT_TRUE(values(docs->value(), actual_value));
+    ASSERT_EQ(names.front(), irs::to_string<irs::string_ref>(actual_value.c_str()));
+  }
+
+  ASSERT_EQ(count - 1, docs_count);
+}
+
+TEST_F(memory_index_test, consolidate_parallel_merge) {
+  irs::index_writer::init_options options;
+  options.merge_threads = 4; // merge columns concurrently with each other and field term data
+
+  size_t count;
+  ASSERT_NO_FATAL_FAILURE(consolidate_sequential(options, count));
+
+  auto reader = open_reader();
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+  ASSERT_EQ(count - 1, segment.docs_count());
+  ASSERT_EQ(count - 1, segment.live_docs_count());
+
+  // every document is found by its name
+  auto* column = segment.column_reader("name");
+  ASSERT_NE(nullptr, column);
+  auto* field = segment.field("name");
+  ASSERT_NE(nullptr, field);
+  auto values = column->values();
+  irs::bytes_ref actual_value;
+  size_t found = 0;
+
+  for (auto docs = segment.docs_iterator(); docs->next(); ++found) {
+    ASSERT_TRUE(values(docs->value(), actual_value));
+    const auto name = irs::to_string<irs::string_ref>(actual_value.c_str());
+    ASSERT_NE("C", name);
+
+    auto terms = field->iterator();
+    ASSERT_TRUE(terms->seek(irs::ref_cast<irs::byte_type>(name)));
+    auto name_docs = terms->postings(irs::flags::empty_instance());
+    ASSERT_TRUE(name_docs->next());
+    ASSERT_EQ(docs->value(), name_docs->value());
+    ASSERT_FALSE(name_docs->next());
+  }
+
+  ASSERT_EQ(count - 1, found);
+}
+
+TEST_F(memory_index_test, concurrent_add_parallel_flush_mt) {
+  tests::json_doc_generator gen(resource("simple_sequential.json"), &tests::generic_json_field_factory);
+  std::vector<const tests::document*> docs;
+
+  for (const tests::document* doc; (doc = gen.next()) != nullptr; docs.emplace_back(doc)) {}
+
+  irs::index_writer::init_options options;
+  options.flush_threads = 4;
+  auto writer = open_writer(irs::OM_CREATE, options);
+  const size_t threads_count = 4;
+
+  // each thread holds its own documents context, i.e. its own segment
+  auto insert_all = [&writer, &docs, threads_count]()->void {
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < threads_count; ++i) {
+      threads.emplace_back([&writer, &docs, i, threads_count](){
+        auto ctx = writer->documents();
+
+        for (size_t j = i, count = docs.size(); j < count; j += threads_count) {
+          auto& doc = docs[j];
+          auto builder = ctx.insert();
+          ASSERT_TRUE(builder.insert(irs::action::index, doc->indexed.begin(), doc->indexed.end()));
+          ASSERT_TRUE(builder.insert(irs::action::store, doc->stored.begin(), doc->stored.end()));
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  insert_all();
+  writer->commit();
+
+  {
+    auto reader = iresearch::directory_reader::open(dir(), codec());
+    ASSERT_LE(1, reader.size());
+    ASSERT_GE(threads_count, reader.size());
+    ASSERT_EQ(docs.size(), reader.docs_count());
+    ASSERT_EQ(docs.size(), reader.live_docs_count());
+  }
+
+  // flush threads are reused by subsequent commits
+  insert_all();
+  writer->commit();
+
+  {
+    auto reader = iresearch::directory_reader::open(dir(), codec());
+    ASSERT_GE(2*threads_count, reader.size());
+    ASSERT_EQ(2*docs.size(), reader.docs_count());
+  }
+}
+
 TEST_F(memory_index_test, concurrent_add_remove_mt) {
   tests::json_doc_generator gen(
     resource("simple_sequential.json"),
@@ -20114,6 +20437,134 @@ TEST_F(memory_index_test, segment_consolidate_policy) {
   }
 }
 
+TEST_F(memory_index_test, documents_batch) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    [] (tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+    if (data.is_string()) {
+      doc.insert(std::make_shared<tests::templates::string_field>(
+        irs::string_ref(name),
+        data.str
+      ));
+    }
+  });
+
+  std::vector<const tests::document*> docs;
+  for (const tests::document* doc; (doc = gen.next());) {
+    docs.push_back(doc);
+  }
+  ASSERT_LT(10, docs.size());
+
+  auto insert_doc = [](irs::segment_writer::document& doc, const tests::document* src)->void {
+    doc.insert(irs::action::index, src->indexed.begin(), src->indexed.end());
+    doc.insert(irs::action::store, src->stored.begin(), src->stored.end());
+  };
+
+  auto read_names = [](const irs::sub_reader& segment)->std::vector<std::string> {
+    std::vector<std::string> names;
+    const auto* column = segment.column_reader("name");
+    EXPECT_NE(nullptr, column);
+    auto values = column->values();
+    irs::bytes_ref value;
+
+    for (auto it = segment.docs_iterator(); it->next();) {
+      EXPECT_TRUE(values(it->value(), value));
+      names.emplace_back(irs::to_string<irs::string_ref>(value.c_str()));
+    }
+
+    return names;
+  };
+
+  // batch is split across segments according to 'segment_docs_max'
+  {
+    irs::index_writer::segment_options options;
+    options.segment_docs_max = 10;
+
+    auto writer = open_writer();
+    writer->options(options);
+
+    ASSERT_EQ(docs.size(), writer->documents().insert(docs.begin(), docs.end(), insert_doc));
+    writer->commit();
+
+    auto reader = open_reader();
+    ASSERT_EQ((docs.size() + 9) / 10, reader.size());
+
+    std::vector<std::string> names;
+    for (auto& segment : reader) {
+      ASSERT_GE(10, segment.docs_count());
+      auto segment_names = read_names(segment);
+      names.insert(names.end(), segment_names.begin(), segment_names.end());
+    }
+
+    std::sort(names.begin(), names.end());
+    ASSERT_EQ(docs.size(), names.size());
+    ASSERT_EQ(names.end(), std::unique(names.begin(), names.end())); // every document exactly once
+  }
+
+  // failed insertion rolls back only the failed document
+  {
+    auto writer = open_writer(irs::OM_CREATE);
+    size_t count = 0;
+
+    {
+      auto ctx = writer->documents();
+      ASSERT_THROW(
+        ctx.insert(docs.begin(), docs.end(), [&insert_doc, &count](irs::segment_writer::document& doc, const tests::document* src)->void {
+          insert_doc(doc, src);
+
+          if (++count == 5) {
+            throw std::runtime_error("failed");
+          }
+        }),
+        std::runtime_error
+      );
+
+      // context remains usable
+      ASSERT_EQ(2, ctx.insert(docs.begin() + 5, docs.begin() + 7, insert_doc));
+    }
+
+    writer->commit();
+
+    auto reader = open_reader();
+    ASSERT_EQ(1, reader.size());
+    auto& segment = reader[0];
+    ASSERT_EQ(7, segment.docs_count());
+    ASSERT_EQ(6, segment.live_docs_count());
+
+    std::vector<std::string> expected{ "A", "B", "C", "D", "F", "G" };
+    ASSERT_EQ(expected, read_names(segment));
+  }
+
+  // documents inserted individually and in a batch share fields
+  {
+    auto writer = open_writer(irs::OM_CREATE);
+
+    {
+      auto ctx = writer->documents();
+      ASSERT_EQ(3, ctx.insert(docs.begin(), docs.begin() + 3, insert_doc));
+
+      {
+        auto doc = ctx.insert();
+        insert_doc(doc, docs[3]);
+        ASSERT_TRUE(doc);
+      }
+
+      ASSERT_EQ(0, ctx.insert(docs.begin(), docs.begin(), insert_doc)); // empty batch
+    }
+
+    writer->commit();
+
+    auto reader = open_reader();
+    ASSERT_EQ(1, reader.size());
+    std::vector<std::string> expected{ "A", "B", "C", "D" };
+    ASSERT_EQ(expected, read_names(reader[0]));
+
+    auto* field = reader[0].field("same");
+    ASSERT_NE(nullptr, field);
+    ASSERT_EQ(4, field->docs_count());
+  }
+}
+
 TEST_F(memory_index_test, segment_options) {
   tests::json_doc_generator gen(
     resource("simple_sequential.json"),
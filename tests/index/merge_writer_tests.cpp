@@ -68,11 +68,12 @@ namespace tests {
         auto& attrs = docs_itr->attributes();
 
         ASSERT_EQ(1, itr->second.erase(docs_itr->value()));
-        ASSERT_EQ(1 + (frequency ? 1 : 0) + (position ? 1 : 0), attrs.size());
+        ASSERT_EQ(1 + (frequency ? 2 : 0) + (position ? 1 : 0), attrs.size()); // frequency + frequency_bound
         ASSERT_TRUE(attrs.contains(iresearch::document::type()));
 
         if (frequency) {
           ASSERT_TRUE(attrs.contains(iresearch::frequency::type()));
+          ASSERT_TRUE(attrs.contains(iresearch::frequency_bound::type()));
           ASSERT_EQ(*frequency, attrs.get<iresearch::frequency>()->value);
         }
 
@@ -94,6 +95,35 @@ namespace tests {
 
     ASSERT_TRUE(expected_terms.empty());
   }
+
+  // writes 'simple_sequential_33.json' into 3 segments of 11 documents
+  // each and removes the document named 'C' from the first segment
+  void write_sequential_33(
+      irs::directory& dir,
+      const irs::format::ptr& codec) {
+    tests::json_doc_generator gen(
+      test_base::resource("simple_sequential_33.json"),
+      &tests::generic_json_field_factory
+    );
+    auto writer = irs::index_writer::make(dir, codec, irs::OM_CREATE);
+    size_t i = 0;
+
+    for (const tests::document* doc; (doc = gen.next()); ++i) {
+      ASSERT_TRUE(insert(
+        *writer,
+        doc->indexed.begin(), doc->indexed.end(),
+        doc->stored.begin(), doc->stored.end()
+      ));
+
+      if (0 == (i + 1) % 11) {
+        writer->commit(); // create segmentN
+      }
+    }
+
+    auto query = irs::iql::query_builder().build("name==C", std::locale::classic());
+    writer->documents().remove(std::move(query.filter));
+    writer->commit();
+  }
 }
 
 using namespace tests;
@@ -2227,6 +2257,510 @@ TEST_F(merge_writer_tests, test_merge_writer_add_segments) {
   }
 }
 
+TEST_F(merge_writer_tests, test_merge_writer_sorted) {
+  auto codec_ptr = irs::formats::get("1_0");
+  ASSERT_NE(nullptr, codec_ptr);
+  irs::memory_directory data_dir;
+
+  // populate directory, 3 segments with a removed document
+  ASSERT_NO_FATAL_FAILURE(write_sequential_33(data_dir, codec_ptr));
+
+  auto reader = irs::directory_reader::open(data_dir, codec_ptr);
+  ASSERT_EQ(3, reader.size());
+
+  // order by 'name' descending, raw values are prefixed by the same length
+  irs::merge_writer::comparer comparer(
+    "name",
+    [](const irs::bytes_ref& lhs, const irs::bytes_ref& rhs) {
+      return rhs < lhs;
+  });
+
+  irs::memory_directory dir;
+  irs::index_meta::index_segment_t index_segment;
+  irs::merge_writer writer(dir, &comparer);
+
+  for (auto& sub_reader: reader) {
+    writer.add(sub_reader);
+  }
+
+  index_segment.meta.codec = codec_ptr;
+  ASSERT_TRUE(writer.flush(index_segment));
+  ASSERT_EQ(32, index_segment.meta.docs_count);
+  ASSERT_EQ(32, index_segment.meta.live_docs_count);
+  ASSERT_EQ("name", index_segment.meta.sort); // order is recorded in segment meta
+
+  // removed documents are not mapped, the rest are mapped in order
+  {
+    std::vector<irs::doc_id_t> mapped;
+
+    for (size_t i = 0; i < reader.size(); ++i) {
+      for (auto docs = reader[i].docs_iterator(); docs->next();) {
+        mapped.push_back(writer[i].doc_map(docs->value()));
+      }
+    }
+
+    ASSERT_EQ(32, mapped.size());
+    std::sort(mapped.begin(), mapped.end());
+
+    for (size_t i = 0; i < mapped.size(); ++i) {
+      ASSERT_EQ(irs::type_limits<irs::type_t::doc_id_t>::min() + i, mapped[i]);
+    }
+  }
+
+  auto segment = irs::segment_reader::open(dir, index_segment.meta);
+  ASSERT_EQ(32, segment.docs_count());
+
+  // stored values follow the order
+  std::vector<std::string> names;
+  {
+    auto* column = segment.column_reader("name");
+    ASSERT_NE(nullptr, column);
+    auto values = column->values();
+    irs::bytes_ref actual_value;
+
+    for (auto docs = segment.docs_iterator(); docs->next();) {
+      ASSERT_TRUE(values(docs->value(), actual_value));
+      names.emplace_back(irs::to_string<irs::string_ref>(actual_value.c_str()));
+    }
+
+    ASSERT_EQ(32, names.size());
+    ASSERT_TRUE(std::is_sorted(names.rbegin(), names.rend()));
+    ASSERT_EQ(names.end(), std::find(names.begin(), names.end(), "C"));
+  }
+
+  // postings are remapped accordingly
+  {
+    auto* terms = segment.field("name");
+    ASSERT_NE(nullptr, terms);
+
+    for (auto term = terms->iterator(); term->next();) {
+      auto docs = term->postings(irs::flags::empty_instance());
+      ASSERT_TRUE(docs->next());
+      ASSERT_EQ(names[docs->value() - irs::type_limits<irs::type_t::doc_id_t>::min()],
+                irs::ref_cast<char>(term->value()));
+      ASSERT_FALSE(docs->next());
+    }
+
+    auto* same = segment.field("same");
+    ASSERT_NE(nullptr, same);
+    ASSERT_EQ(32, same->docs_count());
+    auto term = same->iterator();
+    ASSERT_TRUE(term->next());
+    auto docs = term->postings(same->meta().features);
+    auto& freq = docs->attributes().get<irs::frequency>();
+    auto& pos = docs->attributes().get<irs::position>();
+    irs::doc_id_t expected_doc = irs::type_limits<irs::type_t::doc_id_t>::min();
+
+    for (; docs->next(); ++expected_doc) {
+      ASSERT_EQ(expected_doc, docs->value());
+
+      if (freq) {
+        ASSERT_EQ(1, freq->value);
+      }
+
+      if (pos) {
+        ASSERT_TRUE(pos->next());
+        ASSERT_FALSE(pos->next());
+      }
+    }
+
+    ASSERT_EQ(irs::type_limits<irs::type_t::doc_id_t>::min() + 32, expected_doc);
+
+    // documents having 'duplicated' == 'abcd' are the same as before the merge
+    auto* duplicated = segment.field("duplicated");
+    ASSERT_NE(nullptr, duplicated);
+    std::set<std::string> actual;
+    auto dup_term = duplicated->iterator();
+    ASSERT_TRUE(dup_term->seek(irs::ref_cast<irs::byte_type>(irs::string_ref("abcd"))));
+
+    for (auto dup_docs = dup_term->postings(irs::flags::empty_instance()); dup_docs->next();) {
+      actual.emplace(names[dup_docs->value() - irs::type_limits<irs::type_t::doc_id_t>::min()]);
+    }
+
+    std::set<std::string> expected;
+    for (size_t i = 0; i < reader.size(); ++i) {
+      auto* field = reader[i].field("duplicated");
+      auto* column = reader[i].column_reader("name");
+      ASSERT_NE(nullptr, column);
+      auto values = column->values();
+      irs::bytes_ref value;
+      auto it = field->iterator();
+
+      if (!it->seek(irs::ref_cast<irs::byte_type>(irs::string_ref("abcd")))) {
+        continue;
+      }
+
+      for (auto it_docs = reader[i].mask(it->postings(irs::flags::empty_instance())); it_docs->next();) {
+        ASSERT_TRUE(values(it_docs->value(), value));
+        expected.emplace(irs::to_string<std::string>(value.c_str()));
+      }
+    }
+
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected, actual);
+  }
+}
+
+TEST_F(merge_writer_tests, test_merge_writer_bulk) {
+  auto codec_ptr = irs::formats::get("1_0");
+  ASSERT_NE(nullptr, codec_ptr);
+  irs::memory_directory data_dir;
+
+  // populate directory, 3 segments, only the first one has a removed document
+  ASSERT_NO_FATAL_FAILURE(write_sequential_33(data_dir, codec_ptr));
+
+  auto reader = irs::directory_reader::open(data_dir, codec_ptr);
+  ASSERT_EQ(3, reader.size());
+  ASSERT_EQ(10, reader[0].live_docs_count());
+  ASSERT_EQ(11, reader[1].live_docs_count());
+  ASSERT_EQ(11, reader[2].live_docs_count());
+
+  // live values in order of the readers
+  std::vector<std::string> expected_names;
+
+  for (auto& sub_reader: reader) {
+    auto* column = sub_reader.column_reader("name");
+    ASSERT_NE(nullptr, column);
+    auto values = column->values();
+    irs::bytes_ref value;
+
+    for (auto docs = sub_reader.docs_iterator(); docs->next();) {
+      ASSERT_TRUE(values(docs->value(), value));
+      expected_names.emplace_back(irs::to_string<irs::string_ref>(value.c_str()));
+    }
+  }
+
+  ASSERT_EQ(32, expected_names.size());
+
+  // readers without removals are shifted by a constant
+  irs::memory_directory dir;
+  irs::index_meta::index_segment_t index_segment;
+  irs::merge_writer writer(dir);
+
+  for (auto& sub_reader: reader) {
+    writer.add(sub_reader);
+  }
+
+  index_segment.meta.codec = codec_ptr;
+  ASSERT_TRUE(writer.flush(index_segment));
+  ASSERT_EQ(32, index_segment.meta.docs_count);
+  ASSERT_EQ(32, index_segment.meta.live_docs_count);
+  ASSERT_EQ(irs::type_limits<irs::type_t::doc_id_t>::min() + 10, writer[1].doc_map(irs::type_limits<irs::type_t::doc_id_t>::min()));
+  ASSERT_EQ(irs::type_limits<irs::type_t::doc_id_t>::min() + 21, writer[2].doc_map(irs::type_limits<irs::type_t::doc_id_t>::min()));
+
+  auto segment = irs::segment_reader::open(dir, index_segment.meta);
+  ASSERT_EQ(32, segment.docs_count());
+
+  // stored values
+  std::vector<std::string> names;
+  {
+    auto* column = segment.column_reader("name");
+    ASSERT_NE(nullptr, column);
+    auto values = column->values();
+    irs::bytes_ref actual_value;
+
+    for (auto docs = segment.docs_iterator(); docs->next();) {
+      ASSERT_TRUE(values(docs->value(), actual_value));
+      names.emplace_back(irs::to_string<irs::string_ref>(actual_value.c_str()));
+    }
+  }
+
+  ASSERT_EQ(expected_names, names);
+
+  // postings
+  {
+    auto* terms = segment.field("name");
+    ASSERT_NE(nullptr, terms);
+    size_t count = 0;
+
+    for (auto term = terms->iterator(); term->next(); ++count) {
+      auto docs = term->postings(irs::flags::empty_instance());
+      ASSERT_TRUE(docs->next());
+      ASSERT_EQ(names[docs->value() - irs::type_limits<irs::type_t::doc_id_t>::min()],
+                irs::ref_cast<char>(term->value()));
+      ASSERT_FALSE(docs->next());
+    }
+
+    ASSERT_EQ(32, count);
+
+    auto* same = segment.field("same");
+    ASSERT_NE(nullptr, same);
+    auto term = same->iterator();
+    ASSERT_TRUE(term->next());
+    auto docs = term->postings(same->meta().features);
+    auto& pos = docs->attributes().get<irs::position>();
+    irs::doc_id_t expected_doc = irs::type_limits<irs::type_t::doc_id_t>::min();
+
+    for (; docs->next(); ++expected_doc) {
+      ASSERT_EQ(expected_doc, docs->value());
+
+      if (pos) {
+        ASSERT_TRUE(pos->next());
+        ASSERT_FALSE(pos->next());
+      }
+    }
+
+    ASSERT_EQ(irs::type_limits<irs::type_t::doc_id_t>::min() + 32, expected_doc);
+  }
+}
+
+TEST_F(merge_writer_tests, test_merge_writer_columns_codec) {
+  // stored field optionally declaring compression of its column
+  struct stored_field {
+    const irs::string_ref& name() const { return name_; }
+
+    bool write(irs::data_output& out) const {
+      irs::write_string(out, value_);
+      return true;
+    }
+
+    irs::string_ref name_;
+    std::string value_;
+  };
+
+  struct codec_field : stored_field {
+    irs::column_codec column_codec() const { return codec_; }
+
+    irs::column_codec codec_;
+  };
+
+  auto codec_ptr = irs::formats::get("1_0");
+  ASSERT_NE(nullptr, codec_ptr);
+  irs::memory_directory data_dir;
+
+  const std::pair<irs::string_ref, irs::column_codec> columns[] {
+    { "none", irs::column_codec::NONE },
+    { "lz4hc", irs::column_codec::LZ4HC },
+    { "lz4_dict", irs::column_codec::LZ4_DICT },
+  };
+
+  auto value = [](size_t i) {
+    return "{ \"id\": " + std::to_string(i) + ", \"type\": \"document\" }";
+  };
+
+  // populate directory, 2 segments
+  {
+    auto writer = irs::index_writer::make(data_dir, codec_ptr, irs::OM_CREATE);
+
+    for (size_t i = 0; i < 200; ++i) {
+      {
+        auto ctx = writer->documents();
+        auto doc = ctx.insert();
+
+        for (auto& column : columns) {
+          codec_field field;
+          field.name_ = column.first;
+          field.codec_ = column.second;
+          field.value_ = value(i);
+          ASSERT_TRUE(doc.insert(irs::action::store, field));
+        }
+
+        stored_field field;
+        field.name_ = "lz4";
+        field.value_ = value(i);
+        ASSERT_TRUE(doc.insert(irs::action::store, field));
+      }
+
+      if (99 == i) {
+        writer->commit(); // create segment0
+      }
+    }
+
+    writer->commit(); // create segment1
+  }
+
+  auto assert_columns = [&](const irs::sub_reader& segment, size_t base) {
+    for (auto& column : columns) {
+      auto* reader = segment.column_reader(column.first);
+      ASSERT_NE(nullptr, reader);
+      ASSERT_EQ(column.second, reader->codec());
+
+      auto values = reader->values();
+      irs::bytes_ref actual;
+
+      for (irs::doc_id_t doc = 1; doc <= segment.docs_count(); ++doc) {
+        ASSERT_TRUE(values(doc, actual));
+        ASSERT_EQ(value(base + doc - 1), irs::to_string<irs::string_ref>(actual.c_str()));
+      }
+    }
+
+    auto* reader = segment.column_reader("lz4");
+    ASSERT_NE(nullptr, reader);
+    ASSERT_EQ(irs::column_codec::LZ4, reader->codec());
+  };
+
+  auto reader = irs::directory_reader::open(data_dir, codec_ptr);
+  ASSERT_EQ(2, reader.size());
+  assert_columns(reader[0], 0);
+  assert_columns(reader[1], 100);
+
+  // merged columns retain codecs
+  irs::memory_directory dir;
+  irs::index_meta::index_segment_t index_segment;
+  irs::merge_writer writer(dir);
+
+  for (auto& sub_reader: reader) {
+    writer.add(sub_reader);
+  }
+
+  index_segment.meta.codec = codec_ptr;
+  ASSERT_TRUE(writer.flush(index_segment));
+  ASSERT_EQ(200, index_segment.meta.docs_count);
+
+  auto segment = irs::segment_reader::open(dir, index_segment.meta);
+  assert_columns(segment, 0);
+}
+
+TEST_F(merge_writer_tests, test_merge_writer_parallel) {
+  auto codec_ptr = irs::formats::get("1_0");
+  ASSERT_NE(nullptr, codec_ptr);
+  irs::memory_directory data_dir;
+
+  // populate directory, 3 segments with a removed document
+  ASSERT_NO_FATAL_FAILURE(write_sequential_33(data_dir, codec_ptr));
+
+  auto reader = irs::directory_reader::open(data_dir, codec_ptr);
+  ASSERT_EQ(3, reader.size());
+
+  // merge the same readers sequentially and concurrently
+  irs::memory_directory expected_dir;
+  irs::index_meta::index_segment_t expected_segment;
+  {
+    irs::merge_writer writer(expected_dir);
+
+    for (auto& sub_reader: reader) {
+      writer.add(sub_reader);
+    }
+
+    expected_segment.meta.codec = codec_ptr;
+    ASSERT_TRUE(writer.flush(expected_segment));
+  }
+
+  irs::async_utils::thread_pool pool(4, 4); // columns are spread over the pool
+  irs::memory_directory dir;
+  irs::index_meta::index_segment_t index_segment;
+  {
+    irs::merge_writer writer(dir);
+
+    for (auto& sub_reader: reader) {
+      writer.add(sub_reader);
+    }
+
+    std::atomic<size_t> calls(0);
+    index_segment.meta.codec = codec_ptr;
+    ASSERT_TRUE(writer.flush(
+      index_segment, [&calls]()->bool { ++calls; return true; }, &pool
+    ));
+    ASSERT_LT(0, calls.load());
+  }
+
+  ASSERT_EQ(32, index_segment.meta.docs_count);
+  ASSERT_EQ(32, index_segment.meta.live_docs_count);
+  ASSERT_EQ(expected_segment.meta.files.size(), index_segment.meta.files.size());
+
+  for (auto& file: index_segment.meta.files) {
+    bool exists;
+    ASSERT_TRUE(dir.exists(exists, file) && exists);
+  }
+
+  auto expected = irs::segment_reader::open(expected_dir, expected_segment.meta);
+  auto segment = irs::segment_reader::open(dir, index_segment.meta);
+  ASSERT_EQ(expected.docs_count(), segment.docs_count());
+
+  // stored values of every column
+  {
+    auto expected_columns = expected.columns();
+    auto columns = segment.columns();
+    size_t count = 0;
+
+    while (expected_columns->next()) {
+      ASSERT_TRUE(columns->next());
+      auto& expected_meta = expected_columns->value();
+      ASSERT_EQ(expected_meta.name, columns->value().name);
+      auto* expected_column = expected.column_reader(expected_meta.id);
+      ASSERT_NE(nullptr, expected_column);
+      auto* column = segment.column_reader(columns->value().id);
+      ASSERT_NE(nullptr, column);
+      ASSERT_EQ(expected_column->size(), column->size());
+      auto expected_values = expected_column->values();
+      auto values = column->values();
+      irs::bytes_ref expected_value;
+      irs::bytes_ref actual_value;
+
+      for (auto docs = segment.docs_iterator(); docs->next();) {
+        const bool has_value = expected_values(docs->value(), expected_value);
+        ASSERT_EQ(has_value, values(docs->value(), actual_value));
+
+        if (has_value) {
+          ASSERT_EQ(expected_value, actual_value);
+        }
+      }
+
+      ++count;
+    }
+
+    ASSERT_FALSE(columns->next());
+    ASSERT_LT(1, count); // several columns are merged concurrently
+  }
+
+  // field term data and norms
+  {
+    auto expected_fields = expected.fields();
+    auto fields = segment.fields();
+
+    while (expected_fields->next()) {
+      ASSERT_TRUE(fields->next());
+      auto& expected_field = expected_fields->value();
+      auto& field = fields->value();
+      ASSERT_EQ(expected_field.meta().name, field.meta().name);
+      ASSERT_EQ(expected_field.docs_count(), field.docs_count());
+      ASSERT_EQ(expected_field.size(), field.size());
+      ASSERT_EQ(
+        irs::type_limits<irs::type_t::field_id_t>::valid(expected_field.meta().norm),
+        irs::type_limits<irs::type_t::field_id_t>::valid(field.meta().norm)
+      );
+
+      auto expected_terms = expected_field.iterator();
+      auto terms = field.iterator();
+
+      while (expected_terms->next()) {
+        ASSERT_TRUE(terms->next());
+        ASSERT_EQ(expected_terms->value(), terms->value());
+        auto expected_docs = expected_terms->postings(irs::flags::empty_instance());
+        auto docs = terms->postings(irs::flags::empty_instance());
+
+        while (expected_docs->next()) {
+          ASSERT_TRUE(docs->next());
+          ASSERT_EQ(expected_docs->value(), docs->value());
+        }
+
+        ASSERT_FALSE(docs->next());
+      }
+
+      ASSERT_FALSE(terms->next());
+    }
+
+    ASSERT_FALSE(fields->next());
+  }
+
+  // termination requested by progress
+  {
+    irs::memory_directory abort_dir;
+    irs::index_meta::index_segment_t abort_segment;
+    irs::merge_writer writer(abort_dir);
+
+    for (auto& sub_reader: reader) {
+      writer.add(sub_reader);
+    }
+
+    abort_segment.meta.codec = codec_ptr;
+    ASSERT_FALSE(writer.flush(
+      abort_segment, []()->bool { return false; }, &pool
+    ));
+    ASSERT_TRUE(abort_segment.meta.files.empty());
+  }
+}
+
 TEST_F(merge_writer_tests, test_merge_writer_flush_progress) {
   auto codec_ptr = irs::formats::get("1_0");
   ASSERT_NE(nullptr, codec_ptr);
@@ -141,6 +141,67 @@ TEST(postings_tests, clear) {
   ASSERT_EQ(0, bh.size());
 }
 
+TEST(postings_tests, rehash) {
+  const uint32_t block_size = 32768;
+  block_pool<byte_type, block_size> pool;
+  block_pool<byte_type, block_size>::inserter writer(pool.begin());
+  postings bh(writer);
+  std::vector<std::string> terms;
+
+  // enough terms to grow the table several times
+  for (size_t i = 0; i < 10000; ++i) {
+    terms.emplace_back(std::to_string(i));
+    auto res = bh.emplace(tests::detail::to_bytes_ref(terms.back()));
+    ASSERT_TRUE(res.second);
+    ASSERT_NE(bh.end(), res.first);
+    res.first->second.doc = irs::doc_id_t(i);
+  }
+
+  ASSERT_EQ(terms.size(), bh.size());
+
+  // entries are kept in insertion order with their postings
+  {
+    size_t i = 0;
+
+    for (auto& entry : bh) {
+      ASSERT_EQ(tests::detail::to_bytes_ref(terms[i]), entry.first);
+      ASSERT_EQ(irs::doc_id_t(i), entry.second.doc);
+      ++i;
+    }
+
+    ASSERT_EQ(terms.size(), i);
+  }
+
+  // every term is found after growth
+  for (size_t i = 0; i < terms.size(); ++i) {
+    auto res = bh.emplace(tests::detail::to_bytes_ref(terms[i]));
+    ASSERT_FALSE(res.second);
+    ASSERT_NE(bh.end(), res.first);
+    ASSERT_EQ(irs::doc_id_t(i), res.first->second.doc);
+  }
+
+  ASSERT_EQ(terms.size(), bh.size());
+
+  // memory of the grown table is accounted
+  const auto grown_active = bh.memory_active();
+  const auto grown_reserved = bh.memory_reserved();
+  ASSERT_LE(terms.size()*sizeof(postings::value_type), grown_active);
+  ASSERT_LE(grown_active, grown_reserved);
+
+  // grown table is shrunk on clear and is reusable afterwards
+  bh.clear();
+  ASSERT_TRUE(bh.empty());
+  ASSERT_GT(grown_active, bh.memory_active());
+  ASSERT_GT(grown_reserved, bh.memory_reserved());
+
+  for (size_t i = 0; i < 100; ++i) {
+    auto res = bh.emplace(tests::detail::to_bytes_ref(terms[i]));
+    ASSERT_TRUE(res.second);
+  }
+
+  ASSERT_EQ(100, bh.size());
+}
+
 TEST(postings_tests, slice_alignment) {
   const uint32_t block_size = 32768;
   block_pool<byte_type, block_size> pool;
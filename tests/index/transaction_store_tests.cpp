@@ -5707,6 +5707,121 @@ TEST_F(transaction_store_tests, read_reopen) {
   }
 }
 
+TEST_F(transaction_store_tests, read_reopen_incremental) {
+  irs::transaction_store store;
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"), &tests::generic_json_field_factory
+  );
+  tests::document const* doc1 = gen.next();
+  tests::document const* doc2 = gen.next();
+  tests::document const* doc3 = gen.next();
+  auto inserter = [](tests::document const* src) {
+    return [src](irs::store_writer::document& doc)->bool {
+      doc.insert(irs::action::index, src->indexed.begin(), src->indexed.end());
+      doc.insert(irs::action::store, src->stored.begin(), src->stored.end());
+      return false;
+    };
+  };
+  auto docs_count = [](const irs::term_reader* field, const irs::bytes_ref& term)->size_t {
+    auto terms = field->iterator();
+    if (!terms->seek(term)) {
+      return 0;
+    }
+    size_t count = 0;
+    for (auto docs = terms->postings(irs::flags::empty_instance()); docs->next();) {
+      ++count;
+    }
+    return count;
+  };
+
+  // write 1st generation (doc1 has a 'prefix' field, doc2 does not)
+  {
+    irs::store_writer writer(store);
+    ASSERT_TRUE(writer.insert(inserter(doc1)));
+    ASSERT_TRUE(writer.insert(inserter(doc2)));
+    ASSERT_TRUE(writer.commit());
+  }
+
+  auto reader = store.reader();
+  ASSERT_EQ(1, reader.size());
+  ASSERT_EQ(2, reader.live_docs_count());
+  auto& segment = *(reader.begin());
+  ASSERT_NE(nullptr, segment.field("prefix"));
+  ASSERT_NE(nullptr, segment.column_reader("prefix"));
+
+  // write 2nd generation, doc3 does not touch 'prefix'
+  {
+    irs::store_writer writer(store);
+    ASSERT_TRUE(writer.insert(inserter(doc3)));
+    ASSERT_TRUE(writer.commit());
+  }
+
+  auto reader1 = reader.reopen();
+  ASSERT_EQ(3, reader1.live_docs_count());
+  ASSERT_EQ(4, reader1.docs_count()); // +1 for invalid doc
+  {
+    auto& segment1 = *(reader1.begin());
+    ASSERT_NE(&segment, &segment1);
+
+    // untouched state is shared with the previous reader
+    ASSERT_EQ(segment.field("prefix"), segment1.field("prefix"));
+    ASSERT_EQ(segment.column_reader("prefix"), segment1.column_reader("prefix"));
+
+    // modified state is rebuilt
+    ASSERT_NE(segment.field("same"), segment1.field("same"));
+    ASSERT_EQ(3, segment1.field("same")->docs_count());
+    ASSERT_EQ(3, docs_count(segment1.field("same"), irs::ref_cast<irs::byte_type>(irs::string_ref("xyz"))));
+    ASSERT_EQ(2, segment.field("same")->docs_count()); // previous reader is unaffected
+    ASSERT_EQ(2, docs_count(segment.field("same"), irs::ref_cast<irs::byte_type>(irs::string_ref("xyz"))));
+    ASSERT_EQ(2, docs_count(segment1.field("duplicated"), irs::ref_cast<irs::byte_type>(irs::string_ref("vczc"))));
+  }
+
+  // write 3rd generation, remove doc2
+  {
+    auto query_doc2 = irs::iql::query_builder().build("name==B", std::locale::classic());
+    irs::store_writer writer(store);
+    writer.remove(*query_doc2.filter);
+    ASSERT_TRUE(writer.commit());
+  }
+
+  auto reader2 = reader1.reopen();
+  ASSERT_EQ(2, reader2.live_docs_count());
+  {
+    auto& segment1 = *(reader1.begin());
+    auto& segment2 = *(reader2.begin());
+    ASSERT_EQ(segment1.field("prefix"), segment2.field("prefix"));
+    ASSERT_EQ(2, segment2.field("same")->docs_count());
+    ASSERT_EQ(2, docs_count(segment2.field("same"), irs::ref_cast<irs::byte_type>(irs::string_ref("xyz"))));
+    ASSERT_EQ(1, docs_count(segment2.field("duplicated"), irs::ref_cast<irs::byte_type>(irs::string_ref("vczc"))));
+    ASSERT_EQ(0, docs_count(segment2.field("name"), irs::ref_cast<irs::byte_type>(irs::string_ref("B"))));
+  }
+
+  // flush and cleanup invalidate reusable state
+  {
+    auto flushed = store.flush();
+    ASSERT_TRUE(flushed);
+    store.cleanup();
+  }
+
+  auto reader3 = reader2.reopen();
+  ASSERT_EQ(0, reader3.live_docs_count());
+
+  {
+    irs::store_writer writer(store);
+    ASSERT_TRUE(writer.insert(inserter(doc2)));
+    ASSERT_TRUE(writer.commit());
+  }
+
+  auto reader4 = reader3.reopen();
+  ASSERT_EQ(1, reader4.live_docs_count());
+  {
+    auto& segment4 = *(reader4.begin());
+    ASSERT_EQ(nullptr, segment4.field("prefix"));
+    ASSERT_EQ(1, docs_count(segment4.field("same"), irs::ref_cast<irs::byte_type>(irs::string_ref("xyz"))));
+    ASSERT_EQ(1, docs_count(segment4.field("name"), irs::ref_cast<irs::byte_type>(irs::string_ref("B"))));
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
\ No newline at end of file
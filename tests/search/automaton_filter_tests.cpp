@@ -0,0 +1,354 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "store/memory_directory.hpp"
+#include "formats/formats_10.hpp"
+#include "search/automaton_filter.hpp"
+#include "search/levenshtein_filter.hpp"
+#include "search/prefix_filter.hpp"
+#include "search/regexp_filter.hpp"
+#include "search/wildcard_filter.hpp"
+
+#include <functional>
+#include <set>
+
+NS_BEGIN(tests)
+
+class automaton_filter_test_case : public filter_test_case_base {
+ protected:
+  static const size_t SEGMENTS = 2;
+
+  // every document of every segment contains a single 'name' term, the term
+  // of a document 'i' is the 'i'th word over "abcd" of length at most 5
+  void index_words() {
+    std::set<std::string> words{ "" };
+    std::set<std::string> last{ "" };
+
+    for (size_t i = 0; i < 5; ++i) {
+      std::set<std::string> next;
+      for (auto& prefix : last) {
+        for (auto c : std::string("abcd")) {
+          next.insert(prefix + c);
+        }
+      }
+      words.insert(next.begin(), next.end());
+      last = std::move(next);
+    }
+
+    words.erase("");
+    words_.assign(words.begin(), words.end());
+    words_.push_back("\xD0\x96" "ab"); // multi-byte character
+
+    auto writer = open_writer();
+
+    for (size_t segment = 0; segment < SEGMENTS; ++segment) {
+      {
+        auto ctx = writer->documents();
+        templates::string_field name("name");
+
+        for (auto& word : words_) {
+          name.value(word);
+          auto doc = ctx.insert();
+          ASSERT_TRUE(doc.insert(irs::action::index, name));
+        }
+      }
+
+      writer->commit();
+    }
+  }
+
+  // returns ids of documents with terms satisfying the specified predicate
+  docs_t expected(const std::function<bool(const std::string&)>& pred) const {
+    docs_t docs;
+
+    for (size_t segment = 0; segment < SEGMENTS; ++segment) {
+      for (size_t i = 0; i < words_.size(); ++i) {
+        if (pred(words_[i])) {
+          docs.push_back(irs::doc_id_t(i + 1));
+        }
+      }
+    }
+
+    return docs;
+  }
+
+  // checks unscored results and that scored ones are the same set of documents
+  void check(const irs::filter& filter, const docs_t& expected, const irs::index_reader& rdr) {
+    check_query(filter, expected, rdr);
+
+    irs::order order;
+    order.add<sort::boost>(false);
+    auto prepared_order = order.prepare();
+    auto prepared = filter.prepare(rdr, prepared_order);
+    docs_t actual;
+
+    for (auto& segment : rdr) {
+      auto it = prepared->execute(segment, prepared_order);
+      while (it->next()) {
+        actual.push_back(it->value());
+      }
+    }
+
+    ASSERT_EQ(expected, actual);
+  }
+
+  std::vector<std::string> words_;
+}; // automaton_filter_test_case
+
+NS_END // tests
+
+// ----------------------------------------------------------------------------
+// --SECTION--                           memory_directory + iresearch_format_10
+// ----------------------------------------------------------------------------
+
+class memory_automaton_filter_test_case : public tests::automaton_filter_test_case {
+ protected:
+  virtual irs::directory* get_directory() override {
+    return new irs::memory_directory();
+  }
+
+  virtual irs::format::ptr get_codec() override {
+    return irs::formats::get("1_0");
+  }
+}; // memory_automaton_filter_test_case
+
+NS_LOCAL
+
+// the only multi-byte character indexed is replaced with a single byte one,
+// since distance is counted in characters
+std::string chars(std::string value) {
+  const auto pos = value.find("\xD0\x96");
+
+  if (pos != std::string::npos) {
+    value.replace(pos, 2, "\x01");
+  }
+
+  return value;
+}
+
+size_t edit_distance(const std::string& lhs_value, const std::string& rhs_value) {
+  const auto lhs = chars(lhs_value);
+  const auto rhs = chars(rhs_value);
+  std::vector<size_t> prev(rhs.size() + 1), cur(rhs.size() + 1);
+
+  for (size_t j = 0; j <= rhs.size(); ++j) prev[j] = j;
+
+  for (size_t i = 1; i <= lhs.size(); ++i) {
+    cur[0] = i;
+    for (size_t j = 1; j <= rhs.size(); ++j) {
+      cur[j] = std::min({
+        prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + (lhs[i - 1] == rhs[j - 1] ? 0 : 1)
+      });
+    }
+    std::swap(prev, cur);
+  }
+
+  return prev[rhs.size()];
+}
+
+NS_END
+
+TEST_F(memory_automaton_filter_test_case, wildcard) {
+  index_words();
+  auto rdr = open_reader();
+  ASSERT_EQ(size_t(SEGMENTS), rdr.size());
+
+  // trailing '*' is equivalent to a prefix filter
+  {
+    irs::by_wildcard filter;
+    filter.field("name").term("dc*");
+
+    check(filter, expected([](const std::string& w) {
+      return 0 == w.compare(0, 2, "dc");
+    }), rdr);
+
+    irs::by_prefix prefix;
+    prefix.field("name").term("dc");
+
+    docs_t prefix_docs;
+    auto prepared = prefix.prepare(rdr);
+    for (auto& segment : rdr) {
+      for (auto it = prepared->execute(segment); it->next();) {
+        prefix_docs.push_back(it->value());
+      }
+    }
+    check_query(filter, prefix_docs, rdr);
+  }
+
+  {
+    irs::by_wildcard filter;
+    filter.field("name").term("?b*a");
+
+    check(filter, expected([](const std::string& w) {
+      return w.size() >= 3 && w[1] == 'b' && w.back() == 'a';
+    }), rdr);
+  }
+
+  {
+    irs::by_wildcard filter;
+    filter.field("name").term("?ab");
+
+    check(filter, expected([](const std::string& w) {
+      return (w.size() == 3 && w.compare(1, 2, "ab") == 0) || w == "\xD0\x96" "ab";
+    }), rdr);
+  }
+
+  // no matches
+  check_query(irs::by_wildcard().field("name").term("x*"), docs_t{}, rdr);
+  check_query(irs::by_wildcard().field("missing").term("*"), docs_t{}, rdr);
+}
+
+TEST_F(memory_automaton_filter_test_case, regexp) {
+  index_words();
+  auto rdr = open_reader();
+
+  {
+    irs::by_regexp filter;
+    filter.field("name").term("(ab)+[cd]?");
+
+    check(filter, expected([](const std::string& w) {
+      return w == "ab" || w == "abc" || w == "abd" || w == "abab"
+        || w == "ababc" || w == "ababd";
+    }), rdr);
+  }
+
+  {
+    irs::by_regexp filter;
+    filter.field("name").term("[^a]{4}");
+
+    check(filter, expected([](const std::string& w) {
+      return w.size() == 4 && w.find('a') == std::string::npos;
+    }), rdr);
+  }
+
+  // invalid expression matches nothing
+  check_query(irs::by_regexp().field("name").term("(ab"), docs_t{}, rdr);
+}
+
+TEST_F(memory_automaton_filter_test_case, edit_distance) {
+  index_words();
+  auto rdr = open_reader();
+
+  for (auto* target : { "abcd", "dab", "ccccc" }) {
+    for (irs::byte_type distance = 0; distance <= 2; ++distance) {
+      irs::by_edit_distance filter;
+      filter.field("name").term(target);
+      filter.max_distance(distance);
+
+      check(filter, expected([target, distance](const std::string& w) {
+        return edit_distance(target, w) <= distance;
+      }), rdr);
+    }
+  }
+
+  // transpositions
+  {
+    irs::by_edit_distance filter;
+    filter.field("name").term("bacd");
+    filter.max_distance(1);
+    filter.with_transpositions(true);
+
+    auto docs = expected([](const std::string& w) {
+      return edit_distance("bacd", w) <= 1 || w == "abcd" || w == "bcad" || w == "badc";
+    });
+    check(filter, docs, rdr);
+  }
+
+  // distance is clamped
+  ASSERT_EQ(irs::by_edit_distance::MAX_DISTANCE, irs::by_edit_distance().max_distance(5).max_distance());
+}
+
+TEST_F(memory_automaton_filter_test_case, term_iterator) {
+  index_words();
+  auto rdr = open_reader();
+  auto& segment = rdr[0];
+  auto* field = segment.field("name");
+  ASSERT_NE(nullptr, field);
+
+  const auto acceptor = irs::make_wildcard_automaton(
+    irs::ref_cast<irs::byte_type>(irs::string_ref("c?a*"))
+  );
+
+  std::vector<irs::bstring> expected;
+  for (auto it = field->iterator(); it->next();) {
+    if (acceptor.accept(it->value())) {
+      expected.emplace_back(it->value());
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  std::vector<irs::bstring> actual;
+  irs::automaton_term_iterator it(acceptor, field->iterator());
+  while (it.next()) {
+    actual.emplace_back(it.value());
+  }
+  ASSERT_EQ(expected, actual);
+
+  // seek
+  irs::automaton_term_iterator seek_it(acceptor, field->iterator());
+  ASSERT_EQ(irs::SeekResult::NOT_FOUND, seek_it.seek_ge(irs::ref_cast<irs::byte_type>(irs::string_ref("cb"))));
+  ASSERT_EQ(irs::ref_cast<irs::byte_type>(irs::string_ref("cba")), seek_it.value());
+  ASSERT_EQ(irs::SeekResult::FOUND, seek_it.seek_ge(irs::ref_cast<irs::byte_type>(irs::string_ref("cda"))));
+  ASSERT_EQ(irs::SeekResult::END, seek_it.seek_ge(irs::ref_cast<irs::byte_type>(irs::string_ref("cdb"))));
+  ASSERT_FALSE(seek_it.seek(irs::ref_cast<irs::byte_type>(irs::string_ref("cb"))));
+  ASSERT_TRUE(seek_it.seek(irs::ref_cast<irs::byte_type>(irs::string_ref("caab"))));
+}
+
+TEST(by_wildcard_test, equal) {
+  irs::by_wildcard q0;
+  q0.field("field").term("a*");
+  irs::by_wildcard q1;
+  q1.field("field").term("a*");
+  ASSERT_EQ(q0, q1);
+  ASSERT_EQ(q0.hash(), q1.hash());
+
+  irs::by_wildcard q2;
+  q2.field("field").term("a?");
+  ASSERT_NE(q0, q2);
+
+  irs::by_regexp q3;
+  q3.field("field").term("a*");
+  ASSERT_NE(q0, q3);
+}
+
+TEST(by_edit_distance_test, equal) {
+  irs::by_edit_distance q0;
+  q0.field("field").term("abc");
+  q0.max_distance(2);
+  irs::by_edit_distance q1;
+  q1.field("field").term("abc");
+  q1.max_distance(2);
+  ASSERT_EQ(q0, q1);
+  ASSERT_EQ(q0.hash(), q1.hash());
+
+  q1.with_transpositions(true);
+  ASSERT_NE(q0, q1);
+  q1.with_transpositions(false).max_distance(1);
+  ASSERT_NE(q0, q1);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
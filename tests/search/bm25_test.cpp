@@ -30,6 +30,7 @@
 #include "search/sort.hpp"
 #include "search/score.hpp"
 #include "search/bm25.hpp"
+#include "search/boolean_filter.hpp"
 #include "search/term_filter.hpp"
 #include "utils/utf8_path.hpp"
 
@@ -725,6 +726,249 @@ TEST_F(bm25_test, test_query_norms) {
   }
 }
 
+TEST_F(bm25_test, test_query_block_max) {
+  // terms with varying in-document frequency spanning multiple postings blocks
+  const size_t docs_count = 3000;
+  auto term_freq = [](size_t term, size_t i)->size_t {
+    switch (term) {
+      case 0: return 1 + i % 3; // every document
+      case 1: return 0 == i % 3 ? 1 + (i*7) % 20 : 0;
+      default: return 0 == i % 5 ? 1 + (i*13) % 40 : 0;
+    }
+  };
+
+  {
+    const irs::string_ref terms[] { "a", "b", "c" };
+    auto writer = open_writer();
+
+    for (size_t i = 0; i < docs_count; ++i) {
+      tests::document doc;
+
+      for (size_t term = 0; term < 3; ++term) {
+        for (size_t freq = term_freq(term, i); freq; --freq) {
+          doc.insert(std::make_shared<templates::string_field>("field", terms[term]), true, false);
+        }
+      }
+
+      doc.insert(std::make_shared<templates::string_field>("seq", std::to_string(i)), false, true);
+      ASSERT_TRUE(insert(*writer,
+        doc.indexed.begin(), doc.indexed.end(),
+        doc.stored.begin(), doc.stored.end()
+      ));
+    }
+
+    writer->commit();
+  }
+
+  irs::order ord;
+  ord.add<irs::bm25_sort>(true);
+  auto prepared_order = ord.prepare();
+
+  irs::Or query;
+  query.add<irs::by_term>().field("field").term("a");
+  query.add<irs::by_term>().field("field").term("b");
+  query.add<irs::by_term>().field("field").term("c");
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+  auto prepared = query.prepare(reader, prepared_order);
+
+  auto score_value = [](const irs::bytes_ref& value) {
+    return *reinterpret_cast<const float_t*>(value.c_str());
+  };
+
+  const size_t limit = 10;
+
+  // exhaustive evaluation
+  std::vector<float_t> expected;
+  size_t exhaustive_count = 0;
+  {
+    auto docs = prepared->execute(segment, prepared_order);
+    auto& score = docs->attributes().get<irs::score>();
+    ASSERT_TRUE(bool(score));
+
+    while (docs->next()) {
+      score->evaluate();
+      expected.emplace_back(score_value(score->value()));
+      ++exhaustive_count;
+    }
+
+    ASSERT_EQ(docs_count, exhaustive_count);
+    std::sort(expected.begin(), expected.end(), std::greater<float_t>());
+    expected.resize(limit);
+  }
+
+  // evaluation with dynamic pruning
+  {
+    irs::score_threshold threshold;
+    irs::attribute_view ctx;
+    ctx.emplace(threshold);
+
+    auto docs = prepared->execute(segment, prepared_order, ctx);
+    auto& score = docs->attributes().get<irs::score>();
+    ASSERT_TRUE(bool(score));
+
+    auto greater = [&prepared_order](const irs::bstring& lhs, const irs::bstring& rhs) {
+      return prepared_order.less(lhs.c_str(), rhs.c_str());
+    };
+
+    std::vector<irs::bstring> heap; // worst entry is on top
+    size_t count = 0;
+    irs::doc_id_t prev = irs::type_limits<irs::type_t::doc_id_t>::invalid();
+
+    while (docs->next()) {
+      ASSERT_LT(prev, docs->value());
+      prev = docs->value();
+      ++count;
+      score->evaluate();
+
+      const irs::bstring value(score->value().c_str(), score->value().size());
+
+      if (heap.size() < limit) {
+        heap.push_back(value);
+        std::push_heap(heap.begin(), heap.end(), greater);
+      } else if (greater(value, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        heap.back() = value;
+        std::push_heap(heap.begin(), heap.end(), greater);
+      } else {
+        continue;
+      }
+
+      if (heap.size() == limit) {
+        threshold.value = heap.front();
+      }
+    }
+
+    ASSERT_LT(count, exhaustive_count); // some documents were pruned
+    ASSERT_EQ(limit, heap.size());
+
+    std::vector<float_t> actual;
+    for (auto& entry : heap) {
+      actual.emplace_back(score_value(entry));
+    }
+    std::sort(actual.begin(), actual.end(), std::greater<float_t>());
+
+    for (size_t i = 0; i < limit; ++i) {
+      ASSERT_FLOAT_EQ(expected[i], actual[i]);
+    }
+  }
+
+  // threshold isn't applied to the nested queries
+  {
+    irs::And root;
+    auto& nested = root.add<irs::Or>();
+    nested.add<irs::by_term>().field("field").term("a");
+    nested.add<irs::by_term>().field("field").term("b");
+    nested.add<irs::by_term>().field("field").term("c");
+    root.add<irs::by_term>().field("field").term("a");
+    auto prepared_root = root.prepare(reader, prepared_order);
+
+    irs::score_threshold threshold;
+    threshold.value.resize(sizeof(float_t));
+    *reinterpret_cast<float_t*>(&threshold.value[0]) = std::numeric_limits<float_t>::max();
+    irs::attribute_view ctx;
+    ctx.emplace(threshold);
+
+    auto docs = prepared_root->execute(segment, prepared_order, ctx);
+    size_t count = 0;
+    while (docs->next()) {
+      ++count;
+    }
+    ASSERT_EQ(docs_count, count);
+  }
+}
+
+TEST_F(bm25_test, test_query_batch) {
+  // documents of varying length and in-document frequency spanning
+  // multiple postings blocks and scoring batches
+  const size_t docs_count = 1000;
+
+  {
+    static irs::flags norm_features = { irs::norm::type() };
+    auto writer = open_writer();
+
+    for (size_t i = 0; i < docs_count; ++i) {
+      tests::document doc;
+
+      for (size_t freq = 1 + i % 7; freq; --freq) {
+        doc.insert(std::make_shared<templates::string_field>("field", "a", norm_features), true, false);
+      }
+
+      for (size_t freq = (i*13) % 11; freq; --freq) {
+        doc.insert(std::make_shared<templates::string_field>("field", "b", norm_features), true, false);
+      }
+
+      ASSERT_TRUE(insert(*writer,
+        doc.indexed.begin(), doc.indexed.end(),
+        doc.stored.begin(), doc.stored.end()
+      ));
+    }
+
+    writer->commit();
+  }
+
+  irs::order ord;
+  ord.add<irs::bm25_sort>(true);
+  auto prepared_order = ord.prepare();
+
+  irs::by_term query;
+  query.field("field").term("a");
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+  auto prepared = query.prepare(reader, prepared_order);
+
+  auto score_value = [](const irs::byte_type* value) {
+    return *reinterpret_cast<const float_t*>(value);
+  };
+
+  // document at a time
+  std::vector<std::pair<irs::doc_id_t, float_t>> expected;
+  {
+    auto docs = prepared->execute(segment, prepared_order);
+    auto& score = docs->attributes().get<irs::score>();
+    ASSERT_TRUE(bool(score));
+
+    while (docs->next()) {
+      score->evaluate();
+      expected.emplace_back(docs->value(), score_value(score->c_str()));
+    }
+
+    ASSERT_EQ(docs_count, expected.size());
+  }
+
+  // batch at a time
+  for (size_t batch_size : { size_t(1), size_t(3), size_t(128) }) {
+    auto docs = prepared->execute(segment, prepared_order);
+    auto& batch = docs->attributes().get<irs::score_batch>();
+    ASSERT_TRUE(bool(batch));
+    ASSERT_EQ(sizeof(float_t), prepared_order.size());
+
+    std::vector<irs::doc_id_t> ids(batch_size);
+    std::vector<uint32_t> freqs(batch_size);
+    std::vector<float_t> scores(batch_size);
+    size_t i = 0;
+
+    for (size_t count; (count = docs->next_batch(&ids[0], &freqs[0], batch_size)); ) {
+      batch->evaluate(
+        &ids[0], &freqs[0], count,
+        reinterpret_cast<irs::byte_type*>(&scores[0])
+      );
+
+      for (size_t j = 0; j < count; ++j, ++i) {
+        ASSERT_LT(i, expected.size());
+        ASSERT_EQ(expected[i].first, ids[j]);
+        ASSERT_FLOAT_EQ(expected[i].second, scores[j]);
+      }
+    }
+
+    ASSERT_EQ(expected.size(), i);
+  }
+}
+
 #ifndef IRESEARCH_DLL
 
 TEST_F(bm25_test, test_make) {
@@ -28,6 +28,7 @@
 #include "search/disjunction.hpp"
 #include "search/min_match_disjunction.hpp"
 #include "search/exclusion.hpp"
+#include "search/two_phase.hpp"
 #include "filter_test_case_base.hpp"
 #include "formats/formats_10.hpp"
 #include "index/iterators.hpp"
@@ -283,6 +284,76 @@ std::pair<std::vector<DocIterator>, std::vector<irs::order::prepared>> execute_a
   return { std::move(itrs), std::move(order) };
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class two_phase_doc_iterator
+/// @brief iterator over 'approx' documents verifying 'matched' ones,
+///        counts verifications and checks each document is verified once
+////////////////////////////////////////////////////////////////////////////////
+class two_phase_doc_iterator : public irs::doc_iterator {
+ public:
+  typedef std::vector<iresearch::doc_id_t> docids_t;
+
+  two_phase_doc_iterator(const docids_t& approx, const docids_t& matched)
+    : approx_(approx.begin(), approx.end()),
+      matched_(matched) {
+    est_.value(approx.size());
+    attrs_.emplace(est_);
+    attrs_.emplace(two_phase_);
+    two_phase_.reset(approx_, [this]() { return verify(); });
+  }
+
+  virtual iresearch::doc_id_t value() const override {
+    return approx_.value();
+  }
+
+  virtual bool next() override {
+    while (approx_.next()) {
+      if (verify()) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  virtual iresearch::doc_id_t seek(iresearch::doc_id_t target) override {
+    if (target <= approx_.value()) {
+      return approx_.value();
+    }
+
+    const auto doc = approx_.seek(target);
+
+    if (irs::type_limits<irs::type_t::doc_id_t>::eof(doc) || verify()) {
+      return doc;
+    }
+
+    next();
+    return approx_.value();
+  }
+
+  virtual const irs::attribute_view& attributes() const NOEXCEPT override {
+    return attrs_;
+  }
+
+  size_t verified{}; // number of verified documents
+
+ private:
+  bool verify() {
+    const auto doc = approx_.value();
+    EXPECT_NE(last_, doc); // every document is verified at most once
+    last_ = doc;
+    ++verified;
+    return std::binary_search(matched_.begin(), matched_.end(), doc);
+  }
+
+  basic_doc_iterator approx_;
+  docids_t matched_;
+  irs::cost est_;
+  irs::two_phase two_phase_;
+  irs::attribute_view attrs_;
+  iresearch::doc_id_t last_{ irs::type_limits<irs::type_t::doc_id_t>::invalid() };
+}; // two_phase_doc_iterator
+
 struct seek_doc {
   iresearch::doc_id_t target;
   iresearch::doc_id_t expected;
@@ -3439,6 +3510,34 @@ TEST(disjunction_test, seek_next) {
   }
 }
 
+TEST(disjunction_test, next_batch) {
+  using disjunction = iresearch::disjunction;
+
+  std::vector<std::vector<iresearch::doc_id_t>> docs{
+    { 1, 2, 5, 7, 9, 11, 45 },
+    { 1, 5, 6, 12, 29 },
+    { 1, 5, 6 }
+  };
+
+  const std::vector<irs::doc_id_t> expected{ 1, 2, 5, 6, 7, 9, 11, 12, 29, 45 };
+
+  for (size_t size = 1; size <= expected.size() + 1; ++size) {
+    disjunction it(detail::execute_all<irs::score_iterator_adapter>(docs));
+    std::vector<irs::doc_id_t> result;
+    std::vector<irs::doc_id_t> batch(size);
+
+    for (size_t count; (count = it.next_batch(&batch[0], nullptr, size));) {
+      ASSERT_LE(count, size);
+      result.insert(result.end(), batch.begin(), batch.begin() + count);
+      ASSERT_TRUE(result.back() == it.value() || irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+    }
+
+    ASSERT_EQ(expected, result);
+    ASSERT_FALSE(it.next());
+    ASSERT_EQ(irs::type_limits<irs::type_t::doc_id_t>::eof(), it.value());
+  }
+}
+
 TEST(disjunction_test, scored_seek_next) {
   using disjunction = iresearch::disjunction;
 
@@ -4973,6 +5072,49 @@ TEST(min_match_disjunction_test, scored_seek_next) {
   }
 }
 
+TEST(min_match_disjunction_test, two_phase) {
+  using disjunction = irs::min_match_disjunction;
+  const std::vector<iresearch::doc_id_t> approx{ 1, 2, 3, 5, 7 };
+  const std::vector<iresearch::doc_id_t> matched{ 1, 3, 7 };
+  const std::vector<iresearch::doc_id_t> docs0{ 1, 2, 5, 7 };
+  const std::vector<iresearch::doc_id_t> docs1{ 2, 3, 7, 9 };
+
+  auto make = [&](detail::two_phase_doc_iterator*& two_phase) {
+    disjunction::doc_iterators_t itrs;
+    auto it = irs::doc_iterator::make<detail::two_phase_doc_iterator>(approx, matched);
+    two_phase = static_cast<detail::two_phase_doc_iterator*>(it.get());
+    itrs.emplace_back(std::move(it));
+    itrs.emplace_back(irs::doc_iterator::make<detail::basic_doc_iterator>(docs0.begin(), docs0.end()));
+    itrs.emplace_back(irs::doc_iterator::make<detail::basic_doc_iterator>(docs1.begin(), docs1.end()));
+    return disjunction(std::move(itrs), 2);
+  };
+
+  // next, 5 is matched by a single iterator after verification
+  {
+    detail::two_phase_doc_iterator* two_phase;
+    auto it = make(two_phase);
+    std::vector<iresearch::doc_id_t> result;
+    for (; it.next(); ) {
+      result.push_back(it.value());
+    }
+    ASSERT_FALSE(it.next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+    ASSERT_EQ((std::vector<iresearch::doc_id_t>{ 1, 2, 3, 7 }), result);
+    ASSERT_EQ(approx.size(), two_phase->verified);
+  }
+
+  // seek
+  {
+    detail::two_phase_doc_iterator* two_phase;
+    auto it = make(two_phase);
+    ASSERT_EQ(2, it.seek(2));
+    ASSERT_EQ(2, it.seek(1));
+    ASSERT_EQ(7, it.seek(4));
+    ASSERT_FALSE(it.next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+  }
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                    iterator0 AND iterator1 AND iterator2 AND ... 
 // ----------------------------------------------------------------------------
@@ -5338,6 +5480,55 @@ TEST(conjunction_test, seek_next) {
   }
 }
 
+TEST(conjunction_test, next_batch) {
+  using conjunction = iresearch::conjunction;
+
+  std::vector<std::vector<iresearch::doc_id_t>> docs{
+    { 1, 2, 4, 5, 7, 8, 9, 11, 14, 29, 45, 46, 47, 48 },
+    { 1, 4, 5, 6, 8, 12, 14, 29, 45, 48 },
+    { 1, 4, 5, 8, 14, 29, 30, 31, 45, 48, 49 }
+  };
+
+  const std::vector<irs::doc_id_t> expected{ 1, 4, 5, 8, 14, 29, 45, 48 };
+
+  // various batch sizes, including ones smaller than number of matches
+  for (size_t size = 1; size <= expected.size() + 1; ++size) {
+    conjunction it(detail::execute_all<irs::score_iterator_adapter>(docs));
+    std::vector<irs::doc_id_t> result;
+    std::vector<irs::doc_id_t> batch(size);
+
+    for (size_t count; (count = it.next_batch(&batch[0], nullptr, size));) {
+      ASSERT_LE(count, size);
+      result.insert(result.end(), batch.begin(), batch.begin() + count);
+      ASSERT_TRUE(result.back() == it.value() || irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+    }
+
+    ASSERT_EQ(expected, result);
+    ASSERT_EQ(0, it.next_batch(&batch[0], nullptr, size));
+    ASSERT_FALSE(it.next());
+    ASSERT_EQ(irs::type_limits<irs::type_t::doc_id_t>::eof(), it.value());
+  }
+
+  // batch followed by seek/next, batch may contain less documents than requested
+  {
+    conjunction it(detail::execute_all<irs::score_iterator_adapter>(docs));
+    irs::doc_id_t batch[3];
+    const auto count = it.next_batch(batch, nullptr, 3);
+    ASSERT_LT(0, count);
+    ASSERT_LE(count, 3);
+    ASSERT_TRUE(std::equal(batch, batch + count, expected.begin()));
+    ASSERT_EQ(batch[count - 1], it.value());
+    ASSERT_EQ(5, it.seek(5));
+    ASSERT_TRUE(it.next());
+    ASSERT_EQ(8, it.value());
+    ASSERT_EQ(29, it.seek(15));
+    ASSERT_EQ(2, it.next_batch(batch, nullptr, 3));
+    ASSERT_EQ(45, batch[0]);
+    ASSERT_EQ(48, batch[1]);
+    ASSERT_FALSE(it.next());
+  }
+}
+
 TEST(conjunction_test, scored_seek_next) {
   using conjunction = iresearch::conjunction;
 
@@ -5562,6 +5753,63 @@ TEST(conjunction_test, scored_seek_next) {
   }
 }
 
+TEST(conjunction_test, two_phase) {
+  using conjunction = irs::conjunction;
+  const std::vector<iresearch::doc_id_t> approx{ 1, 2, 3, 5, 7, 9, 11 };
+  const std::vector<iresearch::doc_id_t> matched{ 2, 5, 9, 11 };
+  const std::vector<iresearch::doc_id_t> docs{ 2, 3, 5, 9, 12 };
+  const std::vector<iresearch::doc_id_t> expected{ 2, 5, 9 };
+
+  auto make = [&](detail::two_phase_doc_iterator*& two_phase) {
+    conjunction::doc_iterators_t itrs;
+    auto it = irs::doc_iterator::make<detail::two_phase_doc_iterator>(approx, matched);
+    two_phase = static_cast<detail::two_phase_doc_iterator*>(it.get());
+    itrs.emplace_back(std::move(it));
+    itrs.emplace_back(irs::doc_iterator::make<detail::basic_doc_iterator>(docs.begin(), docs.end()));
+    return conjunction(std::move(itrs));
+  };
+
+  // next, only common documents are verified
+  {
+    detail::two_phase_doc_iterator* two_phase;
+    auto it = make(two_phase);
+    std::vector<iresearch::doc_id_t> result;
+    for (; it.next(); ) {
+      result.push_back(it.value());
+    }
+    ASSERT_FALSE(it.next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+    ASSERT_EQ(expected, result);
+    ASSERT_EQ(4, two_phase->verified); // 2, 3, 5, 9
+  }
+
+  // seek
+  {
+    detail::two_phase_doc_iterator* two_phase;
+    auto it = make(two_phase);
+    ASSERT_EQ(5, it.seek(3));
+    ASSERT_EQ(5, it.seek(5));
+    ASSERT_EQ(9, it.seek(6));
+    ASSERT_FALSE(it.next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+  }
+
+  // conjunction is two-phase itself
+  {
+    detail::two_phase_doc_iterator* two_phase;
+    auto it = make(two_phase);
+    auto* match = irs::two_phase::extract(it.attributes());
+    ASSERT_NE(nullptr, match);
+    std::vector<iresearch::doc_id_t> result;
+    for (auto& approximation = match->approximation(); approximation.next(); ) {
+      if (match->match()) {
+        result.push_back(approximation.value());
+      }
+    }
+    ASSERT_EQ(expected, result);
+  }
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                      iterator0 AND NOT iterator1
 // ----------------------------------------------------------------------------
@@ -5800,6 +6048,71 @@ TEST(exclusion_test, seek) {
   }
 }
 
+TEST(exclusion_test, two_phase) {
+  const std::vector<iresearch::doc_id_t> included{ 1, 2, 5, 7, 9, 11, 45 };
+  const std::vector<iresearch::doc_id_t> included_matched{ 1, 2, 7, 9, 45 };
+  const std::vector<iresearch::doc_id_t> excluded{ 1, 5, 6, 9, 29 };
+  const std::vector<iresearch::doc_id_t> excluded_matched{ 1, 6, 29 };
+  const std::vector<iresearch::doc_id_t> expected{ 2, 7, 9, 45 };
+
+  auto make = [&](
+      detail::two_phase_doc_iterator*& incl,
+      detail::two_phase_doc_iterator*& excl) {
+    auto incl_it = irs::doc_iterator::make<detail::two_phase_doc_iterator>(included, included_matched);
+    auto excl_it = irs::doc_iterator::make<detail::two_phase_doc_iterator>(excluded, excluded_matched);
+    incl = static_cast<detail::two_phase_doc_iterator*>(incl_it.get());
+    excl = static_cast<detail::two_phase_doc_iterator*>(excl_it.get());
+    return irs::exclusion(std::move(incl_it), std::move(excl_it));
+  };
+
+  // next, excluded documents aren't verified
+  {
+    detail::two_phase_doc_iterator* incl;
+    detail::two_phase_doc_iterator* excl;
+    auto it = make(incl, excl);
+    ASSERT_EQ(included.size(), irs::cost::extract(it.attributes()));
+    std::vector<iresearch::doc_id_t> result;
+    for (; it.next(); ) {
+      result.push_back(it.value());
+    }
+    ASSERT_FALSE(it.next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+    ASSERT_EQ(expected, result);
+    ASSERT_EQ(6, incl->verified); // 2, 5, 7, 9, 11, 45
+    ASSERT_EQ(3, excl->verified); // 1, 5, 9
+  }
+
+  // seek
+  {
+    detail::two_phase_doc_iterator* incl;
+    detail::two_phase_doc_iterator* excl;
+    auto it = make(incl, excl);
+    ASSERT_EQ(2, it.seek(1));
+    ASSERT_EQ(7, it.seek(5));
+    ASSERT_EQ(7, it.seek(7));
+    ASSERT_EQ(45, it.seek(10));
+    ASSERT_FALSE(it.next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+  }
+
+  // exclusion is two-phase itself
+  {
+    detail::two_phase_doc_iterator* incl;
+    detail::two_phase_doc_iterator* excl;
+    auto it = make(incl, excl);
+    auto* match = irs::two_phase::extract(it.attributes());
+    ASSERT_NE(nullptr, match);
+    ASSERT_NE(incl->attributes().get<irs::two_phase>().get(), match);
+    std::vector<iresearch::doc_id_t> result;
+    for (auto& approximation = match->approximation(); approximation.next(); ) {
+      if (match->match()) {
+        result.push_back(approximation.value());
+      }
+    }
+    ASSERT_EQ(expected, result);
+  }
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                                Boolean test case 
 // ----------------------------------------------------------------------------
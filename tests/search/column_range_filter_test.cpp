@@ -0,0 +1,320 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "store/memory_directory.hpp"
+#include "formats/formats_10.hpp"
+#include "store/fs_directory.hpp"
+#include "search/boolean_filter.hpp"
+#include "search/column_range_filter.hpp"
+#include "search/term_filter.hpp"
+#include "search/two_phase.hpp"
+#include "utils/numeric_utils.hpp"
+
+NS_LOCAL
+
+typedef irs::numeric_utils::numeric_traits<int64_t> traits_t;
+
+irs::bstring encode(int64_t value) {
+  irs::bstring buf(traits_t::size(), 0);
+  buf.resize(traits_t::encode(value, &buf[0]));
+  return buf;
+}
+
+// field with byte-wise ordered numeric value,
+// indexed term is equal to the stored value
+struct sortable_long_field {
+  const irs::string_ref& name() const { return field_name; }
+
+  bool write(irs::data_output& out) const {
+    const auto encoded = encode(value);
+    out.write_bytes(encoded.c_str(), encoded.size());
+    return true;
+  }
+
+  irs::token_stream& get_tokens() const {
+    encoded = encode(value);
+    stream.reset(irs::bytes_ref(encoded));
+    return stream;
+  }
+
+  const irs::flags& features() const {
+    return irs::flags::empty_instance();
+  }
+
+  irs::string_ref field_name;
+  int64_t value{};
+  mutable irs::bstring encoded;
+  mutable irs::string_token_stream stream;
+}; // sortable_long_field
+
+NS_END
+
+NS_BEGIN(tests)
+
+class column_range_filter_test_case : public filter_test_case_base {
+ protected:
+  static const size_t MAX_DOCS = 10000;
+
+  // 'value' column contains 'doc_id - 1' for every document, the same
+  // values are indexed as terms of the 'value' field,
+  // 'parity' field is indexed with 'even'/'odd' terms of the value
+  void sequential_range() {
+    {
+      auto writer = open_writer();
+      auto ctx = writer->documents();
+
+      sortable_long_field value;
+      value.field_name = "value";
+      templates::string_field parity("parity");
+
+      for (size_t i = 0; i < MAX_DOCS; ++i) {
+        value.value = int64_t(i);
+        parity.value(i % 2 ? "odd" : "even");
+
+        auto doc = ctx.insert();
+        ASSERT_TRUE(doc.insert(irs::action::index_store, value));
+        ASSERT_TRUE(doc.insert(irs::action::index, parity));
+      }
+
+      { irs::index_writer::documents_context(std::move(ctx)); } // force flush of documents()
+      writer->commit();
+    }
+
+    auto rdr = open_reader();
+    ASSERT_EQ(1, rdr->size());
+    auto& segment = (*rdr)[0];
+    auto* column = segment.column_reader("value");
+    ASSERT_NE(nullptr, column);
+
+    // [100, 200)
+    {
+      irs::by_column_range filter;
+      filter.field("value")
+        .include<irs::Bound::MIN>(true).term<irs::Bound::MIN>(encode(100))
+        .include<irs::Bound::MAX>(false).term<irs::Bound::MAX>(encode(200));
+
+      docs_t expected;
+      for (irs::doc_id_t doc = 101; doc <= 200; ++doc) {
+        expected.push_back(doc);
+      }
+
+      check_query(filter, expected, rdr);
+
+      auto prepared = filter.prepare(*rdr, irs::order::prepared::unordered());
+      auto it = prepared->execute(segment);
+      ASSERT_EQ(column->size(), irs::cost::extract(it->attributes()));
+      ASSERT_EQ(151, it->seek(151));
+      ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->seek(201)));
+    }
+
+    // [100, 103], indexed field, term range is cheaper than the column
+    {
+      irs::by_column_range filter;
+      filter.field("value").indexed(true)
+        .include<irs::Bound::MIN>(true).term<irs::Bound::MIN>(encode(100))
+        .include<irs::Bound::MAX>(true).term<irs::Bound::MAX>(encode(103));
+
+      check_query(filter, docs_t{ 101, 102, 103, 104 }, rdr);
+
+      auto prepared = filter.prepare(*rdr, irs::order::prepared::unordered());
+      auto it = prepared->execute(segment);
+      ASSERT_EQ(4, irs::cost::extract(it->attributes()));
+    }
+
+    // [0, +inf), indexed field, every value matches, column is scanned
+    {
+      irs::by_column_range filter;
+      filter.field("value").indexed(true)
+        .include<irs::Bound::MIN>(true).term<irs::Bound::MIN>(encode(0));
+
+      docs_t expected;
+      for (irs::doc_id_t doc = 1; doc <= MAX_DOCS; ++doc) {
+        expected.push_back(doc);
+      }
+
+      check_query(filter, expected, rdr);
+
+      auto prepared = filter.prepare(*rdr, irs::order::prepared::unordered());
+      auto it = prepared->execute(segment);
+      ASSERT_EQ(column->size(), irs::cost::extract(it->attributes()));
+      ASSERT_NE(nullptr, irs::two_phase::extract(it->attributes()));
+    }
+
+    // (9990, +inf)
+    {
+      irs::by_column_range filter;
+      filter.field("value")
+        .include<irs::Bound::MIN>(false).term<irs::Bound::MIN>(encode(9990));
+
+      check_query(filter, docs_t{ 9992, 9993, 9994, 9995, 9996, 9997, 9998, 9999, 10000 }, rdr);
+    }
+
+    // (-inf, 3]
+    {
+      irs::by_column_range filter;
+      filter.field("value")
+        .include<irs::Bound::MAX>(true).term<irs::Bound::MAX>(encode(3));
+
+      check_query(filter, docs_t{ 1, 2, 3, 4 }, rdr);
+    }
+
+    // (-inf, -1], no values in range
+    {
+      irs::by_column_range filter;
+      filter.field("value")
+        .include<irs::Bound::MAX>(true).term<irs::Bound::MAX>(encode(-1));
+
+      check_query(filter, docs_t{}, rdr);
+    }
+
+    // missing column
+    {
+      irs::by_column_range filter;
+      filter.field("invalid")
+        .include<irs::Bound::MIN>(true).term<irs::Bound::MIN>(encode(0));
+
+      check_query(filter, docs_t{}, rdr);
+    }
+
+    // blocks out of range are skipped
+    {
+      const auto min = encode(5000);
+      const auto max = encode(5001);
+      size_t visited = 0;
+
+      ASSERT_TRUE(column->visit_range(
+        min, max,
+        [&visited](irs::doc_id_t, const irs::bytes_ref&) {
+          ++visited;
+          return true;
+      }));
+
+      ASSERT_LT(0, visited);
+      ASSERT_GT(column->size(), visited);
+    }
+
+    // parity=odd AND value in [5000, 5010], range is verified lazily
+    {
+      irs::And filter;
+      filter.add<irs::by_term>().field("parity").term("odd");
+      filter.add<irs::by_column_range>().field("value")
+        .include<irs::Bound::MIN>(true).term<irs::Bound::MIN>(encode(5000))
+        .include<irs::Bound::MAX>(true).term<irs::Bound::MAX>(encode(5010));
+
+      check_query(filter, docs_t{ 5002, 5004, 5006, 5008, 5010 }, rdr);
+
+      auto prepared = filter.prepare(*rdr, irs::order::prepared::unordered());
+      auto it = prepared->execute(segment);
+      ASSERT_NE(nullptr, irs::two_phase::extract(it->attributes()));
+    }
+  }
+}; // column_range_filter_test_case
+
+NS_END
+
+TEST(by_column_range, ctor) {
+  irs::by_column_range filter;
+  ASSERT_EQ(irs::by_column_range::type(), filter.type());
+  ASSERT_TRUE(filter.field().empty());
+  ASSERT_TRUE(filter.term<irs::Bound::MIN>().empty());
+  ASSERT_TRUE(filter.term<irs::Bound::MAX>().empty());
+  ASSERT_FALSE(filter.include<irs::Bound::MIN>());
+  ASSERT_FALSE(filter.include<irs::Bound::MAX>());
+  ASSERT_FALSE(filter.indexed());
+  ASSERT_EQ(irs::boost::no_boost(), filter.boost());
+}
+
+TEST(by_column_range, equal) {
+  irs::by_column_range q0;
+  q0.field("field")
+    .term<irs::Bound::MIN>("min").include<irs::Bound::MIN>(true)
+    .term<irs::Bound::MAX>("max");
+
+  irs::by_column_range q1;
+  q1.field("field")
+    .term<irs::Bound::MIN>("min").include<irs::Bound::MIN>(true)
+    .term<irs::Bound::MAX>("max");
+
+  ASSERT_EQ(q0, q1);
+  ASSERT_EQ(q0.hash(), q1.hash());
+
+  irs::by_column_range q2;
+  q2.field("field")
+    .term<irs::Bound::MIN>("min")
+    .term<irs::Bound::MAX>("max");
+
+  ASSERT_NE(q0, q2);
+
+  q1.indexed(true);
+  ASSERT_NE(q0, q1);
+}
+
+// ----------------------------------------------------------------------------
+// --SECTION--                           memory_directory + iresearch_format_10
+// ----------------------------------------------------------------------------
+
+class memory_column_range_filter_test_case
+    : public tests::column_range_filter_test_case {
+protected:
+  virtual irs::directory* get_directory() override {
+    return new irs::memory_directory();
+  }
+
+  virtual irs::format::ptr get_codec() override {
+    return irs::formats::get("1_0");
+  }
+};
+
+TEST_F(memory_column_range_filter_test_case, sequential_range) {
+  sequential_range();
+}
+
+// ----------------------------------------------------------------------------
+// --SECTION--                               fs_directory + iresearch_format_10
+// ----------------------------------------------------------------------------
+
+class fs_column_range_filter_test_case
+    : public tests::column_range_filter_test_case {
+protected:
+  virtual irs::directory* get_directory() override {
+    auto dir = test_dir();
+
+    dir /= "index";
+
+    return new irs::fs_directory(dir.utf8());
+  }
+
+  virtual irs::format::ptr get_codec() override {
+    return irs::formats::get("1_0");
+  }
+};
+
+TEST_F(fs_column_range_filter_test_case, sequential_range) {
+  sequential_range();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
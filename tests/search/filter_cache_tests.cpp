@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "store/memory_directory.hpp"
+#include "formats/formats_10.hpp"
+#include "search/filter_cache.hpp"
+#include "search/term_filter.hpp"
+#include "utils/index_utils.hpp"
+
+class filter_cache_test_case : public tests::filter_test_case_base {
+ protected:
+  virtual irs::directory* get_directory() override {
+    return new irs::memory_directory();
+  }
+
+  virtual irs::format::ptr get_codec() override {
+    return irs::formats::get("1_0");
+  }
+
+  // adds a segment of 'count' documents with 'parity' field indexed
+  void insert(irs::index_writer& writer, size_t count) {
+    {
+      auto ctx = writer.documents();
+      tests::templates::string_field parity("parity");
+
+      for (size_t i = 0; i < count; ++i) {
+        parity.value(i % 2 ? "odd" : "even");
+
+        auto doc = ctx.insert();
+        ASSERT_TRUE(doc.insert(irs::action::index, parity));
+      }
+    }
+
+    writer.commit();
+  }
+
+  static docs_t expected(size_t count, size_t remainder) {
+    docs_t docs;
+    for (size_t i = 0; i < count; ++i) {
+      if (remainder == i % 2) {
+        docs.push_back(irs::doc_id_t(i + 1));
+      }
+    }
+    return docs;
+  }
+
+  static void parity(irs::cached& filter, const irs::string_ref& value) {
+    filter.filter<irs::by_term>().field("parity").term(value);
+  }
+}; // filter_cache_test_case
+
+TEST_F(filter_cache_test_case, hits_and_misses) {
+  const size_t count = 1000;
+  auto writer = open_writer();
+  insert(*writer, count);
+
+  auto rdr = open_reader();
+  ASSERT_EQ(1, rdr.size());
+
+  irs::filter_cache cache(1 << 20); // cache after 2 uses
+  irs::cached filter;
+  filter.cache(&cache);
+  parity(filter, "even");
+
+  // first use, not cached
+  check_query(filter, expected(count, 0), rdr);
+  auto stats = cache.statistics();
+  ASSERT_EQ(0, stats.hits);
+  ASSERT_EQ(1, stats.misses);
+  ASSERT_EQ(0, stats.entries);
+  ASSERT_EQ(0, stats.memory);
+
+  // second use, materialized
+  check_query(filter, expected(count, 0), rdr);
+  stats = cache.statistics();
+  ASSERT_EQ(0, stats.hits);
+  ASSERT_EQ(2, stats.misses);
+  ASSERT_EQ(1, stats.entries);
+  ASSERT_LT(0, stats.memory);
+
+  // served from cache
+  check_query(filter, expected(count, 0), rdr);
+  stats = cache.statistics();
+  ASSERT_EQ(1, stats.hits);
+  ASSERT_EQ(2, stats.misses);
+  ASSERT_EQ(1, stats.entries);
+
+  // equal filter shares the entry
+  {
+    irs::cached other;
+    other.cache(&cache);
+    parity(other, "even");
+    ASSERT_EQ(filter, other);
+    ASSERT_EQ(filter.hash(), other.hash());
+
+    auto prepared = other.prepare(rdr);
+    auto it = prepared->execute(rdr[0]);
+    ASSERT_EQ(count/2, irs::cost::extract(it->attributes()));
+    ASSERT_EQ(501, it->seek(500));
+    ASSERT_EQ(501, it->seek(1));
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(503, it->value());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->seek(1000)));
+    ASSERT_FALSE(it->next());
+    ASSERT_EQ(2, cache.statistics().hits);
+  }
+
+  // different filter
+  {
+    irs::cached other;
+    other.cache(&cache);
+    parity(other, "odd");
+    ASSERT_NE(filter, other);
+    check_query(other, expected(count, 1), rdr);
+    stats = cache.statistics();
+    ASSERT_EQ(2, stats.hits);
+    ASSERT_EQ(3, stats.misses);
+  }
+
+  // scored queries bypass the cache
+  {
+    irs::order order;
+    order.add<tests::sort::boost>(false);
+    auto prepared_order = order.prepare();
+    auto prepared = filter.prepare(rdr, prepared_order);
+    auto it = prepared->execute(rdr[0], prepared_order);
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(1, it->value());
+    stats = cache.statistics();
+    ASSERT_EQ(2, stats.hits);
+    ASSERT_EQ(3, stats.misses);
+  }
+
+  cache.clear();
+  stats = cache.statistics();
+  ASSERT_EQ(0, stats.entries);
+  ASSERT_EQ(0, stats.memory);
+}
+
+TEST_F(filter_cache_test_case, reopen) {
+  const size_t count = 100;
+  auto writer = open_writer();
+  insert(*writer, count);
+
+  auto rdr = open_reader();
+  ASSERT_EQ(1, rdr.size());
+
+  irs::filter_cache cache(1 << 20, 1); // cache on first use
+  irs::cached filter;
+  filter.cache(&cache);
+  parity(filter, "odd");
+
+  check_query(filter, expected(count, 1), rdr);
+  auto stats = cache.statistics();
+  ASSERT_EQ(0, stats.hits);
+  ASSERT_EQ(1, stats.misses);
+  ASSERT_EQ(1, stats.entries);
+
+  // add another segment
+  insert(*writer, count);
+  rdr = rdr.reopen();
+  ASSERT_EQ(2, rdr.size());
+
+  // only the new segment is evaluated
+  for (size_t i = 0; i < rdr.size(); ++i) {
+    check_query(filter, expected(count, 1), rdr[i]);
+  }
+  stats = cache.statistics();
+  ASSERT_EQ(1, stats.hits);
+  ASSERT_EQ(2, stats.misses);
+  ASSERT_EQ(2, stats.entries);
+
+  // merge segments, entries for the old ones are dropped
+  ASSERT_TRUE(writer->consolidate(irs::index_utils::consolidation_policy(
+    irs::index_utils::consolidate_count()
+  )));
+  writer->commit();
+  rdr = rdr.reopen();
+  ASSERT_EQ(1, rdr.size());
+
+  auto expected_docs = expected(count, 1);
+  for (auto doc : expected(count, 1)) {
+    expected_docs.push_back(irs::doc_id_t(doc + count));
+  }
+
+  check_query(filter, expected_docs, rdr);
+  stats = cache.statistics();
+  ASSERT_EQ(1, stats.hits);
+  ASSERT_EQ(3, stats.misses);
+  ASSERT_EQ(1, stats.entries);
+}
+
+TEST_F(filter_cache_test_case, eviction) {
+  const size_t count = 100000;
+  auto writer = open_writer();
+  insert(*writer, count);
+
+  auto rdr = open_reader();
+  ASSERT_EQ(1, rdr.size());
+
+  size_t entry_memory;
+  {
+    irs::filter_cache cache(1 << 20, 1);
+    irs::cached filter;
+    filter.cache(&cache);
+    parity(filter, "even");
+    check_query(filter, expected(count, 0), rdr);
+    entry_memory = cache.statistics().memory;
+    ASSERT_LT(0, entry_memory);
+  }
+
+  // room for a single entry only
+  irs::filter_cache cache(entry_memory + entry_memory/2, 1);
+  irs::cached even;
+  even.cache(&cache);
+  parity(even, "even");
+  irs::cached odd;
+  odd.cache(&cache);
+  parity(odd, "odd");
+
+  check_query(even, expected(count, 0), rdr);
+  check_query(odd, expected(count, 1), rdr);
+  auto stats = cache.statistics();
+  ASSERT_EQ(0, stats.hits);
+  ASSERT_EQ(2, stats.misses);
+  ASSERT_EQ(1, stats.evictions);
+  ASSERT_EQ(1, stats.entries);
+  ASSERT_LE(stats.memory, stats.limit);
+
+  check_query(odd, expected(count, 1), rdr);
+  check_query(even, expected(count, 0), rdr);
+  stats = cache.statistics();
+  ASSERT_EQ(1, stats.hits);
+  ASSERT_EQ(3, stats.misses);
+  ASSERT_EQ(2, stats.evictions);
+
+  // entry that does not fit at all is never cached
+  irs::filter_cache tiny(1, 1);
+  even.cache(&tiny);
+  check_query(even, expected(count, 0), rdr);
+  check_query(even, expected(count, 0), rdr);
+  stats = tiny.statistics();
+  ASSERT_EQ(0, stats.hits);
+  ASSERT_EQ(2, stats.misses);
+  ASSERT_EQ(0, stats.entries);
+}
+
+TEST(cached_test, ctor) {
+  irs::cached q;
+  ASSERT_EQ(irs::cached::type(), q.type());
+  ASSERT_TRUE(q.empty());
+  ASSERT_EQ(nullptr, q.cache());
+  ASSERT_EQ(irs::boost::no_boost(), q.boost());
+}
+
+TEST(cached_test, equal) {
+  irs::filter_cache cache(1024);
+  irs::cached q0;
+  q0.filter<irs::by_term>().field("field").term("term");
+  irs::cached q1;
+  q1.cache(&cache).filter<irs::by_term>().field("field").term("term");
+  ASSERT_EQ(q0, q1);
+  ASSERT_EQ(q0.hash(), q1.hash());
+
+  irs::cached q2;
+  q2.filter<irs::by_term>().field("field").term("term1");
+  ASSERT_NE(q0, q2);
+
+  irs::cached q3;
+  ASSERT_NE(q0, q3);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -884,6 +884,95 @@ TEST_F(tfidf_test, test_query) {
   }
 }
 
+TEST_F(tfidf_test, test_query_batch) {
+  // documents of varying length and in-document frequency spanning
+  // multiple postings blocks and scoring batches
+  const size_t docs_count = 1000;
+
+  {
+    static irs::flags norm_features = { irs::norm::type() };
+    auto writer = open_writer();
+
+    for (size_t i = 0; i < docs_count; ++i) {
+      tests::document doc;
+
+      for (size_t freq = 1 + i % 7; freq; --freq) {
+        doc.insert(std::make_shared<templates::string_field>("field", "a", norm_features), true, false);
+      }
+
+      for (size_t freq = (i*13) % 11; freq; --freq) {
+        doc.insert(std::make_shared<templates::string_field>("field", "b", norm_features), true, false);
+      }
+
+      ASSERT_TRUE(insert(*writer,
+        doc.indexed.begin(), doc.indexed.end(),
+        doc.stored.begin(), doc.stored.end()
+      ));
+    }
+
+    writer->commit();
+  }
+
+  irs::order ord;
+  ord.add(true, irs::scorers::get("tfidf", irs::text_format::json, "true")); // with norms
+  auto prepared_order = ord.prepare();
+
+  irs::by_term query;
+  query.field("field").term("a");
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+  auto prepared = query.prepare(reader, prepared_order);
+
+  auto score_value = [](const irs::byte_type* value) {
+    return *reinterpret_cast<const float_t*>(value);
+  };
+
+  // document at a time
+  std::vector<std::pair<irs::doc_id_t, float_t>> expected;
+  {
+    auto docs = prepared->execute(segment, prepared_order);
+    auto& score = docs->attributes().get<irs::score>();
+    ASSERT_TRUE(bool(score));
+
+    while (docs->next()) {
+      score->evaluate();
+      expected.emplace_back(docs->value(), score_value(score->c_str()));
+    }
+
+    ASSERT_EQ(docs_count, expected.size());
+  }
+
+  // batch at a time
+  for (size_t batch_size : { size_t(1), size_t(3), size_t(128) }) {
+    auto docs = prepared->execute(segment, prepared_order);
+    auto& batch = docs->attributes().get<irs::score_batch>();
+    ASSERT_TRUE(bool(batch));
+    ASSERT_EQ(sizeof(float_t), prepared_order.size());
+
+    std::vector<irs::doc_id_t> ids(batch_size);
+    std::vector<uint32_t> freqs(batch_size);
+    std::vector<float_t> scores(batch_size);
+    size_t i = 0;
+
+    for (size_t count; (count = docs->next_batch(&ids[0], &freqs[0], batch_size)); ) {
+      batch->evaluate(
+        &ids[0], &freqs[0], count,
+        reinterpret_cast<irs::byte_type*>(&scores[0])
+      );
+
+      for (size_t j = 0; j < count; ++j, ++i) {
+        ASSERT_LT(i, expected.size());
+        ASSERT_EQ(expected[i].first, ids[j]);
+        ASSERT_FLOAT_EQ(expected[i].second, scores[j]);
+      }
+    }
+
+    ASSERT_EQ(expected.size(), i);
+  }
+}
+
 #ifndef IRESEARCH_DLL
 
 TEST_F(tfidf_test, test_make) {
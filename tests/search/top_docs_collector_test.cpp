@@ -0,0 +1,606 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "index/index_tests.hpp"
+#include "store/memory_directory.hpp"
+#include "search/bm25.hpp"
+#include "search/boolean_filter.hpp"
+#include "search/prefix_filter.hpp"
+#include "search/term_filter.hpp"
+#include "search/top_docs_collector.hpp"
+#include "store/store_utils.hpp"
+
+NS_BEGIN(tests)
+
+struct hit {
+  size_t segment;
+  irs::doc_id_t doc;
+  float_t score;
+};
+
+int32_t decode_rank(const irs::bytes_ref& value) {
+  irs::bytes_ref_input in(value);
+  return irs::read_zvint(in);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief scores a document by the value of its 'rank' column
+//////////////////////////////////////////////////////////////////////////////
+class rank_scorer : public irs::sort::scorer_base<irs::doc_id_t> {
+ public:
+  rank_scorer(
+      const irs::sub_reader& segment,
+      const irs::attribute_view& document_attrs)
+    : document_attrs_(document_attrs),
+      values_(segment.column_reader("rank")->values()) {
+  }
+
+  virtual void score(irs::byte_type* score_buf) override {
+    irs::bytes_ref value;
+    const auto doc = document_attrs_.get<irs::document>()->value;
+
+    score_cast(score_buf) = values_(doc, value)
+      ? irs::doc_id_t(decode_rank(value))
+      : irs::type_limits<irs::type_t::doc_id_t>::eof();
+  }
+
+ private:
+  const irs::attribute_view& document_attrs_;
+  irs::columnstore_reader::values_reader_f values_;
+}; // rank_scorer
+
+class top_docs_collector_test: public index_test_base {
+ protected:
+  virtual irs::directory* get_directory() override {
+    return new irs::memory_directory();
+  }
+
+  virtual irs::format::ptr get_codec() override {
+    return irs::formats::get("1_0");
+  }
+
+  // writes a segment where term 'a' occurs in every document
+  // with in-document frequency depending on the document number
+  void add_segment(size_t docs_count, size_t seed) {
+    auto writer = open_writer(irs::OM_CREATE | irs::OM_APPEND);
+
+    for (size_t i = 0; i < docs_count; ++i) {
+      tests::document doc;
+
+      for (size_t freq = 1 + (i*seed) % 17; freq; --freq) {
+        doc.insert(std::make_shared<templates::string_field>("field", "a"), true, false);
+      }
+
+      if (0 == i % 4) {
+        doc.insert(std::make_shared<templates::string_field>("field", "b"), true, false);
+      }
+
+      ASSERT_TRUE(insert(*writer, doc.indexed.begin(), doc.indexed.end()));
+    }
+
+    writer->commit();
+  }
+
+  // writes a segment where every document contains some of the terms
+  // 'a0'..'a4' with in-document frequency depending on the document number
+  void add_prefix_segment(size_t docs_count, size_t seed) {
+    auto writer = open_writer(irs::OM_CREATE | irs::OM_APPEND);
+
+    for (size_t i = 0; i < docs_count; ++i) {
+      tests::document doc;
+
+      for (size_t term = 0; term < 5; ++term) {
+        if ((i + term) % (term + 2)) {
+          continue;
+        }
+
+        const auto value = "a" + std::to_string(term);
+
+        for (size_t freq = 1 + (i*seed + term) % 7; freq; --freq) {
+          doc.insert(std::make_shared<templates::string_field>("field", value), true, false);
+        }
+      }
+
+      doc.insert(std::make_shared<templates::string_field>("field", "b"), true, false);
+
+      ASSERT_TRUE(insert(*writer, doc.indexed.begin(), doc.indexed.end()));
+    }
+
+    writer->commit();
+  }
+
+  // checks that documents of the scored disjunction of terms 'a0'..'a4'
+  // are scored in batches exactly as one by one
+  void check_ordered_batch(const irs::index_reader& reader) {
+    irs::order ord;
+    ord.add<irs::bm25_sort>(true);
+    auto prepared_order = ord.prepare();
+
+    // disjunction of the scored terms 'a0'..'a4'
+    irs::by_prefix query;
+    query.field("field").term("a");
+    auto prepared = query.prepare(reader, prepared_order);
+
+    auto score_value = [&prepared_order](const irs::byte_type* score) {
+      return prepared_order.get<float_t>(score, 0);
+    };
+
+    // exhaustive evaluation document by document
+    std::vector<hit> expected;
+    for (size_t i = 0, size = reader.size(); i < size; ++i) {
+      auto& segment = reader[i];
+      auto docs = segment.mask(prepared->execute(segment, prepared_order));
+      auto& score = irs::score::extract(docs->attributes());
+
+      while (docs->next()) {
+        score.evaluate();
+        expected.push_back(hit{ i, docs->value(), score_value(score.c_str()) });
+      }
+    }
+
+    // evaluation in batches
+    {
+      const size_t score_size = prepared_order.size();
+      auto expected_hit = expected.begin();
+
+      for (size_t i = 0, size = reader.size(); i < size; ++i) {
+        auto& segment = reader[i];
+        auto docs = segment.mask(prepared->execute(segment, prepared_order));
+        auto& batch = docs->attributes().get<irs::score_batch>();
+        ASSERT_FALSE(!batch);
+
+        irs::doc_id_t ids[64];
+        uint32_t freqs[64];
+        irs::bstring scores(64*score_size, 0);
+
+        for (size_t count; (count = docs->next_batch(ids, freqs, 64));) {
+          batch->evaluate(ids, freqs, count, &scores[0]);
+
+          for (size_t j = 0; j < count; ++j, ++expected_hit) {
+            ASSERT_NE(expected.end(), expected_hit);
+            ASSERT_EQ(i, expected_hit->segment);
+            ASSERT_EQ(expected_hit->doc, ids[j]);
+            ASSERT_FLOAT_EQ(expected_hit->score, score_value(scores.c_str() + j*score_size));
+          }
+        }
+      }
+
+      ASSERT_EQ(expected.end(), expected_hit);
+    }
+
+    std::stable_sort(
+      expected.begin(), expected.end(),
+      [](const hit& lhs, const hit& rhs) { return lhs.score > rhs.score; }
+    );
+
+    // collector scores documents in batches
+    for (size_t limit : { size_t(1), size_t(10), size_t(100) }) {
+      irs::top_docs_collector collector(prepared_order, limit);
+      collector.collect(reader, *prepared);
+      ASSERT_EQ(limit, collector.size());
+      ASSERT_EQ(expected.size(), collector.hits());
+
+      auto begin = expected.begin();
+      ASSERT_TRUE(collector.visit([&](const irs::top_docs_collector::entry& entry) {
+        EXPECT_FLOAT_EQ(begin->score, score_value(entry.score));
+        ++begin;
+        return true;
+      }));
+      ASSERT_EQ(expected.begin() + limit, begin);
+    }
+  }
+};
+
+NS_END
+
+using namespace tests;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+TEST_F(top_docs_collector_test, unordered) {
+  add_segment(50, 3);
+  add_segment(50, 5);
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(2, reader.size());
+
+  irs::by_term query;
+  query.field("field").term("b");
+  auto prepared = query.prepare(reader);
+
+  irs::top_docs_collector collector(irs::order::prepared::unordered(), 5);
+  ASSERT_EQ(5, collector.limit());
+  ASSERT_TRUE(collector.empty());
+
+  collector.collect(reader, *prepared);
+  ASSERT_EQ(5, collector.size());
+  ASSERT_EQ(5, collector.hits()); // execution stops once the collector is full
+  ASSERT_TRUE(collector.threshold().value.empty());
+
+  std::vector<irs::doc_id_t> actual;
+  ASSERT_TRUE(collector.visit([&reader, &actual](const irs::top_docs_collector::entry& entry) {
+    EXPECT_EQ(&reader[0], entry.segment);
+    actual.push_back(entry.doc);
+    return true;
+  }));
+
+  const std::vector<irs::doc_id_t> expected{ 1, 5, 9, 13, 17 };
+  ASSERT_EQ(expected, actual);
+
+  // terminate visitation
+  size_t visited = 0;
+  ASSERT_FALSE(collector.visit([&visited](const irs::top_docs_collector::entry&) {
+    return ++visited < 2;
+  }));
+  ASSERT_EQ(2, visited);
+
+  collector.clear();
+  ASSERT_TRUE(collector.empty());
+  ASSERT_EQ(0, collector.hits());
+}
+
+TEST_F(top_docs_collector_test, ordered) {
+  add_segment(300, 3);
+  add_segment(200, 7);
+  add_segment(400, 11);
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(3, reader.size());
+
+  irs::order ord;
+  ord.add<irs::bm25_sort>(true);
+  auto prepared_order = ord.prepare();
+
+  irs::Or query;
+  query.add<irs::by_term>().field("field").term("a");
+  query.add<irs::by_term>().field("field").term("b");
+  auto prepared = query.prepare(reader, prepared_order);
+
+  auto score_value = [&prepared_order](const irs::byte_type* score) {
+    return prepared_order.get<float_t>(score, 0);
+  };
+
+  // exhaustive evaluation
+  std::vector<hit> expected;
+  for (size_t i = 0, size = reader.size(); i < size; ++i) {
+    auto& segment = reader[i];
+    auto docs = prepared->execute(segment, prepared_order);
+    auto& score = irs::score::extract(docs->attributes());
+
+    while (docs->next()) {
+      score.evaluate();
+      expected.push_back(hit{ i, docs->value(), score_value(score.c_str()) });
+    }
+  }
+
+  std::stable_sort(
+    expected.begin(), expected.end(),
+    [](const hit& lhs, const hit& rhs) { return lhs.score > rhs.score; }
+  );
+
+  for (size_t limit : { size_t(1), size_t(10), size_t(100), size_t(2000) }) {
+    irs::top_docs_collector collector(prepared_order, limit);
+    collector.collect(reader, *prepared);
+
+    const size_t size = std::min(limit, expected.size());
+    ASSERT_EQ(size, collector.size());
+    ASSERT_LE(collector.hits(), expected.size());
+
+    if (limit <= expected.size()) {
+      ASSERT_FALSE(collector.threshold().value.empty());
+      ASSERT_EQ(expected[size - 1].score, score_value(collector.threshold().value.c_str()));
+    } else {
+      ASSERT_TRUE(collector.threshold().value.empty());
+    }
+
+    // visit twice, results must be the same
+    for (size_t pass = 0; pass < 2; ++pass) {
+      auto begin = expected.begin();
+      ASSERT_TRUE(collector.visit([&](const irs::top_docs_collector::entry& entry) {
+        EXPECT_EQ(&reader[begin->segment], entry.segment);
+        EXPECT_EQ(begin->doc, entry.doc);
+        EXPECT_EQ(begin->score, score_value(entry.score));
+        ++begin;
+        return true;
+      }));
+      ASSERT_EQ(expected.begin() + size, begin);
+    }
+  }
+}
+
+TEST_F(top_docs_collector_test, ordered_batch) {
+  add_prefix_segment(700, 3);
+  add_prefix_segment(300, 5);
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(2, reader.size());
+
+  check_ordered_batch(reader);
+}
+
+TEST_F(top_docs_collector_test, ordered_batch_removals) {
+  add_prefix_segment(700, 3);
+  add_prefix_segment(300, 5);
+
+  // remove every 5th document, batches read through the mask iterator
+  // lose some documents and may get the one following the batch
+  {
+    auto writer = open_writer(irs::OM_APPEND);
+    auto query = irs::by_term::make();
+    static_cast<irs::by_term&>(*query).field("field").term("a3");
+    writer->documents().remove(std::move(query));
+    writer->commit();
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(2, reader.size());
+  ASSERT_LT(reader[0].live_docs_count(), reader[0].docs_count());
+  ASSERT_LT(reader[1].live_docs_count(), reader[1].docs_count());
+
+  check_ordered_batch(reader);
+}
+
+TEST_F(top_docs_collector_test, ordered_by_sort_column) {
+  // segments are ordered by the 'rank' column, lesser ranks first
+  irs::index_writer::init_options options;
+  options.comparator = irs::merge_writer::comparer(
+    "rank",
+    [](const irs::bytes_ref& lhs, const irs::bytes_ref& rhs) {
+      return decode_rank(lhs) < decode_rank(rhs);
+  });
+
+  {
+    auto writer = open_writer(irs::OM_CREATE, options);
+
+    for (size_t seed = 0; seed < 3; ++seed) {
+      for (size_t i = 0; i < 500; ++i) {
+        tests::document doc;
+        doc.insert(std::make_shared<templates::string_field>("field", "a"), true, false);
+
+        auto rank = std::make_shared<tests::int_field>();
+        rank->name("rank");
+        rank->value(int32_t((i*7919 + seed*13) % 1000)); // unique within a segment
+        doc.insert(rank, false, true);
+
+        ASSERT_TRUE(insert(*writer,
+          doc.indexed.begin(), doc.indexed.end(),
+          doc.stored.begin(), doc.stored.end()
+        ));
+      }
+
+      writer->commit();
+    }
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(3, reader.size());
+
+  for (auto& segment : reader) {
+    ASSERT_EQ("rank", segment.sort_column());
+  }
+
+  // the query ranks documents by the 'rank' column as well
+  irs::order ord;
+  auto& sort = ord.add<tests::sort::custom_sort>(false);
+  sort.prepare_scorer = [](
+      const irs::sub_reader& segment,
+      const irs::term_reader&,
+      const irs::attribute_store&,
+      const irs::attribute_view& document_attrs) -> irs::sort::scorer::ptr {
+    return irs::sort::scorer::make<rank_scorer>(segment, document_attrs);
+  };
+  sort.scorer_less = [](const irs::doc_id_t& lhs, const irs::doc_id_t& rhs) {
+    return lhs < rhs;
+  };
+
+  auto prepared_order = ord.prepare();
+
+  irs::by_term query;
+  query.field("field").term("a");
+  auto prepared = query.prepare(reader, prepared_order);
+
+  auto score_value = [&prepared_order](const irs::byte_type* score) {
+    return prepared_order.get<irs::doc_id_t>(score, 0);
+  };
+
+  for (size_t limit : { size_t(1), size_t(10), size_t(100) }) {
+    irs::top_docs_collector expected(prepared_order, limit);
+    expected.collect(reader, *prepared);
+    ASSERT_EQ(1500, expected.hits());
+
+    // collection of a segment stops at the first document that doesn't
+    // get into the collector
+    irs::top_docs_collector collector(prepared_order, limit, "rank");
+    collector.collect(reader, *prepared);
+    ASSERT_EQ(limit, collector.size());
+    ASSERT_LE(limit, collector.hits());
+    ASSERT_GE(3*(limit + 1), collector.hits());
+
+    std::vector<std::pair<const irs::sub_reader*, irs::doc_id_t>> expected_docs;
+    ASSERT_TRUE(expected.visit([&](const irs::top_docs_collector::entry& entry) {
+      expected_docs.emplace_back(entry.segment, entry.doc);
+      return true;
+    }));
+
+    auto begin = expected_docs.begin();
+    irs::doc_id_t prev_rank = 0;
+    ASSERT_TRUE(collector.visit([&](const irs::top_docs_collector::entry& entry) {
+      EXPECT_NE(expected_docs.end(), begin);
+      EXPECT_EQ(begin->first, entry.segment);
+      EXPECT_EQ(begin->second, entry.doc);
+      EXPECT_LE(prev_rank, score_value(entry.score));
+      prev_rank = score_value(entry.score);
+      ++begin;
+      return true;
+    }));
+    ASSERT_EQ(expected_docs.end(), begin);
+  }
+
+  // the order of the query doesn't match the order of segments
+  {
+    irs::top_docs_collector collector(prepared_order, 10, "name");
+    collector.collect(reader, *prepared);
+    ASSERT_EQ(1500, collector.hits());
+  }
+}
+
+TEST_F(top_docs_collector_test, collect_document) {
+  add_segment(10, 3);
+  add_segment(10, 3);
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(2, reader.size());
+
+  irs::order ord;
+  ord.add<irs::bm25_sort>(true);
+  auto prepared_order = ord.prepare();
+
+  irs::bstring score(prepared_order.size(), 0);
+  auto& value = *reinterpret_cast<float_t*>(&score[0]);
+
+  irs::top_docs_collector collector(prepared_order, 3);
+  value = 1.f;
+  ASSERT_TRUE(collector.collect(reader[0], 5, score.c_str()));
+  value = 3.f;
+  ASSERT_TRUE(collector.collect(reader[0], 6, score.c_str()));
+  value = 2.f;
+  ASSERT_TRUE(collector.collect(reader[0], 7, score.c_str()));
+  ASSERT_EQ(1.f, *reinterpret_cast<const float_t*>(collector.threshold().value.c_str()));
+
+  // worse than the worst one
+  value = 0.5f;
+  ASSERT_FALSE(collector.collect(reader[1], 1, score.c_str()));
+
+  // same score as the worst one, but the later document
+  value = 1.f;
+  ASSERT_FALSE(collector.collect(reader[1], 2, score.c_str()));
+
+  // replaces the worst one
+  value = 2.f;
+  ASSERT_TRUE(collector.collect(reader[1], 3, score.c_str()));
+  ASSERT_EQ(2.f, *reinterpret_cast<const float_t*>(collector.threshold().value.c_str()));
+
+  std::vector<std::pair<const irs::sub_reader*, irs::doc_id_t>> actual;
+  collector.visit([&actual](const irs::top_docs_collector::entry& entry) {
+    actual.emplace_back(entry.segment, entry.doc);
+    return true;
+  });
+
+  const decltype(actual) expected {
+    { &reader[0], 6 }, { &reader[0], 7 }, { &reader[1], 3 }
+  };
+  ASSERT_EQ(expected, actual);
+
+  // collect after visitation
+  value = 4.f;
+  ASSERT_TRUE(collector.collect(reader[1], 4, score.c_str()));
+  actual.clear();
+  collector.visit([&actual](const irs::top_docs_collector::entry& entry) {
+    actual.emplace_back(entry.segment, entry.doc);
+    return true;
+  });
+
+  const decltype(actual) expected_after {
+    { &reader[1], 4 }, { &reader[0], 6 }, { &reader[0], 7 }
+  };
+  ASSERT_EQ(expected_after, actual);
+
+  // zero limit
+  irs::top_docs_collector empty(prepared_order, 0);
+  ASSERT_FALSE(empty.collect(reader[0], 1, score.c_str()));
+  ASSERT_TRUE(empty.empty());
+}
+
+TEST_F(top_docs_collector_test, parallel) {
+  add_segment(300, 3);
+  add_segment(200, 7);
+  add_segment(10, 13);
+  add_segment(400, 11);
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(4, reader.size());
+
+  irs::order ord;
+  ord.add<irs::bm25_sort>(true);
+  auto prepared_order = ord.prepare();
+
+  irs::Or query;
+  query.add<irs::by_term>().field("field").term("a");
+  query.add<irs::by_term>().field("field").term("b");
+  auto prepared = query.prepare(reader, prepared_order);
+  auto prepared_unordered = query.prepare(reader);
+
+  typedef std::vector<std::pair<const irs::sub_reader*, irs::doc_id_t>> hits_t;
+
+  auto collected = [](irs::top_docs_collector& collector) {
+    hits_t hits;
+    collector.visit([&hits](const irs::top_docs_collector::entry& entry) {
+      hits.emplace_back(entry.segment, entry.doc);
+      return true;
+    });
+    return hits;
+  };
+
+  irs::async_utils::thread_pool pool(4, 4);
+
+  for (size_t limit : { size_t(1), size_t(10), size_t(100), size_t(2000) }) {
+    irs::top_docs_collector expected(prepared_order, limit);
+    expected.collect(reader, *prepared);
+
+    irs::top_docs_collector expected_unordered(irs::order::prepared::unordered(), limit);
+    expected_unordered.collect(reader, *prepared_unordered);
+
+    // 0 - ranges aren't split, 64 - large segments are split
+    for (size_t range_docs : { size_t(0), size_t(64), size_t(1) }) {
+      irs::top_docs_collector actual(prepared_order, limit);
+      actual.collect(reader, *prepared, pool, range_docs);
+      ASSERT_EQ(expected.size(), actual.size());
+      ASSERT_EQ(expected.threshold().value, actual.threshold().value);
+      ASSERT_EQ(collected(expected), collected(actual));
+
+      irs::top_docs_collector actual_unordered(irs::order::prepared::unordered(), limit);
+      actual_unordered.collect(reader, *prepared_unordered, pool, range_docs);
+      ASSERT_EQ(expected_unordered.size(), actual_unordered.size());
+      ASSERT_EQ(collected(expected_unordered), collected(actual_unordered));
+    }
+  }
+
+  // stopped pool, ranges are executed in the current thread
+  {
+    irs::top_docs_collector expected(prepared_order, 10);
+    expected.collect(reader, *prepared);
+
+    pool.stop();
+    irs::top_docs_collector actual(prepared_order, 10);
+    actual.collect(reader, *prepared, pool, 64);
+    ASSERT_EQ(collected(expected), collected(actual));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -26,10 +26,13 @@
 #include "directory_test_case.hpp"
 
 #include "store/fs_directory.hpp"
+#include "store/directory_attributes.hpp"
 #include "utils/process_utils.hpp"
 #include "utils/network_utils.hpp"
 
+#include <atomic>
 #include <fstream>
+#include <thread>
 
 #ifndef _WIN32
 #include <sys/file.h>
@@ -294,6 +297,70 @@ TEST_F(fs_directory_test, directory_size) {
   directory_size();
 }
 
+TEST_F(fs_directory_test, positional_read_mode) {
+  ASSERT_EQ(irs::fs_read_mode::STREAM, dir_->attributes().emplace<irs::fs_read_mode>()->mode); // default
+  dir_->attributes().emplace<irs::fs_read_mode>()->mode = irs::fs_read_mode::POSITIONAL;
+  smoke_store();
+  smoke_index_io();
+  read_multiple_streams();
+}
+
+TEST_F(fs_directory_test, positional_read_concurrent) {
+  dir_->attributes().emplace<irs::fs_read_mode>()->mode = irs::fs_read_mode::POSITIONAL;
+
+  const size_t count = 100000;
+
+  {
+    auto out = dir_->create("file");
+    ASSERT_FALSE(!out);
+
+    for (size_t i = 0; i < count; ++i) {
+      out->write_vlong(i);
+    }
+  }
+
+  auto in = dir_->open("file", irs::IOAdvice::RANDOM);
+  ASSERT_FALSE(!in);
+
+  // reopened inputs have their own positions while sharing a single descriptor
+  std::vector<irs::index_input::ptr> inputs;
+  for (size_t i = 0; i < 8; ++i) {
+    inputs.emplace_back(in->reopen());
+    ASSERT_FALSE(!inputs.back());
+  }
+
+  std::vector<std::thread> threads;
+  std::atomic<size_t> errors(0);
+
+  for (auto& input : inputs) {
+    threads.emplace_back([&input, &errors, count]() {
+      for (size_t i = 0; i < count; ++i) {
+        if (i != input->read_vlong()) {
+          ++errors;
+        }
+      }
+
+      if (!input->eof()) {
+        ++errors;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(0, errors);
+
+  // original input is not affected
+  ASSERT_EQ(0, in->file_pointer());
+  ASSERT_EQ(0, in->read_vlong());
+  in->seek(in->length() - 3); // 3 bytes per vlong
+  ASSERT_EQ(count - 1, in->read_vlong());
+  ASSERT_TRUE(in->eof());
+  ASSERT_THROW(in->read_byte(), irs::io_error);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2018 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "error/error.hpp"
+#include "store/memory_directory.hpp"
+#include "store/store_utils.hpp"
+#include "store/store_utils_adaptive.hpp"
+
+#include <random>
+
+using namespace iresearch;
+using namespace iresearch::encode;
+
+NS_LOCAL
+
+const uint32_t SENTINEL = 0xDEADBEEF;
+
+// writes blocks followed by a sentinel value, then checks that every block
+// can be read back and skipped, returns headers of the written blocks
+std::vector<uint32_t> read_write_blocks(
+    const std::vector<std::vector<uint32_t>>& blocks,
+    bool deltas) {
+  memory_directory dir;
+  std::vector<uint32_t> headers;
+  std::vector<uint32_t> buf(adaptive::BLOCK_SIZE, std::numeric_limits<uint32_t>::max());
+
+  {
+    auto out = dir.create("blocks");
+    EXPECT_NE(nullptr, out);
+
+    for (auto& block : blocks) {
+      EXPECT_EQ(adaptive::BLOCK_SIZE, block.size());
+      headers.push_back(adaptive::write_block(*out, block.data(), buf.data(), deltas));
+    }
+
+    out->write_int(SENTINEL);
+  }
+
+  auto in = dir.open("blocks", IOAdvice::NORMAL);
+  EXPECT_NE(nullptr, in);
+
+  // read
+  for (auto& block : blocks) {
+    std::vector<uint32_t> read(adaptive::BLOCK_SIZE);
+    adaptive::read_block(*in, buf.data(), read.data());
+    EXPECT_EQ(block, read);
+  }
+  EXPECT_EQ(SENTINEL, uint32_t(in->read_int()));
+
+  // skip
+  in->seek(0);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    adaptive::skip_block(*in);
+  }
+  EXPECT_EQ(SENTINEL, uint32_t(in->read_int()));
+
+  return headers;
+}
+
+uint32_t read_write_block(const std::vector<uint32_t>& block, bool deltas) {
+  return read_write_blocks({ block }, deltas).front();
+}
+
+NS_END
+
+TEST(store_utils_adaptive_tests, pack_unpack) {
+  std::mt19937 engine(42);
+  std::vector<uint32_t> decoded(adaptive::BLOCK_SIZE);
+  std::vector<uint32_t> encoded(adaptive::BLOCK_SIZE);
+  std::vector<uint32_t> unpacked(adaptive::BLOCK_SIZE);
+
+  ASSERT_TRUE(adaptive::supported(adaptive::isa_t::SCALAR));
+  ASSERT_TRUE(adaptive::supported(adaptive::best_isa()));
+
+  for (uint32_t bits = 1; bits <= 32; ++bits) {
+    const uint32_t mask = uint32_t((uint64_t(1) << bits) - 1);
+
+    for (auto& value : decoded) {
+      value = engine() & mask;
+    }
+    decoded[0] = mask; // at least one value requires all bits
+
+    adaptive::pack(decoded.data(), encoded.data(), bits);
+
+    for (auto isa : { adaptive::isa_t::SCALAR, adaptive::isa_t::SSE2, adaptive::isa_t::AVX2 }) {
+      if (!adaptive::supported(isa)) {
+        continue;
+      }
+
+      std::fill(unpacked.begin(), unpacked.end(), std::numeric_limits<uint32_t>::max());
+      adaptive::unpack(encoded.data(), unpacked.data(), bits, isa);
+      ASSERT_EQ(decoded, unpacked) << bits << " " << int(isa);
+    }
+  }
+}
+
+TEST(store_utils_adaptive_tests, read_write_block) {
+  const size_t size = adaptive::BLOCK_SIZE;
+  std::mt19937 engine(42);
+
+  // all equal
+  ASSERT_EQ(adaptive::ALL_EQUAL, read_write_block(std::vector<uint32_t>(size, 1), false));
+  ASSERT_EQ(adaptive::ALL_EQUAL, read_write_block(std::vector<uint32_t>(size, 0), true));
+
+  // uniformly distributed values are bit packed
+  {
+    std::vector<uint32_t> block(size);
+    for (auto& value : block) {
+      value = (engine() & 0xFFFFF) | 0x80000;
+    }
+
+    ASSERT_EQ(20, read_write_block(block, false));
+    ASSERT_EQ(20, read_write_block(block, true));
+
+    for (auto& value : block) {
+      value = engine() | 0x80000000;
+    }
+    ASSERT_EQ(32, read_write_block(block, false));
+  }
+
+  // deltas of a dense sequence
+  {
+    std::vector<uint32_t> block(size, 1);
+    block[0] = 1000;
+    block[17] = 2;
+    block[100] = 3;
+
+    ASSERT_EQ(adaptive::DENSE, read_write_block(block, true));
+    ASSERT_NE(adaptive::DENSE, read_write_block(block, false));
+
+    block[50] = 0; // not a strictly increasing sequence
+    ASSERT_NE(adaptive::DENSE, read_write_block(block, true));
+  }
+
+  // a few large values among small ones
+  {
+    std::vector<uint32_t> block(size);
+    for (auto& value : block) {
+      value = engine() % 4;
+    }
+    block[3] = 100000;
+    block[127] = std::numeric_limits<uint32_t>::max();
+
+    ASSERT_EQ(adaptive::PFOR, read_write_block(block, false));
+
+    // zero low bits
+    std::fill(block.begin(), block.end(), 0);
+    block[0] = 1 << 20;
+    block[64] = 1 << 30;
+    ASSERT_EQ(adaptive::PFOR, read_write_block(block, false));
+  }
+
+  // mixed blocks
+  {
+    std::vector<std::vector<uint32_t>> blocks;
+    for (size_t i = 0; i < 64; ++i) {
+      const uint32_t max = 1U << (engine() % 32);
+      std::vector<uint32_t> block(size);
+
+      for (auto& value : block) {
+        value = 1 + engine() % max;
+      }
+
+      if (i % 3) {
+        block[engine() % size] = engine(); // exception
+      }
+
+      blocks.emplace_back(std::move(block));
+    }
+
+    read_write_blocks(blocks, true);
+    read_write_blocks(blocks, false);
+  }
+}
+
+TEST(store_utils_adaptive_tests, read_invalid_block) {
+  bytes_output out;
+  out.write_vint(adaptive::PFOR + 1);
+
+  bytes_input in(out);
+  std::vector<uint32_t> buf(adaptive::BLOCK_SIZE);
+  std::vector<uint32_t> read(adaptive::BLOCK_SIZE);
+  ASSERT_THROW(adaptive::read_block(in, buf.data(), read.data()), index_error);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
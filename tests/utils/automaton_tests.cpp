@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "utils/automaton.hpp"
+
+#include <set>
+
+using namespace iresearch;
+
+NS_LOCAL
+
+bytes_ref ref(const char* value) {
+  return ref_cast<byte_type>(string_ref(value));
+}
+
+bool accept(const automaton& a, const std::string& value) {
+  return a.accept(ref_cast<byte_type>(string_ref(value)));
+}
+
+// all strings over 'alphabet' of length at most 'max_length'
+std::set<std::string> all_strings(const std::string& alphabet, size_t max_length) {
+  std::set<std::string> strings{ "" };
+  std::set<std::string> last{ "" };
+
+  for (size_t i = 0; i < max_length; ++i) {
+    std::set<std::string> next;
+    for (auto& prefix : last) {
+      for (auto c : alphabet) {
+        next.insert(prefix + c);
+      }
+    }
+    strings.insert(next.begin(), next.end());
+    last = std::move(next);
+  }
+
+  return strings;
+}
+
+size_t edit_distance(const std::string& lhs, const std::string& rhs, bool transpositions) {
+  std::vector<std::vector<size_t>> d(lhs.size() + 1, std::vector<size_t>(rhs.size() + 1));
+
+  for (size_t i = 0; i <= lhs.size(); ++i) d[i][0] = i;
+  for (size_t j = 0; j <= rhs.size(); ++j) d[0][j] = j;
+
+  for (size_t i = 1; i <= lhs.size(); ++i) {
+    for (size_t j = 1; j <= rhs.size(); ++j) {
+      const size_t cost = lhs[i - 1] == rhs[j - 1] ? 0 : 1;
+      d[i][j] = std::min({ d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + cost });
+
+      if (transpositions && i > 1 && j > 1
+          && lhs[i - 1] == rhs[j - 2] && lhs[i - 2] == rhs[j - 1]) {
+        d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+      }
+    }
+  }
+
+  return d[lhs.size()][rhs.size()];
+}
+
+// checks that iterating 'terms' via 'next_bound' yields exactly accepted ones
+void assert_intersection(const automaton& a, const std::set<std::string>& terms) {
+  std::vector<std::string> expected;
+  for (auto& term : terms) {
+    if (accept(a, term)) {
+      expected.push_back(term);
+    }
+  }
+
+  std::vector<std::string> actual;
+  bstring bound;
+
+  for (auto it = terms.begin(); it != terms.end();) {
+    if (accept(a, *it)) {
+      actual.push_back(*it);
+      ++it;
+      continue;
+    }
+
+    const bytes_ref term = ref_cast<byte_type>(string_ref(*it));
+
+    if (!a.next_bound(term, bound)) {
+      // no accepted terms after the current one
+      for (++it; it != terms.end(); ++it) {
+        ASSERT_FALSE(accept(a, *it));
+      }
+      break;
+    }
+
+    ASSERT_LT(term, bytes_ref(bound));
+
+    const std::string target(ref_cast<char>(bound).c_str(), bound.size());
+    const auto next = terms.lower_bound(target);
+
+    // nothing accepted is skipped
+    for (++it; it != next; ++it) {
+      ASSERT_FALSE(accept(a, *it));
+    }
+  }
+
+  ASSERT_EQ(expected, actual);
+}
+
+NS_END
+
+TEST(automaton_test, empty) {
+  automaton a;
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(automaton::INVALID_STATE, a.start());
+  ASSERT_FALSE(a.accept(bytes_ref::EMPTY));
+  ASSERT_FALSE(a.accept(ref("a")));
+
+  bstring bound;
+  ASSERT_FALSE(a.next_bound(ref("a"), bound));
+}
+
+TEST(automaton_test, manual) {
+  // accepts "ab" and "b[c-e]"
+  automaton a;
+  const auto start = a.add_state();
+  const auto a1 = a.add_state();
+  const auto b1 = a.add_state();
+  const auto end = a.add_state(true);
+  const auto dead = a.add_state();
+  a.add_transition(start, 'a', 'a', a1);
+  a.add_transition(start, 'b', 'b', b1);
+  a.add_transition(start, 'x', 'x', dead);
+  a.add_transition(a1, 'b', 'b', end);
+  a.add_transition(b1, 'c', 'e', end);
+  a.prune();
+
+  ASSERT_EQ(4, a.size()); // dead state removed
+  ASSERT_FALSE(a.empty());
+  ASSERT_TRUE(a.accept(ref("ab")));
+  ASSERT_TRUE(a.accept(ref("bd")));
+  ASSERT_FALSE(a.accept(ref("bf")));
+  ASSERT_FALSE(a.accept(ref("x")));
+  ASSERT_FALSE(a.accept(ref("abc")));
+  ASSERT_FALSE(a.accept(bytes_ref::EMPTY));
+
+  bstring bound;
+  ASSERT_TRUE(a.next_bound(bytes_ref::EMPTY, bound));
+  ASSERT_EQ(ref("ab"), bytes_ref(bound));
+  ASSERT_TRUE(a.next_bound(ref("aa"), bound));
+  ASSERT_EQ(ref("ab"), bytes_ref(bound));
+  ASSERT_TRUE(a.next_bound(ref("ab"), bound));
+  ASSERT_EQ(ref("bc"), bytes_ref(bound));
+  ASSERT_TRUE(a.next_bound(ref("bcz"), bound));
+  ASSERT_EQ(ref("bd"), bytes_ref(bound));
+  ASSERT_FALSE(a.next_bound(ref("be"), bound));
+  ASSERT_FALSE(a.next_bound(ref("c"), bound));
+}
+
+TEST(automaton_test, wildcard) {
+  {
+    auto a = make_wildcard_automaton(ref("a*c"));
+    ASSERT_TRUE(a.accept(ref("ac")));
+    ASSERT_TRUE(a.accept(ref("abc")));
+    ASSERT_TRUE(a.accept(ref("abbbc")));
+    ASSERT_TRUE(a.accept(ref("a\xD0\x96" "c")));
+    ASSERT_FALSE(a.accept(ref("ab")));
+    ASSERT_FALSE(a.accept(ref("bac")));
+    assert_intersection(a, all_strings("abc", 5));
+  }
+
+  {
+    auto a = make_wildcard_automaton(ref("?b?"));
+    ASSERT_TRUE(a.accept(ref("abc")));
+    ASSERT_TRUE(a.accept(ref("\xD0\x96" "b" "\xE2\x82\xAC")));
+    ASSERT_FALSE(a.accept(ref("\xD0" "b" "c"))); // malformed UTF-8
+    ASSERT_FALSE(a.accept(ref("ab")));
+    ASSERT_FALSE(a.accept(ref("abcd")));
+    assert_intersection(a, all_strings("abc", 4));
+  }
+
+  {
+    auto a = make_wildcard_automaton(ref("a\\*\\?"));
+    ASSERT_TRUE(a.accept(ref("a*?")));
+    ASSERT_FALSE(a.accept(ref("ab?")));
+  }
+
+  {
+    auto a = make_wildcard_automaton(ref("*"));
+    ASSERT_TRUE(a.accept(bytes_ref::EMPTY));
+    ASSERT_TRUE(a.accept(ref("abc")));
+    assert_intersection(a, all_strings("abc", 3));
+  }
+
+  {
+    auto a = make_wildcard_automaton(bytes_ref::EMPTY);
+    ASSERT_FALSE(a.empty());
+    ASSERT_TRUE(a.accept(bytes_ref::EMPTY));
+    ASSERT_FALSE(a.accept(ref("a")));
+  }
+}
+
+TEST(automaton_test, regexp) {
+  {
+    auto a = make_regexp_automaton(ref("(ab|c)+d?"));
+    ASSERT_TRUE(a.accept(ref("ab")));
+    ASSERT_TRUE(a.accept(ref("cabd")));
+    ASSERT_TRUE(a.accept(ref("ccc")));
+    ASSERT_FALSE(a.accept(ref("d")));
+    ASSERT_FALSE(a.accept(ref("abdd")));
+    assert_intersection(a, all_strings("abcd", 4));
+  }
+
+  {
+    auto a = make_regexp_automaton(ref("[a-c]{2,3}[^b]"));
+    ASSERT_TRUE(a.accept(ref("aaa")));
+    ASSERT_TRUE(a.accept(ref("abcd")));
+    ASSERT_TRUE(a.accept(ref("ab" "\xE2\x82\xAC")));
+    ASSERT_FALSE(a.accept(ref("abb")));
+    ASSERT_FALSE(a.accept(ref("aa")));
+    ASSERT_FALSE(a.accept(ref("abcab")));
+    assert_intersection(a, all_strings("abcd", 5));
+  }
+
+  {
+    auto a = make_regexp_automaton(ref("a.c"));
+    ASSERT_TRUE(a.accept(ref("abc")));
+    ASSERT_TRUE(a.accept(ref("a" "\xF0\x9F\x98\x80" "c")));
+    ASSERT_FALSE(a.accept(ref("ac")));
+  }
+
+  {
+    auto a = make_regexp_automaton(ref("\\d+\\.\\w{2,}"));
+    ASSERT_TRUE(a.accept(ref("12.a_")));
+    ASSERT_FALSE(a.accept(ref("12xab")));
+    ASSERT_FALSE(a.accept(ref("12.a")));
+  }
+
+  {
+    auto a = make_regexp_automaton(ref("a*b*"));
+    assert_intersection(a, all_strings("abc", 5));
+  }
+
+  {
+    auto a = make_regexp_automaton(ref("[\xD0\x90-\xD0\xAF]"));
+    ASSERT_TRUE(a.accept(ref("\xD0\x96")));
+    ASSERT_FALSE(a.accept(ref("\xD0\xB6")));
+  }
+
+  // invalid expressions accept nothing
+  for (auto* pattern : { "(ab", "ab)", "*a", "a{2", "a{3,2}", "[a", "[b-a]", "a||*" }) {
+    ASSERT_TRUE(make_regexp_automaton(ref(pattern)).empty()) << pattern;
+  }
+}
+
+TEST(automaton_test, levenshtein) {
+  const auto terms = all_strings("abcd", 5);
+
+  for (auto* target : { "", "a", "ab", "abc", "abcd", "badc" }) {
+    for (byte_type distance = 0; distance <= 2; ++distance) {
+      for (auto transpositions : { false, true }) {
+        auto a = make_levenshtein_automaton(ref(target), distance, transpositions);
+
+        for (auto& term : terms) {
+          ASSERT_EQ(
+            edit_distance(target, term, transpositions) <= distance,
+            accept(a, term)
+          ) << target << " " << term << " " << int(distance);
+        }
+
+        assert_intersection(a, terms);
+      }
+    }
+  }
+
+  // distance is counted in characters rather than bytes
+  auto a = make_levenshtein_automaton(ref("\xD0\x96" "ab"), 1);
+  ASSERT_TRUE(a.accept(ref("ab")));
+  ASSERT_TRUE(a.accept(ref("\xE2\x82\xAC" "ab")));
+  ASSERT_FALSE(a.accept(ref("\xD0" "ab")));
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "utils/compact_fst.hpp"
+#include "utils/noncopyable.hpp"
+
+#if defined (__GNUC__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wsign-compare"
+  #pragma GCC diagnostic ignored "-Wunused-local-typedefs"
+#endif
+
+#include "utils/fst_utils.hpp"
+#include "utils/fst.hpp"
+
+#if defined (__GNUC__)
+  #pragma GCC diagnostic pop
+#endif
+
+#include <map>
+#include <random>
+
+using namespace iresearch;
+
+NS_LOCAL
+
+bytes_ref to_ref(const std::string& str) {
+  return bytes_ref(reinterpret_cast<const byte_type*>(str.c_str()), str.size());
+}
+
+// builds FST from the specified sorted input
+void build(vector_byte_fst& fst, const std::map<std::string, std::string>& data) {
+  fst_byte_builder builder(fst);
+  builder.reset();
+
+  for (auto& entry : data) {
+    const auto out = to_ref(entry.second);
+    builder.add(to_ref(entry.first), byte_weight(out.begin(), out.end()));
+  }
+
+  builder.finish();
+}
+
+// checks that compact FST is structurally identical to the source one
+void assert_equal(const vector_byte_fst& expected, const compact_fst& actual) {
+  ASSERT_EQ(size_t(expected.NumStates()), actual.num_states());
+  ASSERT_EQ(compact_fst::stateid_t(expected.Start()), actual.start());
+
+  for (compact_fst::stateid_t state = 0; state < actual.num_states(); ++state) {
+    const auto& final = expected.Final(state);
+    bytes_ref weight;
+    ASSERT_EQ(byte_weight::Zero() != final, actual.final(state, weight));
+
+    if (byte_weight::Zero() != final) {
+      ASSERT_EQ(bytes_ref(final.c_str(), final.Size()), weight);
+    }
+
+    ASSERT_EQ(expected.NumArcs(state), actual.num_arcs(state));
+
+    size_t i = 0;
+    for (fst::ArcIterator<vector_byte_fst> it(expected, state); !it.Done(); it.Next(), ++i) {
+      const auto& arc = it.Value();
+      const bytes_ref arc_weight(arc.weight.c_str(), arc.weight.Size());
+
+      auto actual_arc = actual.at(state, i);
+      ASSERT_EQ(arc.ilabel, actual_arc.label);
+      ASSERT_EQ(compact_fst::stateid_t(arc.nextstate), actual_arc.target);
+      ASSERT_EQ(arc_weight, actual_arc.weight);
+
+      ASSERT_TRUE(actual.find(state, byte_type(arc.ilabel), actual_arc));
+      ASSERT_EQ(arc.ilabel, actual_arc.label);
+      ASSERT_EQ(compact_fst::stateid_t(arc.nextstate), actual_arc.target);
+      ASSERT_EQ(arc_weight, actual_arc.weight);
+    }
+  }
+}
+
+// returns concatenated output for the specified input
+bool lookup(const compact_fst& fst, const std::string& key, bstring& out) {
+  auto state = fst.start();
+  bytes_ref weight;
+  compact_fst::arc arc;
+
+  out.clear();
+
+  for (auto c : key) {
+    if (!fst.find(state, byte_type(c), arc)) {
+      return false;
+    }
+
+    out.append(arc.weight.c_str(), arc.weight.size());
+    state = arc.target;
+  }
+
+  if (!fst.final(state, weight)) {
+    return false;
+  }
+
+  out.append(weight.c_str(), weight.size());
+  return true;
+}
+
+// returns concatenated output for the specified input using the source FST
+bool lookup(const vector_byte_fst& fst, const std::string& key, bstring& out) {
+  auto state = fst.Start();
+
+  out.clear();
+
+  for (auto c : key) {
+    fst::ArcIterator<vector_byte_fst> it(fst, state);
+
+    for (; !it.Done() && it.Value().ilabel != byte_type(c); it.Next());
+
+    if (it.Done()) {
+      return false;
+    }
+
+    out.append(it.Value().weight.c_str(), it.Value().weight.Size());
+    state = it.Value().nextstate;
+  }
+
+  const auto& weight = fst.Final(state);
+
+  if (byte_weight::Zero() == weight) {
+    return false;
+  }
+
+  out.append(weight.c_str(), weight.Size());
+  return true;
+}
+
+NS_END
+
+TEST(compact_fst_tests, empty) {
+  compact_fst fst;
+  ASSERT_TRUE(fst.empty());
+  ASSERT_EQ(0, fst.num_states());
+  ASSERT_TRUE(fst.data().null());
+
+  vector_byte_fst src;
+  bstring data;
+  compact_fst::compile(src, data);
+  ASSERT_TRUE(fst.reset(data));
+  ASSERT_TRUE(fst.empty());
+}
+
+TEST(compact_fst_tests, malformed) {
+  compact_fst fst;
+  ASSERT_FALSE(fst.reset(bytes_ref::NIL));
+  ASSERT_FALSE(fst.reset(to_ref("garbage")));
+
+  vector_byte_fst src;
+  build(src, { { "a", "1" }, { "abc", "2" } });
+
+  bstring data;
+  compact_fst::compile(src, data);
+  ASSERT_TRUE(fst.reset(data));
+  ASSERT_FALSE(fst.reset(bytes_ref(data.c_str(), data.size()/2))); // truncated
+  ASSERT_TRUE(fst.empty());
+}
+
+TEST(compact_fst_tests, lookup) {
+  std::map<std::string, std::string> data {
+    { "", "root" },
+    { "a", "1" },
+    { "aa", "" },
+    { "ab", "12" },
+    { "abc", "123" },
+    { "abd", "123" },
+    { "b", "\xFF" },
+    { "bcd", "1" },
+    { "\xFF\xFE", "end" }
+  };
+
+  vector_byte_fst src;
+  build(src, data);
+
+  bstring buf;
+  compact_fst::compile(src, buf);
+
+  compact_fst fst;
+  ASSERT_TRUE(fst.reset(buf));
+  ASSERT_EQ(bytes_ref(buf), fst.data());
+  ASSERT_FALSE(fst.empty());
+  assert_equal(src, fst);
+  ASSERT_EQ(fst_byte_builder::final, 0);
+
+  bstring expected, actual;
+  for (auto& entry : data) {
+    ASSERT_EQ(lookup(src, entry.first, expected), lookup(fst, entry.first, actual));
+    ASSERT_EQ(expected, actual);
+  }
+
+  ASSERT_TRUE(lookup(fst, "", actual));
+  ASSERT_EQ(to_ref("root"), bytes_ref(actual));
+  ASSERT_FALSE(lookup(fst, "abe", actual));
+  ASSERT_FALSE(lookup(fst, "bc", actual));
+  ASSERT_FALSE(lookup(fst, "c", actual));
+}
+
+TEST(compact_fst_tests, random) {
+  std::mt19937 engine(42);
+  std::uniform_int_distribution<int> length(1, 16);
+  std::uniform_int_distribution<int> symbol(0, 255);
+  std::map<std::string, std::string> data;
+
+  auto random_string = [&](size_t size) {
+    std::string str;
+    for (; size; --size) {
+      str += char(symbol(engine));
+    }
+    return str;
+  };
+
+  for (size_t i = 0; i < 10000; ++i) {
+    data[random_string(length(engine))] = random_string(length(engine) % 4);
+  }
+
+  vector_byte_fst src;
+  build(src, data);
+
+  bstring buf;
+  compact_fst::compile(src, buf);
+
+  compact_fst fst;
+  ASSERT_TRUE(fst.reset(buf));
+  assert_equal(src, fst);
+
+  bstring expected, actual;
+  for (auto& entry : data) {
+    ASSERT_EQ(lookup(src, entry.first, expected), lookup(fst, entry.first, actual));
+    ASSERT_EQ(expected, actual);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
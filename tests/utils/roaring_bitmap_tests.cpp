@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "utils/roaring_bitmap.hpp"
+
+#include <random>
+#include <set>
+
+using namespace iresearch;
+
+NS_LOCAL
+
+// checks that 'actual' contains exactly the values of 'expected'
+void assert_equal(const std::set<uint32_t>& expected, const roaring_bitmap& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  ASSERT_EQ(expected.empty(), actual.empty());
+  ASSERT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin()));
+  ASSERT_EQ(expected.size(), size_t(std::distance(actual.begin(), actual.end())));
+
+  for (auto value : expected) {
+    ASSERT_TRUE(actual.contains(value));
+    ASSERT_EQ(1, actual.count(value));
+    ASSERT_EQ(value, *actual.find(value));
+  }
+}
+
+// naive implementation of 'next_absent'
+uint32_t next_absent(const std::set<uint32_t>& values, uint32_t value) {
+  for (auto it = values.find(value); it != values.end() && *it == value; ++it) {
+    if (value == std::numeric_limits<uint32_t>::max()) {
+      break;
+    }
+
+    ++value;
+  }
+
+  return value;
+}
+
+NS_END
+
+TEST(roaring_bitmap_tests, ctor) {
+  {
+    const roaring_bitmap bm;
+    ASSERT_TRUE(bm.empty());
+    ASSERT_EQ(0, bm.size());
+    ASSERT_EQ(bm.begin(), bm.end());
+    ASSERT_EQ(bm.end(), bm.find(0));
+    ASSERT_EQ(bm.end(), bm.lower_bound(0));
+    ASSERT_FALSE(bm.contains(0));
+    ASSERT_EQ(0, bm.next_absent(0));
+    ASSERT_EQ(42, bm.next_absent(42));
+  }
+
+  {
+    const roaring_bitmap bm{ 5, 1, 70000, 3, 1 };
+    ASSERT_EQ(4, bm.size());
+    assert_equal({ 1, 3, 5, 70000 }, bm);
+    ASSERT_EQ((roaring_bitmap{ 1, 3, 5, 70000 }), bm);
+    ASSERT_NE((roaring_bitmap{ 1, 3, 5 }), bm);
+    ASSERT_NE((roaring_bitmap{ 1, 3, 5, 70001 }), bm);
+  }
+}
+
+TEST(roaring_bitmap_tests, insert_erase) {
+  roaring_bitmap bm;
+
+  auto res = bm.insert(42);
+  ASSERT_TRUE(res.second);
+  ASSERT_EQ(42, *res.first);
+  res = bm.emplace(42);
+  ASSERT_FALSE(res.second);
+  ASSERT_EQ(42, *res.first);
+  ASSERT_EQ(1, bm.size());
+
+  ASSERT_TRUE(bm.insert(std::numeric_limits<uint32_t>::max()).second);
+  ASSERT_TRUE(bm.insert(0).second);
+  assert_equal({ 0, 42, std::numeric_limits<uint32_t>::max() }, bm);
+
+  ASSERT_EQ(0, bm.erase(43));
+  ASSERT_EQ(0, bm.erase(1U << 20));
+  ASSERT_EQ(1, bm.erase(42));
+  ASSERT_EQ(0, bm.erase(42));
+  ASSERT_EQ(1, bm.erase(std::numeric_limits<uint32_t>::max()));
+  assert_equal({ 0 }, bm);
+
+  bm.clear();
+  ASSERT_TRUE(bm.empty());
+  ASSERT_EQ(bm.begin(), bm.end());
+}
+
+TEST(roaring_bitmap_tests, dense_container) {
+  roaring_bitmap bm;
+  std::set<uint32_t> expected;
+
+  // every 3rd value, container is converted into a bitset
+  for (uint32_t i = 65536; i < 2*65536; i += 3) {
+    ASSERT_TRUE(bm.insert(i).second);
+    expected.insert(i);
+  }
+
+  assert_equal(expected, bm);
+  ASSERT_GT(expected.size(), roaring_bitmap::ARRAY_MAX);
+  ASSERT_EQ(65537, bm.next_absent(65536));
+  ASSERT_EQ(0, bm.next_absent(0));
+  ASSERT_EQ(2*65536, bm.next_absent(2*65536));
+
+  // erase until the container is converted back into an array
+  for (auto it = expected.begin(); expected.size() > roaring_bitmap::ARRAY_MAX/2;) {
+    ASSERT_EQ(1, bm.erase(*it));
+    it = expected.erase(it);
+
+    if (it == expected.end() || ++it == expected.end()) {
+      it = expected.begin();
+    }
+  }
+
+  assert_equal(expected, bm);
+
+  bm.optimize();
+  assert_equal(expected, bm);
+}
+
+TEST(roaring_bitmap_tests, insert_range) {
+  roaring_bitmap bm;
+  std::set<uint32_t> expected;
+
+  auto insert_range = [&bm, &expected](uint32_t begin, uint32_t end) {
+    bm.insert_range(begin, end);
+
+    for (; begin < end; ++begin) {
+      expected.insert(begin);
+    }
+  };
+
+  insert_range(10, 10); // empty range
+  ASSERT_TRUE(bm.empty());
+
+  insert_range(10, 20); // array
+  insert_range(15, 30);
+  assert_equal(expected, bm);
+  ASSERT_EQ(30, bm.next_absent(10));
+  ASSERT_EQ(30, bm.next_absent(29));
+  ASSERT_EQ(9, bm.next_absent(9));
+
+  insert_range(1000, 70000); // spans 2 containers
+  insert_range(65530, 65540);
+  insert_range(200000, 200064); // whole words
+  assert_equal(expected, bm);
+  ASSERT_EQ(70000, bm.next_absent(1000));
+  ASSERT_EQ(200064, bm.next_absent(200000));
+  ASSERT_EQ(*bm.lower_bound(30), 1000);
+  ASSERT_EQ(*bm.lower_bound(70000), 200000);
+  ASSERT_EQ(bm.end(), bm.lower_bound(200064));
+
+  // runs are the most compact representation here
+  const auto memory = bm.memory();
+  bm.optimize();
+  ASSERT_LT(bm.memory(), memory);
+  assert_equal(expected, bm);
+  ASSERT_EQ(70000, bm.next_absent(1000));
+  ASSERT_EQ(30, bm.next_absent(10));
+  ASSERT_EQ(*bm.lower_bound(30), 1000);
+  ASSERT_EQ(*bm.lower_bound(69999), 69999);
+
+  // modify containers stored as runs
+  ASSERT_FALSE(bm.insert(1500).second);
+  ASSERT_TRUE(bm.insert(31).second);
+  expected.insert(31);
+  ASSERT_EQ(1, bm.erase(5000));
+  expected.erase(5000);
+  assert_equal(expected, bm);
+  ASSERT_EQ(5000, bm.next_absent(1000));
+}
+
+TEST(roaring_bitmap_tests, random) {
+  std::mt19937 engine(42);
+  std::uniform_int_distribution<uint32_t> value(0, 4*65536);
+  std::uniform_int_distribution<uint32_t> length(1, 512);
+
+  roaring_bitmap bm;
+  std::set<uint32_t> expected;
+
+  for (size_t i = 0; i < 2000; ++i) {
+    const auto begin = value(engine);
+
+    switch (i % 4) {
+      case 0: {
+        const auto end = begin + length(engine);
+        bm.insert_range(begin, end);
+        for (auto v = begin; v < end; ++v) {
+          expected.insert(v);
+        }
+      } break;
+      case 1:
+        ASSERT_EQ(expected.insert(begin).second, bm.insert(begin).second);
+        break;
+      case 2: {
+        const auto it = expected.lower_bound(begin);
+        const auto v = it == expected.end() ? begin : *it;
+        ASSERT_EQ(expected.erase(v), bm.erase(v));
+      } break;
+      case 3:
+        bm.optimize();
+        break;
+    }
+  }
+
+  assert_equal(expected, bm);
+
+  for (uint32_t v = 0; v < 4*65536 + 1024; v += 7) {
+    ASSERT_EQ(next_absent(expected, v), bm.next_absent(v));
+
+    const auto it = expected.lower_bound(v);
+    const auto actual = bm.lower_bound(v);
+
+    if (it == expected.end()) {
+      ASSERT_EQ(bm.end(), actual);
+    } else {
+      ASSERT_EQ(*it, *actual);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
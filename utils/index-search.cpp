@@ -65,8 +65,8 @@
 #include "search/phrase_filter.hpp"
 #include "search/bm25.hpp"
 #include "search/score.hpp"
+#include "search/top_docs_collector.hpp"
 #include "utils/async_utils.hpp"
-#include "utils/memory_pool.hpp"
 
 #include <boost/chrono.hpp>
 #include <random>
@@ -133,7 +133,7 @@ struct Task {
     irs::filter::prepared::ptr prepared;
 
     int taskId;
-    int totalHitCount;
+    int totalHitCount; // lower bound, documents pruned by block-max WAND are not counted
     int topN;
 
     boost::posix_time::time_duration tdiff;
@@ -194,38 +194,20 @@ struct SearchTask : public Task {
     virtual int query(irs::directory_reader& reader) override {
         SCOPED_TIMER("Query execution + Result processing time");
 
-        for (auto& segment : reader) { // iterate segments
-            irs::order order;
-            order.add<irs::bm25_sort>(true);
-            auto prepared_order = order.prepare();
-            auto docs = prepared->execute(segment, prepared_order); // query segment
-            const irs::score* score = docs->attributes().get<iresearch::score>().get();
-            auto comparer = [&prepared_order](const irs::bstring& lhs, const irs::bstring& rhs)->bool {
-              return prepared_order.less(lhs.c_str(), rhs.c_str());
-            };
-            std::multimap<irs::bstring, Entry, decltype(comparer)> sorted(comparer);
+        irs::order order;
+        order.add<irs::bm25_sort>(true);
+        auto prepared_order = order.prepare();
+        irs::top_docs_collector collector(prepared_order, topN);
 
-            // ensure we avoid COW for pre c++11 std::basic_string
-            const irs::bytes_ref score_value = score->value();
+        collector.collect(reader, *prepared); // query all segments
+        totalHitCount += int(collector.hits()); // lower bound on the number of matches
 
-            while (docs->next()) {
-              SCOPED_TIMER("Result processing time");
-              ++totalHitCount;
-              score->evaluate();
-              sorted.emplace(
-                std::piecewise_construct,
-                std::forward_as_tuple(score_value),
-                std::forward_as_tuple(docs->value(), score ? prepared_order.get<float>(score_value.c_str(), 0) : .0)
-              );
-
-              if (sorted.size() > topN) {
-                sorted.erase(--(sorted.end()));
-              }
-            }
-
-            for (auto& entry: sorted) {
-              top_docs.emplace_back(std::move(entry.second));
-            }
+        {
+            SCOPED_TIMER("Result processing time");
+            collector.visit([this, &prepared_order](const irs::top_docs_collector::entry& entry) {
+              top_docs.emplace_back(entry.doc, prepared_order.get<float>(entry.score, 0));
+              return true;
+            });
         }
         return 0;
     }
@@ -233,7 +215,7 @@ struct SearchTask : public Task {
     /**
      */
     void print(std::ostream& out) override {
-        out << "TASK: cat=" << category << " q='body:" << text << "' hits=" << totalHitCount << std::endl;
+        out << "TASK: cat=" << category << " q='body:" << text << "' hits>=" << totalHitCount << std::endl;
         out << "  " << tdiff.total_milliseconds() / 1000. << " msec" << std::endl;
         out << "  thread " << tid << std::endl;
         for (auto& doc : top_docs) {
@@ -974,15 +956,6 @@ int search(
     task_provider = std::move(tasks);
   }
 
-  struct Entry {
-    Entry(irs::doc_id_t i, float s)
-      : id(i), score(s) {
-    }
-
-    irs::doc_id_t id;
-    float score;
-  };
-
   // indexer threads
   for (size_t i = search_threads; i; --i) {
     thread_pool.run([&task_provider, &dir, &reader, &order, limit, &out, csv, scored_terms_limit]()->void {
@@ -992,36 +965,14 @@ int search(
       irs::filter::prepared::ptr filter;
       std::string tmpBuf;
 
-      #if defined(_MSC_VER) && defined(IRESEARCH_DEBUG)
-        typedef irs::memory::memory_multi_size_pool<irs::memory::identity_grow> pool_t;
-        typedef irs::memory::memory_pool_multi_size_allocator<Entry, pool_t> alloc_t;
-      #else
-        typedef irs::memory::memory_pool<irs::memory::identity_grow> pool_t;
-        typedef irs::memory::memory_pool_allocator<Entry, pool_t> alloc_t;
-      #endif
-
-      pool_t pool(limit + 1); // +1 for least significant overflow element
-
-#ifdef IRESEARCH_COMPLEX_SCORING
-      auto comparer = [&order](const irs::bstring& lhs, const irs::bstring& rhs)->bool {
-        return order.less(lhs.c_str(), rhs.c_str());
-      };
-      std::multimap<irs::bstring, Entry, decltype(comparer), alloc_t> sorted(
-        comparer, alloc_t{pool}
-      );
-#else
-      std::multimap<float, irs::doc_id_t, std::less<float>, alloc_t> sorted(
-        std::less<float>(), alloc_t{pool}
-      );
-#endif
+      irs::top_docs_collector collector(order, limit);
 
       // process a single task
       for (const task_t* task; (task = ++task_provider) != nullptr;) {
         SCOPED_TIMER("Full task processing time");
-        size_t doc_count = 0;
         auto start = std::chrono::system_clock::now();
 
-        sorted.clear();
+        collector.clear();
 
         // parse task
         {
@@ -1055,39 +1006,7 @@ int search(
           SCOPED_TIMER("Query execution time");
           irs::timer_utils::scoped_timer timer(*(timers.stat[size_t(task->category)]));
 
-          const float EMPTY_SCORE = 0.f;
-
-          for (auto& segment: reader) {
-            auto docs = filter->execute(segment, order); // query segment
-            const irs::score& score = irs::score::extract(docs->attributes());
-
-#ifdef IRESEARCH_COMPLEX_SCORING
-            // ensure we avoid COW for pre c++11 std::basic_string
-            const irs::bytes_ref raw_score_value = score->value();                        
-#endif
-            const auto& score_value = &score != &irs::score::no_score()
-              ? order.get<float>(score.c_str(), 0)
-              : EMPTY_SCORE;
-            
-            while (docs->next()) {
-              ++doc_count;
-              score.evaluate();
-
-#ifdef IRESEARCH_COMPLEX_SCORING
-              sorted.emplace(
-                std::piecewise_construct,
-                std::forward_as_tuple(raw_score_value),
-                std::forward_as_tuple(docs->value(), score_value)
-              );
-#else
-              sorted.emplace(score_value, docs->value());
-#endif
-
-              if (sorted.size() > limit) {
-                sorted.erase(--(sorted.end()));
-              }
-            }
-          }
+          collector.collect(reader, *filter);
         }
 
         // output task results
@@ -1096,21 +1015,21 @@ int search(
           SCOPED_LOCK(mutex);
           SCOPED_TIMER("Result processing time");
           auto tdiff = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+          const auto doc_count = collector.hits(); // lower bound, see top_docs_collector::hits()
 
           if (csv) {
             out << stringCategory(task->category) << "," << task->text << "," << doc_count << "," << tdiff.count() / 1000. << "," << tdiff.count() << std::endl;
           } else {
-            out << "TASK: cat=" << stringCategory(task->category) << " q='body:" << task->text << "' hits=" << doc_count << std::endl;
+            out << "TASK: cat=" << stringCategory(task->category) << " q='body:" << task->text << "' hits>=" << doc_count << std::endl;
             out << "  " << tdiff.count() / 1000. << " msec" << std::endl;
             out << "  thread " << std::this_thread::get_id() << std::endl;
 
-            for (auto& entry : sorted) {
-#ifdef IRESEARCH_COMPLEX_SCORING
-              out << "  doc=" << entry.second.id << " score=" << entry.second.score << std::endl;
-#else
-              out << "  doc=" << entry.second << " score=" << entry.first<< std::endl;
-#endif
-            }
+            collector.visit([&order, &out](const irs::top_docs_collector::entry& entry) {
+              const float score = order.empty() ? 0.f : order.get<float>(entry.score, 0);
+
+              out << "  doc=" << entry.doc << " score=" << score << std::endl;
+              return true;
+            });
 
             out << std::endl;
           }